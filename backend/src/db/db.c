@@ -10,8 +10,8 @@
 #include "models/word.h"
 #include "dbug/dbug.h"
 
-/* Глобальный указатель на соединение (реиспользуется) */
-static PGconn *db_conn = NULL;
+/* Соединение (реиспользуется); своё у каждого потока — воркеры задач ходят в БД параллельно */
+static __thread PGconn *db_conn = NULL;
 
 /* Параметры по умолчанию; при необходимости вынеси в конфиг / env */
 static char CONNINFO[256];
@@ -677,8 +677,38 @@ int db_update_word(const db_word_update_input_t *input)
 
 int db_delete_word(const db_word_delete_input_t *input)
 {
-    (void)input;
-    return DB_ERR_NOT_IMPLEMENTED;
+    const char *paramValues[2];
+    char idbuf[16];
+    char userbuf[16];
+    PGresult *res;
+    int rc = DB_ERR_SERVER;
+
+    if (!input || input->word_id <= 0 || input->user_id <= 0) {
+        return DB_ERR_INVALID_ARGUMENT;
+    }
+
+    if (db_connect(CONNINFO) != 0) {
+        ERROR_PRINT("db_delete_word: db_connect failed");
+        return DB_ERR_SERVER;
+    }
+
+    snprintf(idbuf, sizeof(idbuf), "%d", input->word_id);
+    snprintf(userbuf, sizeof(userbuf), "%d", input->user_id);
+    paramValues[0] = idbuf;
+    paramValues[1] = userbuf;
+    res = PQexecParams(db_conn, "DELETE FROM words WHERE id = $1 AND user_id = $2;",
+                       2, NULL, paramValues, NULL, NULL, 0);
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        ERROR_PRINT("db_delete_word: DELETE failed: %s", PQerrorMessage(db_conn));
+    } else if (atoi(PQcmdTuples(res)) == 0) {
+        rc = DB_ERR_NOT_FOUND;
+    } else {
+        rc = DB_OK;
+    }
+
+    if (res) PQclear(res);
+    db_disconnect();
+    return rc;
 }
 
 int db_get_all_words(Word **out_list, size_t *out_count, int user_id) {
@@ -716,6 +746,60 @@ int db_get_all_words(Word **out_list, size_t *out_count, int user_id) {
     return 0;
 }
 
+int db_get_user_word_keys(int user_id, char ***out_words, size_t *out_count)
+{
+    const char *paramValues[1];
+    char idbuf[16];
+    PGresult *res;
+    int rc = DB_ERR_SERVER;
+
+    if (user_id <= 0 || !out_words || !out_count) {
+        return DB_ERR_INVALID_ARGUMENT;
+    }
+    *out_words = NULL;
+    *out_count = 0;
+
+    if (db_connect(CONNINFO) != 0) {
+        ERROR_PRINT("db_get_user_word_keys: db_connect failed");
+        return DB_ERR_SERVER;
+    }
+
+    snprintf(idbuf, sizeof(idbuf), "%d", user_id);
+    paramValues[0] = idbuf;
+    res = PQexecParams(db_conn, "SELECT word FROM words WHERE user_id = $1;",
+                       1, NULL, paramValues, NULL, NULL, 0);
+    if (!res || PQresultStatus(res) != PGRES_TUPLES_OK) {
+        ERROR_PRINT("db_get_user_word_keys: SELECT failed: %s", PQerrorMessage(db_conn));
+    } else {
+        size_t rows = (size_t) PQntuples(res);
+        size_t size = rows * sizeof(char *);
+        char **words;
+        char *dst;
+
+        for (size_t i = 0; i < rows; ++i) {
+            size += (size_t) PQgetlength(res, (int) i, 0) + 1;
+        }
+        words = malloc(size > 0 ? size : 1);
+        if (words) {
+            dst = (char *) (words + rows);
+            for (size_t i = 0; i < rows; ++i) {
+                size_t len = (size_t) PQgetlength(res, (int) i, 0);
+
+                memcpy(dst, PQgetvalue(res, (int) i, 0), len + 1);
+                words[i] = dst;
+                dst += len + 1;
+            }
+            *out_words = words;
+            *out_count = rows;
+            rc = DB_OK;
+        }
+    }
+
+    if (res) PQclear(res);
+    db_disconnect();
+    return rc;
+}
+
 void db_free_word(Word *word)
 {
     if (!word) return;
@@ -747,12 +831,14 @@ void db_free_word_list(Word *words, size_t count)
     free(words);
 }
 
-/* --- db_get_user_profile: заполняет username, words_learned и active_lessons.
+/* --- db_get_user_profile: заполняет username, words_learned, active_lessons и known_level.
      Возвращает 0 при успехе, -1 при ошибке, -2 если пользователя нет. --- */
 int db_get_user_profile(int user_id, char *username_out, size_t uname_sz,
-                        int *words_learned_out, int *active_lessons_out)
+                        int *words_learned_out, int *active_lessons_out,
+                        int *known_level_out)
 {
-    if (user_id <= 0 || !username_out || uname_sz == 0 || !words_learned_out || !active_lessons_out) {
+    if (user_id <= 0 || !username_out || uname_sz == 0 || !words_learned_out || !active_lessons_out ||
+        !known_level_out) {
         ERROR_PRINT("db_get_user_profile: invalid args");
         return -1;
     }
@@ -767,9 +853,9 @@ int db_get_user_profile(int user_id, char *username_out, size_t uname_sz,
     const char *paramValues[1] = { idbuf };
     Oid paramTypes[1] = { 23 }; /* int4 */
 
-    /* 1) username */
+    /* 1) username, known_level */
     PGresult *res = PQexecParams(db_conn,
-        "SELECT username FROM users WHERE id = $1;",
+        "SELECT username, known_level FROM users WHERE id = $1;",
         1, paramTypes, paramValues, NULL, NULL, 0);
     if (!res) {
         ERROR_PRINT("db_get_user_profile: SELECT username returned NULL");
@@ -790,6 +876,7 @@ int db_get_user_profile(int user_id, char *username_out, size_t uname_sz,
     const char *uname = PQgetvalue(res, 0, 0);
     strncpy(username_out, uname, uname_sz - 1);
     username_out[uname_sz - 1] = '\0';
+    *known_level_out = atoi(PQgetvalue(res, 0, 1));
     PQclear(res);
 
     /* 2) words_learned -> COUNT(*) FROM words WHERE user_id = $1 */
@@ -823,3 +910,722 @@ int db_get_user_profile(int user_id, char *username_out, size_t uname_sz,
     db_disconnect();
     return 0;
 }
+
+int db_get_user_known_level(int user_id, int *out_level)
+{
+    const char *paramValues[1];
+    char idbuf[16];
+    PGresult *res;
+    int rc = DB_ERR_SERVER;
+
+    if (user_id <= 0 || !out_level) {
+        return DB_ERR_INVALID_ARGUMENT;
+    }
+
+    if (db_connect(CONNINFO) != 0) {
+        ERROR_PRINT("db_get_user_known_level: db_connect failed");
+        return DB_ERR_SERVER;
+    }
+
+    snprintf(idbuf, sizeof(idbuf), "%d", user_id);
+    paramValues[0] = idbuf;
+    res = PQexecParams(db_conn, "SELECT known_level FROM users WHERE id = $1;",
+                       1, NULL, paramValues, NULL, NULL, 0);
+    if (!res || PQresultStatus(res) != PGRES_TUPLES_OK) {
+        ERROR_PRINT("db_get_user_known_level: SELECT failed: %s", PQerrorMessage(db_conn));
+    } else if (PQntuples(res) == 0) {
+        rc = DB_ERR_NOT_FOUND;
+    } else {
+        *out_level = atoi(PQgetvalue(res, 0, 0));
+        rc = DB_OK;
+    }
+
+    if (res) PQclear(res);
+    db_disconnect();
+    return rc;
+}
+
+int db_set_user_known_level(int user_id, int level)
+{
+    const char *paramValues[2];
+    char idbuf[16];
+    char levelbuf[16];
+    PGresult *res;
+    int rc = DB_ERR_SERVER;
+
+    if (user_id <= 0 || level < 0) {
+        return DB_ERR_INVALID_ARGUMENT;
+    }
+
+    if (db_connect(CONNINFO) != 0) {
+        ERROR_PRINT("db_set_user_known_level: db_connect failed");
+        return DB_ERR_SERVER;
+    }
+
+    snprintf(idbuf, sizeof(idbuf), "%d", user_id);
+    snprintf(levelbuf, sizeof(levelbuf), "%d", level);
+    paramValues[0] = levelbuf;
+    paramValues[1] = idbuf;
+    res = PQexecParams(db_conn, "UPDATE users SET known_level = $1 WHERE id = $2;",
+                       2, NULL, paramValues, NULL, NULL, 0);
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        ERROR_PRINT("db_set_user_known_level: UPDATE failed: %s", PQerrorMessage(db_conn));
+    } else if (strcmp(PQcmdTuples(res), "0") == 0) {
+        rc = DB_ERR_NOT_FOUND;
+    } else {
+        rc = DB_OK;
+    }
+
+    if (res) PQclear(res);
+    db_disconnect();
+    return rc;
+}
+
+/* --- Кэш карточек (card_cache) --- */
+
+/*
+ * Литерал массива text[]: {"a","b"} с экранированием '"' и '\'.
+ * NULL — нет памяти; освободить через free().
+ */
+static char *db_text_array_literal(const char *const *words, size_t count)
+{
+    char *array;
+    char *dst;
+    size_t size = 3;
+    size_t i;
+
+    for (i = 0; i < count; ++i) {
+        size += strlen(words[i]) * 2 + 3;
+    }
+    array = malloc(size);
+    if (!array) {
+        return NULL;
+    }
+    dst = array;
+    *dst++ = '{';
+    for (i = 0; i < count; ++i) {
+        const char *src;
+
+        if (i > 0) *dst++ = ',';
+        *dst++ = '"';
+        for (src = words[i]; *src; ++src) {
+            if (*src == '"' || *src == '\\') *dst++ = '\\';
+            *dst++ = *src;
+        }
+        *dst++ = '"';
+    }
+    *dst++ = '}';
+    *dst = '\0';
+    return array;
+}
+
+int db_card_cache_get(const char *word, Word *out_word)
+{
+    const char *paramValues[1];
+    PGresult *res;
+    int rc = DB_ERR_SERVER;
+
+    if (!word || !out_word) {
+        return DB_ERR_INVALID_ARGUMENT;
+    }
+
+    memset(out_word, 0, sizeof(*out_word));
+
+    if (db_connect(CONNINFO) != 0) {
+        ERROR_PRINT("db_card_cache_get: db_connect failed");
+        return DB_ERR_SERVER;
+    }
+
+    paramValues[0] = word;
+    res = PQexecParams(db_conn,
+        "SELECT word, transcription, translation, example_1, example_2 "
+        "FROM card_cache WHERE word = lower($1);",
+        1, NULL, paramValues, NULL, NULL, 0);
+
+    if (!res || PQresultStatus(res) != PGRES_TUPLES_OK) {
+        ERROR_PRINT("db_card_cache_get: SELECT failed: %s", PQerrorMessage(db_conn));
+    } else if (PQntuples(res) == 0) {
+        rc = DB_ERR_NOT_FOUND;
+    } else {
+        out_word->word = strdup(PQgetvalue(res, 0, 0));
+        out_word->transcription = strdup(PQgetvalue(res, 0, 1));
+        out_word->translation = strdup(PQgetvalue(res, 0, 2));
+        out_word->example_1 = strdup(PQgetvalue(res, 0, 3));
+        out_word->example_2 = strdup(PQgetvalue(res, 0, 4));
+        out_word->example = out_word->example_1;
+
+        if (out_word->word && out_word->transcription && out_word->translation &&
+            out_word->example_1 && out_word->example_2) {
+            rc = DB_OK;
+        } else {
+            db_free_word(out_word);
+        }
+    }
+
+    if (res) PQclear(res);
+    db_disconnect();
+    return rc;
+}
+
+int db_card_cache_put_many(const db_card_cache_input_t *inputs, size_t count)
+{
+    const char *paramValues[DB_CARD_CACHE_MAX_BATCH * 5];
+    char query[128 + DB_CARD_CACHE_MAX_BATCH * 64];
+    size_t used;
+    size_t i;
+    PGresult *res;
+    int rc = DB_OK;
+
+    if (!inputs || count == 0 || count > DB_CARD_CACHE_MAX_BATCH) {
+        return DB_ERR_INVALID_ARGUMENT;
+    }
+
+    used = (size_t) snprintf(query, sizeof(query),
+        "INSERT INTO card_cache (word, transcription, translation, example_1, example_2) VALUES ");
+    for (i = 0; i < count; ++i) {
+        if (!inputs[i].word) {
+            return DB_ERR_INVALID_ARGUMENT;
+        }
+        paramValues[i * 5 + 0] = inputs[i].word;
+        paramValues[i * 5 + 1] = inputs[i].transcription;
+        paramValues[i * 5 + 2] = inputs[i].translation;
+        paramValues[i * 5 + 3] = inputs[i].example_1;
+        paramValues[i * 5 + 4] = inputs[i].example_2;
+        used += (size_t) snprintf(query + used, sizeof(query) - used,
+                                  "%s(lower($%zu), $%zu, $%zu, $%zu, $%zu)",
+                                  i > 0 ? ", " : "",
+                                  i * 5 + 1, i * 5 + 2, i * 5 + 3, i * 5 + 4, i * 5 + 5);
+    }
+    snprintf(query + used, sizeof(query) - used, " ON CONFLICT (word) DO NOTHING;");
+
+    if (db_connect(CONNINFO) != 0) {
+        ERROR_PRINT("db_card_cache_put_many: db_connect failed");
+        return DB_ERR_SERVER;
+    }
+
+    res = PQexecParams(db_conn, query, (int) (count * 5), NULL, paramValues, NULL, NULL, 0);
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        ERROR_PRINT("db_card_cache_put_many: INSERT failed: %s", PQerrorMessage(db_conn));
+        rc = DB_ERR_SERVER;
+    } else {
+        DEBUG_PRINT_DB("card_cache: %s of %zu rows inserted", PQcmdTuples(res), count);
+    }
+
+    if (res) PQclear(res);
+    db_disconnect();
+    return rc;
+}
+
+int db_card_cache_contains(const char *const *words, size_t count, int *out_present)
+{
+    const char *paramValues[1];
+    char *array = NULL;
+    size_t i;
+    PGresult *res = NULL;
+    int rc = DB_ERR_SERVER;
+
+    if (!words || !out_present || count == 0) {
+        return DB_ERR_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < count; ++i) {
+        out_present[i] = 0;
+        if (!words[i]) {
+            return DB_ERR_INVALID_ARGUMENT;
+        }
+    }
+    array = db_text_array_literal(words, count);
+    if (!array) {
+        return DB_ERR_SERVER;
+    }
+
+    if (db_connect(CONNINFO) != 0) {
+        ERROR_PRINT("db_card_cache_contains: db_connect failed");
+        free(array);
+        return DB_ERR_SERVER;
+    }
+
+    paramValues[0] = array;
+    res = PQexecParams(db_conn,
+        "SELECT i - 1 FROM unnest($1::text[]) WITH ORDINALITY AS t(w, i) "
+        "WHERE EXISTS (SELECT 1 FROM card_cache c WHERE c.word = lower(t.w));",
+        1, NULL, paramValues, NULL, NULL, 0);
+
+    if (!res || PQresultStatus(res) != PGRES_TUPLES_OK) {
+        ERROR_PRINT("db_card_cache_contains: SELECT failed: %s", PQerrorMessage(db_conn));
+    } else {
+        int rows = PQntuples(res);
+
+        for (int r = 0; r < rows; ++r) {
+            long idx = atol(PQgetvalue(res, r, 0));
+
+            if (idx >= 0 && (size_t) idx < count) {
+                out_present[idx] = 1;
+            }
+        }
+        rc = DB_OK;
+    }
+
+    if (res) PQclear(res);
+    db_disconnect();
+    free(array);
+    return rc;
+}
+
+int db_card_cache_get_many(const char *const *words, size_t count, Word *out_words, int *out_found)
+{
+    const char *paramValues[1];
+    char *array = NULL;
+    size_t i;
+    PGresult *res = NULL;
+    int rc = DB_ERR_SERVER;
+
+    if (!words || !out_words || !out_found || count == 0) {
+        return DB_ERR_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < count; ++i) {
+        memset(&out_words[i], 0, sizeof(out_words[i]));
+        out_found[i] = 0;
+        if (!words[i]) {
+            return DB_ERR_INVALID_ARGUMENT;
+        }
+    }
+    array = db_text_array_literal(words, count);
+    if (!array) {
+        return DB_ERR_SERVER;
+    }
+
+    if (db_connect(CONNINFO) != 0) {
+        ERROR_PRINT("db_card_cache_get_many: db_connect failed");
+        free(array);
+        return DB_ERR_SERVER;
+    }
+
+    paramValues[0] = array;
+    res = PQexecParams(db_conn,
+        "SELECT t.i - 1, c.word, c.transcription, c.translation, c.example_1, c.example_2 "
+        "FROM unnest($1::text[]) WITH ORDINALITY AS t(w, i) "
+        "JOIN card_cache c ON c.word = lower(t.w);",
+        1, NULL, paramValues, NULL, NULL, 0);
+
+    if (!res || PQresultStatus(res) != PGRES_TUPLES_OK) {
+        ERROR_PRINT("db_card_cache_get_many: SELECT failed: %s", PQerrorMessage(db_conn));
+    } else {
+        int rows = PQntuples(res);
+
+        for (int r = 0; r < rows; ++r) {
+            long idx = atol(PQgetvalue(res, r, 0));
+            Word *word;
+
+            if (idx < 0 || (size_t) idx >= count || out_found[idx]) {
+                continue;
+            }
+            word = &out_words[idx];
+            word->word = strdup(PQgetvalue(res, r, 1));
+            word->transcription = strdup(PQgetvalue(res, r, 2));
+            word->translation = strdup(PQgetvalue(res, r, 3));
+            word->example_1 = strdup(PQgetvalue(res, r, 4));
+            word->example_2 = strdup(PQgetvalue(res, r, 5));
+            word->example = word->example_1;
+
+            if (word->word && word->transcription && word->translation &&
+                word->example_1 && word->example_2) {
+                out_found[idx] = 1;
+            } else {
+                db_free_word(word);
+            }
+        }
+        rc = DB_OK;
+    }
+
+    if (res) PQclear(res);
+    db_disconnect();
+    free(array);
+    return rc;
+}
+
+/* --- Задачи генерации (generation_jobs / generation_drafts) --- */
+
+/* Строк в одном INSERT; параметров остаётся заметно меньше предела 65535. */
+#define DB_GENERATION_JOBS_BATCH 100
+#define DB_GENERATION_JOB_COLUMNS 11
+#define DB_GENERATION_DRAFT_COLUMNS 11
+
+#define DB_GENERATION_JOBS_UNFINISHED \
+    "status NOT IN ('" GENERATION_JOB_STATE_COMPLETED "', '" \
+    GENERATION_JOB_STATE_FAILED "', '" GENERATION_JOB_STATE_CANCELED "')"
+
+/* Дописывает ", ($n, ..., $m)" для rows строк по columns параметров. */
+static size_t db_append_value_rows(char *query, size_t size, size_t used,
+                                   size_t rows, size_t columns)
+{
+    size_t r;
+    size_t c;
+
+    for (r = 0; r < rows && used < size; ++r) {
+        used += (size_t) snprintf(query + used, size - used, "%s(", r > 0 ? ", " : "");
+        for (c = 0; c < columns && used < size; ++c) {
+            used += (size_t) snprintf(query + used, size - used, "%s$%zu",
+                                      c > 0 ? ", " : "", r * columns + c + 1);
+        }
+        if (used < size) {
+            used += (size_t) snprintf(query + used, size - used, ")");
+        }
+    }
+    return used;
+}
+
+static int db_exec_simple(const char *sql)
+{
+    PGresult *res = PQexec(db_conn, sql);
+    int rc = DB_OK;
+
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        ERROR_PRINT("%s failed: %s", sql, PQerrorMessage(db_conn));
+        rc = DB_ERR_SERVER;
+    }
+    if (res) PQclear(res);
+    return rc;
+}
+
+static int db_generation_jobs_upsert(const generation_job_t *jobs, size_t count)
+{
+    const char *paramValues[DB_GENERATION_JOBS_BATCH * DB_GENERATION_JOB_COLUMNS];
+    char numbers[DB_GENERATION_JOBS_BATCH][8][12];
+    char query[1024 + DB_GENERATION_JOBS_BATCH * 96];
+    size_t used;
+    size_t i;
+    PGresult *res;
+    int rc = DB_OK;
+
+    used = (size_t) snprintf(query, sizeof(query),
+        "INSERT INTO generation_jobs (job_id, user_id, status, source_text, error_message, "
+        "total_words, filtered_words, existing_words, failed_words, generated_drafts, "
+        "reviewed_drafts) VALUES ");
+    for (i = 0; i < count; ++i) {
+        const generation_job_t *job = &jobs[i];
+        const char **row = &paramValues[i * DB_GENERATION_JOB_COLUMNS];
+
+        snprintf(numbers[i][0], sizeof(numbers[i][0]), "%d", job->job_id);
+        snprintf(numbers[i][1], sizeof(numbers[i][1]), "%d", job->user_id);
+        snprintf(numbers[i][2], sizeof(numbers[i][2]), "%d", job->total_words);
+        snprintf(numbers[i][3], sizeof(numbers[i][3]), "%d", job->filtered_words);
+        snprintf(numbers[i][4], sizeof(numbers[i][4]), "%d", job->existing_words);
+        snprintf(numbers[i][5], sizeof(numbers[i][5]), "%d", job->failed_words);
+        snprintf(numbers[i][6], sizeof(numbers[i][6]), "%d", job->generated_drafts);
+        snprintf(numbers[i][7], sizeof(numbers[i][7]), "%d", job->reviewed_drafts);
+
+        row[0] = numbers[i][0];
+        row[1] = numbers[i][1];
+        row[2] = job->status ? job->status : "";
+        row[3] = job->source_text ? job->source_text : "";
+        row[4] = job->error_message;
+        row[5] = numbers[i][2];
+        row[6] = numbers[i][3];
+        row[7] = numbers[i][4];
+        row[8] = numbers[i][5];
+        row[9] = numbers[i][6];
+        row[10] = numbers[i][7];
+    }
+    used = db_append_value_rows(query, sizeof(query), used, count, DB_GENERATION_JOB_COLUMNS);
+    snprintf(query + used, sizeof(query) - used,
+        " ON CONFLICT (job_id) DO UPDATE SET status = EXCLUDED.status, "
+        "source_text = EXCLUDED.source_text, "
+        "error_message = EXCLUDED.error_message, total_words = EXCLUDED.total_words, "
+        "filtered_words = EXCLUDED.filtered_words, existing_words = EXCLUDED.existing_words, "
+        "failed_words = EXCLUDED.failed_words, generated_drafts = EXCLUDED.generated_drafts, "
+        "reviewed_drafts = EXCLUDED.reviewed_drafts, updated_at = now();");
+
+    res = PQexecParams(db_conn, query, (int) (count * DB_GENERATION_JOB_COLUMNS),
+                       NULL, paramValues, NULL, NULL, 0);
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        ERROR_PRINT("db_generation_jobs_save: jobs upsert failed: %s", PQerrorMessage(db_conn));
+        rc = DB_ERR_SERVER;
+    }
+    if (res) PQclear(res);
+    return rc;
+}
+
+static int db_generation_drafts_upsert(const generation_card_draft_t *drafts, size_t count)
+{
+    const char *paramValues[DB_GENERATION_JOBS_BATCH * DB_GENERATION_DRAFT_COLUMNS];
+    char numbers[DB_GENERATION_JOBS_BATCH][4][12];
+    char query[1024 + DB_GENERATION_JOBS_BATCH * 96];
+    size_t used;
+    size_t i;
+    PGresult *res;
+    int rc = DB_OK;
+
+    used = (size_t) snprintf(query, sizeof(query),
+        "INSERT INTO generation_drafts (draft_id, job_id, user_id, saved_card_id, status, "
+        "word, transcription, translation, example_1, example_2, forms) VALUES ");
+    for (i = 0; i < count; ++i) {
+        const generation_card_draft_t *draft = &drafts[i];
+        const char **row = &paramValues[i * DB_GENERATION_DRAFT_COLUMNS];
+
+        snprintf(numbers[i][0], sizeof(numbers[i][0]), "%d", draft->draft_id);
+        snprintf(numbers[i][1], sizeof(numbers[i][1]), "%d", draft->job_id);
+        snprintf(numbers[i][2], sizeof(numbers[i][2]), "%d", draft->user_id);
+        snprintf(numbers[i][3], sizeof(numbers[i][3]), "%d", draft->saved_card_id);
+
+        row[0] = numbers[i][0];
+        row[1] = numbers[i][1];
+        row[2] = numbers[i][2];
+        row[3] = numbers[i][3];
+        row[4] = draft->status ? draft->status : "";
+        row[5] = draft->word ? draft->word : "";
+        row[6] = draft->transcription ? draft->transcription : "";
+        row[7] = draft->translation ? draft->translation : "";
+        row[8] = draft->examples[0] ? draft->examples[0] : "";
+        row[9] = draft->examples[1] ? draft->examples[1] : "";
+        row[10] = draft->forms ? draft->forms : "";
+    }
+    used = db_append_value_rows(query, sizeof(query), used, count, DB_GENERATION_DRAFT_COLUMNS);
+    snprintf(query + used, sizeof(query) - used,
+        " ON CONFLICT (draft_id) DO UPDATE SET saved_card_id = EXCLUDED.saved_card_id, "
+        "status = EXCLUDED.status, word = EXCLUDED.word, "
+        "transcription = EXCLUDED.transcription, translation = EXCLUDED.translation, "
+        "example_1 = EXCLUDED.example_1, example_2 = EXCLUDED.example_2, forms = EXCLUDED.forms;");
+
+    res = PQexecParams(db_conn, query, (int) (count * DB_GENERATION_DRAFT_COLUMNS),
+                       NULL, paramValues, NULL, NULL, 0);
+    if (!res || PQresultStatus(res) != PGRES_COMMAND_OK) {
+        ERROR_PRINT("db_generation_jobs_save: drafts upsert failed: %s", PQerrorMessage(db_conn));
+        rc = DB_ERR_SERVER;
+    }
+    if (res) PQclear(res);
+    return rc;
+}
+
+int db_generation_jobs_save(const generation_job_t *jobs, size_t job_count,
+                            const generation_card_draft_t *drafts, size_t draft_count)
+{
+    size_t i;
+    int rc;
+
+    if ((!jobs && job_count > 0) || (!drafts && draft_count > 0)) {
+        return DB_ERR_INVALID_ARGUMENT;
+    }
+    if (job_count == 0 && draft_count == 0) {
+        return DB_OK;
+    }
+
+    if (db_connect(CONNINFO) != 0) {
+        ERROR_PRINT("db_generation_jobs_save: db_connect failed");
+        return DB_ERR_SERVER;
+    }
+
+    rc = db_exec_simple("BEGIN");
+    /* Строки задач раньше черновиков: на них ссылается внешний ключ. */
+    for (i = 0; rc == DB_OK && i < job_count; i += DB_GENERATION_JOBS_BATCH) {
+        size_t n = job_count - i < DB_GENERATION_JOBS_BATCH ? job_count - i : DB_GENERATION_JOBS_BATCH;
+        rc = db_generation_jobs_upsert(&jobs[i], n);
+    }
+    for (i = 0; rc == DB_OK && i < draft_count; i += DB_GENERATION_JOBS_BATCH) {
+        size_t n = draft_count - i < DB_GENERATION_JOBS_BATCH ? draft_count - i : DB_GENERATION_JOBS_BATCH;
+        rc = db_generation_drafts_upsert(&drafts[i], n);
+    }
+    if (rc == DB_OK) {
+        rc = db_exec_simple("COMMIT");
+    } else {
+        db_exec_simple("ROLLBACK");
+    }
+
+    if (rc == DB_OK) {
+        DEBUG_PRINT_DB("generation jobs: saved %zu jobs, %zu drafts", job_count, draft_count);
+    }
+    db_disconnect();
+    return rc;
+}
+
+static char *db_strdup_value(PGresult *res, int row, int column)
+{
+    if (PQgetisnull(res, row, column)) {
+        return NULL;
+    }
+    return strdup(PQgetvalue(res, row, column));
+}
+
+void db_free_generation_jobs(generation_job_t *jobs, size_t count)
+{
+    size_t i;
+    size_t d;
+
+    if (!jobs) {
+        return;
+    }
+    for (i = 0; i < count; ++i) {
+        for (d = 0; d < jobs[i].draft_count; ++d) {
+            generation_card_draft_t *draft = &jobs[i].drafts[d];
+
+            free(draft->status);
+            free(draft->word);
+            free(draft->transcription);
+            free(draft->translation);
+            free(draft->examples[0]);
+            free(draft->examples[1]);
+            free(draft->forms);
+        }
+        free(jobs[i].drafts);
+        free(jobs[i].status);
+        free(jobs[i].source_text);
+        free(jobs[i].error_message);
+    }
+    free(jobs);
+}
+
+int db_generation_jobs_load_unfinished(generation_job_t **out_jobs, size_t *out_count)
+{
+    PGresult *res = NULL;
+    PGresult *drafts_res = NULL;
+    generation_job_t *jobs = NULL;
+    size_t count = 0;
+    size_t j;
+    int rows;
+    int r;
+    int rc = DB_ERR_SERVER;
+
+    if (!out_jobs || !out_count) {
+        return DB_ERR_INVALID_ARGUMENT;
+    }
+    *out_jobs = NULL;
+    *out_count = 0;
+
+    if (db_connect(CONNINFO) != 0) {
+        ERROR_PRINT("db_generation_jobs_load_unfinished: db_connect failed");
+        return DB_ERR_SERVER;
+    }
+
+    res = PQexec(db_conn,
+        "SELECT job_id, user_id, status, source_text, error_message, total_words, "
+        "filtered_words, existing_words, failed_words, generated_drafts, reviewed_drafts "
+        "FROM generation_jobs WHERE " DB_GENERATION_JOBS_UNFINISHED " ORDER BY job_id;");
+    if (!res || PQresultStatus(res) != PGRES_TUPLES_OK) {
+        ERROR_PRINT("db_generation_jobs_load_unfinished: SELECT jobs failed: %s", PQerrorMessage(db_conn));
+        goto cleanup;
+    }
+    rows = PQntuples(res);
+    if (rows == 0) {
+        rc = DB_OK;
+        goto cleanup;
+    }
+
+    drafts_res = PQexec(db_conn,
+        "SELECT d.job_id, d.draft_id, d.user_id, d.saved_card_id, d.status, d.word, "
+        "d.transcription, d.translation, d.example_1, d.example_2, d.forms "
+        "FROM generation_drafts d JOIN generation_jobs j ON j.job_id = d.job_id "
+        "WHERE j." DB_GENERATION_JOBS_UNFINISHED " ORDER BY d.job_id, d.draft_id;");
+    if (!drafts_res || PQresultStatus(drafts_res) != PGRES_TUPLES_OK) {
+        ERROR_PRINT("db_generation_jobs_load_unfinished: SELECT drafts failed: %s", PQerrorMessage(db_conn));
+        goto cleanup;
+    }
+
+    jobs = calloc((size_t) rows, sizeof(*jobs));
+    if (!jobs) {
+        goto cleanup;
+    }
+    for (r = 0; r < rows; ++r) {
+        generation_job_t *job = &jobs[count++];
+
+        job->job_id = atoi(PQgetvalue(res, r, 0));
+        job->user_id = atoi(PQgetvalue(res, r, 1));
+        job->status = db_strdup_value(res, r, 2);
+        job->source_text = db_strdup_value(res, r, 3);
+        job->error_message = db_strdup_value(res, r, 4);
+        job->total_words = atoi(PQgetvalue(res, r, 5));
+        job->filtered_words = atoi(PQgetvalue(res, r, 6));
+        job->existing_words = atoi(PQgetvalue(res, r, 7));
+        job->failed_words = atoi(PQgetvalue(res, r, 8));
+        job->generated_drafts = atoi(PQgetvalue(res, r, 9));
+        job->reviewed_drafts = atoi(PQgetvalue(res, r, 10));
+        if (!job->status || !job->source_text ||
+            (!job->error_message && !PQgetisnull(res, r, 4))) {
+            goto cleanup;
+        }
+    }
+
+    /* Обе выборки упорядочены по job_id: черновики раскладываются одним проходом. */
+    rows = PQntuples(drafts_res);
+    j = 0;
+    for (r = 0; r < rows; ++r) {
+        int job_id = atoi(PQgetvalue(drafts_res, r, 0));
+        generation_card_draft_t *tmp;
+        generation_card_draft_t *draft;
+        generation_job_t *job;
+
+        while (j < count && jobs[j].job_id < job_id) {
+            ++j;
+        }
+        if (j == count || jobs[j].job_id != job_id) {
+            continue;
+        }
+        job = &jobs[j];
+
+        tmp = realloc(job->drafts, (job->draft_count + 1) * sizeof(*job->drafts));
+        if (!tmp) {
+            goto cleanup;
+        }
+        job->drafts = tmp;
+        draft = &job->drafts[job->draft_count++];
+        memset(draft, 0, sizeof(*draft));
+
+        draft->job_id = job_id;
+        draft->draft_id = atoi(PQgetvalue(drafts_res, r, 1));
+        draft->user_id = atoi(PQgetvalue(drafts_res, r, 2));
+        draft->saved_card_id = atoi(PQgetvalue(drafts_res, r, 3));
+        draft->status = db_strdup_value(drafts_res, r, 4);
+        draft->word = db_strdup_value(drafts_res, r, 5);
+        draft->transcription = db_strdup_value(drafts_res, r, 6);
+        draft->translation = db_strdup_value(drafts_res, r, 7);
+        draft->examples[0] = db_strdup_value(drafts_res, r, 8);
+        draft->examples[1] = db_strdup_value(drafts_res, r, 9);
+        draft->forms = db_strdup_value(drafts_res, r, 10);
+        if (!draft->status || !draft->word || !draft->transcription ||
+            !draft->translation || !draft->examples[0] || !draft->examples[1] || !draft->forms) {
+            goto cleanup;
+        }
+    }
+
+    *out_jobs = jobs;
+    *out_count = count;
+    jobs = NULL;
+    rc = DB_OK;
+
+cleanup:
+    db_free_generation_jobs(jobs, count);
+    if (drafts_res) PQclear(drafts_res);
+    if (res) PQclear(res);
+    db_disconnect();
+    return rc;
+}
+
+int db_generation_jobs_max_ids(int *out_job_id, int *out_draft_id)
+{
+    PGresult *res;
+    int rc = DB_ERR_SERVER;
+
+    if (!out_job_id || !out_draft_id) {
+        return DB_ERR_INVALID_ARGUMENT;
+    }
+
+    if (db_connect(CONNINFO) != 0) {
+        ERROR_PRINT("db_generation_jobs_max_ids: db_connect failed");
+        return DB_ERR_SERVER;
+    }
+
+    res = PQexec(db_conn,
+        "SELECT COALESCE((SELECT max(job_id) FROM generation_jobs), 0), "
+        "COALESCE((SELECT max(draft_id) FROM generation_drafts), 0);");
+    if (!res || PQresultStatus(res) != PGRES_TUPLES_OK) {
+        ERROR_PRINT("db_generation_jobs_max_ids: SELECT failed: %s", PQerrorMessage(db_conn));
+    } else {
+        *out_job_id = atoi(PQgetvalue(res, 0, 0));
+        *out_draft_id = atoi(PQgetvalue(res, 0, 1));
+        rc = DB_OK;
+    }
+
+    if (res) PQclear(res);
+    db_disconnect();
+    return rc;
+}
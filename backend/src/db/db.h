@@ -4,6 +4,7 @@
 
 #include <stddef.h>
 #include "models/word.h"
+#include "models/generation_job.h"
 #include <libpq-fe.h>
 
 typedef struct {
@@ -35,6 +36,17 @@ typedef struct {
     int word_id;
 } db_word_delete_input_t;
 
+typedef struct {
+    const char *word;
+    const char *transcription;
+    const char *translation;
+    const char *example_1;
+    const char *example_2;
+} db_card_cache_input_t;
+
+/* Максимум карточек в одном INSERT db_card_cache_put_many(). */
+#define DB_CARD_CACHE_MAX_BATCH 100
+
 enum {
     DB_OK = 0,
     DB_ERR_SERVER = -1,
@@ -59,7 +71,11 @@ char *db_create_session(int user_id, int ttl_seconds);
 int db_userid_by_session(const char *raw_token, int ttl_seconds);
 
 int db_get_user_profile(int user_id, char *username_out, size_t uname_sz,
-                        int *words_learned_out, int *active_lessons_out);
+                        int *words_learned_out, int *active_lessons_out,
+                        int *known_level_out);
+/* users.known_level: DB_OK, DB_ERR_NOT_FOUND, если пользователя нет, иначе DB_ERR_SERVER. */
+int db_get_user_known_level(int user_id, int *out_level);
+int db_set_user_known_level(int user_id, int level);
 int db_word_exists(const char *word, int user_id);
 
 /*
@@ -68,6 +84,11 @@ int db_word_exists(const char *word, int user_id);
 int db_add_word(const char *word, const char *transcription,
                 const char *translation, const char *example, int user_id);
 int db_get_all_words(Word **out_list, size_t *out_count, int user_id);
+/*
+ * Только поле word всех карточек пользователя: массив указателей и сами
+ * строки одним блоком, освобождается одним free(). DB_OK или DB_ERR_SERVER.
+ */
+int db_get_user_word_keys(int user_id, char ***out_words, size_t *out_count);
 
 /*
  * Target word/card API.
@@ -79,5 +100,34 @@ int db_delete_word(const db_word_delete_input_t *input);
 void db_free_word(Word *word);
 void db_free_word_list(Word *words, size_t count);
 
+/*
+ * Общий (не пользовательский) кэш готовых карточек по слову.
+ * Наполняется офлайн утилитой cardwarm, читается перед походом в LLM.
+ */
+int db_card_cache_get(const char *word, Word *out_word);
+/*
+ * Один запрос на несколько слов: out_found[i] = 1 и out_words[i]
+ * заполнено, если для words[i] есть карточка; найденное освобождать
+ * через db_free_word().
+ */
+int db_card_cache_get_many(const char *const *words, size_t count, Word *out_words, int *out_found);
+/* Вставляет до DB_CARD_CACHE_MAX_BATCH карточек; существующие не трогает. */
+int db_card_cache_put_many(const db_card_cache_input_t *inputs, size_t count);
+/* out_present[i] = 1, если для words[i] уже есть карточка. */
+int db_card_cache_contains(const char *const *words, size_t count, int *out_present);
+
+/*
+ * Состояние задач генерации (generation_jobs / generation_drafts).
+ * save — upsert строк задач и черновиков одной транзакцией; поле drafts
+ * у jobs не используется, черновики передаются отдельным массивом.
+ */
+int db_generation_jobs_save(const generation_job_t *jobs, size_t job_count,
+                            const generation_card_draft_t *drafts, size_t draft_count);
+/* Незавершённые задачи вместе с черновиками; освобождать db_free_generation_jobs. */
+int db_generation_jobs_load_unfinished(generation_job_t **out_jobs, size_t *out_count);
+void db_free_generation_jobs(generation_job_t *jobs, size_t count);
+/* Наибольшие выданные job_id и draft_id (0, если таблицы пусты). */
+int db_generation_jobs_max_ids(int *out_job_id, int *out_draft_id);
+
 #endif
 
@@ -39,6 +39,9 @@
 */
 
 -- Удаление таблиц в правильном порядке для переинициализации схемы
+DROP TABLE IF EXISTS generation_drafts;
+DROP TABLE IF EXISTS generation_jobs;
+DROP TABLE IF EXISTS card_cache;
 DROP TABLE IF EXISTS text_words;
 DROP TABLE IF EXISTS words;
 DROP TABLE IF EXISTS texts;
@@ -51,6 +54,8 @@ CREATE TABLE users (
     username TEXT NOT NULL UNIQUE,
     email TEXT NOT NULL UNIQUE,
     password_hash TEXT NOT NULL,
+    -- уровень базовой лексики, которую ученик уже знает (см. tools/stopwords)
+    known_level INTEGER NOT NULL DEFAULT 0,
     created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
 );
 
@@ -97,4 +102,52 @@ CREATE TABLE sessions (
 CREATE INDEX sessions_user_idx ON sessions(user_id);
 CREATE INDEX sessions_expires_idx ON sessions(expires_at);
 
+-- Общий кэш готовых карточек (не привязан к пользователю).
+-- Наполняется офлайн утилитой bin/cardwarm по частотному списку слов;
+-- генерация сначала ищет карточку здесь и только потом идёт в LLM.
+CREATE TABLE card_cache (
+    word          TEXT PRIMARY KEY,
+    transcription TEXT NOT NULL,
+    translation   TEXT NOT NULL,
+    example_1     TEXT NOT NULL,
+    example_2     TEXT NOT NULL,
+    created_at    TIMESTAMPTZ NOT NULL DEFAULT now()
+);
+
+-- Задачи генерации карточек по тексту и их черновики.
+-- Сервер пишет состояние пачками (GENERATION_JOB_FLUSH_MS) и при старте
+-- поднимает незавершённые задачи; готовые черновики повторно не генерируются.
+-- user_id = 0 — анонимная задача, поэтому без внешнего ключа на users.
+CREATE TABLE generation_jobs (
+    job_id           INTEGER PRIMARY KEY,
+    user_id          INTEGER NOT NULL DEFAULT 0,
+    status           TEXT NOT NULL,
+    source_text      TEXT NOT NULL,
+    error_message    TEXT,
+    total_words      INTEGER NOT NULL DEFAULT 0,
+    filtered_words   INTEGER NOT NULL DEFAULT 0,
+    existing_words   INTEGER NOT NULL DEFAULT 0,
+    failed_words     INTEGER NOT NULL DEFAULT 0,
+    generated_drafts INTEGER NOT NULL DEFAULT 0,
+    reviewed_drafts  INTEGER NOT NULL DEFAULT 0,
+    created_at       TIMESTAMPTZ NOT NULL DEFAULT now(),
+    updated_at       TIMESTAMPTZ NOT NULL DEFAULT now()
+);
+
+CREATE INDEX generation_jobs_status_idx ON generation_jobs(status);
+
+CREATE TABLE generation_drafts (
+    draft_id      INTEGER PRIMARY KEY,
+    job_id        INTEGER NOT NULL REFERENCES generation_jobs(job_id) ON DELETE CASCADE,
+    user_id       INTEGER NOT NULL DEFAULT 0,
+    saved_card_id INTEGER NOT NULL DEFAULT 0,
+    status        TEXT NOT NULL,
+    word          TEXT NOT NULL,
+    transcription TEXT NOT NULL,
+    translation   TEXT NOT NULL,
+    example_1     TEXT NOT NULL,
+    example_2     TEXT NOT NULL,
+    forms         TEXT NOT NULL DEFAULT ''
+);
 
+CREATE INDEX generation_drafts_job_idx ON generation_drafts(job_id);
@@ -109,7 +109,7 @@ void handle_cards(http_connection_t *conn, http_request_t *req)
         }
 
         http_send_response(conn, 200, "application/json", out, strlen(out));
-        free(out);
+        cJSON_free(out);
         DBG("EXIT handle_cards GET: success");
         return;
     }
@@ -5,6 +5,10 @@
 #include "handlers/generate_handler.h"
 #include "libs/cJSON.h"
 #include "services/generate_service.h"
+#include "utils/json.h"
+
+/* Карточка с двумя примерами обычно помещается в стековый буфер. */
+#define GENERATE_HANDLER_JSON_STACK_SIZE 2048
 
 
 /* Простая утилита: извлечь значение строки из простого JSON {"key":"value", ...}
@@ -91,36 +95,32 @@ void handle_generate_card(http_connection_t *conn, http_request_t *req)
 
 	print_word_card_to_debug(&card);
 
-	/* Безопасные значения (если LLM вернул NULL поля) */
-	const char *c_word  = card.word          ? card.word          : "";
-	const char *c_trans = card.transcription ? card.transcription : "";
-	const char *c_tranl = card.translation   ? card.translation   : "";
-	const char *ex1     = card.examples[0]   ? card.examples[0]   : "";
-	const char *ex2     = card.examples[1]   ? card.examples[1]   : "";
-
 	/*
-	 * Формируем JSON.
-	 * Добавляем массив examples.
+	 * Формируем JSON. Поля приходят от LLM и могут содержать кавычки,
+	 * переводы строк и битый UTF-8 — экранирует json_writer.
+	 * NULL поля пишутся пустыми строками.
 	 */
-	const char *resp_fmt =
-		"{"
-		"\"word\":\"%s\","
-		"\"transcription\":\"%s\","
-		"\"translation\":\"%s\","
-		"\"examples\":[\"%s\",\"%s\"]"
-		"}";
-
-	size_t resp_sz =
-		strlen(resp_fmt) +
-		strlen(c_word) +
-		strlen(c_trans) +
-		strlen(c_tranl) +
-		strlen(ex1) +
-		strlen(ex2) +
-		64;
-
-	char *out = malloc(resp_sz);
+	char stack[GENERATE_HANDLER_JSON_STACK_SIZE];
+	json_writer_t w;
+	const char *out;
+	size_t out_len;
+
+	json_writer_init(&w, stack, sizeof(stack));
+	json_write_object_begin(&w);
+	json_write_field_string(&w, "word", card.word);
+	json_write_field_string(&w, "transcription", card.transcription);
+	json_write_field_string(&w, "translation", card.translation);
+	json_write_key(&w, "examples");
+	json_write_array_begin(&w);
+	for (int i = 0; i < GENERATE_SERVICE_EXAMPLE_COUNT; i++) {
+		json_write_string(&w, card.examples[i]);
+	}
+	json_write_array_end(&w);
+	json_write_object_end(&w);
+
+	out = json_writer_finish(&w, &out_len);
 	if (!out) {
+		json_writer_free(&w);
 		generate_service_free_card(&card);
 		free(word);
 
@@ -131,20 +131,13 @@ void handle_generate_card(http_connection_t *conn, http_request_t *req)
 		return;
 	}
 
-	snprintf(out, resp_sz, resp_fmt,
-			 c_word,
-			 c_trans,
-			 c_tranl,
-			 ex1,
-			 ex2);
-
 	http_send_response(conn, 200,
 					   "application/json",
 					   out,
-					   strlen(out));
+					   out_len);
 
 	/* cleanup */
-	free(out);
+	json_writer_free(&w);
 	generate_service_free_card(&card);
 	free(word);
 }
@@ -2,6 +2,7 @@
 
 #include "libs/cJSON.h"
 #include "services/generation_job_service.h"
+#include "utils/json.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -24,108 +25,82 @@ static int parse_positive_int(const char *value)
     return (int) parsed;
 }
 
-static int send_json(http_connection_t *conn, int status, cJSON *json)
+/* Ответ со списком черновиков обычно помещается в стековый буфер целиком. */
+#define GENERATION_JOB_JSON_STACK_SIZE 8192
+
+/* Отправляет готовый JSON и освобождает writer; при ошибке записи — 500. */
+static int send_json(http_connection_t *conn, int status, json_writer_t *w)
 {
-    char *text;
+    const char *text;
+    size_t len;
     int rc;
 
-    if (!conn || !json) {
-        return -1;
-    }
-
-    text = cJSON_PrintUnformatted(json);
+    text = json_writer_finish(w, &len);
     if (!text) {
-        return -1;
+        rc = http_send_response(conn, 500, "application/json",
+                                "{\"error\":\"internal\"}",
+                                strlen("{\"error\":\"internal\"}"));
+    } else {
+        rc = http_send_response(conn, status, "application/json", text, len);
     }
-
-    rc = http_send_response(conn, status, "application/json", text, strlen(text));
-    cJSON_free(text);
+    json_writer_free(w);
     return rc;
 }
 
-static cJSON *build_draft_json(const generation_card_draft_t *draft)
+static void write_draft_json(json_writer_t *w, const generation_card_draft_t *draft)
 {
-    cJSON *root;
-    cJSON *examples;
     int i;
 
-    if (!draft) {
-        return NULL;
-    }
-
-    root = cJSON_CreateObject();
-    if (!root) {
-        return NULL;
-    }
-
-    cJSON_AddNumberToObject(root, "draft_id", draft->draft_id);
-    cJSON_AddNumberToObject(root, "job_id", draft->job_id);
-    cJSON_AddNumberToObject(root, "user_id", draft->user_id);
-    cJSON_AddNumberToObject(root, "saved_card_id", draft->saved_card_id);
-    cJSON_AddStringToObject(root, "status", draft->status ? draft->status : "");
-    cJSON_AddStringToObject(root, "word", draft->word ? draft->word : "");
-    cJSON_AddStringToObject(root, "transcription", draft->transcription ? draft->transcription : "");
-    cJSON_AddStringToObject(root, "translation", draft->translation ? draft->translation : "");
-
-    examples = cJSON_AddArrayToObject(root, "examples");
-    if (!examples) {
-        cJSON_Delete(root);
-        return NULL;
-    }
+    json_write_object_begin(w);
+    json_write_field_int(w, "draft_id", draft->draft_id);
+    json_write_field_int(w, "job_id", draft->job_id);
+    json_write_field_int(w, "user_id", draft->user_id);
+    json_write_field_int(w, "saved_card_id", draft->saved_card_id);
+    json_write_field_string(w, "status", draft->status);
+    json_write_field_string(w, "word", draft->word);
+    json_write_field_string(w, "transcription", draft->transcription);
+    json_write_field_string(w, "translation", draft->translation);
+    json_write_field_string(w, "forms", draft->forms);
+
+    json_write_key(w, "examples");
+    json_write_array_begin(w);
     for (i = 0; i < 2; i++) {
-        cJSON_AddItemToArray(examples, cJSON_CreateString(draft->examples[i] ? draft->examples[i] : ""));
+        json_write_string(w, draft->examples[i]);
     }
-
-    return root;
+    json_write_array_end(w);
+    json_write_object_end(w);
 }
 
-static cJSON *build_job_json(const generation_job_t *job, int include_drafts)
+static void write_job_json(json_writer_t *w, const generation_job_t *job, int include_drafts)
 {
-    cJSON *root;
-    cJSON *drafts;
     size_t i;
 
-    if (!job) {
-        return NULL;
-    }
-
-    root = cJSON_CreateObject();
-    if (!root) {
-        return NULL;
-    }
-
-    cJSON_AddNumberToObject(root, "job_id", job->job_id);
-    cJSON_AddNumberToObject(root, "user_id", job->user_id);
-    cJSON_AddStringToObject(root, "status", job->status ? job->status : "");
-    cJSON_AddStringToObject(root, "text", job->source_text ? job->source_text : "");
-    cJSON_AddNumberToObject(root, "total_words", job->total_words);
-    cJSON_AddNumberToObject(root, "filtered_words", job->filtered_words);
-    cJSON_AddNumberToObject(root, "existing_words", job->existing_words);
-    cJSON_AddNumberToObject(root, "generated_drafts", job->generated_drafts);
-    cJSON_AddNumberToObject(root, "reviewed_drafts", job->reviewed_drafts);
+    json_write_object_begin(w);
+    json_write_field_int(w, "job_id", job->job_id);
+    json_write_field_int(w, "user_id", job->user_id);
+    json_write_field_string(w, "status", job->status);
+    json_write_field_string(w, "text", job->source_text);
+    json_write_field_int(w, "total_words", job->total_words);
+    json_write_field_int(w, "filtered_words", job->filtered_words);
+    json_write_field_int(w, "existing_words", job->existing_words);
+    json_write_field_int(w, "generated_drafts", job->generated_drafts);
+    json_write_field_int(w, "reviewed_drafts", job->reviewed_drafts);
+    json_write_field_int(w, "failed_words", job->failed_words);
     if (job->error_message) {
-        cJSON_AddStringToObject(root, "error", job->error_message);
+        json_write_field_string(w, "error", job->error_message);
     }
 
     if (include_drafts) {
-        drafts = cJSON_AddArrayToObject(root, "drafts");
-        if (!drafts) {
-            cJSON_Delete(root);
-            return NULL;
-        }
+        json_write_key(w, "drafts");
+        json_write_array_begin(w);
         for (i = 0; i < job->draft_count; i++) {
-            cJSON *draft_json = build_draft_json(&job->drafts[i]);
-            if (!draft_json) {
-                cJSON_Delete(root);
-                return NULL;
-            }
-            cJSON_AddItemToArray(drafts, draft_json);
+            write_draft_json(w, &job->drafts[i]);
         }
+        json_write_array_end(w);
     } else {
-        cJSON_AddNumberToObject(root, "draft_count", (double) job->draft_count);
+        json_write_field_int(w, "draft_count", (long long) job->draft_count);
     }
-
-    return root;
+    json_write_object_end(w);
 }
 
 static void send_service_error(http_connection_t *conn, int service_rc)
@@ -154,6 +129,10 @@ static void send_service_error(http_connection_t *conn, int service_rc)
         status = 502;
         body = "{\"error\":\"generation failed\"}";
         break;
+    case GENERATION_JOB_SERVICE_ERR_BUSY:
+        status = 503;
+        body = "{\"error\":\"too many jobs\"}";
+        break;
     default:
         status = 500;
         body = "{\"error\":\"internal\"}";
@@ -166,8 +145,10 @@ static void send_service_error(http_connection_t *conn, int service_rc)
 void handle_generation_jobs_create(http_connection_t *conn, http_request_t *req)
 {
     generation_job_create_input_t input;
-    const generation_job_t *job;
-    cJSON *json;
+    generation_job_t job;
+    char stack[GENERATION_JOB_JSON_STACK_SIZE];
+    json_writer_t w;
+    int existing = 0;
     int rc;
     cJSON *root;
     cJSON *text_item;
@@ -200,29 +181,27 @@ void handle_generation_jobs_create(http_connection_t *conn, http_request_t *req)
 
     input.text = text_item->valuestring;
     input.user_id = cJSON_IsNumber(user_id_item) ? user_id_item->valueint : 0;
-    rc = generation_job_service_create(&input, &job);
+    rc = generation_job_service_create(&input, &job, &existing);
     cJSON_Delete(root);
     if (rc != GENERATION_JOB_SERVICE_OK) {
         send_service_error(conn, rc);
         return;
     }
 
-    json = build_job_json(job, 1);
-    if (!json) {
-        http_send_response(conn, 500, "application/json",
-                           "{\"error\":\"internal\"}",
-                           strlen("{\"error\":\"internal\"}"));
-        return;
-    }
+    /* Пайплайн выполняется воркерами, прогресс приходит через realtime. */
+    json_writer_init(&w, stack, sizeof(stack));
+    write_job_json(&w, &job, 1);
+    generation_job_service_free_job(&job);
 
-    send_json(conn, 201, json);
-    cJSON_Delete(json);
+    /* Повторная отправка текста отдаёт уже идущую задачу. */
+    send_json(conn, existing ? 200 : 202, &w);
 }
 
 static void handle_generation_job_get(http_connection_t *conn, int job_id)
 {
-    const generation_job_t *job;
-    cJSON *json;
+    generation_job_t job;
+    char stack[GENERATION_JOB_JSON_STACK_SIZE];
+    json_writer_t w;
     int rc = generation_job_service_get(job_id, &job);
 
     if (rc != GENERATION_JOB_SERVICE_OK) {
@@ -230,24 +209,18 @@ static void handle_generation_job_get(http_connection_t *conn, int job_id)
         return;
     }
 
-    json = build_job_json(job, 1);
-    if (!json) {
-        http_send_response(conn, 500, "application/json",
-                           "{\"error\":\"internal\"}",
-                           strlen("{\"error\":\"internal\"}"));
-        return;
-    }
-
-    send_json(conn, 200, json);
-    cJSON_Delete(json);
+    json_writer_init(&w, stack, sizeof(stack));
+    write_job_json(&w, &job, 1);
+    generation_job_service_free_job(&job);
+    send_json(conn, 200, &w);
 }
 
 static void handle_generation_job_cards(http_connection_t *conn, int job_id)
 {
-    const generation_card_draft_t *drafts;
-    size_t count;
-    cJSON *root;
-    cJSON *items;
+    generation_card_draft_t *drafts = NULL;
+    size_t count = 0;
+    char stack[GENERATION_JOB_JSON_STACK_SIZE];
+    json_writer_t w;
     size_t i;
     int rc = generation_job_service_list_drafts(job_id, &drafts, &count);
 
@@ -256,38 +229,19 @@ static void handle_generation_job_cards(http_connection_t *conn, int job_id)
         return;
     }
 
-    root = cJSON_CreateObject();
-    if (!root) {
-        http_send_response(conn, 500, "application/json",
-                           "{\"error\":\"internal\"}",
-                           strlen("{\"error\":\"internal\"}"));
-        return;
-    }
-
-    cJSON_AddNumberToObject(root, "job_id", job_id);
-    items = cJSON_AddArrayToObject(root, "items");
-    if (!items) {
-        cJSON_Delete(root);
-        http_send_response(conn, 500, "application/json",
-                           "{\"error\":\"internal\"}",
-                           strlen("{\"error\":\"internal\"}"));
-        return;
-    }
-
+    json_writer_init(&w, stack, sizeof(stack));
+    json_write_object_begin(&w);
+    json_write_field_int(&w, "job_id", job_id);
+    json_write_key(&w, "items");
+    json_write_array_begin(&w);
     for (i = 0; i < count; i++) {
-        cJSON *draft_json = build_draft_json(&drafts[i]);
-        if (!draft_json) {
-            cJSON_Delete(root);
-            http_send_response(conn, 500, "application/json",
-                               "{\"error\":\"internal\"}",
-                               strlen("{\"error\":\"internal\"}"));
-            return;
-        }
-        cJSON_AddItemToArray(items, draft_json);
+        write_draft_json(&w, &drafts[i]);
     }
+    json_write_array_end(&w);
+    json_write_object_end(&w);
+    generation_job_service_free_drafts(drafts, count);
 
-    send_json(conn, 200, root);
-    cJSON_Delete(root);
+    send_json(conn, 200, &w);
 }
 
 static void handle_generation_job_draft_action(http_connection_t *conn,
@@ -295,9 +249,10 @@ static void handle_generation_job_draft_action(http_connection_t *conn,
                                                int draft_id,
                                                const char *action)
 {
-    const generation_job_t *job = NULL;
-    const generation_card_draft_t *draft = NULL;
-    cJSON *root;
+    generation_job_t job;
+    generation_card_draft_t draft;
+    char stack[GENERATION_JOB_JSON_STACK_SIZE];
+    json_writer_t w;
     int rc;
 
     if (strcmp(action, "approve") == 0) {
@@ -318,24 +273,23 @@ static void handle_generation_job_draft_action(http_connection_t *conn,
         return;
     }
 
-    root = cJSON_CreateObject();
-    if (!root) {
-        http_send_response(conn, 500, "application/json",
-                           "{\"error\":\"internal\"}",
-                           strlen("{\"error\":\"internal\"}"));
-        return;
-    }
-
-    cJSON_AddItemToObject(root, "job", build_job_json(job, 0));
-    cJSON_AddItemToObject(root, "draft", build_draft_json(draft));
-    send_json(conn, 200, root);
-    cJSON_Delete(root);
+    json_writer_init(&w, stack, sizeof(stack));
+    json_write_object_begin(&w);
+    json_write_key(&w, "job");
+    write_job_json(&w, &job, 0);
+    json_write_key(&w, "draft");
+    write_draft_json(&w, &draft);
+    json_write_object_end(&w);
+    generation_job_service_free_job(&job);
+    generation_job_service_free_draft(&draft);
+    send_json(conn, 200, &w);
 }
 
 static void handle_generation_job_cancel(http_connection_t *conn, int job_id)
 {
-    const generation_job_t *job;
-    cJSON *json;
+    generation_job_t job;
+    char stack[GENERATION_JOB_JSON_STACK_SIZE];
+    json_writer_t w;
     int rc = generation_job_service_cancel(job_id, &job);
 
     if (rc != GENERATION_JOB_SERVICE_OK) {
@@ -343,16 +297,56 @@ static void handle_generation_job_cancel(http_connection_t *conn, int job_id)
         return;
     }
 
-    json = build_job_json(job, 0);
-    if (!json) {
-        http_send_response(conn, 500, "application/json",
-                           "{\"error\":\"internal\"}",
-                           strlen("{\"error\":\"internal\"}"));
+    json_writer_init(&w, stack, sizeof(stack));
+    write_job_json(&w, &job, 0);
+    generation_job_service_free_job(&job);
+    send_json(conn, 200, &w);
+}
+
+static void handle_generation_job_extend(http_connection_t *conn, http_request_t *req, int job_id)
+{
+    generation_job_t job;
+    cJSON *root;
+    cJSON *text_item;
+    char stack[GENERATION_JOB_JSON_STACK_SIZE];
+    json_writer_t w;
+    int rc;
+
+    if (!req->body) {
+        http_send_response(conn, 400, "application/json",
+                           "{\"error\":\"empty request body\"}",
+                           strlen("{\"error\":\"empty request body\"}"));
         return;
     }
 
-    send_json(conn, 200, json);
-    cJSON_Delete(json);
+    root = cJSON_Parse(req->body);
+    if (!root) {
+        http_send_response(conn, 400, "application/json",
+                           "{\"error\":\"invalid json\"}",
+                           strlen("{\"error\":\"invalid json\"}"));
+        return;
+    }
+
+    text_item = cJSON_GetObjectItemCaseSensitive(root, "text");
+    if (!cJSON_IsString(text_item) || !text_item->valuestring || text_item->valuestring[0] == '\0') {
+        cJSON_Delete(root);
+        http_send_response(conn, 400, "application/json",
+                           "{\"error\":\"missing 'text'\"}",
+                           strlen("{\"error\":\"missing 'text'\"}"));
+        return;
+    }
+
+    rc = generation_job_service_extend(job_id, text_item->valuestring, &job);
+    cJSON_Delete(root);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        send_service_error(conn, rc);
+        return;
+    }
+
+    json_writer_init(&w, stack, sizeof(stack));
+    write_job_json(&w, &job, 0);
+    generation_job_service_free_job(&job);
+    send_json(conn, 202, &w);
 }
 
 void handle_generation_jobs_routes(http_connection_t *conn, http_request_t *req)
@@ -420,6 +414,10 @@ void handle_generation_jobs_routes(http_connection_t *conn, http_request_t *req)
         handle_generation_job_cancel(conn, job_id);
         return;
     }
+    if (strcmp(req->method, "POST") == 0 && segment_count == 2 && strcmp(segments[1], "extend") == 0) {
+        handle_generation_job_extend(conn, req, job_id);
+        return;
+    }
     if (strcmp(req->method, "POST") == 0 && segment_count == 4 && strcmp(segments[1], "cards") == 0) {
         draft_id = parse_positive_int(segments[2]);
         if (draft_id <= 0) {
@@ -0,0 +1,239 @@
+#include "handlers/metrics_handler.h"
+
+#include "internal_api/card_api.h"
+#include "internal_api/llm_api.h"
+#include "utils/json_arena.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define METRICS_BUFFER_SIZE 16384
+
+/*
+ * Дописывает строку в буфер метрик. -1, если буфер переполнен.
+ */
+static int metrics_append(char *body, size_t size, size_t *used, const char *fmt, ...)
+{
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = vsnprintf(body + *used, size - *used, fmt, args);
+    va_end(args);
+
+    if (len < 0 || (size_t) len >= size - *used) {
+        return -1;
+    }
+    *used += (size_t) len;
+    return 0;
+}
+
+/*
+ * GET /metrics — метрики в текстовом формате Prometheus.
+ */
+void handle_metrics(http_connection_t *conn, http_request_t *req)
+{
+    llm_api_metrics_t llm;
+    card_api_known_words_stats_t known;
+    json_arena_stats_t arena;
+    char body[METRICS_BUFFER_SIZE];
+    size_t used;
+    size_t i;
+    int len;
+
+    (void) req;
+
+    llm_api_get_metrics(&llm);
+    card_api_get_known_words_stats(&known);
+    json_arena_get_stats(&arena);
+
+    len = snprintf(body, sizeof(body),
+                   "# TYPE langforge_llm_max_concurrency gauge\n"
+                   "langforge_llm_max_concurrency %d\n"
+                   "# TYPE langforge_llm_in_flight gauge\n"
+                   "langforge_llm_in_flight %d\n"
+                   "# TYPE langforge_llm_queue_depth gauge\n"
+                   "langforge_llm_queue_depth{priority=\"interactive\"} %d\n"
+                   "langforge_llm_queue_depth{priority=\"batch\"} %d\n"
+                   "# TYPE langforge_llm_queued_users gauge\n"
+                   "langforge_llm_queued_users %d\n"
+                   "# TYPE langforge_llm_requests_granted_total counter\n"
+                   "langforge_llm_requests_granted_total{priority=\"interactive\"} %llu\n"
+                   "langforge_llm_requests_granted_total{priority=\"batch\"} %llu\n"
+                   "# TYPE langforge_llm_queue_wait_ms_total counter\n"
+                   "langforge_llm_queue_wait_ms_total{priority=\"interactive\"} %llu\n"
+                   "langforge_llm_queue_wait_ms_total{priority=\"batch\"} %llu\n"
+                   "# TYPE langforge_llm_queue_wait_ms_max gauge\n"
+                   "langforge_llm_queue_wait_ms_max{priority=\"interactive\"} %llu\n"
+                   "langforge_llm_queue_wait_ms_max{priority=\"batch\"} %llu\n",
+                   llm.max_concurrency,
+                   llm.in_flight,
+                   llm.queued_interactive,
+                   llm.queued_batch,
+                   llm.active_users,
+                   llm.granted_interactive,
+                   llm.granted_batch,
+                   llm.wait_ms_total_interactive,
+                   llm.wait_ms_total_batch,
+                   llm.wait_ms_max_interactive,
+                   llm.wait_ms_max_batch);
+    if (len < 0 || (size_t) len >= sizeof(body)) {
+        goto overflow;
+    }
+    used = (size_t) len;
+
+    if (metrics_append(body, sizeof(body), &used,
+                       "# TYPE langforge_llm_queue_timeouts_total counter\n"
+                       "langforge_llm_queue_timeouts_total{priority=\"interactive\"} %llu\n"
+                       "langforge_llm_queue_timeouts_total{priority=\"batch\"} %llu\n"
+                       "# TYPE langforge_llm_upstream_timeouts_total counter\n"
+                       "langforge_llm_upstream_timeouts_total %llu\n"
+                       "# TYPE langforge_llm_hedged_requests_total counter\n"
+                       "langforge_llm_hedged_requests_total %llu\n"
+                       "# TYPE langforge_llm_hedge_wins_total counter\n"
+                       "langforge_llm_hedge_wins_total %llu\n"
+                       "# TYPE langforge_llm_card_repairs_total counter\n"
+                       "langforge_llm_card_repairs_total %llu\n"
+                       "# TYPE langforge_llm_card_repairs_failed_total counter\n"
+                       "langforge_llm_card_repairs_failed_total %llu\n"
+                       "# TYPE langforge_llm_card_cache_hits_total counter\n"
+                       "langforge_llm_card_cache_hits_total %llu\n"
+                       "# TYPE langforge_llm_card_cache_misses_total counter\n"
+                       "langforge_llm_card_cache_misses_total %llu\n",
+                       llm.queue_timeouts_interactive,
+                       llm.queue_timeouts_batch,
+                       llm.upstream_timeouts,
+                       llm.hedges,
+                       llm.hedge_wins,
+                       llm.card_repairs,
+                       llm.card_repairs_failed,
+                       llm.card_cache_hits,
+                       llm.card_cache_misses) != 0) {
+        goto overflow;
+    }
+
+    for (i = 0; i < llm.backend_count; i++) {
+        const llm_api_backend_metrics_t *b = &llm.backends[i];
+
+        if (metrics_append(body, sizeof(body), &used,
+                           "%slangforge_llm_backend_in_flight{backend=\"%s:%s\"} %d\n",
+                           i == 0 ? "# TYPE langforge_llm_backend_in_flight gauge\n" : "",
+                           b->host, b->port, b->in_flight) != 0) {
+            goto overflow;
+        }
+    }
+    for (i = 0; i < llm.backend_count; i++) {
+        const llm_api_backend_metrics_t *b = &llm.backends[i];
+
+        if (metrics_append(body, sizeof(body), &used,
+                           "%slangforge_llm_backend_max_in_flight{backend=\"%s:%s\"} %d\n",
+                           i == 0 ? "# TYPE langforge_llm_backend_max_in_flight gauge\n" : "",
+                           b->host, b->port, b->max_in_flight) != 0) {
+            goto overflow;
+        }
+    }
+    for (i = 0; i < llm.backend_count; i++) {
+        const llm_api_backend_metrics_t *b = &llm.backends[i];
+
+        if (metrics_append(body, sizeof(body), &used,
+                           "%slangforge_llm_backend_healthy{backend=\"%s:%s\"} %d\n",
+                           i == 0 ? "# TYPE langforge_llm_backend_healthy gauge\n" : "",
+                           b->host, b->port, b->healthy) != 0) {
+            goto overflow;
+        }
+    }
+    for (i = 0; i < llm.backend_count; i++) {
+        const llm_api_backend_metrics_t *b = &llm.backends[i];
+
+        if (metrics_append(body, sizeof(body), &used,
+                           "%slangforge_llm_backend_requests_total{backend=\"%s:%s\"} %llu\n",
+                           i == 0 ? "# TYPE langforge_llm_backend_requests_total counter\n" : "",
+                           b->host, b->port, b->requests) != 0) {
+            goto overflow;
+        }
+    }
+    for (i = 0; i < llm.backend_count; i++) {
+        const llm_api_backend_metrics_t *b = &llm.backends[i];
+
+        if (metrics_append(body, sizeof(body), &used,
+                           "%slangforge_llm_backend_failures_total{backend=\"%s:%s\"} %llu\n",
+                           i == 0 ? "# TYPE langforge_llm_backend_failures_total counter\n" : "",
+                           b->host, b->port, b->failures) != 0) {
+            goto overflow;
+        }
+    }
+
+    for (i = 0; i < llm.backend_count; i++) {
+        const llm_api_backend_metrics_t *b = &llm.backends[i];
+
+        if (metrics_append(body, sizeof(body), &used,
+                           "%slangforge_llm_backend_latency_p95_ms{backend=\"%s:%s\"} %llu\n",
+                           i == 0 ? "# TYPE langforge_llm_backend_latency_p95_ms gauge\n" : "",
+                           b->host, b->port, b->latency_p95_ms) != 0) {
+            goto overflow;
+        }
+    }
+
+    if (metrics_append(body, sizeof(body), &used,
+                       "# TYPE langforge_known_words_users gauge\n"
+                       "langforge_known_words_users %zu\n"
+                       "# TYPE langforge_known_words_bytes gauge\n"
+                       "langforge_known_words_bytes %zu\n"
+                       "# TYPE langforge_known_words_memory_limit_bytes gauge\n"
+                       "langforge_known_words_memory_limit_bytes %zu\n"
+                       "# TYPE langforge_known_words_checks_total counter\n"
+                       "langforge_known_words_checks_total{result=\"absent\"} %llu\n"
+                       "langforge_known_words_checks_total{result=\"maybe\"} %llu\n"
+                       "langforge_known_words_checks_total{result=\"unfiltered\"} %llu\n"
+                       "# TYPE langforge_known_words_false_positives_total counter\n"
+                       "langforge_known_words_false_positives_total %llu\n"
+                       "# TYPE langforge_known_words_builds_total counter\n"
+                       "langforge_known_words_builds_total %llu\n"
+                       "# TYPE langforge_known_words_build_failures_total counter\n"
+                       "langforge_known_words_build_failures_total %llu\n"
+                       "# TYPE langforge_known_words_evictions_total counter\n"
+                       "langforge_known_words_evictions_total %llu\n",
+                       known.users,
+                       known.bytes,
+                       known.memory_limit,
+                       known.absent,
+                       known.maybe,
+                       known.unfiltered,
+                       known.false_positives,
+                       known.builds,
+                       known.build_failures,
+                       known.evictions) != 0) {
+        goto overflow;
+    }
+
+    if (metrics_append(body, sizeof(body), &used,
+                       "# TYPE langforge_json_arena_chunk_bytes gauge\n"
+                       "langforge_json_arena_chunk_bytes %zu\n"
+                       "# TYPE langforge_json_arena_peak_bytes gauge\n"
+                       "langforge_json_arena_peak_bytes %zu\n"
+                       "# TYPE langforge_json_arena_requests_total counter\n"
+                       "langforge_json_arena_requests_total %llu\n"
+                       "# TYPE langforge_json_arena_allocations_total counter\n"
+                       "langforge_json_arena_allocations_total{source=\"arena\"} %llu\n"
+                       "langforge_json_arena_allocations_total{source=\"heap\"} %llu\n"
+                       "# TYPE langforge_json_arena_bytes_total counter\n"
+                       "langforge_json_arena_bytes_total %llu\n"
+                       "# TYPE langforge_json_arena_extra_chunks_total counter\n"
+                       "langforge_json_arena_extra_chunks_total %llu\n",
+                       arena.chunk_size,
+                       arena.peak_bytes,
+                       arena.requests,
+                       arena.allocations,
+                       arena.heap_allocations,
+                       arena.bytes,
+                       arena.extra_chunks) != 0) {
+        goto overflow;
+    }
+
+    http_send_response(conn, 200, "text/plain; version=0.0.4", body, used);
+    return;
+
+overflow:
+    http_send_response(conn, 500, "text/plain", "internal", strlen("internal"));
+}
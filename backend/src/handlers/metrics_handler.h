@@ -0,0 +1,8 @@
+#ifndef METRICS_HANDLER_H
+#define METRICS_HANDLER_H
+
+#include "libs/http.h"
+
+void handle_metrics(http_connection_t *conn, http_request_t *req);
+
+#endif
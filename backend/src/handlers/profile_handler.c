@@ -3,18 +3,23 @@
 #include "dbug/dbug.h"
 #include "libs/cJSON.h"
 #include "services/user_service.h"
+#include "utils/json.h"
 
 #include <stdlib.h>
 #include <string.h>
 
-static int send_json_response(http_connection_t *conn, int status, cJSON *obj)
+/* Короткие ответы вида {"success":..,"message":..} помещаются в стек. */
+#define PROFILE_JSON_STACK_SIZE 512
+
+static int send_json_response(http_connection_t *conn, int status, json_writer_t *w)
 {
-    if (!conn || !obj) {
-        return -1;
-    }
+    const char *out;
+    size_t len;
+    int rc;
 
-    char *out = cJSON_PrintUnformatted(obj);
-    if (!out) {
+    out = json_writer_finish(w, &len);
+    if (!conn || !out) {
+        json_writer_free(w);
         return -1;
     }
 
@@ -22,12 +27,25 @@ static int send_json_response(http_connection_t *conn, int status, cJSON *obj)
         "Cache-Control: no-store",
         "X-Content-Type-Options: nosniff"
     };
-    int rc = my_send_response_with_headers(conn, status, "application/json", out, strlen(out),
-                                           hdrs, sizeof(hdrs) / sizeof(hdrs[0]));
-    free(out);
+    rc = my_send_response_with_headers(conn, status, "application/json", out, len,
+                                       hdrs, sizeof(hdrs) / sizeof(hdrs[0]));
+    json_writer_free(w);
     return rc;
 }
 
+static int send_message(http_connection_t *conn, int status, int success, const char *message)
+{
+    char stack[PROFILE_JSON_STACK_SIZE];
+    json_writer_t w;
+
+    json_writer_init(&w, stack, sizeof(stack));
+    json_write_object_begin(&w);
+    json_write_field_bool(&w, "success", success);
+    json_write_field_string(&w, "message", message);
+    json_write_object_end(&w);
+    return send_json_response(conn, status, &w);
+}
+
 void handle_me(http_connection_t *conn, http_request_t *req)
 {
     DEBUG_PRINT_CARD_HANDLER("ENTER handle_me: path='%s'", req && req->path ? req->path : "-");
@@ -39,47 +57,76 @@ void handle_me(http_connection_t *conn, http_request_t *req)
 
     const char *cookie_hdr = http_get_header(req, "Cookie");
     if (!cookie_hdr) {
-        cJSON *resp = cJSON_CreateObject();
-        cJSON_AddBoolToObject(resp, "success", 0);
-        cJSON_AddStringToObject(resp, "message", "Unauthorized");
-        send_json_response(conn, 401, resp);
-        cJSON_Delete(resp);
+        send_message(conn, 401, 0, "Unauthorized");
         DEBUG_PRINT_CARD_HANDLER("EXIT handle_me: no cookie");
         return;
     }
 
+    /* POST {"known_level": N} сначала меняет уровень, ответ тот же, что у GET. */
+    if (req->body && req->body_len > 0) {
+        cJSON *json_req = cJSON_Parse(req->body);
+        const cJSON *level_item = json_req ? cJSON_GetObjectItemCaseSensitive(json_req, "known_level") : NULL;
+
+        if (level_item) {
+            int set_rc = cJSON_IsNumber(level_item) ?
+                         user_service_set_known_level(cookie_hdr, level_item->valueint) :
+                         USER_SERVICE_ERR_INVALID_ARGUMENT;
+            if (set_rc != USER_SERVICE_OK) {
+                int status = set_rc == USER_SERVICE_ERR_UNAUTHORIZED ? 401 :
+                             set_rc == USER_SERVICE_ERR_INVALID_ARGUMENT ? 400 : 500;
+                char stack[PROFILE_JSON_STACK_SIZE];
+                json_writer_t w;
+
+                json_writer_init(&w, stack, sizeof(stack));
+                json_write_object_begin(&w);
+                json_write_field_bool(&w, "success", 0);
+                json_write_field_string(&w, "message",
+                                        status == 401 ? "Unauthorized" :
+                                        status == 400 ? "known_level out of range" : "Server error");
+                if (status == 400) {
+                    json_write_field_int(&w, "max_known_level", user_service_max_known_level());
+                }
+                json_write_object_end(&w);
+                send_json_response(conn, status, &w);
+                cJSON_Delete(json_req);
+                DEBUG_PRINT_CARD_HANDLER("EXIT handle_me: set known_level rc=%d", set_rc);
+                return;
+            }
+        }
+        cJSON_Delete(json_req);
+    }
+
     user_profile_t profile;
     int service_rc = user_service_get_profile(cookie_hdr, &profile);
     if (service_rc == USER_SERVICE_ERR_UNAUTHORIZED) {
-        cJSON *resp = cJSON_CreateObject();
-        cJSON_AddBoolToObject(resp, "success", 0);
-        cJSON_AddStringToObject(resp, "message", "Unauthorized");
-        send_json_response(conn, 401, resp);
-        cJSON_Delete(resp);
+        send_message(conn, 401, 0, "Unauthorized");
         DEBUG_PRINT_CARD_HANDLER("EXIT handle_me: unauthorized");
         return;
     }
 
     if (service_rc != USER_SERVICE_OK) {
-        cJSON *resp = cJSON_CreateObject();
-        cJSON_AddBoolToObject(resp, "success", 0);
-        cJSON_AddStringToObject(resp, "message", "Server error");
-        send_json_response(conn, 500, resp);
-        cJSON_Delete(resp);
+        send_message(conn, 500, 0, "Server error");
         DEBUG_PRINT_CARD_HANDLER("EXIT handle_me: service error=%d", service_rc);
         return;
     }
 
-    cJSON *resp = cJSON_CreateObject();
-    cJSON *user = cJSON_CreateObject();
-    cJSON_AddStringToObject(user, "username", profile.username);
-    cJSON_AddNumberToObject(user, "words_learned", profile.words_learned);
-    cJSON_AddNumberToObject(user, "active_lessons", profile.active_lessons);
-    cJSON_AddItemToObject(resp, "user", user);
-    cJSON_AddBoolToObject(resp, "success", 1);
+    char stack[PROFILE_JSON_STACK_SIZE];
+    json_writer_t w;
+
+    json_writer_init(&w, stack, sizeof(stack));
+    json_write_object_begin(&w);
+    json_write_key(&w, "user");
+    json_write_object_begin(&w);
+    json_write_field_string(&w, "username", profile.username);
+    json_write_field_int(&w, "words_learned", profile.words_learned);
+    json_write_field_int(&w, "active_lessons", profile.active_lessons);
+    json_write_field_int(&w, "known_level", profile.known_level);
+    json_write_field_int(&w, "max_known_level", user_service_max_known_level());
+    json_write_object_end(&w);
+    json_write_field_bool(&w, "success", 1);
+    json_write_object_end(&w);
 
-    send_json_response(conn, 200, resp);
-    cJSON_Delete(resp);
+    send_json_response(conn, 200, &w);
 
     DEBUG_PRINT_CARD_HANDLER("EXIT handle_me: success username='%s'", profile.username);
 }
@@ -3,20 +3,25 @@
 #include "dbug/dbug.h"
 #include "libs/cJSON.h"
 #include "services/user_service.h"
+#include "utils/json.h"
 
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
 
-static int send_json_response(http_connection_t *conn, int status, cJSON *obj)
+/* Короткие ответы вида {"success":..,"message":..} помещаются в стек. */
+#define USER_JSON_STACK_SIZE 512
+
+static int send_json_response(http_connection_t *conn, int status, json_writer_t *w)
 {
-    if (!conn || !obj) {
-        return -1;
-    }
+    const char *out;
+    size_t len;
+    int rc;
 
-    char *out = cJSON_PrintUnformatted(obj);
-    if (!out) {
+    out = json_writer_finish(w, &len);
+    if (!conn || !out) {
+        json_writer_free(w);
         return -1;
     }
 
@@ -24,12 +29,25 @@ static int send_json_response(http_connection_t *conn, int status, cJSON *obj)
         "Cache-Control: no-store",
         "X-Content-Type-Options: nosniff"
     };
-    int rc = my_send_response_with_headers(conn, status, "application/json", out, strlen(out),
-                                           hdrs, sizeof(hdrs) / sizeof(hdrs[0]));
-    free(out);
+    rc = my_send_response_with_headers(conn, status, "application/json", out, len,
+                                       hdrs, sizeof(hdrs) / sizeof(hdrs[0]));
+    json_writer_free(w);
     return rc;
 }
 
+static int send_message(http_connection_t *conn, int status, int success, const char *message)
+{
+    char stack[USER_JSON_STACK_SIZE];
+    json_writer_t w;
+
+    json_writer_init(&w, stack, sizeof(stack));
+    json_write_object_begin(&w);
+    json_write_field_bool(&w, "success", success);
+    json_write_field_string(&w, "message", message);
+    json_write_object_end(&w);
+    return send_json_response(conn, status, &w);
+}
+
 static int appendf(char **pbuf, size_t *psize, size_t *plen, const char *fmt, ...)
 {
     va_list ap;
@@ -215,11 +233,7 @@ void handle_login(http_connection_t *conn, http_request_t *req)
         log_response_headers(400, "application/json", json_hdrs,
                              sizeof(json_hdrs) / sizeof(json_hdrs[0]));
 
-        cJSON *err = cJSON_CreateObject();
-        cJSON_AddBoolToObject(err, "success", 0);
-        cJSON_AddStringToObject(err, "message", "Missing fields");
-        send_json_response(conn, 400, err);
-        cJSON_Delete(err);
+        send_message(conn, 400, 0, "Missing fields");
         cJSON_Delete(json_req);
         DEBUG_PRINT_CARD_HANDLER("EXIT handle_login");
         return;
@@ -237,11 +251,7 @@ void handle_login(http_connection_t *conn, http_request_t *req)
         log_response_headers(500, "application/json", json_hdrs,
                              sizeof(json_hdrs) / sizeof(json_hdrs[0]));
 
-        cJSON *err = cJSON_CreateObject();
-        cJSON_AddBoolToObject(err, "success", 0);
-        cJSON_AddStringToObject(err, "message", "Server error");
-        send_json_response(conn, 500, err);
-        cJSON_Delete(err);
+        send_message(conn, 500, 0, "Server error");
         cJSON_Delete(json_req);
         DEBUG_PRINT_CARD_HANDLER("EXIT handle_login");
         return;
@@ -255,20 +265,22 @@ void handle_login(http_connection_t *conn, http_request_t *req)
         log_response_headers(401, "application/json", json_hdrs,
                              sizeof(json_hdrs) / sizeof(json_hdrs[0]));
 
-        cJSON *err = cJSON_CreateObject();
-        cJSON_AddBoolToObject(err, "success", 0);
-        cJSON_AddStringToObject(err, "message", "Invalid credentials");
-        send_json_response(conn, 401, err);
-        cJSON_Delete(err);
+        send_message(conn, 401, 0, "Invalid credentials");
         cJSON_Delete(json_req);
         DEBUG_PRINT_CARD_HANDLER("EXIT handle_login");
         return;
     }
 
-    cJSON *out_obj = cJSON_CreateObject();
-    cJSON_AddBoolToObject(out_obj, "success", 1);
-    cJSON_AddNumberToObject(out_obj, "user_id", user_id);
-    char *out_text = cJSON_PrintUnformatted(out_obj);
+    char stack[USER_JSON_STACK_SIZE];
+    json_writer_t w;
+    size_t out_len = 0;
+
+    json_writer_init(&w, stack, sizeof(stack));
+    json_write_object_begin(&w);
+    json_write_field_bool(&w, "success", 1);
+    json_write_field_int(&w, "user_id", user_id);
+    json_write_object_end(&w);
+    const char *out_text = json_writer_finish(&w, &out_len);
 
     const char *hdrs[] = {
         cookie_hdr,
@@ -276,11 +288,14 @@ void handle_login(http_connection_t *conn, http_request_t *req)
         "X-Content-Type-Options: nosniff"
     };
     log_response_headers(200, "application/json", hdrs, sizeof(hdrs) / sizeof(hdrs[0]));
-    my_send_response_with_headers(conn, 200, "application/json", out_text, strlen(out_text),
-                                  hdrs, sizeof(hdrs) / sizeof(hdrs[0]));
+    if (out_text) {
+        my_send_response_with_headers(conn, 200, "application/json", out_text, out_len,
+                                      hdrs, sizeof(hdrs) / sizeof(hdrs[0]));
+    } else {
+        http_send_response(conn, 500, "text/plain", "Server error\n", strlen("Server error\n"));
+    }
 
-    free(out_text);
-    cJSON_Delete(out_obj);
+    json_writer_free(&w);
     free(cookie_hdr);
     cJSON_Delete(json_req);
 
@@ -320,11 +335,7 @@ void handle_register(http_connection_t *conn, http_request_t *req)
     const char *password = (password_item && cJSON_IsString(password_item)) ? password_item->valuestring : NULL;
 
     if (!username || !email || !password) {
-        cJSON *res = cJSON_CreateObject();
-        cJSON_AddBoolToObject(res, "success", 0);
-        cJSON_AddStringToObject(res, "message", "Missing fields");
-        send_json_response(conn, 400, res);
-        cJSON_Delete(res);
+        send_message(conn, 400, 0, "Missing fields");
         cJSON_Delete(json_req);
         DEBUG_PRINT_CARD_HANDLER("EXIT handle_register");
         return;
@@ -334,65 +345,49 @@ void handle_register(http_connection_t *conn, http_request_t *req)
     int service_rc = user_service_register(username, email, password, &new_user_id);
 
     if (service_rc == USER_SERVICE_ERR_PASSWORD_TOO_SHORT) {
-        cJSON *res = cJSON_CreateObject();
-        cJSON_AddBoolToObject(res, "success", 0);
-        cJSON_AddStringToObject(res, "message", "Password too short (min 6 chars)");
-        send_json_response(conn, 400, res);
-        cJSON_Delete(res);
+        send_message(conn, 400, 0, "Password too short (min 6 chars)");
         cJSON_Delete(json_req);
         DEBUG_PRINT_CARD_HANDLER("EXIT handle_register");
         return;
     }
 
     if (service_rc == USER_SERVICE_ERR_INVALID_EMAIL) {
-        cJSON *res = cJSON_CreateObject();
-        cJSON_AddBoolToObject(res, "success", 0);
-        cJSON_AddStringToObject(res, "message", "Invalid email");
-        send_json_response(conn, 400, res);
-        cJSON_Delete(res);
+        send_message(conn, 400, 0, "Invalid email");
         cJSON_Delete(json_req);
         DEBUG_PRINT_CARD_HANDLER("EXIT handle_register");
         return;
     }
 
     if (service_rc == USER_SERVICE_OK && new_user_id > 0) {
-        cJSON *res = cJSON_CreateObject();
-        cJSON_AddBoolToObject(res, "success", 1);
-        cJSON_AddNumberToObject(res, "user_id", new_user_id);
-        send_json_response(conn, 201, res);
-        cJSON_Delete(res);
+        char stack[USER_JSON_STACK_SIZE];
+        json_writer_t w;
+
+        json_writer_init(&w, stack, sizeof(stack));
+        json_write_object_begin(&w);
+        json_write_field_bool(&w, "success", 1);
+        json_write_field_int(&w, "user_id", new_user_id);
+        json_write_object_end(&w);
+        send_json_response(conn, 201, &w);
         cJSON_Delete(json_req);
         DEBUG_PRINT_CARD_HANDLER("EXIT handle_register");
         return;
     }
 
     if (service_rc == USER_SERVICE_OK && new_user_id == 0) {
-        cJSON *res = cJSON_CreateObject();
-        cJSON_AddBoolToObject(res, "success", 1);
-        cJSON_AddStringToObject(res, "message", "Registered (id not returned)");
-        send_json_response(conn, 201, res);
-        cJSON_Delete(res);
+        send_message(conn, 201, 1, "Registered (id not returned)");
         cJSON_Delete(json_req);
         DEBUG_PRINT_CARD_HANDLER("EXIT handle_register");
         return;
     }
 
     if (service_rc == USER_SERVICE_ERR_CONFLICT) {
-        cJSON *res = cJSON_CreateObject();
-        cJSON_AddBoolToObject(res, "success", 0);
-        cJSON_AddStringToObject(res, "message", "User already exists");
-        send_json_response(conn, 409, res);
-        cJSON_Delete(res);
+        send_message(conn, 409, 0, "User already exists");
         cJSON_Delete(json_req);
         DEBUG_PRINT_CARD_HANDLER("EXIT handle_register");
         return;
     }
 
-    cJSON *res = cJSON_CreateObject();
-    cJSON_AddBoolToObject(res, "success", 0);
-    cJSON_AddStringToObject(res, "message", "Registration failed due to server error");
-    send_json_response(conn, 500, res);
-    cJSON_Delete(res);
+    send_message(conn, 500, 0, "Registration failed due to server error");
     cJSON_Delete(json_req);
     DEBUG_PRINT_CARD_HANDLER("EXIT handle_register");
 }
@@ -19,6 +19,25 @@ typedef struct {
     const char *word;
 } card_api_exists_query_t;
 
+typedef struct {
+    int user_id;
+    int card_id;
+} card_api_delete_input_t;
+
+/* Фильтр известных слов перед card_api_exists: ABSENT отвечается без БД. */
+typedef struct {
+    size_t users;
+    size_t bytes;
+    size_t memory_limit;
+    unsigned long long absent;
+    unsigned long long maybe;
+    unsigned long long unfiltered;
+    unsigned long long false_positives;
+    unsigned long long builds;
+    unsigned long long build_failures;
+    unsigned long long evictions;
+} card_api_known_words_stats_t;
+
 enum {
     CARD_API_OK = 0,
     CARD_API_ERR_SERVER = -1,
@@ -34,6 +53,8 @@ int card_api_add_word(const char *word, const char *transcription,
 void card_api_free_words(Word *words, size_t count);
 
 int card_api_create(const card_api_create_input_t *input, int *out_card_id);
+int card_api_delete(const card_api_delete_input_t *input);
 int card_api_exists(const card_api_exists_query_t *query, int *out_exists);
+void card_api_get_known_words_stats(card_api_known_words_stats_t *out);
 
 #endif
@@ -0,0 +1,26 @@
+#ifndef INTERNAL_API_GENERATION_JOB_API_H
+#define INTERNAL_API_GENERATION_JOB_API_H
+
+#include <stddef.h>
+
+#include "models/generation_job.h"
+
+enum {
+    GENERATION_JOB_API_OK = 0,
+    GENERATION_JOB_API_ERR_SERVER = -1,
+    GENERATION_JOB_API_ERR_INVALID_ARGUMENT = -2
+};
+
+/*
+ * Хранение состояния задач генерации. Поле drafts у jobs при сохранении
+ * не используется: изменённые черновики передаются отдельным массивом.
+ */
+int generation_job_api_save(const generation_job_t *jobs, size_t job_count,
+                            const generation_card_draft_t *drafts, size_t draft_count);
+/* Незавершённые задачи с черновиками; освобождать generation_job_api_free_jobs. */
+int generation_job_api_load_unfinished(generation_job_t **out_jobs, size_t *out_count);
+void generation_job_api_free_jobs(generation_job_t *jobs, size_t count);
+/* Следующие свободные job_id и draft_id. */
+int generation_job_api_next_ids(int *out_job_id, int *out_draft_id);
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef INTERNAL_API_LLM_API_H
 #define INTERNAL_API_LLM_API_H
 
+#include <stddef.h>
+
 enum {
     LLM_API_EXAMPLE_COUNT = 2
 };
@@ -10,8 +12,68 @@ typedef struct {
     char *translation;
     char *transcription;
     char *examples[LLM_API_EXAMPLE_COUNT];
+    /* Если не NULL — все строки лежат в этой одной аллокации. */
+    char *storage;
 } llm_api_word_card_t;
 
+enum {
+    LLM_API_PRIORITY_INTERACTIVE = 0,
+    LLM_API_PRIORITY_BATCH = 1
+};
+
+/*
+ * Кто и с каким приоритетом обращается к модели.
+ * NULL вместо options — интерактивный запрос анонимного пользователя.
+ * deadline_ms — абсолютное время http_now_ms(), к которому нужен ответ,
+ * включая ожидание в очереди; 0 — LLM_REQUEST_TIMEOUT_MS (интерактивные)
+ * или LLM_BATCH_TIMEOUT_MS (пакетные) от начала вызова.
+ */
+typedef struct {
+    int user_id;
+    int priority;
+    unsigned long long deadline_ms;
+} llm_api_request_options_t;
+
+enum {
+    LLM_API_MAX_BACKENDS = 16
+};
+
+typedef struct {
+    char host[128];
+    char port[16];
+    int max_in_flight;
+    int in_flight;
+    int healthy;
+    unsigned long long requests;
+    unsigned long long failures;
+    unsigned long long latency_p95_ms;
+} llm_api_backend_metrics_t;
+
+typedef struct {
+    int max_concurrency;
+    int in_flight;
+    int queued_interactive;
+    int queued_batch;
+    int active_users;
+    unsigned long long granted_interactive;
+    unsigned long long granted_batch;
+    unsigned long long wait_ms_total_interactive;
+    unsigned long long wait_ms_total_batch;
+    unsigned long long wait_ms_max_interactive;
+    unsigned long long wait_ms_max_batch;
+    unsigned long long queue_timeouts_interactive;
+    unsigned long long queue_timeouts_batch;
+    unsigned long long upstream_timeouts;
+    unsigned long long hedges;
+    unsigned long long hedge_wins;
+    unsigned long long card_repairs;
+    unsigned long long card_repairs_failed;
+    unsigned long long card_cache_hits;
+    unsigned long long card_cache_misses;
+    size_t backend_count;
+    llm_api_backend_metrics_t backends[LLM_API_MAX_BACKENDS];
+} llm_api_metrics_t;
+
 enum {
     LLM_API_OK = 0,
     LLM_API_ERR_INVALID_ARGUMENT = -1,
@@ -19,7 +81,24 @@ enum {
     LLM_API_ERR_SERVER = -3
 };
 
-int llm_api_generate_word_card(const char *word, llm_api_word_card_t *out_card);
+int llm_api_generate_word_card(const char *word,
+                               const llm_api_request_options_t *options,
+                               llm_api_word_card_t *out_card);
+
+/*
+ * Генерирует карточки для count слов одним запросом к модели.
+ * out_results[i] получает код LLM_API_* для words[i]; слова, которые
+ * не удалось разобрать из ответа пачкой, повторяются по одному.
+ * Возвращает LLM_API_OK, если вызов выполнен (даже если часть слов не удалась).
+ */
+int llm_api_generate_word_cards(const char *const *words, size_t count,
+                                const llm_api_request_options_t *options,
+                                llm_api_word_card_t *out_cards, int *out_results);
+
+/*
+ * Снимок состояния планировщика запросов к модели и upstream-backend'ов.
+ */
+void llm_api_get_metrics(llm_api_metrics_t *out);
 void llm_api_free_word_card(llm_api_word_card_t *card);
 
 #endif
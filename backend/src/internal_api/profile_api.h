@@ -7,6 +7,7 @@ typedef struct {
     char username[256];
     int words_learned;
     int active_lessons;
+    int known_level;
 } profile_api_user_profile_t;
 
 enum {
@@ -18,4 +19,8 @@ enum {
 
 int profile_api_get_user_profile(int user_id, profile_api_user_profile_t *profile);
 
+/* Уровень базовой лексики, известной пользователю: такие слова не идут в генерацию. */
+int profile_api_get_known_level(int user_id, int *out_level);
+int profile_api_set_known_level(int user_id, int level);
+
 #endif
@@ -11,6 +11,8 @@ enum {
 #define REALTIME_EVENT_GENERATION_JOB_PROGRESS "generation.job.progress"
 #define REALTIME_EVENT_GENERATION_JOB_STEP "generation.job.step"
 #define REALTIME_EVENT_GENERATION_CARD_DRAFT "generation.card.draft"
+/* Пачка черновиков: payload {"drafts":[...]}. */
+#define REALTIME_EVENT_GENERATION_CARD_DRAFTS "generation.card.drafts"
 #define REALTIME_EVENT_GENERATION_CARD_UPDATED "generation.card.updated"
 #define REALTIME_EVENT_GENERATION_CARD_SAVED "generation.card.saved"
 #define REALTIME_EVENT_GENERATION_JOB_COMPLETED "generation.job.completed"
@@ -5,6 +5,7 @@
 
 #include "modules/realtime/realtime_hub.h"
 #include "modules/realtime/realtime_ws.h"
+#include "utils/json_arena.h"
 
 #include <arpa/inet.h>
 #include <errno.h>
@@ -16,8 +17,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <time.h>
+#include <poll.h>
 #include <sys/epoll.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #define MAX_HANDLER 16
@@ -76,6 +80,44 @@ static int send_all_nonblocking(int fd, const char *data, size_t len)
     return 0;
 }
 
+/*
+ * Заголовок и тело ответа одним sendmsg: без второго системного вызова и
+ * без склейки в общий буфер. Частичная запись продолжается с места остановки.
+ */
+static int send_iov_nonblocking(int fd, struct iovec *iov, int iovcnt)
+{
+    struct msghdr msg;
+
+    while (iovcnt > 0 && iov->iov_len == 0) {
+        iov++;
+        iovcnt--;
+    }
+    while (iovcnt > 0) {
+        ssize_t rc;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t) iovcnt;
+        rc = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (rc < 0 && errno == EINTR) {
+            continue;
+        }
+        if (rc <= 0) {
+            return -1;
+        }
+        while (iovcnt > 0 && (size_t) rc >= iov->iov_len) {
+            rc -= (ssize_t) iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char *) iov->iov_base + rc;
+            iov->iov_len -= (size_t) rc;
+        }
+    }
+    return 0;
+}
+
 static int set_nonblocking(int fd)
 {
     int flags = fcntl(fd, F_GETFL, 0);
@@ -527,7 +569,10 @@ static void process_http_connection(http_connection_t *conn)
                     return;
                 }
 
+                /* Всё, что cJSON выделил за запрос, освобождается после ответа разом. */
+                json_arena_begin();
                 handler(conn, &conn->req);
+                json_arena_end();
                 if (!conn->keep_open) {
                     conn->should_close = 1;
                 }
@@ -667,6 +712,7 @@ static const char *reason_phrase(int status)
     switch (status) {
     case 200: return "OK";
     case 201: return "Created";
+    case 202: return "Accepted";
     case 204: return "No Content";
     case 301: return "Moved Permanently";
     case 302: return "Found";
@@ -737,6 +783,23 @@ void http_connection_mark_sse(http_connection_t *conn)
     conn->mode = HTTP_CONN_MODE_SSE;
 }
 
+static int http_send_response_parts(http_connection_t *conn,
+                                    const char *header, size_t header_len,
+                                    const char *body, size_t body_len)
+{
+    struct iovec iov[2];
+
+    iov[0].iov_base = (void *) header;
+    iov[0].iov_len = header_len;
+    iov[1].iov_base = (void *) body;
+    iov[1].iov_len = body ? body_len : 0;
+    if (send_iov_nonblocking(conn->fd, iov, 2) != 0) {
+        conn->should_close = 1;
+        return -1;
+    }
+    return 0;
+}
+
 int http_send_response(http_connection_t *conn, int status_code,
                        const char *content_type, const char *body,
                        size_t body_len)
@@ -761,13 +824,7 @@ int http_send_response(http_connection_t *conn, int status_code,
     if (header_len < 0 || (size_t) header_len >= sizeof(header)) {
         return -1;
     }
-    if (http_send_raw(conn, header, (size_t) header_len) != 0) {
-        return -1;
-    }
-    if (body_len > 0 && http_send_raw(conn, body, body_len) != 0) {
-        return -1;
-    }
-    return 0;
+    return http_send_response_parts(conn, header, (size_t) header_len, body, body_len);
 }
 
 int my_send_response_with_headers(http_connection_t *conn,
@@ -862,11 +919,7 @@ int my_send_response_with_headers(http_connection_t *conn,
     hdr[hdr_len++] = '\r';
     hdr[hdr_len++] = '\n';
 
-    if (http_send_raw(conn, hdr, (size_t) hdr_len) != 0) {
-        free(hdr);
-        return -1;
-    }
-    if (len > 0 && http_send_raw(conn, body, len) != 0) {
+    if (http_send_response_parts(conn, hdr, (size_t) hdr_len, body, len) != 0) {
         free(hdr);
         return -1;
     }
@@ -875,140 +928,597 @@ int my_send_response_with_headers(http_connection_t *conn,
     return 0;
 }
 
-static ssize_t read_all(int sock, char **out_buf)
+enum {
+    HTTP_CLIENT_STATE_CONNECTING = 0,
+    HTTP_CLIENT_STATE_WRITING = 1,
+    HTTP_CLIENT_STATE_READING = 2
+};
+
+enum {
+    HTTP_CHUNK_SIZE = 0,
+    HTTP_CHUNK_DATA = 1,
+    HTTP_CHUNK_DATA_END = 2,
+    HTTP_CHUNK_TRAILER = 3
+};
+
+struct http_client_request_s {
+    int fd;
+    int state;
+    int status;
+    int flags;
+    struct addrinfo *addrs;
+    struct addrinfo *next_addr;
+    char *request;
+    size_t request_len;
+    size_t sent;
+    char *response;
+    size_t response_len;
+    size_t response_cap;
+    /*
+     * HTTP_CLIENT_DECODE_BODY: заголовки и chunked-кадры разбираются по
+     * мере чтения, а тело сдвигается на место в начало response.
+     */
+    size_t scan_off;
+    size_t body_len;
+    int header_done;
+    int http_status;
+    int chunked;
+    int chunk_state;
+    size_t chunk_left;
+    long long content_left;
+};
+
+unsigned long long http_now_ms(void)
 {
-    size_t cap = 1024;
-    size_t len = 0;
-    char *buf = malloc(cap);
+    struct timespec ts;
 
-    if (!buf) {
-        return -1;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000ULL + (unsigned long long) ts.tv_nsec / 1000000ULL;
+}
+
+static char *build_client_request(const char *host, const char *port,
+                                  const char *path, const char *method,
+                                  const char *body, const char *headers[],
+                                  size_t *out_len)
+{
+    char *request;
+    size_t request_cap;
+    size_t body_len = 0;
+    size_t offset = 0;
+
+    /* Размер запроса зависит от тела (батч-промпты LLM легко больше MAX_BUFFER). */
+    request_cap = strlen(method) + strlen(path) + strlen(host) + strlen(port) + 160;
+    if (headers) {
+        int i;
+        for (i = 0; headers[i]; i++) {
+            request_cap += strlen(headers[i]) + 2;
+        }
     }
-    for (;;) {
-        ssize_t n = recv(sock, buf + len, cap - len, 0);
-        if (n < 0) {
-            if (errno == EINTR) {
-                continue;
-            }
-            free(buf);
-            return -1;
+    if (body) {
+        body_len = strlen(body);
+        request_cap += body_len;
+    }
+
+    request = malloc(request_cap);
+    if (!request) {
+        return NULL;
+    }
+
+    /* Ответ читается до EOF, поэтому keep-alive upstream'у не нужен. */
+    offset += (size_t) snprintf(request + offset, request_cap - offset,
+                                "%s %s HTTP/1.1\r\nHost: %s:%s\r\nConnection: close\r\n",
+                                method, path, host, port);
+
+    if (headers) {
+        int i;
+        for (i = 0; headers[i]; i++) {
+            offset += (size_t) snprintf(request + offset, request_cap - offset,
+                                        "%s\r\n", headers[i]);
         }
-        if (n == 0) {
-            break;
+    }
+
+    if (body) {
+        offset += (size_t) snprintf(request + offset, request_cap - offset,
+                                    "Content-Length: %zu\r\n", body_len);
+    }
+
+    offset += (size_t) snprintf(request + offset, request_cap - offset, "\r\n");
+    if (body) {
+        memcpy(request + offset, body, body_len);
+        offset += body_len;
+    }
+
+    *out_len = offset;
+    return request;
+}
+
+/*
+ * Неблокирующий connect на следующий адрес из getaddrinfo.
+ * 0 — соединение начато, -1 — адреса закончились.
+ */
+static int http_client_connect_next(http_client_request_t *req)
+{
+    if (req->fd >= 0) {
+        close(req->fd);
+        req->fd = -1;
+    }
+
+    while (req->next_addr) {
+        struct addrinfo *rp = req->next_addr;
+
+        req->next_addr = rp->ai_next;
+        req->fd = socket(rp->ai_family, rp->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                         rp->ai_protocol);
+        if (req->fd < 0) {
+            continue;
         }
-        len += (size_t) n;
-        if (len + 1 >= cap) {
-            char *tmp;
-            cap *= 2;
-            tmp = realloc(buf, cap);
-            if (!tmp) {
-                free(buf);
-                return -1;
-            }
-            buf = tmp;
+        if (connect(req->fd, rp->ai_addr, rp->ai_addrlen) == 0) {
+            req->state = HTTP_CLIENT_STATE_WRITING;
+            return 0;
+        }
+        if (errno == EINPROGRESS) {
+            req->state = HTTP_CLIENT_STATE_CONNECTING;
+            return 0;
         }
+        close(req->fd);
+        req->fd = -1;
     }
-    buf[len] = '\0';
-    *out_buf = buf;
-    return (ssize_t) len;
+
+    return -1;
 }
 
-static int http_request_internal(const char *host, const char *port,
-                                 const char *path, const char *method,
-                                 const char *body, const char *headers[],
-                                 char **response_out)
+http_client_request_t *http_client_start(const char *host, const char *port,
+                                         const char *method, const char *path,
+                                         const char *body, const char *headers[],
+                                         int flags)
 {
-    int sock = -1;
-    int rc = -1;
+    http_client_request_t *req;
     struct addrinfo hints;
-    struct addrinfo *res = NULL;
-    struct addrinfo *rp;
-    char *request = NULL;
-    size_t offset = 0;
 
-    DBG("[HTTP] http_request_internal: %s %s:%s%s\n", method, host, port, path);
+    DBG("[HTTP] http_client_start: %s %s:%s%s\n", method, host, port, path);
+
+    req = calloc(1, sizeof(*req));
+    if (!req) {
+        return NULL;
+    }
+    req->fd = -1;
+    req->status = HTTP_CLIENT_IN_PROGRESS;
+    req->flags = flags;
+    req->content_left = -1;
+
+    req->request = build_client_request(host, port, path, method, body, headers,
+                                        &req->request_len);
+    if (!req->request) {
+        goto fail;
+    }
 
     memset(&hints, 0, sizeof(hints));
     hints.ai_family = AF_UNSPEC;
     hints.ai_socktype = SOCK_STREAM;
 
-    if (getaddrinfo(host, port, &hints, &res) != 0) {
-        goto cleanup;
+    if (getaddrinfo(host, port, &hints, &req->addrs) != 0) {
+        req->addrs = NULL;
+        goto fail;
+    }
+    req->next_addr = req->addrs;
+
+    if (http_client_connect_next(req) != 0) {
+        goto fail;
+    }
+
+    return req;
+
+fail:
+    http_client_free(req);
+    return NULL;
+}
+
+static void http_client_finish(http_client_request_t *req, int status)
+{
+    req->status = status;
+    if (req->fd >= 0) {
+        close(req->fd);
+        req->fd = -1;
+    }
+    if (status == HTTP_CLIENT_DONE) {
+        if (req->flags & HTTP_CLIENT_DECODE_BODY) {
+            req->response_len = req->body_len;
+        }
+        req->response[req->response_len] = '\0';
+    }
+}
+
+/*
+ * Разбирает заголовки, как только пришёл разделитель "\r\n\r\n".
+ * Ищет только в новых байтах. 1 — заголовки разобраны, 0 — ждать, -1 — ошибка.
+ */
+static int http_client_parse_headers(http_client_request_t *req)
+{
+    size_t from = req->scan_off > 3 ? req->scan_off - 3 : 0;
+    const char *sep = memmem(req->response + from, req->response_len - from, "\r\n\r\n", 4);
+    const char *line;
+    const char *headers_end;
+
+    if (!sep) {
+        req->scan_off = req->response_len;
+        return 0;
+    }
+
+    if (sscanf(req->response, "HTTP/%*s %d", &req->http_status) != 1) {
+        return -1;
+    }
+
+    headers_end = sep + 2;
+    line = memchr(req->response, '\n', (size_t) (headers_end - req->response));
+    while (line && ++line < headers_end) {
+        const char *eol = memchr(line, '\n', (size_t) (headers_end - line));
+        size_t line_len = eol ? (size_t) (eol - line) : (size_t) (headers_end - line);
+
+        if (line_len > 18 && strncasecmp(line, "Transfer-Encoding:", 18) == 0 &&
+            memmem(line, line_len, "chunked", 7)) {
+            req->chunked = 1;
+        } else if (line_len > 15 && strncasecmp(line, "Content-Length:", 15) == 0) {
+            req->content_left = strtoll(line + 15, NULL, 10);
+        }
+        line = eol;
+    }
+
+    req->header_done = 1;
+    req->scan_off = (size_t) (sep + 4 - req->response);
+    req->body_len = 0;
+    req->chunk_state = HTTP_CHUNK_SIZE;
+    if (req->chunked) {
+        req->content_left = -1;
+    }
+    return 1;
+}
+
+static void http_client_take_body_bytes(http_client_request_t *req, size_t n)
+{
+    memmove(req->response + req->body_len, req->response + req->scan_off, n);
+    req->body_len += n;
+    req->scan_off += n;
+}
+
+/*
+ * Снимает HTTP-кадрирование с только что прочитанных байт. Тело пишется
+ * в начало буфера: позиция записи всегда позади позиции чтения.
+ * 1 — сообщение получено целиком, 0 — ждать данных, -1 — ошибка формата.
+ */
+static int http_client_decode(http_client_request_t *req)
+{
+    if (!req->header_done) {
+        int rc = http_client_parse_headers(req);
+        if (rc <= 0) {
+            return rc;
+        }
     }
 
-    for (rp = res; rp != NULL; rp = rp->ai_next) {
-        sock = socket(rp->ai_family, rp->ai_socktype, rp->ai_protocol);
-        if (sock < 0) {
+    while (req->scan_off < req->response_len) {
+        size_t avail = req->response_len - req->scan_off;
+        char *cur = req->response + req->scan_off;
+        char *eol;
+        char *endptr;
+
+        if (!req->chunked) {
+            size_t take = avail;
+
+            if (req->content_left >= 0 && take > (size_t) req->content_left) {
+                take = (size_t) req->content_left;
+            }
+            http_client_take_body_bytes(req, take);
+            if (req->content_left >= 0) {
+                req->content_left -= (long long) take;
+                if (req->content_left == 0) {
+                    return 1;
+                }
+            }
             continue;
         }
-        if (connect(sock, rp->ai_addr, rp->ai_addrlen) == 0) {
+
+        switch (req->chunk_state) {
+        case HTTP_CHUNK_SIZE:
+            eol = memchr(cur, '\n', avail);
+            if (!eol) {
+                return 0;
+            }
+            req->chunk_left = strtoul(cur, &endptr, 16);
+            if (endptr == cur) {
+                return -1;
+            }
+            req->scan_off = (size_t) (eol + 1 - req->response);
+            req->chunk_state = req->chunk_left ? HTTP_CHUNK_DATA : HTTP_CHUNK_TRAILER;
+            break;
+        case HTTP_CHUNK_DATA: {
+            size_t take = avail < req->chunk_left ? avail : req->chunk_left;
+
+            http_client_take_body_bytes(req, take);
+            req->chunk_left -= take;
+            if (req->chunk_left == 0) {
+                req->chunk_state = HTTP_CHUNK_DATA_END;
+            }
+            break;
+        }
+        case HTTP_CHUNK_DATA_END:
+            if (avail < 2) {
+                return 0;
+            }
+            if (cur[0] != '\r' || cur[1] != '\n') {
+                return -1;
+            }
+            req->scan_off += 2;
+            req->chunk_state = HTTP_CHUNK_SIZE;
+            break;
+        default:
+            /* Трейлеры после нулевого чанка; пустая строка — конец сообщения. */
+            eol = memchr(cur, '\n', avail);
+            if (!eol) {
+                return 0;
+            }
+            req->scan_off = (size_t) (eol + 1 - req->response);
+            if (eol == cur || (eol == cur + 1 && cur[0] == '\r')) {
+                return 1;
+            }
             break;
         }
-        close(sock);
-        sock = -1;
     }
 
-    if (sock < 0) {
-        goto cleanup;
+    return 0;
+}
+
+/*
+ * Сервер закрыл соединение: в режиме декодирования ответ валиден, только
+ * если тело не оборвано посреди кадра.
+ */
+static int http_client_eof_status(const http_client_request_t *req)
+{
+    if (!(req->flags & HTTP_CLIENT_DECODE_BODY)) {
+        return HTTP_CLIENT_DONE;
+    }
+    if (!req->header_done || req->chunked || req->content_left > 0) {
+        return HTTP_CLIENT_FAILED;
     }
+    return HTTP_CLIENT_DONE;
+}
 
-    request = malloc(MAX_BUFFER);
-    if (!request) {
-        goto cleanup;
+/*
+ * Продвигает запрос, насколько позволяет сокет, не блокируясь.
+ */
+static void http_client_step(http_client_request_t *req)
+{
+    if (req->state == HTTP_CLIENT_STATE_CONNECTING) {
+        int err = 0;
+        socklen_t err_len = sizeof(err);
+
+        if (getsockopt(req->fd, SOL_SOCKET, SO_ERROR, &err, &err_len) != 0 || err != 0) {
+            if (http_client_connect_next(req) != 0) {
+                http_client_finish(req, HTTP_CLIENT_FAILED);
+            }
+            return;
+        }
+        req->state = HTTP_CLIENT_STATE_WRITING;
     }
 
-    offset += (size_t) snprintf(request + offset, MAX_BUFFER - offset,
-                                "%s %s HTTP/1.1\r\nHost: %s:%s\r\n",
-                                method, path, host, port);
+    if (req->state == HTTP_CLIENT_STATE_WRITING) {
+        while (req->sent < req->request_len) {
+            ssize_t n = send(req->fd, req->request + req->sent,
+                             req->request_len - req->sent, MSG_NOSIGNAL);
+            if (n > 0) {
+                req->sent += (size_t) n;
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return;
+            }
+            http_client_finish(req, HTTP_CLIENT_FAILED);
+            return;
+        }
+        req->state = HTTP_CLIENT_STATE_READING;
+    }
 
-    if (headers) {
-        int i;
-        for (i = 0; headers[i]; i++) {
-            offset += (size_t) snprintf(request + offset, MAX_BUFFER - offset,
-                                        "%s\r\n", headers[i]);
+    for (;;) {
+        ssize_t n;
+
+        if (req->response_len + 1 >= req->response_cap) {
+            size_t cap = req->response_cap ? req->response_cap * 2 : 4096;
+            char *tmp = realloc(req->response, cap);
+            if (!tmp) {
+                http_client_finish(req, HTTP_CLIENT_FAILED);
+                return;
+            }
+            req->response = tmp;
+            req->response_cap = cap;
+        }
+
+        n = recv(req->fd, req->response + req->response_len,
+                 req->response_cap - req->response_len - 1, 0);
+        if (n > 0) {
+            req->response_len += (size_t) n;
+            req->response[req->response_len] = '\0';
+            if (req->flags & HTTP_CLIENT_DECODE_BODY) {
+                int rc = http_client_decode(req);
+
+                if (rc != 0) {
+                    http_client_finish(req, rc > 0 ? HTTP_CLIENT_DONE : HTTP_CLIENT_FAILED);
+                    return;
+                }
+            }
+            continue;
+        }
+        if (n == 0) {
+            http_client_finish(req, http_client_eof_status(req));
+            return;
+        }
+        if (errno == EINTR) {
+            continue;
         }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            http_client_finish(req, HTTP_CLIENT_FAILED);
+        }
+        return;
     }
+}
 
-    if (body) {
-        offset += (size_t) snprintf(request + offset, MAX_BUFFER - offset,
-                                    "Content-Length: %zu\r\n", strlen(body));
+int http_client_wait(http_client_request_t *const *requests, size_t count,
+                     unsigned long long deadline_ms)
+{
+    struct pollfd fds[HTTP_CLIENT_MAX_WAIT];
+    size_t index[HTTP_CLIENT_MAX_WAIT];
+
+    if (!requests || count > HTTP_CLIENT_MAX_WAIT) {
+        return -1;
     }
 
-    offset += (size_t) snprintf(request + offset, MAX_BUFFER - offset, "\r\n");
-    if (body) {
-        offset += (size_t) snprintf(request + offset, MAX_BUFFER - offset, "%s", body);
+    for (;;) {
+        unsigned long long now;
+        int timeout = -1;
+        nfds_t nfds = 0;
+        size_t i;
+        int rc;
+
+        for (i = 0; i < count; i++) {
+            http_client_request_t *req = requests[i];
+
+            if (!req || req->status != HTTP_CLIENT_IN_PROGRESS) {
+                continue;
+            }
+            fds[nfds].fd = req->fd;
+            fds[nfds].events = req->state == HTTP_CLIENT_STATE_READING ? POLLIN : POLLOUT;
+            fds[nfds].revents = 0;
+            index[nfds] = i;
+            nfds++;
+        }
+        if (nfds == 0) {
+            return -1;
+        }
+
+        if (deadline_ms) {
+            now = http_now_ms();
+            if (now >= deadline_ms) {
+                return -1;
+            }
+            timeout = (int) (deadline_ms - now);
+        }
+
+        rc = poll(fds, nfds, timeout);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+
+        for (i = 0; i < (size_t) nfds; i++) {
+            http_client_request_t *req;
+
+            if (!fds[i].revents) {
+                continue;
+            }
+            req = requests[index[i]];
+            http_client_step(req);
+            if (req->status != HTTP_CLIENT_IN_PROGRESS) {
+                return (int) index[i];
+            }
+        }
     }
+}
+
+int http_client_status(const http_client_request_t *request)
+{
+    return request ? request->status : HTTP_CLIENT_FAILED;
+}
+
+int http_client_http_status(const http_client_request_t *request)
+{
+    return request && request->header_done ? request->http_status : 0;
+}
 
-    if (send_all_nonblocking(sock, request, offset) != 0) {
-        goto cleanup;
+char *http_client_take_body(http_client_request_t *request, size_t *body_len)
+{
+    if (!request || !(request->flags & HTTP_CLIENT_DECODE_BODY)) {
+        return NULL;
     }
-    if (read_all(sock, response_out) < 0) {
-        goto cleanup;
+    if (body_len) {
+        *body_len = request->body_len;
     }
+    return http_client_take_response(request);
+}
 
-    rc = 0;
+char *http_client_take_response(http_client_request_t *request)
+{
+    char *response;
 
-cleanup:
-    if (res) {
-        freeaddrinfo(res);
+    if (!request || request->status != HTTP_CLIENT_DONE) {
+        return NULL;
+    }
+    response = request->response;
+    request->response = NULL;
+    return response;
+}
+
+void http_client_free(http_client_request_t *request)
+{
+    if (!request) {
+        return;
+    }
+    if (request->fd >= 0) {
+        close(request->fd);
     }
-    if (sock >= 0) {
-        close(sock);
+    if (request->addrs) {
+        freeaddrinfo(request->addrs);
     }
+    free(request->request);
+    free(request->response);
     free(request);
+}
+
+static int http_request_internal(const char *host, const char *port,
+                                 const char *path, const char *method,
+                                 const char *body, const char *headers[],
+                                 unsigned long long deadline_ms,
+                                 char **response_out)
+{
+    http_client_request_t *req;
+    int rc = -1;
+
+    req = http_client_start(host, port, method, path, body, headers, 0);
+    if (!req) {
+        return -1;
+    }
+
+    if (http_client_wait(&req, 1, deadline_ms) == 0 &&
+        http_client_status(req) == HTTP_CLIENT_DONE) {
+        *response_out = http_client_take_response(req);
+        rc = 0;
+    } else if (http_client_status(req) == HTTP_CLIENT_IN_PROGRESS) {
+        DBG("[HTTP] %s %s:%s%s: deadline exceeded\n", method, host, port, path);
+    }
+
+    http_client_free(req);
     return rc;
 }
 
 int http_get(const char *host, const char *port, const char *path,
              const char *headers[], char **response_out)
 {
-    return http_request_internal(host, port, path, "GET", NULL, headers, response_out);
+    return http_request_internal(host, port, path, "GET", NULL, headers, 0, response_out);
 }
 
 int http_post(const char *host, const char *port, const char *path,
               const char *body, const char *headers[], char **response_out)
 {
-    return http_request_internal(host, port, path, "POST", body, headers, response_out);
+    return http_request_internal(host, port, path, "POST", body, headers, 0, response_out);
+}
+
+int http_post_deadline(const char *host, const char *port, const char *path,
+                       const char *body, const char *headers[],
+                       unsigned long long deadline_ms, char **response_out)
+{
+    return http_request_internal(host, port, path, "POST", body, headers, deadline_ms,
+                                 response_out);
 }
 
 void http_free_response(char *response)
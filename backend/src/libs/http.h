@@ -40,6 +40,56 @@ int http_post(const char *host,const char *port, const char *path,
 
 void http_free_response(char *response);
 
+// Монотонное время в миллисекундах — шкала для всех deadline_ms.
+unsigned long long http_now_ms(void);
+
+// Как http_post, но connect, отправка и чтение ограничены абсолютным
+// дедлайном deadline_ms (0 — без ограничения). По истечении — -1.
+int http_post_deadline(const char *host, const char *port, const char *path,
+                       const char *body, const char *headers[],
+                       unsigned long long deadline_ms, char **response_out);
+
+// Неблокирующий клиентский запрос: несколько запросов можно вести
+// одновременно и дожидаться первого завершившегося через http_client_wait().
+// http_client_free() закрывает сокет — так отменяется незавершённый запрос.
+#define HTTP_CLIENT_MAX_WAIT 8
+
+enum {
+    HTTP_CLIENT_IN_PROGRESS = 0,
+    HTTP_CLIENT_DONE = 1,
+    HTTP_CLIENT_FAILED = -1
+};
+
+// Флаг http_client_start: разбирать заголовки и снимать chunked-кадрирование
+// по мере чтения; ответ завершается по Content-Length или нулевому чанку.
+// Результат забирается через http_client_take_body().
+#define HTTP_CLIENT_DECODE_BODY 0x1
+
+typedef struct http_client_request_s http_client_request_t;
+
+// Начинает connect; NULL, если адрес не разрешился или соединиться нельзя.
+http_client_request_t *http_client_start(const char *host, const char *port,
+                                         const char *method, const char *path,
+                                         const char *body, const char *headers[],
+                                         int flags);
+
+// Ведёт незавершённые запросы из массива (NULL-элементы пропускаются) до
+// завершения одного из них. Возвращает его индекс или -1, если наступил
+// deadline_ms (0 — ждать без ограничения) либо ждать нечего.
+int http_client_wait(http_client_request_t *const *requests, size_t count,
+                     unsigned long long deadline_ms);
+
+int http_client_status(const http_client_request_t *request);
+
+// Забирает сырой HTTP-ответ (освободить через http_free_response()).
+char *http_client_take_response(http_client_request_t *request);
+
+// Для HTTP_CLIENT_DECODE_BODY: код статуса (0, пока заголовки не пришли)
+// и декодированное тело, завершённое '\0' (освободить через http_free_response()).
+int http_client_http_status(const http_client_request_t *request);
+char *http_client_take_body(http_client_request_t *request, size_t *body_len);
+void http_client_free(http_client_request_t *request);
+
 // ===================== HTTP СЕРВЕР =====================
 
 typedef struct http_request_s {
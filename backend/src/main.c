@@ -14,6 +14,7 @@
 #include "libs/redis/redis.h"
 #include "modules/realtime/realtime_hub.h"
 #include "services/generation_job_service.h"
+#include "utils/json_arena.h"
 
 #define LISTEN_PORT 1234
 
@@ -59,12 +60,14 @@ int main(void)
 		/* Продолжаем без корректной обработки SIGINT, но предупредим */
 	}
 
+	/* Хуки cJSON ставятся до запуска любых потоков */
+	json_arena_init();
 	ollama_init();
 	redis_init();
 	rt_hub_init();
-	generation_job_service_init();
-	/* Инициализация db conninfo */
+	/* Инициализация db conninfo (до запуска воркеров задач) */
 	db_init_conninfo();
+	generation_job_service_init();
 
 	/* Инициализация маршрутов.
 	 * Внутри init_router() вы должны зарегистрировать все нужные пути:
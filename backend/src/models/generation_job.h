@@ -5,6 +5,7 @@
 
 #define GENERATION_JOB_STATE_QUEUED "queued"
 #define GENERATION_JOB_STATE_TOKENIZING "tokenizing"
+#define GENERATION_JOB_STATE_LEMMATIZING "lemmatizing"
 #define GENERATION_JOB_STATE_FILTERING_COMMON_WORDS "filtering_common_words"
 #define GENERATION_JOB_STATE_CHECKING_DATABASE "checking_database"
 #define GENERATION_JOB_STATE_GENERATING "generating"
@@ -27,6 +28,8 @@ typedef struct {
     char *transcription;
     char *translation;
     char *examples[2];
+    /* Словоформы леммы word из текста через ", " ("runs, running, ran"); "" — только сама лемма. */
+    char *forms;
 } generation_card_draft_t;
 
 typedef struct {
@@ -40,6 +43,7 @@ typedef struct {
     int existing_words;
     int generated_drafts;
     int reviewed_drafts;
+    int failed_words;
     generation_card_draft_t *drafts;
     size_t draft_count;
 } generation_job_t;
@@ -1,6 +1,7 @@
 #include "internal_api/card_api.h"
 
 #include "db/db.h"
+#include "modules/cards/known_words.h"
 
 int card_api_list_words(int user_id, Word **out_words, size_t *out_count)
 {
@@ -28,6 +29,7 @@ int card_api_add_word(const char *word, const char *transcription,
     if (db_add_word(word, transcription, translation, example, user_id) != 0) {
         return CARD_API_ERR_SERVER;
     }
+    known_words_add(user_id, word);
 
     return CARD_API_OK;
 }
@@ -55,6 +57,7 @@ int card_api_create(const card_api_create_input_t *input, int *out_card_id)
 
     switch (db_create_word(&db_input, out_card_id)) {
     case DB_OK:
+        known_words_add(input->user_id, input->word);
         return CARD_API_OK;
     case DB_ERR_INVALID_ARGUMENT:
         return CARD_API_ERR_INVALID_ARGUMENT;
@@ -65,12 +68,69 @@ int card_api_create(const card_api_create_input_t *input, int *out_card_id)
     }
 }
 
+int card_api_delete(const card_api_delete_input_t *input)
+{
+    db_word_delete_input_t db_input;
+
+    if (!input || input->user_id <= 0 || input->card_id <= 0) {
+        return CARD_API_ERR_INVALID_ARGUMENT;
+    }
+
+    db_input.user_id = input->user_id;
+    db_input.word_id = input->card_id;
+
+    switch (db_delete_word(&db_input)) {
+    case DB_OK:
+        known_words_note_delete(input->user_id);
+        return CARD_API_OK;
+    case DB_ERR_INVALID_ARGUMENT:
+        return CARD_API_ERR_INVALID_ARGUMENT;
+    case DB_ERR_NOT_FOUND:
+        return CARD_API_ERR_NOT_FOUND;
+    default:
+        return CARD_API_ERR_SERVER;
+    }
+}
+
 int card_api_exists(const card_api_exists_query_t *query, int *out_exists)
 {
+    int filter;
+
     if (!query || !out_exists || !query->word || query->user_id <= 0) {
         return CARD_API_ERR_INVALID_ARGUMENT;
     }
 
+    /* Большинство кандидатов у пользователя не сохранены: им БД не нужна. */
+    filter = known_words_check(query->user_id, query->word);
+    if (filter == KNOWN_WORDS_ABSENT) {
+        *out_exists = 0;
+        return CARD_API_OK;
+    }
+
     *out_exists = db_word_exists(query->word, query->user_id) ? 1 : 0;
+    if (filter == KNOWN_WORDS_MAYBE && !*out_exists) {
+        known_words_note_false_positive();
+    }
     return CARD_API_OK;
 }
+
+void card_api_get_known_words_stats(card_api_known_words_stats_t *out)
+{
+    known_words_stats_t stats;
+
+    if (!out) {
+        return;
+    }
+
+    known_words_get_stats(&stats);
+    out->users = stats.users;
+    out->bytes = stats.bytes;
+    out->memory_limit = stats.memory_limit;
+    out->absent = stats.absent;
+    out->maybe = stats.maybe;
+    out->unfiltered = stats.unfiltered;
+    out->false_positives = stats.false_positives;
+    out->builds = stats.builds;
+    out->build_failures = stats.build_failures;
+    out->evictions = stats.evictions;
+}
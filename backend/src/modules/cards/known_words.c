@@ -0,0 +1,378 @@
+#include "modules/cards/known_words.h"
+
+#include "db/db.h"
+#include "utils/hash.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KNOWN_WORDS_DEFAULT_MEMORY_MB 32
+#define KNOWN_WORDS_BUCKETS 4096
+/* 10 бит на слово и 7 хешей — около 1% ложных срабатываний. */
+#define KNOWN_WORDS_BITS_PER_WORD 10
+#define KNOWN_WORDS_HASHES 7
+#define KNOWN_WORDS_MIN_BITS 512
+
+/* Слово, созданное, пока фильтр строится из БД. */
+typedef struct known_words_pending_s {
+    struct known_words_pending_s *next;
+    char word[];
+} known_words_pending_t;
+
+typedef struct known_words_entry_s {
+    int user_id;
+    /*
+     * Фильтр строится из БД без блокировки: новые слова пользователя
+     * тем временем копятся в pending и добавляются при установке.
+     * Строящийся фильтр не вытесняется и не выбрасывается.
+     */
+    int building;
+    /* Слово не попало в pending (нет памяти): такой фильтр ставить нельзя. */
+    int lost_word;
+    uint64_t *bits;
+    size_t bit_mask;
+    size_t capacity;
+    size_t count;
+    size_t deleted;
+    size_t bytes;
+    known_words_pending_t *pending;
+    struct known_words_entry_s *hash_next;
+    struct known_words_entry_s *lru_prev;
+    struct known_words_entry_s *lru_next;
+} known_words_entry_t;
+
+static pthread_once_t g_known_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t g_known_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t g_memory_limit = (size_t) KNOWN_WORDS_DEFAULT_MEMORY_MB * 1024 * 1024;
+static known_words_entry_t *g_buckets[KNOWN_WORDS_BUCKETS];
+/* Голова — самая свежая проверка, хвост вытесняется первым. */
+static known_words_entry_t *g_lru_head = NULL;
+static known_words_entry_t *g_lru_tail = NULL;
+static known_words_stats_t g_stats;
+
+static void known_words_init_once(void)
+{
+    const char *value = getenv("KNOWN_WORDS_MEMORY_MB");
+    char *endptr;
+    long parsed;
+
+    if (!value || value[0] == '\0') {
+        return;
+    }
+
+    parsed = strtol(value, &endptr, 10);
+    if (*endptr != '\0' || parsed < 0 || parsed > 64 * 1024) {
+        return;
+    }
+
+    g_memory_limit = (size_t) parsed * 1024 * 1024;
+}
+
+static known_words_entry_t **known_words_slot(int user_id)
+{
+    known_words_entry_t **slot = &g_buckets[(unsigned) user_id % KNOWN_WORDS_BUCKETS];
+
+    while (*slot && (*slot)->user_id != user_id) {
+        slot = &(*slot)->hash_next;
+    }
+    return slot;
+}
+
+static void known_words_lru_unlink(known_words_entry_t *entry)
+{
+    if (entry->lru_prev) {
+        entry->lru_prev->lru_next = entry->lru_next;
+    } else {
+        g_lru_head = entry->lru_next;
+    }
+    if (entry->lru_next) {
+        entry->lru_next->lru_prev = entry->lru_prev;
+    } else {
+        g_lru_tail = entry->lru_prev;
+    }
+    entry->lru_prev = NULL;
+    entry->lru_next = NULL;
+}
+
+static void known_words_lru_push(known_words_entry_t *entry)
+{
+    entry->lru_prev = NULL;
+    entry->lru_next = g_lru_head;
+    if (g_lru_head) {
+        g_lru_head->lru_prev = entry;
+    } else {
+        g_lru_tail = entry;
+    }
+    g_lru_head = entry;
+}
+
+static void known_words_free_entry(known_words_entry_t *entry)
+{
+    while (entry->pending) {
+        known_words_pending_t *next = entry->pending->next;
+
+        free(entry->pending);
+        entry->pending = next;
+    }
+    free(entry->bits);
+    free(entry);
+}
+
+/* Убирает фильтр из таблицы и освобождает его. Под g_known_lock. */
+static void known_words_drop_locked(known_words_entry_t *entry)
+{
+    known_words_entry_t **slot = known_words_slot(entry->user_id);
+
+    *slot = entry->hash_next;
+    if (!entry->building) {
+        known_words_lru_unlink(entry);
+        g_stats.users--;
+        g_stats.bytes -= entry->bytes;
+    }
+    known_words_free_entry(entry);
+}
+
+static void known_words_hash_pair(const char *word, uint32_t *h1, uint32_t *h2)
+{
+    uint64_t h = hash_xxh64(word, strlen(word), 0);
+
+    *h1 = (uint32_t) h;
+    /* Нечётный шаг обходит все позиции таблицы размером 2^k. */
+    *h2 = (uint32_t) (h >> 32) | 1u;
+}
+
+static void known_words_set(uint64_t *bits, size_t bit_mask, const char *word)
+{
+    uint32_t h1;
+    uint32_t h2;
+
+    known_words_hash_pair(word, &h1, &h2);
+    for (uint32_t i = 0; i < KNOWN_WORDS_HASHES; i++) {
+        size_t bit = (size_t) (h1 + i * h2) & bit_mask;
+
+        bits[bit >> 6] |= 1ULL << (bit & 63);
+    }
+}
+
+static int known_words_test(const uint64_t *bits, size_t bit_mask, const char *word)
+{
+    uint32_t h1;
+    uint32_t h2;
+
+    known_words_hash_pair(word, &h1, &h2);
+    for (uint32_t i = 0; i < KNOWN_WORDS_HASHES; i++) {
+        size_t bit = (size_t) (h1 + i * h2) & bit_mask;
+
+        if (!(bits[bit >> 6] & (1ULL << (bit & 63)))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * Строит фильтр для уже вставленной заглушки entry (building = 1) и
+ * ставит его в таблицу; при неудаче заглушка убирается. Вызывается без
+ * блокировки.
+ */
+static void known_words_build(known_words_entry_t *entry)
+{
+    char **words = NULL;
+    size_t count = 0;
+    size_t capacity;
+    size_t nbits = KNOWN_WORDS_MIN_BITS;
+    size_t bytes;
+    uint64_t *bits = NULL;
+    int db_rc;
+
+    db_rc = db_get_user_word_keys(entry->user_id, &words, &count);
+    if (db_rc == DB_OK) {
+        /* Запас в половину: новые карточки дописываются без перестройки. */
+        capacity = count + count / 2 + 64;
+        while (nbits < capacity * KNOWN_WORDS_BITS_PER_WORD) {
+            nbits <<= 1;
+        }
+        bits = calloc(nbits / 64, sizeof(*bits));
+        if (bits) {
+            for (size_t i = 0; i < count; i++) {
+                known_words_set(bits, nbits - 1, words[i]);
+            }
+        }
+    }
+    free(words);
+    bytes = sizeof(*entry) + nbits / 8;
+
+    pthread_mutex_lock(&g_known_lock);
+    if (!bits || entry->lost_word || bytes > g_memory_limit) {
+        if (!bits || entry->lost_word) {
+            g_stats.build_failures++;
+        }
+        known_words_drop_locked(entry);
+        pthread_mutex_unlock(&g_known_lock);
+        free(bits);
+        return;
+    }
+
+    while (entry->pending) {
+        known_words_pending_t *next = entry->pending->next;
+
+        known_words_set(bits, nbits - 1, entry->pending->word);
+        count++;
+        free(entry->pending);
+        entry->pending = next;
+    }
+    while (g_lru_tail && g_stats.bytes + bytes > g_memory_limit) {
+        known_words_drop_locked(g_lru_tail);
+        g_stats.evictions++;
+    }
+
+    entry->bits = bits;
+    entry->bit_mask = nbits - 1;
+    entry->capacity = capacity;
+    entry->count = count;
+    entry->bytes = bytes;
+    entry->building = 0;
+    known_words_lru_push(entry);
+    g_stats.users++;
+    g_stats.bytes += bytes;
+    g_stats.builds++;
+    pthread_mutex_unlock(&g_known_lock);
+}
+
+int known_words_check(int user_id, const char *word)
+{
+    known_words_entry_t *entry;
+    int result = KNOWN_WORDS_UNKNOWN;
+
+    if (user_id <= 0 || !word) {
+        return KNOWN_WORDS_UNKNOWN;
+    }
+
+    pthread_once(&g_known_once, known_words_init_once);
+    if (g_memory_limit == 0) {
+        return KNOWN_WORDS_UNKNOWN;
+    }
+
+    pthread_mutex_lock(&g_known_lock);
+    entry = *known_words_slot(user_id);
+    if (!entry) {
+        entry = calloc(1, sizeof(*entry));
+        if (!entry) {
+            g_stats.unfiltered++;
+            pthread_mutex_unlock(&g_known_lock);
+            return KNOWN_WORDS_UNKNOWN;
+        }
+        entry->user_id = user_id;
+        entry->building = 1;
+        entry->hash_next = g_buckets[(unsigned) user_id % KNOWN_WORDS_BUCKETS];
+        g_buckets[(unsigned) user_id % KNOWN_WORDS_BUCKETS] = entry;
+        pthread_mutex_unlock(&g_known_lock);
+
+        known_words_build(entry);
+        pthread_mutex_lock(&g_known_lock);
+        /* Фильтр мог не построиться или уже быть вытесненным чужой сборкой. */
+        entry = *known_words_slot(user_id);
+    }
+
+    if (entry && !entry->building) {
+        result = known_words_test(entry->bits, entry->bit_mask, word) ?
+                 KNOWN_WORDS_MAYBE : KNOWN_WORDS_ABSENT;
+        if (g_lru_head != entry) {
+            known_words_lru_unlink(entry);
+            known_words_lru_push(entry);
+        }
+    }
+    if (result == KNOWN_WORDS_ABSENT) {
+        g_stats.absent++;
+    } else if (result == KNOWN_WORDS_MAYBE) {
+        g_stats.maybe++;
+    } else {
+        g_stats.unfiltered++;
+    }
+    pthread_mutex_unlock(&g_known_lock);
+    return result;
+}
+
+void known_words_add(int user_id, const char *word)
+{
+    known_words_entry_t *entry;
+
+    if (user_id <= 0 || !word) {
+        return;
+    }
+
+    pthread_once(&g_known_once, known_words_init_once);
+    if (g_memory_limit == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_known_lock);
+    entry = *known_words_slot(user_id);
+    if (!entry) {
+        /* Фильтра нет — слово попадёт в него при сборке из БД. */
+    } else if (entry->building) {
+        size_t len = strlen(word);
+        known_words_pending_t *pending = malloc(sizeof(*pending) + len + 1);
+
+        if (pending) {
+            memcpy(pending->word, word, len + 1);
+            pending->next = entry->pending;
+            entry->pending = pending;
+        } else {
+            entry->lost_word = 1;
+        }
+    } else {
+        known_words_set(entry->bits, entry->bit_mask, word);
+        entry->count++;
+        /* Сверх расчёта ложных срабатываний становится больше: перестроить. */
+        if (entry->count > entry->capacity) {
+            known_words_drop_locked(entry);
+        }
+    }
+    pthread_mutex_unlock(&g_known_lock);
+}
+
+void known_words_note_delete(int user_id)
+{
+    known_words_entry_t *entry;
+
+    if (user_id <= 0) {
+        return;
+    }
+
+    pthread_once(&g_known_once, known_words_init_once);
+
+    pthread_mutex_lock(&g_known_lock);
+    entry = *known_words_slot(user_id);
+    if (entry && !entry->building) {
+        entry->deleted++;
+        /* Каждое удалённое слово — лишний MAYBE; четверть таких — перестроить. */
+        if (entry->deleted * 4 > entry->count + 64) {
+            known_words_drop_locked(entry);
+        }
+    }
+    pthread_mutex_unlock(&g_known_lock);
+}
+
+void known_words_note_false_positive(void)
+{
+    pthread_mutex_lock(&g_known_lock);
+    g_stats.false_positives++;
+    pthread_mutex_unlock(&g_known_lock);
+}
+
+void known_words_get_stats(known_words_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+
+    pthread_once(&g_known_once, known_words_init_once);
+
+    pthread_mutex_lock(&g_known_lock);
+    *out = g_stats;
+    out->memory_limit = g_memory_limit;
+    pthread_mutex_unlock(&g_known_lock);
+}
@@ -0,0 +1,48 @@
+#ifndef KNOWN_WORDS_H
+#define KNOWN_WORDS_H
+
+#include <stddef.h>
+
+enum {
+    KNOWN_WORDS_ABSENT = 0,  /* слова у пользователя точно нет */
+    KNOWN_WORDS_MAYBE = 1,   /* фильтр говорит "возможно есть": решает БД */
+    KNOWN_WORDS_UNKNOWN = 2  /* фильтра нет (выключен, строится, ошибка БД) */
+};
+
+typedef struct {
+    size_t users;
+    size_t bytes;
+    size_t memory_limit;
+    unsigned long long absent;
+    unsigned long long maybe;
+    unsigned long long unfiltered;
+    unsigned long long false_positives;
+    unsigned long long builds;
+    unsigned long long build_failures;
+    unsigned long long evictions;
+} known_words_stats_t;
+
+/*
+ * Фильтры Блума слов из карточек пользователей (таблица words), чтобы
+ * проверять кандидатов генерации без запроса к БД: ответ ABSENT точен,
+ * MAYBE и UNKNOWN проверяются в БД.
+ *
+ * Фильтр пользователя строится из БД при первой проверке и дальше
+ * обновляется: create дописывает слово, delete только учитывается —
+ * из фильтра Блума не удалить, а лишний бит даёт лишь проверку в БД.
+ * Когда удалённых или дописанных сверх расчёта слов становится много,
+ * фильтр выбрасывается и при следующей проверке строится заново.
+ *
+ * Память ограничена KNOWN_WORDS_MEMORY_MB (0 — фильтры выключены);
+ * при нехватке вытесняются давно не проверявшиеся пользователи (LRU).
+ * Все функции потокобезопасны.
+ */
+int known_words_check(int user_id, const char *word);
+void known_words_add(int user_id, const char *word);
+void known_words_note_delete(int user_id);
+/* БД не подтвердила ответ MAYBE — для статистики ложных срабатываний. */
+void known_words_note_false_positive(void);
+
+void known_words_get_stats(known_words_stats_t *out);
+
+#endif
@@ -0,0 +1,55 @@
+#include "internal_api/generation_job_api.h"
+
+#include "db/db.h"
+
+static int generation_job_api_map_db_rc(int db_rc)
+{
+    switch (db_rc) {
+    case DB_OK:
+        return GENERATION_JOB_API_OK;
+    case DB_ERR_INVALID_ARGUMENT:
+        return GENERATION_JOB_API_ERR_INVALID_ARGUMENT;
+    default:
+        return GENERATION_JOB_API_ERR_SERVER;
+    }
+}
+
+int generation_job_api_save(const generation_job_t *jobs, size_t job_count,
+                            const generation_card_draft_t *drafts, size_t draft_count)
+{
+    return generation_job_api_map_db_rc(db_generation_jobs_save(jobs, job_count, drafts, draft_count));
+}
+
+int generation_job_api_load_unfinished(generation_job_t **out_jobs, size_t *out_count)
+{
+    if (!out_jobs || !out_count) {
+        return GENERATION_JOB_API_ERR_INVALID_ARGUMENT;
+    }
+
+    return generation_job_api_map_db_rc(db_generation_jobs_load_unfinished(out_jobs, out_count));
+}
+
+void generation_job_api_free_jobs(generation_job_t *jobs, size_t count)
+{
+    db_free_generation_jobs(jobs, count);
+}
+
+int generation_job_api_next_ids(int *out_job_id, int *out_draft_id)
+{
+    int max_job_id = 0;
+    int max_draft_id = 0;
+    int rc;
+
+    if (!out_job_id || !out_draft_id) {
+        return GENERATION_JOB_API_ERR_INVALID_ARGUMENT;
+    }
+
+    rc = db_generation_jobs_max_ids(&max_job_id, &max_draft_id);
+    if (rc != DB_OK) {
+        return generation_job_api_map_db_rc(rc);
+    }
+
+    *out_job_id = max_job_id + 1;
+    *out_draft_id = max_draft_id + 1;
+    return GENERATION_JOB_API_OK;
+}
@@ -1,10 +1,77 @@
 #include "internal_api/llm_api.h"
 
+#include "db/db.h"
+#include "libs/http.h"
+#include "modules/llm/llm_scheduler.h"
 #include "ollama/ollama.h"
+#include "ollama/ollama_backends.h"
 
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 
+/*
+ * Single-flight: одновременные запросы одного и того же слова
+ * сводятся к одному вызову generate_word_card(). Первый вызвавший
+ * (leader) идёт в upstream, остальные ждут на cond и получают копию
+ * того же результата.
+ */
+typedef struct llm_inflight_s {
+    char *word;
+    int done;
+    int rc;
+    int refs;
+    llm_api_word_card_t card;
+    pthread_cond_t cond;
+    struct llm_inflight_s *next;
+} llm_inflight_t;
+
+static pthread_mutex_t g_inflight_lock = PTHREAD_MUTEX_INITIALIZER;
+static llm_inflight_t *g_inflight = NULL;
+
+#define LLM_DEFAULT_REQUEST_TIMEOUT_MS 60000
+#define LLM_DEFAULT_BATCH_TIMEOUT_MS 180000
+
+static pthread_once_t g_config_once = PTHREAD_ONCE_INIT;
+static unsigned long long g_request_timeout_ms = LLM_DEFAULT_REQUEST_TIMEOUT_MS;
+static unsigned long long g_batch_timeout_ms = LLM_DEFAULT_BATCH_TIMEOUT_MS;
+
+/*
+ * Общий кэш готовых карточек (card_cache, наполняется bin/cardwarm):
+ * найденное там слово в модель не отправляется. LLM_CARD_CACHE=0 отключает.
+ */
+static int g_card_cache_enabled = 1;
+static pthread_mutex_t g_cache_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long long g_cache_hits = 0;
+static unsigned long long g_cache_misses = 0;
+
+static unsigned long long llm_env_ms(const char *name, unsigned long long fallback)
+{
+    const char *value = getenv(name);
+    char *endptr;
+    long long parsed;
+
+    if (!value || value[0] == '\0') {
+        return fallback;
+    }
+
+    parsed = strtoll(value, &endptr, 10);
+    if (*endptr != '\0' || parsed <= 0) {
+        return fallback;
+    }
+
+    return (unsigned long long) parsed;
+}
+
+static void llm_config_init(void)
+{
+    const char *cache = getenv("LLM_CARD_CACHE");
+
+    g_request_timeout_ms = llm_env_ms("LLM_REQUEST_TIMEOUT_MS", LLM_DEFAULT_REQUEST_TIMEOUT_MS);
+    g_batch_timeout_ms = llm_env_ms("LLM_BATCH_TIMEOUT_MS", LLM_DEFAULT_BATCH_TIMEOUT_MS);
+    g_card_cache_enabled = !(cache && strcmp(cache, "0") == 0);
+}
+
 static char *llm_strdup(const char *value)
 {
     if (!value) {
@@ -29,51 +96,518 @@ void llm_api_free_word_card(llm_api_word_card_t *card)
         return;
     }
 
-    free(card->word);
-    free(card->translation);
-    free(card->transcription);
+    if (card->storage) {
+        free(card->storage);
+    } else {
+        free(card->word);
+        free(card->translation);
+        free(card->transcription);
+        for (i = 0; i < LLM_API_EXAMPLE_COUNT; ++i) {
+            free(card->examples[i]);
+        }
+    }
+
+    memset(card, 0, sizeof(*card));
+}
+
+/*
+ * Копия карточки одной аллокацией — для waiters single-flight.
+ */
+static int llm_copy_word_card(const llm_api_word_card_t *src, llm_api_word_card_t *dst)
+{
+    const char *fields[3 + LLM_API_EXAMPLE_COUNT];
+    char **targets[3 + LLM_API_EXAMPLE_COUNT];
+    size_t total = 0;
+    size_t used = 0;
+    size_t i;
+
+    memset(dst, 0, sizeof(*dst));
 
+    fields[0] = src->word;
+    fields[1] = src->translation;
+    fields[2] = src->transcription;
+    targets[0] = &dst->word;
+    targets[1] = &dst->translation;
+    targets[2] = &dst->transcription;
     for (i = 0; i < LLM_API_EXAMPLE_COUNT; ++i) {
-        free(card->examples[i]);
-        card->examples[i] = NULL;
+        fields[3 + i] = src->examples[i];
+        targets[3 + i] = &dst->examples[i];
+    }
+
+    for (i = 0; i < 3 + LLM_API_EXAMPLE_COUNT; ++i) {
+        total += strlen(fields[i] ? fields[i] : "") + 1;
     }
 
-    card->word = NULL;
-    card->translation = NULL;
-    card->transcription = NULL;
+    dst->storage = malloc(total);
+    if (!dst->storage) {
+        return LLM_API_ERR_SERVER;
+    }
+
+    for (i = 0; i < 3 + LLM_API_EXAMPLE_COUNT; ++i) {
+        const char *value = fields[i] ? fields[i] : "";
+        size_t len = strlen(value) + 1;
+
+        memcpy(dst->storage + used, value, len);
+        *targets[i] = dst->storage + used;
+        used += len;
+    }
+
+    return LLM_API_OK;
 }
 
-int llm_api_generate_word_card(const char *word, llm_api_word_card_t *out_card)
+/*
+ * Забирает строки сгенерированной карточки без копирования:
+ * хранилище word_card_t переходит к out_card.
+ */
+static int llm_card_take_generated(word_card_t *generated, llm_api_word_card_t *out_card)
 {
-    word_card_t *generated;
     int i;
 
-    if (!word || !out_card || word[0] == '\0') {
-        return LLM_API_ERR_INVALID_ARGUMENT;
+    if (!generated->storage) {
+        llm_api_word_card_t view;
+
+        view.word = generated->word;
+        view.translation = generated->translation;
+        view.transcription = generated->transcription;
+        for (i = 0; i < LLM_API_EXAMPLE_COUNT; ++i) {
+            view.examples[i] = generated->examples[i];
+        }
+        view.storage = NULL;
+        return llm_copy_word_card(&view, out_card);
     }
 
-    memset(out_card, 0, sizeof(*out_card));
+    out_card->word = generated->word;
+    out_card->translation = generated->translation;
+    out_card->transcription = generated->transcription;
+    for (i = 0; i < LLM_API_EXAMPLE_COUNT; ++i) {
+        out_card->examples[i] = generated->examples[i];
+    }
+    out_card->storage = generated->storage;
+
+    memset(generated, 0, sizeof(*generated));
+    return LLM_API_OK;
+}
 
-    generated = generate_word_card(word);
+static void llm_options_resolve(const llm_api_request_options_t *options,
+                                int *user_id, int *priority,
+                                unsigned long long *deadline_ms)
+{
+    *user_id = options ? options->user_id : 0;
+    *priority = options && options->priority == LLM_API_PRIORITY_BATCH
+                    ? LLM_SCHEDULER_PRIORITY_BATCH
+                    : LLM_SCHEDULER_PRIORITY_INTERACTIVE;
+
+    if (options && options->deadline_ms) {
+        *deadline_ms = options->deadline_ms;
+        return;
+    }
+
+    pthread_once(&g_config_once, llm_config_init);
+    *deadline_ms = http_now_ms() + (*priority == LLM_SCHEDULER_PRIORITY_BATCH
+                                        ? g_batch_timeout_ms
+                                        : g_request_timeout_ms);
+}
+
+static int llm_generate_upstream(const char *word,
+                                 const llm_api_request_options_t *options,
+                                 llm_api_word_card_t *out_card)
+{
+    word_card_t *generated;
+    unsigned long long deadline_ms;
+    int user_id;
+    int priority;
+    int rc;
+
+    llm_options_resolve(options, &user_id, &priority, &deadline_ms);
+    rc = llm_scheduler_acquire(user_id, priority, 1, deadline_ms);
+    if (rc != LLM_SCHEDULER_OK) {
+        return rc == LLM_SCHEDULER_ERR_TIMEOUT ? LLM_API_ERR_UPSTREAM : LLM_API_ERR_SERVER;
+    }
+    generated = generate_word_card(word, deadline_ms);
+    llm_scheduler_release();
     if (!generated) {
         return LLM_API_ERR_UPSTREAM;
     }
 
-    out_card->word = llm_strdup(generated->word ? generated->word : "");
-    out_card->translation = llm_strdup(generated->translation ? generated->translation : "");
-    out_card->transcription = llm_strdup(generated->transcription ? generated->transcription : "");
+    rc = llm_card_take_generated(generated, out_card);
+    free_word_card(generated);
+    return rc;
+}
 
-    for (i = 0; i < LLM_API_EXAMPLE_COUNT; ++i) {
-        out_card->examples[i] = llm_strdup(generated->examples[i] ? generated->examples[i] : "");
+/* Переносит карточку из card_cache в out_card и освобождает cached. */
+static int llm_cache_take(Word *cached, llm_api_word_card_t *out_card)
+{
+    llm_api_word_card_t view;
+    int rc;
+
+    view.word = cached->word;
+    view.translation = cached->translation;
+    view.transcription = cached->transcription;
+    view.examples[0] = cached->example_1;
+    view.examples[1] = cached->example_2;
+    view.storage = NULL;
+    rc = llm_copy_word_card(&view, out_card);
+    db_free_word(cached);
+    return rc;
+}
+
+static void llm_cache_count(unsigned long long hits, unsigned long long misses)
+{
+    pthread_mutex_lock(&g_cache_stats_lock);
+    g_cache_hits += hits;
+    g_cache_misses += misses;
+    pthread_mutex_unlock(&g_cache_stats_lock);
+}
+
+/*
+ * Ищет слово в card_cache. LLM_API_OK — out_card заполнена одной
+ * аллокацией; любой другой код — идти в модель.
+ */
+static int llm_cache_lookup(const char *word, llm_api_word_card_t *out_card)
+{
+    Word cached;
+    int rc;
+
+    pthread_once(&g_config_once, llm_config_init);
+    if (!g_card_cache_enabled) {
+        return LLM_API_ERR_UPSTREAM;
     }
 
-    free_word_card(generated);
+    rc = db_card_cache_get(word, &cached);
+    if (rc == DB_OK) {
+        rc = llm_cache_take(&cached, out_card);
+    } else {
+        rc = LLM_API_ERR_UPSTREAM;
+    }
+
+    llm_cache_count(rc == LLM_API_OK, rc != LLM_API_OK);
+    return rc;
+}
+
+/*
+ * То же для пачки одним запросом к БД: out_results[i] = LLM_API_OK и
+ * out_cards[i] заполнена для найденных слов, у остальных — код ошибки.
+ */
+static void llm_cache_lookup_many(const char *const *words, size_t count,
+                                  llm_api_word_card_t *out_cards, int *out_results)
+{
+    Word *cached = NULL;
+    int *found = NULL;
+    unsigned long long hits = 0;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        out_results[i] = LLM_API_ERR_UPSTREAM;
+    }
+
+    pthread_once(&g_config_once, llm_config_init);
+    if (!g_card_cache_enabled) {
+        return;
+    }
+
+    cached = calloc(count, sizeof(*cached));
+    found = calloc(count, sizeof(*found));
+    if (!cached || !found || db_card_cache_get_many(words, count, cached, found) != DB_OK) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (!found[i]) {
+            continue;
+        }
+        out_results[i] = llm_cache_take(&cached[i], &out_cards[i]);
+        if (out_results[i] == LLM_API_OK) {
+            hits++;
+        }
+    }
+
+cleanup:
+    llm_cache_count(hits, count - hits);
+    free(cached);
+    free(found);
+}
 
-    if (!out_card->word || !out_card->translation || !out_card->transcription ||
-        !out_card->examples[0] || !out_card->examples[1]) {
-        llm_api_free_word_card(out_card);
+static llm_inflight_t *llm_inflight_find(const char *word)
+{
+    llm_inflight_t *entry;
+
+    for (entry = g_inflight; entry; entry = entry->next) {
+        if (strcmp(entry->word, word) == 0) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static void llm_inflight_unlink(llm_inflight_t *target)
+{
+    llm_inflight_t **link = &g_inflight;
+
+    while (*link) {
+        if (*link == target) {
+            *link = target->next;
+            target->next = NULL;
+            return;
+        }
+        link = &(*link)->next;
+    }
+}
+
+static void llm_inflight_free(llm_inflight_t *entry)
+{
+    llm_api_free_word_card(&entry->card);
+    pthread_cond_destroy(&entry->cond);
+    free(entry->word);
+    free(entry);
+}
+
+/*
+ * Забирает результат завершённого in-flight запроса и отпускает ссылку.
+ * Вызывается под g_inflight_lock.
+ */
+static int llm_inflight_release(llm_inflight_t *entry, llm_api_word_card_t *out_card)
+{
+    int rc = entry->rc;
+
+    entry->refs--;
+    if (rc == LLM_API_OK) {
+        if (entry->refs == 0) {
+            /* Последний получатель забирает карточку без копии. */
+            *out_card = entry->card;
+            memset(&entry->card, 0, sizeof(entry->card));
+        } else {
+            rc = llm_copy_word_card(&entry->card, out_card);
+        }
+    }
+
+    if (entry->refs == 0) {
+        llm_inflight_free(entry);
+    }
+
+    return rc;
+}
+
+static int llm_generate_shared(const char *word,
+                               const llm_api_request_options_t *options,
+                               llm_api_word_card_t *out_card)
+{
+    llm_inflight_t *entry;
+    int rc;
+
+    pthread_mutex_lock(&g_inflight_lock);
+
+    entry = llm_inflight_find(word);
+    if (entry) {
+        entry->refs++;
+        while (!entry->done) {
+            pthread_cond_wait(&entry->cond, &g_inflight_lock);
+        }
+        rc = llm_inflight_release(entry, out_card);
+        pthread_mutex_unlock(&g_inflight_lock);
+        return rc;
+    }
+
+    entry = calloc(1, sizeof(*entry));
+    if (!entry) {
+        pthread_mutex_unlock(&g_inflight_lock);
+        return LLM_API_ERR_SERVER;
+    }
+    entry->word = llm_strdup(word);
+    if (!entry->word || pthread_cond_init(&entry->cond, NULL) != 0) {
+        free(entry->word);
+        free(entry);
+        pthread_mutex_unlock(&g_inflight_lock);
         return LLM_API_ERR_SERVER;
     }
+    entry->refs = 1;
+    entry->next = g_inflight;
+    g_inflight = entry;
 
-    return LLM_API_OK;
+    pthread_mutex_unlock(&g_inflight_lock);
+
+    rc = llm_generate_upstream(word, options, &entry->card);
+
+    pthread_mutex_lock(&g_inflight_lock);
+    entry->rc = rc;
+    entry->done = 1;
+    llm_inflight_unlink(entry);
+    pthread_cond_broadcast(&entry->cond);
+    rc = llm_inflight_release(entry, out_card);
+    pthread_mutex_unlock(&g_inflight_lock);
+
+    return rc;
+}
+
+int llm_api_generate_word_card(const char *word,
+                               const llm_api_request_options_t *options,
+                               llm_api_word_card_t *out_card)
+{
+    if (!word || !out_card || word[0] == '\0') {
+        return LLM_API_ERR_INVALID_ARGUMENT;
+    }
+
+    memset(out_card, 0, sizeof(*out_card));
+
+    if (llm_cache_lookup(word, out_card) == LLM_API_OK) {
+        return LLM_API_OK;
+    }
+
+    return llm_generate_shared(word, options, out_card);
+}
+
+int llm_api_generate_word_cards(const char *const *words, size_t count,
+                                const llm_api_request_options_t *options,
+                                llm_api_word_card_t *out_cards, int *out_results)
+{
+    word_card_t **generated = NULL;
+    const char **pending = NULL;
+    size_t *slots = NULL;
+    size_t pending_count = 0;
+    llm_api_request_options_t retry_options;
+    unsigned long long deadline_ms;
+    size_t i;
+    int user_id;
+    int priority;
+    int parsed = 0;
+    int rc;
+
+    if (!words || !out_cards || !out_results || count == 0) {
+        return LLM_API_ERR_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < count; i++) {
+        memset(&out_cards[i], 0, sizeof(out_cards[i]));
+        out_results[i] = LLM_API_ERR_UPSTREAM;
+        if (!words[i] || words[i][0] == '\0') {
+            return LLM_API_ERR_INVALID_ARGUMENT;
+        }
+    }
+
+    generated = calloc(count, sizeof(*generated));
+    pending = calloc(count, sizeof(*pending));
+    slots = calloc(count, sizeof(*slots));
+    if (!generated || !pending || !slots) {
+        rc = LLM_API_ERR_SERVER;
+        goto cleanup;
+    }
+
+    /* Слова из card_cache в модель не уходят. */
+    llm_cache_lookup_many(words, count, out_cards, out_results);
+    for (i = 0; i < count; i++) {
+        if (out_results[i] != LLM_API_OK) {
+            pending[pending_count] = words[i];
+            slots[pending_count] = i;
+            pending_count++;
+        }
+    }
+
+    rc = LLM_API_OK;
+    if (pending_count == 0) {
+        goto cleanup;
+    }
+    if (pending_count == 1) {
+        out_results[slots[0]] = llm_generate_shared(pending[0], options, &out_cards[slots[0]]);
+        goto cleanup;
+    }
+
+    llm_options_resolve(options, &user_id, &priority, &deadline_ms);
+    rc = llm_scheduler_acquire(user_id, priority, (int) pending_count, deadline_ms);
+    if (rc != LLM_SCHEDULER_OK && rc != LLM_SCHEDULER_ERR_TIMEOUT) {
+        rc = LLM_API_ERR_SERVER;
+        goto cleanup;
+    }
+    if (rc == LLM_SCHEDULER_OK) {
+        parsed = generate_word_cards(pending, pending_count, generated, deadline_ms);
+        llm_scheduler_release();
+    }
+    rc = LLM_API_OK;
+
+    if (parsed > 0) {
+        for (i = 0; i < pending_count; i++) {
+            if (generated[i]) {
+                out_results[slots[i]] = llm_card_take_generated(generated[i], &out_cards[slots[i]]);
+            }
+        }
+    }
+
+    /* Повторы по одному укладываются в тот же дедлайн, что и пачка. */
+    retry_options.user_id = user_id;
+    retry_options.priority = options ? options->priority : LLM_API_PRIORITY_INTERACTIVE;
+    retry_options.deadline_ms = deadline_ms;
+
+    for (i = 0; i < pending_count; i++) {
+        size_t slot = slots[i];
+
+        if (out_results[slot] != LLM_API_OK && http_now_ms() < deadline_ms) {
+            out_results[slot] = llm_generate_shared(pending[i], &retry_options, &out_cards[slot]);
+        }
+    }
+
+cleanup:
+    if (generated) {
+        for (i = 0; i < count; i++) {
+            free_word_card(generated[i]);
+        }
+    }
+    free(generated);
+    free(pending);
+    free(slots);
+    return rc;
+}
+
+void llm_api_get_metrics(llm_api_metrics_t *out)
+{
+    llm_scheduler_stats_t stats;
+    ollama_backends_stats_t upstream;
+    ollama_backend_t backends[OLLAMA_MAX_BACKENDS];
+    size_t backend_count;
+    size_t i;
+
+    if (!out) {
+        return;
+    }
+
+    llm_scheduler_get_stats(&stats);
+    ollama_backends_get_stats(&upstream);
+    backend_count = ollama_backends_snapshot(backends, OLLAMA_MAX_BACKENDS);
+
+    memset(out, 0, sizeof(*out));
+    out->max_concurrency = stats.max_concurrency;
+    out->in_flight = stats.in_flight;
+    out->queued_interactive = stats.queued[LLM_SCHEDULER_PRIORITY_INTERACTIVE];
+    out->queued_batch = stats.queued[LLM_SCHEDULER_PRIORITY_BATCH];
+    out->active_users = stats.active_users;
+    out->granted_interactive = stats.granted[LLM_SCHEDULER_PRIORITY_INTERACTIVE];
+    out->granted_batch = stats.granted[LLM_SCHEDULER_PRIORITY_BATCH];
+    out->wait_ms_total_interactive = stats.wait_ms_total[LLM_SCHEDULER_PRIORITY_INTERACTIVE];
+    out->wait_ms_total_batch = stats.wait_ms_total[LLM_SCHEDULER_PRIORITY_BATCH];
+    out->wait_ms_max_interactive = stats.wait_ms_max[LLM_SCHEDULER_PRIORITY_INTERACTIVE];
+    out->wait_ms_max_batch = stats.wait_ms_max[LLM_SCHEDULER_PRIORITY_BATCH];
+    out->queue_timeouts_interactive = stats.timed_out[LLM_SCHEDULER_PRIORITY_INTERACTIVE];
+    out->queue_timeouts_batch = stats.timed_out[LLM_SCHEDULER_PRIORITY_BATCH];
+    out->upstream_timeouts = upstream.timeouts;
+    out->hedges = upstream.hedges;
+    out->hedge_wins = upstream.hedge_wins;
+    out->card_repairs = upstream.repairs;
+    out->card_repairs_failed = upstream.repairs_failed;
+
+    pthread_mutex_lock(&g_cache_stats_lock);
+    out->card_cache_hits = g_cache_hits;
+    out->card_cache_misses = g_cache_misses;
+    pthread_mutex_unlock(&g_cache_stats_lock);
+
+    for (i = 0; i < backend_count && i < LLM_API_MAX_BACKENDS; i++) {
+        llm_api_backend_metrics_t *dst = &out->backends[i];
+
+        memcpy(dst->host, backends[i].host, sizeof(dst->host));
+        memcpy(dst->port, backends[i].port, sizeof(dst->port));
+        dst->max_in_flight = backends[i].max_in_flight;
+        dst->in_flight = backends[i].in_flight;
+        dst->healthy = backends[i].healthy;
+        dst->requests = backends[i].requests;
+        dst->failures = backends[i].failures;
+        dst->latency_p95_ms = ollama_backend_p95_ms(&backends[i]);
+    }
+    out->backend_count = i;
 }
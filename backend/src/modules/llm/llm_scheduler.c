@@ -0,0 +1,364 @@
+#include "modules/llm/llm_scheduler.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LLM_SCHEDULER_DEFAULT_CONCURRENCY 4
+#define LLM_SCHEDULER_DEFAULT_QUANTUM 8
+
+struct llm_flow_s;
+
+typedef struct llm_ticket_s {
+    int cost;
+    int granted;
+    unsigned long long enqueued_ms;
+    pthread_cond_t cond;
+    struct llm_flow_s *flow;
+    struct llm_ticket_s *next;
+} llm_ticket_t;
+
+typedef struct {
+    llm_ticket_t *head;
+    llm_ticket_t *tail;
+} llm_ticket_queue_t;
+
+/* Очередь пакетных запросов одного пользователя. */
+typedef struct llm_flow_s {
+    int user_id;
+    int deficit;
+    int quantum_added;
+    llm_ticket_queue_t queue;
+    struct llm_flow_s *next;
+} llm_flow_t;
+
+static pthread_once_t g_sched_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t g_sched_lock = PTHREAD_MUTEX_INITIALIZER;
+static int g_max_concurrency = LLM_SCHEDULER_DEFAULT_CONCURRENCY;
+static int g_quantum = LLM_SCHEDULER_DEFAULT_QUANTUM;
+static int g_in_flight = 0;
+static llm_ticket_queue_t g_interactive;
+/* Активные flow в порядке обхода round-robin; голова обслуживается первой. */
+static llm_flow_t *g_flows_head = NULL;
+static llm_flow_t *g_flows_tail = NULL;
+static llm_scheduler_stats_t g_stats;
+
+static int llm_scheduler_env_int(const char *name, int fallback)
+{
+    const char *value = getenv(name);
+    char *endptr;
+    long parsed;
+
+    if (!value || value[0] == '\0') {
+        return fallback;
+    }
+
+    parsed = strtol(value, &endptr, 10);
+    if (*endptr != '\0' || parsed <= 0 || parsed > 1024) {
+        return fallback;
+    }
+
+    return (int) parsed;
+}
+
+static void llm_scheduler_init_once(void)
+{
+    g_max_concurrency = llm_scheduler_env_int("LLM_MAX_CONCURRENCY",
+                                              LLM_SCHEDULER_DEFAULT_CONCURRENCY);
+    g_quantum = llm_scheduler_env_int("LLM_SCHEDULER_QUANTUM",
+                                      LLM_SCHEDULER_DEFAULT_QUANTUM);
+}
+
+static unsigned long long llm_scheduler_now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long) ts.tv_sec * 1000ULL + (unsigned long long) ts.tv_nsec / 1000000ULL;
+}
+
+static void llm_queue_push(llm_ticket_queue_t *queue, llm_ticket_t *ticket)
+{
+    ticket->next = NULL;
+    if (queue->tail) {
+        queue->tail->next = ticket;
+    } else {
+        queue->head = ticket;
+    }
+    queue->tail = ticket;
+}
+
+static llm_ticket_t *llm_queue_pop(llm_ticket_queue_t *queue)
+{
+    llm_ticket_t *ticket = queue->head;
+
+    if (!ticket) {
+        return NULL;
+    }
+    queue->head = ticket->next;
+    if (!queue->head) {
+        queue->tail = NULL;
+    }
+    ticket->next = NULL;
+    return ticket;
+}
+
+static void llm_queue_remove(llm_ticket_queue_t *queue, llm_ticket_t *ticket)
+{
+    llm_ticket_t *prev = NULL;
+    llm_ticket_t *cur;
+
+    for (cur = queue->head; cur; prev = cur, cur = cur->next) {
+        if (cur != ticket) {
+            continue;
+        }
+        if (prev) {
+            prev->next = cur->next;
+        } else {
+            queue->head = cur->next;
+        }
+        if (queue->tail == cur) {
+            queue->tail = prev;
+        }
+        cur->next = NULL;
+        return;
+    }
+}
+
+static llm_flow_t *llm_flow_get(int user_id)
+{
+    llm_flow_t *flow;
+
+    for (flow = g_flows_head; flow; flow = flow->next) {
+        if (flow->user_id == user_id) {
+            return flow;
+        }
+    }
+
+    flow = calloc(1, sizeof(*flow));
+    if (!flow) {
+        return NULL;
+    }
+    flow->user_id = user_id;
+
+    if (g_flows_tail) {
+        g_flows_tail->next = flow;
+    } else {
+        g_flows_head = flow;
+    }
+    g_flows_tail = flow;
+    g_stats.active_users++;
+    return flow;
+}
+
+static llm_flow_t *llm_flow_pop_head(void)
+{
+    llm_flow_t *flow = g_flows_head;
+
+    if (!flow) {
+        return NULL;
+    }
+    g_flows_head = flow->next;
+    if (!g_flows_head) {
+        g_flows_tail = NULL;
+    }
+    flow->next = NULL;
+    return flow;
+}
+
+static void llm_flow_push_tail(llm_flow_t *flow)
+{
+    flow->next = NULL;
+    if (g_flows_tail) {
+        g_flows_tail->next = flow;
+    } else {
+        g_flows_head = flow;
+    }
+    g_flows_tail = flow;
+}
+
+static void llm_flow_remove(llm_flow_t *target)
+{
+    llm_flow_t *prev = NULL;
+    llm_flow_t *flow;
+
+    for (flow = g_flows_head; flow; prev = flow, flow = flow->next) {
+        if (flow != target) {
+            continue;
+        }
+        if (prev) {
+            prev->next = flow->next;
+        } else {
+            g_flows_head = flow->next;
+        }
+        if (g_flows_tail == flow) {
+            g_flows_tail = prev;
+        }
+        free(flow);
+        g_stats.active_users--;
+        return;
+    }
+}
+
+/*
+ * Снимает с очереди ticket, чей дедлайн истёк. Вызывается под g_sched_lock.
+ */
+static void llm_scheduler_cancel(llm_ticket_t *ticket, int priority)
+{
+    if (ticket->flow) {
+        llm_queue_remove(&ticket->flow->queue, ticket);
+        if (!ticket->flow->queue.head) {
+            llm_flow_remove(ticket->flow);
+        }
+    } else {
+        llm_queue_remove(&g_interactive, ticket);
+    }
+    g_stats.queued[priority]--;
+    g_stats.timed_out[priority]++;
+}
+
+static void llm_scheduler_grant(llm_ticket_t *ticket, int priority)
+{
+    unsigned long long waited = llm_scheduler_now_ms() - ticket->enqueued_ms;
+
+    ticket->granted = 1;
+    g_in_flight++;
+    g_stats.queued[priority]--;
+    g_stats.granted[priority]++;
+    g_stats.wait_ms_total[priority] += waited;
+    if (waited > g_stats.wait_ms_max[priority]) {
+        g_stats.wait_ms_max[priority] = waited;
+    }
+    pthread_cond_signal(&ticket->cond);
+}
+
+/*
+ * Раздаёт свободные слоты ожидающим. Вызывается под g_sched_lock.
+ */
+static void llm_scheduler_dispatch(void)
+{
+    while (g_in_flight < g_max_concurrency) {
+        llm_ticket_t *ticket = llm_queue_pop(&g_interactive);
+        llm_flow_t *flow;
+
+        if (ticket) {
+            llm_scheduler_grant(ticket, LLM_SCHEDULER_PRIORITY_INTERACTIVE);
+            continue;
+        }
+
+        flow = g_flows_head;
+        if (!flow) {
+            return;
+        }
+
+        if (!flow->quantum_added) {
+            flow->deficit += g_quantum;
+            flow->quantum_added = 1;
+        }
+
+        if (flow->deficit < flow->queue.head->cost) {
+            flow->quantum_added = 0;
+            llm_flow_push_tail(llm_flow_pop_head());
+            continue;
+        }
+
+        ticket = llm_queue_pop(&flow->queue);
+        flow->deficit -= ticket->cost;
+        llm_scheduler_grant(ticket, LLM_SCHEDULER_PRIORITY_BATCH);
+
+        if (!flow->queue.head) {
+            free(llm_flow_pop_head());
+            g_stats.active_users--;
+        }
+    }
+}
+
+int llm_scheduler_acquire(int user_id, int priority, int cost,
+                          unsigned long long deadline_ms)
+{
+    llm_ticket_t ticket;
+    llm_flow_t *flow = NULL;
+    pthread_condattr_t attr;
+    struct timespec ts;
+    int rc = LLM_SCHEDULER_OK;
+
+    pthread_once(&g_sched_once, llm_scheduler_init_once);
+
+    memset(&ticket, 0, sizeof(ticket));
+    ticket.cost = cost > 0 ? cost : 1;
+    if (priority != LLM_SCHEDULER_PRIORITY_BATCH) {
+        priority = LLM_SCHEDULER_PRIORITY_INTERACTIVE;
+    }
+
+    /* Дедлайн задаётся по CLOCK_MONOTONIC, как и время ожидания в статистике. */
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    if (pthread_cond_init(&ticket.cond, &attr) != 0) {
+        pthread_condattr_destroy(&attr);
+        return LLM_SCHEDULER_ERR_SERVER;
+    }
+    pthread_condattr_destroy(&attr);
+
+    ts.tv_sec = (time_t) (deadline_ms / 1000ULL);
+    ts.tv_nsec = (long) (deadline_ms % 1000ULL) * 1000000L;
+
+    pthread_mutex_lock(&g_sched_lock);
+
+    if (priority == LLM_SCHEDULER_PRIORITY_BATCH) {
+        flow = llm_flow_get(user_id);
+        if (!flow) {
+            pthread_mutex_unlock(&g_sched_lock);
+            pthread_cond_destroy(&ticket.cond);
+            return LLM_SCHEDULER_ERR_SERVER;
+        }
+    }
+
+    ticket.flow = flow;
+    ticket.enqueued_ms = llm_scheduler_now_ms();
+    g_stats.queued[priority]++;
+    llm_queue_push(flow ? &flow->queue : &g_interactive, &ticket);
+
+    llm_scheduler_dispatch();
+    while (!ticket.granted) {
+        if (!deadline_ms) {
+            pthread_cond_wait(&ticket.cond, &g_sched_lock);
+            continue;
+        }
+        if (pthread_cond_timedwait(&ticket.cond, &g_sched_lock, &ts) != 0 &&
+            !ticket.granted && llm_scheduler_now_ms() >= deadline_ms) {
+            llm_scheduler_cancel(&ticket, priority);
+            rc = LLM_SCHEDULER_ERR_TIMEOUT;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&g_sched_lock);
+    pthread_cond_destroy(&ticket.cond);
+    return rc;
+}
+
+void llm_scheduler_release(void)
+{
+    pthread_mutex_lock(&g_sched_lock);
+    if (g_in_flight > 0) {
+        g_in_flight--;
+    }
+    llm_scheduler_dispatch();
+    pthread_mutex_unlock(&g_sched_lock);
+}
+
+void llm_scheduler_get_stats(llm_scheduler_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+
+    pthread_once(&g_sched_once, llm_scheduler_init_once);
+
+    pthread_mutex_lock(&g_sched_lock);
+    *out = g_stats;
+    out->max_concurrency = g_max_concurrency;
+    out->in_flight = g_in_flight;
+    pthread_mutex_unlock(&g_sched_lock);
+}
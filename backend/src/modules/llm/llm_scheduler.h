@@ -0,0 +1,45 @@
+#ifndef LLM_SCHEDULER_H
+#define LLM_SCHEDULER_H
+
+enum {
+    LLM_SCHEDULER_PRIORITY_INTERACTIVE = 0,
+    LLM_SCHEDULER_PRIORITY_BATCH = 1,
+    LLM_SCHEDULER_PRIORITY_COUNT = 2
+};
+
+enum {
+    LLM_SCHEDULER_OK = 0,
+    LLM_SCHEDULER_ERR_SERVER = -1,
+    LLM_SCHEDULER_ERR_TIMEOUT = -2
+};
+
+typedef struct {
+    int max_concurrency;
+    int in_flight;
+    int queued[LLM_SCHEDULER_PRIORITY_COUNT];
+    int active_users;
+    unsigned long long granted[LLM_SCHEDULER_PRIORITY_COUNT];
+    unsigned long long wait_ms_total[LLM_SCHEDULER_PRIORITY_COUNT];
+    unsigned long long wait_ms_max[LLM_SCHEDULER_PRIORITY_COUNT];
+    unsigned long long timed_out[LLM_SCHEDULER_PRIORITY_COUNT];
+} llm_scheduler_stats_t;
+
+/*
+ * Ограничивает число одновременных запросов к модели (LLM_MAX_CONCURRENCY).
+ * Интерактивные запросы обслуживаются раньше пакетных; пакетные запросы
+ * разных пользователей делят слоты по deficit round-robin, cost — число
+ * слов в запросе (квант LLM_SCHEDULER_QUANTUM).
+ *
+ * acquire блокирует вызывающий поток до получения слота, но не дольше
+ * deadline_ms (абсолютное время по CLOCK_MONOTONIC, 0 — без ограничения);
+ * по истечении запрос снимается с очереди и возвращается
+ * LLM_SCHEDULER_ERR_TIMEOUT. После запроса к модели слот возвращается
+ * через release.
+ */
+int llm_scheduler_acquire(int user_id, int priority, int cost,
+                          unsigned long long deadline_ms);
+void llm_scheduler_release(void);
+
+void llm_scheduler_get_stats(llm_scheduler_stats_t *out);
+
+#endif
@@ -16,7 +16,8 @@ int profile_api_get_user_profile(int user_id, profile_api_user_profile_t *profil
                                  profile->username,
                                  sizeof(profile->username),
                                  &profile->words_learned,
-                                 &profile->active_lessons);
+                                 &profile->active_lessons,
+                                 &profile->known_level);
     if (rc == -2) {
         return PROFILE_API_ERR_NOT_FOUND;
     }
@@ -26,3 +27,37 @@ int profile_api_get_user_profile(int user_id, profile_api_user_profile_t *profil
 
     return PROFILE_API_OK;
 }
+
+int profile_api_get_known_level(int user_id, int *out_level)
+{
+    if (user_id <= 0 || !out_level) {
+        return PROFILE_API_ERR_INVALID_ARGUMENT;
+    }
+
+    int rc = db_get_user_known_level(user_id, out_level);
+    if (rc == DB_ERR_NOT_FOUND) {
+        return PROFILE_API_ERR_NOT_FOUND;
+    }
+    if (rc != DB_OK) {
+        return PROFILE_API_ERR_SERVER;
+    }
+
+    return PROFILE_API_OK;
+}
+
+int profile_api_set_known_level(int user_id, int level)
+{
+    if (user_id <= 0 || level < 0) {
+        return PROFILE_API_ERR_INVALID_ARGUMENT;
+    }
+
+    int rc = db_set_user_known_level(user_id, level);
+    if (rc == DB_ERR_NOT_FOUND) {
+        return PROFILE_API_ERR_NOT_FOUND;
+    }
+    if (rc != DB_OK) {
+        return PROFILE_API_ERR_SERVER;
+    }
+
+    return PROFILE_API_OK;
+}
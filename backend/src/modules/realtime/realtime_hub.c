@@ -2,11 +2,14 @@
 
 #include "modules/realtime/realtime_ws.h"
 
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
 
 static rt_hub_t g_rt_hub;
+/* Клиентов регистрирует HTTP-поток, а события рассылают воркеры задач. */
+static pthread_mutex_t g_rt_hub_lock = PTHREAD_MUTEX_INITIALIZER;
 
 static int rt_hub_extract_job_id(const char *json)
 {
@@ -32,24 +35,39 @@ static int rt_hub_extract_job_id(const char *json)
     return (int) value;
 }
 
+static void rt_hub_remove_client_locked(int fd)
+{
+    int i;
+
+    for (i = 0; i < RT_HUB_MAX_CLIENTS; i++) {
+        if (g_rt_hub.clients[i].fd == fd) {
+            memset(&g_rt_hub.clients[i], 0, sizeof(g_rt_hub.clients[i]));
+            if (g_rt_hub.count > 0) {
+                g_rt_hub.count--;
+            }
+            return;
+        }
+    }
+}
+
 void rt_hub_init(void)
 {
+    pthread_mutex_lock(&g_rt_hub_lock);
     memset(&g_rt_hub, 0, sizeof(g_rt_hub));
+    pthread_mutex_unlock(&g_rt_hub_lock);
 }
 
 void rt_hub_shutdown(void)
 {
+    pthread_mutex_lock(&g_rt_hub_lock);
     memset(&g_rt_hub, 0, sizeof(g_rt_hub));
+    pthread_mutex_unlock(&g_rt_hub_lock);
 }
 
-int rt_hub_add_client(int fd, int is_ws, int is_sse)
+static int rt_hub_add_client_locked(int fd, int is_ws, int is_sse)
 {
     int i;
 
-    if (fd < 0) {
-        return -1;
-    }
-
     for (i = 0; i < RT_HUB_MAX_CLIENTS; i++) {
         if (g_rt_hub.clients[i].fd == fd) {
             g_rt_hub.clients[i].is_websocket = is_ws ? 1 : 0;
@@ -75,35 +93,43 @@ int rt_hub_add_client(int fd, int is_ws, int is_sse)
     return -1;
 }
 
-void rt_hub_remove_client(int fd)
+int rt_hub_add_client(int fd, int is_ws, int is_sse)
 {
-    int i;
+    int rc;
 
     if (fd < 0) {
-        return;
+        return -1;
     }
 
-    for (i = 0; i < RT_HUB_MAX_CLIENTS; i++) {
-        if (g_rt_hub.clients[i].fd == fd) {
-            memset(&g_rt_hub.clients[i], 0, sizeof(g_rt_hub.clients[i]));
-            if (g_rt_hub.count > 0) {
-                g_rt_hub.count--;
-            }
-            return;
-        }
+    pthread_mutex_lock(&g_rt_hub_lock);
+    rc = rt_hub_add_client_locked(fd, is_ws, is_sse);
+    pthread_mutex_unlock(&g_rt_hub_lock);
+    return rc;
+}
+
+void rt_hub_remove_client(int fd)
+{
+    if (fd < 0) {
+        return;
     }
+
+    pthread_mutex_lock(&g_rt_hub_lock);
+    rt_hub_remove_client_locked(fd);
+    pthread_mutex_unlock(&g_rt_hub_lock);
 }
 
 void rt_hub_set_subscription(int fd, int job_id)
 {
     int i;
 
+    pthread_mutex_lock(&g_rt_hub_lock);
     for (i = 0; i < RT_HUB_MAX_CLIENTS; i++) {
         if (g_rt_hub.clients[i].fd == fd) {
             g_rt_hub.clients[i].subscribed_job_id = job_id > 0 ? job_id : 0;
-            return;
+            break;
         }
     }
+    pthread_mutex_unlock(&g_rt_hub_lock);
 }
 
 void rt_hub_mark_websocket(int fd)
@@ -127,6 +153,12 @@ void rt_hub_broadcast(const char *json)
 
     event_job_id = rt_hub_extract_job_id(json);
 
+    /*
+     * Отправка идёт под блокировкой: HTTP-поток снимает клиента с хаба
+     * до close(fd), поэтому дескриптор не может переиспользоваться
+     * посреди рассылки.
+     */
+    pthread_mutex_lock(&g_rt_hub_lock);
     for (i = 0; i < RT_HUB_MAX_CLIENTS; i++) {
         rt_client_t *client = &g_rt_hub.clients[i];
         int rc;
@@ -149,7 +181,8 @@ void rt_hub_broadcast(const char *json)
 
         if (rc != 0) {
             shutdown(client->fd, SHUT_RDWR);
-            rt_hub_remove_client(client->fd);
+            rt_hub_remove_client_locked(client->fd);
         }
     }
+    pthread_mutex_unlock(&g_rt_hub_lock);
 }
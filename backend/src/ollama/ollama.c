@@ -1,7 +1,10 @@
 
+#include <ctype.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -14,9 +17,11 @@
 
 #include "libs/http.h"
 #include "libs/cJSON.h"
+#include "utils/json.h"
 #include "dbug.h"
 
 #include "ollama.h"
+#include "ollama_backends.h"
 
 #define MODEL_NAME        "llama3:8b"
 //#define OLLAMA_HOST       "127.0.0.1"
@@ -26,82 +31,51 @@
 
 
 char *build_prompt_for_word(const char *word);
-char *build_json_payload(const char *escaped_prompt);
+char *build_prompt_for_words(const char *const *words, size_t count);
+char *build_json_payload(const char *escaped_prompt, const char *format);
 void ensure_ollama_running(void);
 void handle_response(const char *response);
 
 static char *OLLAMA_HOST;
 static char *OLLAMA_PORT;
 
+// Hedge: дублировать запрос на второй backend, если первый отвечает дольше p95.
+static int OLLAMA_HEDGE = 0;
+static unsigned long long OLLAMA_HEDGE_MIN_MS = 50;
+
+// Structured output: что передаётся в "format" запроса к /api/generate.
+enum {
+    OLLAMA_FORMAT_NONE = 0,   // свободный текст, JSON ищется в ответе
+    OLLAMA_FORMAT_JSON,       // "format": "json"
+    OLLAMA_FORMAT_SCHEMA      // "format": JSON-схема карточки
+};
+static int OLLAMA_FORMAT = OLLAMA_FORMAT_SCHEMA;
+// Сколько раз дозапрашивать недостающие поля карточки.
+static int OLLAMA_REPAIR_ATTEMPTS = 1;
+
 void ollama_init(void) {
+    const char *hedge;
+    const char *hedge_min;
+    const char *format;
+    const char *repair;
+
     OLLAMA_HOST = getenv("OLLAMA_HOST");
     OLLAMA_PORT = getenv("OLLAMA_PORT");
     if (!OLLAMA_HOST) OLLAMA_HOST = "127.0.0.1";
     if (!OLLAMA_PORT) OLLAMA_PORT = "11434";
-}
-
-/*
- * Экранирует кавычки, бэкслэши и управляющие символы, чтобы вставлять в JSON.
- * Возвращает malloc-строку или NULL.
- * Один выход через label end.
- */
-char *escape_json(const char *input) {
-    char *escaped = NULL;
-    size_t len;
-    char *buf = NULL;
-    const char *src;
-    char *dst;
-
-    DEBUG_PRINT_OLLAMA("enter: input=%p \"%s\"", input, input ? input : "");
-    if (!input) {
-        ERROR_PRINT("input is NULL");
-        goto end;
-    }
-
-    len = strlen(input);
-    /* worst-case: каждый символ превращается в 2 символа */
-    buf = malloc(len * 2 + 1);
-    if (!buf) {
-        ERROR_PRINT("malloc failed for escape buffer");
-        goto end;
-    }
-
-    dst = buf;
-    for (src = input; *src; src++) {
-        switch (*src) {
-        case '\"':
-            *dst++ = '\\';
-            *dst++ = '\"';
-            break;
-        case '\\':
-            *dst++ = '\\';
-            *dst++ = '\\';
-            break;
-        case '\n':
-            *dst++ = '\\';
-            *dst++ = 'n';
-            break;
-        case '\r':
-            *dst++ = '\\';
-            *dst++ = 'r';
-            break;
-        case '\t':
-            *dst++ = '\\';
-            *dst++ = 't';
-            break;
-        default:
-            *dst++ = *src;
-            break;
-        }
-    }
-    *dst = '\0';
-    escaped = buf;
-    buf = NULL; /* чтобы не освободить дважды */
-
-end:
-    if (buf) free(buf);
-    DEBUG_PRINT_OLLAMA("exit: escaped=%p \"%s\"", escaped, escaped ? escaped : "");
-    return escaped;
+    ollama_backends_init(OLLAMA_HOST, OLLAMA_PORT);
+
+    hedge = getenv("OLLAMA_HEDGE");
+    OLLAMA_HEDGE = hedge && strcmp(hedge, "1") == 0;
+    hedge_min = getenv("OLLAMA_HEDGE_MIN_MS");
+    if (hedge_min && atoll(hedge_min) > 0) OLLAMA_HEDGE_MIN_MS = (unsigned long long) atoll(hedge_min);
+
+    format = getenv("OLLAMA_FORMAT");
+    if (format && strcmp(format, "none") == 0) OLLAMA_FORMAT = OLLAMA_FORMAT_NONE;
+    else if (format && strcmp(format, "json") == 0) OLLAMA_FORMAT = OLLAMA_FORMAT_JSON;
+    else OLLAMA_FORMAT = OLLAMA_FORMAT_SCHEMA;
+    repair = getenv("OLLAMA_REPAIR_ATTEMPTS");
+    if (repair) OLLAMA_REPAIR_ATTEMPTS = atoi(repair) > 0 ? atoi(repair) : 0;
 }
 
 /*
@@ -407,7 +381,7 @@ void print_card_from_response(const char *response_json) {
     pretty = cJSON_Print(card_json);
     if (pretty) {
         printf("%s\n", pretty);
-        free(pretty);
+        cJSON_free(pretty);
     } else {
         ERROR_PRINT("cJSON_Print returned NULL");
     }
@@ -439,17 +413,76 @@ char *build_prompt_for_word(const char *word) {
     return strdup(prompt);
 }
 
+/*
+ * Промпт на пачку слов: модель возвращает JSON-массив карточек
+ * в том же порядке, что и слова. Возвращает malloc-строку или NULL.
+ */
+char *build_prompt_for_words(const char *const *words, size_t count) {
+    static const char *head =
+        "Please generate only a JSON object {\"cards\": [...]} with one card object per English word "
+        "listed below, in the same order, without additional text, explanation, or commentary.\n"
+        "English words: [";
+    static const char *tail =
+        "]\n"
+        "Each object in the \"cards\" array must have this structure:\n"
+        "{\n"
+        "  \"word\": \"<the English word>\",\n"
+        "  \"translation\": \"<Russian translation>\",\n"
+        "  \"transcription\": \"<phonetic transcription>\",\n"
+        "  \"example\": [\n"
+        "    {\"text\": \"<simple example sentence 1>\"},\n"
+        "    {\"text\": \"<simple example sentence 2>\"}\n"
+        "  ]\n"
+        "}\n"
+        "Fill in all fields accurately and do not return anything beyond this JSON object.";
+    size_t size = strlen(head) + strlen(tail) + 1;
+    char *prompt;
+    char *dst;
+    size_t i;
+
+    if (!words || count == 0) return NULL;
+
+    for (i = 0; i < count; i++) {
+        size = size + strlen(words[i]) + 4;
+    }
+
+    prompt = malloc(size);
+    if (!prompt) return NULL;
+
+    dst = prompt;
+    dst += sprintf(dst, "%s", head);
+    for (i = 0; i < count; i++) {
+        dst += sprintf(dst, "%s\"%s\"", i > 0 ? ", " : "", words[i]);
+    }
+    sprintf(dst, "%s", tail);
+    return prompt;
+}
+
 
-char *build_json_payload(const char *escaped_prompt) {
-    char json_data[4096];
-    snprintf(json_data, sizeof(json_data),
-        "{ \"model\": \"%s\", \"prompt\": \"%s\", \"stream\": false }",
-        MODEL_NAME, escaped_prompt);
-    return strdup(json_data);
+/*
+ * format — готовое JSON-значение для поля "format" (схема или "\"json\"")
+ * либо NULL, если ответ модели не ограничивается.
+ */
+char *build_json_payload(const char *escaped_prompt, const char *format) {
+    static const char *fmt = "{ \"model\": \"%s\", \"prompt\": \"%s\", \"stream\": false%s%s }";
+    static const char *format_key = ", \"format\": ";
+    size_t size = strlen(fmt) + strlen(MODEL_NAME) + strlen(escaped_prompt) + 1;
+    char *json_data;
+
+    if (format) size += strlen(format_key) + strlen(format);
+    json_data = malloc(size);
+    if (!json_data) return NULL;
+    snprintf(json_data, size, fmt, MODEL_NAME, escaped_prompt,
+             format ? format_key : "", format ? format : "");
+    return json_data;
 }
 
 
 void ensure_ollama_running(void) {
+    // Локальный сервер поднимаем только в режиме одного backend'а.
+    if (ollama_backends_count() > 1) {
+        return;
+    }
     if (!is_ollama_running()) {
         DEBUG_PRINT_OLLAMA("Ollama not running, starting server");
         start_ollama_server();
@@ -483,96 +516,814 @@ void handle_response(const char *response) {
     }
 }
 
-word_card_t *parse_card_from_json(const char *json_response) {
-    cJSON *root = cJSON_Parse(json_response);
-    if (!root) return NULL;
+#define CARD_FIELD_COUNT (3 + NUMBER_OF_EXAMPLES)
+
+static void card_fields(word_card_t *card, char **fields[CARD_FIELD_COUNT]) {
+    int i;
+
+    fields[0] = &card->word;
+    fields[1] = &card->translation;
+    fields[2] = &card->transcription;
+    for (i = 0; i < NUMBER_OF_EXAMPLES; ++i) {
+        fields[3 + i] = &card->examples[i];
+    }
+}
+
+/* Биты маски полей карточки — в порядке card_fields(). */
+#define CARD_FIELD_WORD          (1u << 0)
+#define CARD_FIELD_TRANSLATION   (1u << 1)
+#define CARD_FIELD_TRANSCRIPTION (1u << 2)
+#define CARD_FIELD_EXAMPLE(i)    (1u << (3 + (i)))
+#define CARD_FIELD_ALL           ((1u << CARD_FIELD_COUNT) - 1)
+
+static const char *const card_string_fields[3] = { "word", "translation", "transcription" };
+
+static int card_text_blank(const char *text) {
+    if (!text) return 1;
+    while (*text && isspace((unsigned char) *text)) text++;
+    return *text == '\0';
+}
+
+/*
+ * Строгая проверка карточки: маска отсутствующих, не строковых
+ * или пустых полей. 0 — карточка полная.
+ */
+static unsigned card_missing_fields(word_card_t *view) {
+    char **fields[CARD_FIELD_COUNT];
+    unsigned missing = 0;
+    size_t i;
+
+    card_fields(view, fields);
+    for (i = 0; i < CARD_FIELD_COUNT; i++) {
+        if (card_text_blank(*fields[i])) missing |= 1u << i;
+    }
+    return missing;
+}
+
+static int card_missing_examples(unsigned fields) {
+    int count = 0;
+    int i;
+
+    for (i = 0; i < NUMBER_OF_EXAMPLES; i++) {
+        if (fields & CARD_FIELD_EXAMPLE(i)) count++;
+    }
+    return count;
+}
+
+static int text_append(char *buf, size_t size, size_t *used, const char *fmt, ...) {
+    va_list ap;
+    int len;
+
+    va_start(ap, fmt);
+    len = vsnprintf(buf + *used, size - *used, fmt, ap);
+    va_end(ap);
+    if (len < 0 || (size_t) len >= size - *used) return -1;
+    *used += (size_t) len;
+    return 0;
+}
+
+/*
+ * JSON-схема карточки для "format" структурированного вывода Ollama,
+ * только с полями из маски fields. Примеры — массив ровно из стольких
+ * объектов {"text": ...}, сколько примеров в маске.
+ * Возвращает malloc-строку или NULL.
+ */
+static char *build_card_schema(unsigned fields) {
+    char schema[1024];
+    size_t used = 0;
+    int examples = card_missing_examples(fields);
+    int pass;
+    size_t i;
+
+    if (text_append(schema, sizeof(schema), &used, "{\"type\":\"object\",\"properties\":{") != 0) return NULL;
+
+    // Первый проход — properties, второй — required.
+    for (pass = 0; pass < 2; pass++) {
+        const char *sep = "";
+
+        for (i = 0; i < 3; i++) {
+            if (!(fields & (1u << i))) continue;
+            if (text_append(schema, sizeof(schema), &used,
+                            pass == 0 ? "%s\"%s\":{\"type\":\"string\",\"minLength\":1}" : "%s\"%s\"",
+                            sep, card_string_fields[i]) != 0) return NULL;
+            sep = ",";
+        }
+        if (examples > 0) {
+            if (pass == 0) {
+                if (text_append(schema, sizeof(schema), &used,
+                                "%s\"example\":{\"type\":\"array\",\"minItems\":%d,\"maxItems\":%d,"
+                                "\"items\":{\"type\":\"object\",\"properties\":"
+                                "{\"text\":{\"type\":\"string\",\"minLength\":1}},\"required\":[\"text\"]}}",
+                                sep, examples, examples) != 0) return NULL;
+            } else if (text_append(schema, sizeof(schema), &used, "%s\"example\"", sep) != 0) {
+                return NULL;
+            }
+        }
+        if (text_append(schema, sizeof(schema), &used, pass == 0 ? "},\"required\":[" : "]}") != 0) return NULL;
+    }
+
+    return strdup(schema);
+}
+
+/* Схема ответа на пачку: {"cards": [карточка x count]}. */
+static char *build_batch_schema(size_t count) {
+    static const char *fmt =
+        "{\"type\":\"object\",\"properties\":{\"cards\":{\"type\":\"array\","
+        "\"minItems\":%zu,\"maxItems\":%zu,\"items\":%s}},\"required\":[\"cards\"]}";
+    char *card = build_card_schema(CARD_FIELD_ALL);
+    char *schema = NULL;
+    size_t size;
+
+    if (!card) return NULL;
+    size = strlen(fmt) + strlen(card) + 2 * 24;
+    schema = malloc(size);
+    if (schema) snprintf(schema, size, fmt, count, count, card);
+    free(card);
+    return schema;
+}
 
-    word_card_t *card = calloc(1, sizeof(word_card_t));
-    if (!card) {
-        cJSON_Delete(root);
+/*
+ * Промпт на дозапрос только недостающих полей карточки слова word.
+ * Возвращает malloc-строку или NULL.
+ */
+static char *build_repair_prompt(const char *word, unsigned missing) {
+    static const char *const hints[3] = {
+        "<the English word>", "<Russian translation>", "<phonetic transcription>"
+    };
+    char prompt[1024];
+    size_t used = 0;
+    const char *sep = "";
+    int examples = card_missing_examples(missing);
+    size_t i;
+    int n;
+
+    if (text_append(prompt, sizeof(prompt), &used,
+                    "Please generate only the following JSON object for the English word: \"%s\" "
+                    "without additional text, explanation, or commentary:\n{\n", word) != 0) return NULL;
+    for (i = 0; i < 3; i++) {
+        if (!(missing & (1u << i))) continue;
+        if (text_append(prompt, sizeof(prompt), &used, "%s  \"%s\": \"%s\"",
+                        sep, card_string_fields[i], hints[i]) != 0) return NULL;
+        sep = ",\n";
+    }
+    if (examples > 0) {
+        if (text_append(prompt, sizeof(prompt), &used, "%s  \"example\": [\n", sep) != 0) return NULL;
+        for (n = 0; n < examples; n++) {
+            if (text_append(prompt, sizeof(prompt), &used, "    {\"text\": \"<simple example sentence %d>\"}%s\n",
+                            n + 1, n + 1 < examples ? "," : "") != 0) return NULL;
+        }
+        if (text_append(prompt, sizeof(prompt), &used, "  ]") != 0) return NULL;
+    }
+    if (text_append(prompt, sizeof(prompt), &used,
+                    "\n}\nFill in all fields accurately and do not return anything beyond this JSON structure.") != 0) {
         return NULL;
     }
 
-    card->word = strdup(cJSON_GetObjectItem(root, "word")->valuestring);
-    card->translation = strdup(cJSON_GetObjectItem(root, "translation")->valuestring);
-    card->transcription = strdup(cJSON_GetObjectItem(root, "transcription")->valuestring);
+    return strdup(prompt);
+}
+
+/*
+ * Массив "example": [{"text": "..."}, ...] — берутся первые NUMBER_OF_EXAMPLES.
+ */
+static int scan_card_examples(json_scan_t *scan, word_card_t *view) {
+    int index = 0;
+
+    if (json_scan_expect(scan, '[') != 0) return -1;
+    if (json_scan_peek(scan) == ']') {
+        scan->p++;
+        return 0;
+    }
+
+    for (;;) {
+        if (json_scan_peek(scan) == '{' && index < NUMBER_OF_EXAMPLES) {
+            scan->p++;
+            while (json_scan_peek(scan) != '}') {
+                char *key;
+
+                if (json_scan_string(scan, &key, NULL) != 0 || json_scan_expect(scan, ':') != 0) return -1;
+                if (strcmp(key, "text") == 0 && json_scan_peek(scan) == '"') {
+                    if (json_scan_string(scan, &view->examples[index], NULL) != 0) return -1;
+                } else if (json_scan_skip_value(scan) != 0) {
+                    return -1;
+                }
+                if (json_scan_peek(scan) == ',') scan->p++;
+            }
+            scan->p++;
+        } else if (json_scan_skip_value(scan) != 0) {
+            return -1;
+        }
+        index++;
+
+        if (json_scan_peek(scan) == ',') {
+            scan->p++;
+            continue;
+        }
+        return json_scan_expect(scan, ']');
+    }
+}
+
+/*
+ * Разбирает объект карточки на месте: поля view указывают внутрь буфера
+ * сканера, отсутствующие поля остаются NULL (их проверяет
+ * card_missing_fields()). Возвращает -1, если JSON некорректен; поля,
+ * прочитанные до ошибки, в view сохраняются.
+ */
+static int scan_card_object(json_scan_t *scan, word_card_t *view) {
+    memset(view, 0, sizeof(*view));
+
+    if (json_scan_expect(scan, '{') != 0) return -1;
+
+    while (json_scan_peek(scan) != '}') {
+        char *key;
+        char **field = NULL;
+
+        if (json_scan_string(scan, &key, NULL) != 0 || json_scan_expect(scan, ':') != 0) return -1;
 
-    cJSON *examples = cJSON_GetObjectItem(root, "example");
-    if (cJSON_IsArray(examples)) {
-        for (int i = 0; i < NUMBER_OF_EXAMPLES && i < cJSON_GetArraySize(examples); ++i) {
-            cJSON *ex = cJSON_GetArrayItem(examples, i);
-            card->examples[i] = strdup(cJSON_GetObjectItem(ex, "text")->valuestring);
+        if (strcmp(key, "word") == 0) field = &view->word;
+        else if (strcmp(key, "translation") == 0) field = &view->translation;
+        else if (strcmp(key, "transcription") == 0) field = &view->transcription;
+
+        if (field && json_scan_peek(scan) == '"') {
+            if (json_scan_string(scan, field, NULL) != 0) return -1;
+        } else if (strcmp(key, "example") == 0 && json_scan_peek(scan) == '[') {
+            if (scan_card_examples(scan, view) != 0) return -1;
+        } else if (json_scan_skip_value(scan) != 0) {
+            return -1;
+        }
+
+        if (json_scan_peek(scan) == ',') {
+            scan->p++;
+        } else if (json_scan_peek(scan) != '}') {
+            return -1;
         }
     }
+    scan->p++;
+
+    return 0;
+}
+
+static int field_ptr_cmp(const void *a, const void *b) {
+    const char *x = **(char **const *) a;
+    const char *y = **(char **const *) b;
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/*
+ * Переносит найденные поля в начало buffer и ужимает его: карточка
+ * получает buffer как единственное хранилище строк. Поля идут в буфере
+ * по возрастанию адресов, поэтому запись всегда позади чтения.
+ * Отсутствующие примеры становятся пустыми строками.
+ */
+static word_card_t *card_compact_into(char *buffer, const word_card_t *view) {
+    word_card_t *card = malloc(sizeof(*card));
+    char **fields[CARD_FIELD_COUNT];
+    size_t offsets[CARD_FIELD_COUNT];
+    size_t present = 0;
+    size_t used = 0;
+    size_t i;
+    char *shrunk;
+
+    if (!card) return NULL;
+    *card = *view;
+    card_fields(card, fields);
+
+    for (i = 0; i < CARD_FIELD_COUNT; i++) {
+        if (*fields[i]) fields[present++] = fields[i];
+    }
+    qsort(fields, present, sizeof(fields[0]), field_ptr_cmp);
+
+    for (i = 0; i < present; i++) {
+        size_t len = strlen(*fields[i]) + 1;
 
-    cJSON_Delete(root);
+        memmove(buffer + used, *fields[i], len);
+        offsets[i] = used;
+        used += len;
+    }
+    buffer[used] = '\0';  // общая пустая строка для отсутствующих полей
+
+    shrunk = realloc(buffer, used + 1);
+    if (shrunk) buffer = shrunk;
+
+    card->storage = buffer;
+    for (i = 0; i < present; i++) {
+        *fields[i] = buffer + offsets[i];
+    }
+    for (i = 0; i < NUMBER_OF_EXAMPLES; i++) {
+        if (!card->examples[i]) card->examples[i] = buffer + used;
+    }
     return card;
 }
 
-word_card_t *generate_word_card(const char *word) {
-    char *prompt = NULL;
-    char *escaped_prompt = NULL;
-    char *json_data = NULL;
-    char *response = NULL;
-    char *body = NULL;  //не надо освобождать память
-    char *decoded = NULL;
-    word_card_t *card = NULL;
+/*
+ * Копирует поля view в одну новую аллокацию (для карточек из пачки,
+ * которые делят один буфер ответа).
+ */
+static word_card_t *card_pack_copy(const word_card_t *view) {
+    word_card_t tmp = *view;
+    char **fields[CARD_FIELD_COUNT];
+    size_t total = 1;
+    size_t used = 0;
+    char *buffer;
+    size_t i;
+
+    card_fields(&tmp, fields);
+    for (i = 0; i < CARD_FIELD_COUNT; i++) {
+        if (*fields[i]) total += strlen(*fields[i]) + 1;
+    }
+
+    buffer = malloc(total);
+    if (!buffer) return NULL;
+
+    for (i = 0; i < CARD_FIELD_COUNT; i++) {
+        size_t len;
+
+        if (!*fields[i]) continue;
+        len = strlen(*fields[i]) + 1;
+        memcpy(buffer + used, *fields[i], len);
+        *fields[i] = buffer + used;
+        used += len;
+    }
+
+    tmp.storage = buffer;
+    return card_compact_into(buffer, &tmp);
+}
+
+#define OLLAMA_MAX_ATTEMPTS 2
+
+typedef struct {
+    ollama_backend_t *backend;
+    http_client_request_t *req;
+    unsigned long long started_ms;
+} generate_attempt_t;
+
+static int attempt_start(generate_attempt_t *attempt, ollama_backend_t *backend, const char *json_data) {
     const char *headers[] = {
         "Content-Type: application/json",
         NULL
     };
 
-    // Ensure Ollama is running
-    ensure_ollama_running();
+    DEBUG_PRINT_OLLAMA("backend %s:%s", backend->host, backend->port);
+
+    attempt->backend = backend;
+    attempt->started_ms = http_now_ms();
+    attempt->req = http_client_start(backend->host, backend->port, "POST", API_GENERATE_PATH,
+                                     json_data, headers, HTTP_CLIENT_DECODE_BODY);
+    if (!attempt->req) {
+        ERROR_PRINT("connect to %s:%s failed", backend->host, backend->port);
+        ollama_backend_release(backend, OLLAMA_BACKEND_FAILED, 0);
+        attempt->backend = NULL;
+        return -1;
+    }
+    return 0;
+}
 
-    prompt = build_prompt_for_word(word);
-    if (!prompt) goto cleanup;
+static void attempt_finish(generate_attempt_t *attempt, int outcome) {
+    ollama_backend_release(attempt->backend, outcome, http_now_ms() - attempt->started_ms);
+    http_client_free(attempt->req);
+    attempt->backend = NULL;
+    attempt->req = NULL;
+}
+
+/*
+ * Забирает декодированное тело ответа /api/generate и находит в нём поле
+ * "response" (раскодируется на месте). Возвращает тело, *inner указывает
+ * внутрь него. *outcome — как засчитать ответ backend'у: сетевая ошибка
+ * или 5xx — сбой, остальное — живой backend (даже если ответ невалиден).
+ */
+static char *extract_generate_response(http_client_request_t *req, int *outcome,
+                                       char **inner, size_t *inner_len) {
+    int status = http_client_http_status(req);
+    size_t body_len = 0;
+    char *body;
+
+    *outcome = OLLAMA_BACKEND_FAILED;
+    if (status >= 500 || status <= 0) {
+        ERROR_PRINT("backend returned HTTP %d", status);
+        return NULL;
+    }
+    *outcome = OLLAMA_BACKEND_OK;
+
+    body = http_client_take_body(req, &body_len);
+    if (!body) return NULL;
+
+    // Ответ модели — это JSON с полем response, внутри которого — вложенный JSON.
+    *inner = json_scan_find_string(body, body_len, "response", inner_len);
+    if (!*inner) {
+        ERROR_PRINT("no \"response\" string in /api/generate reply");
+        http_free_response(body);
+        return NULL;
+    }
+    return body;
+}
+
+/*
+ * POST /api/generate на наименее загруженный backend с дедлайном
+ * deadline_ms (0 — без ограничения) на connect, отправку и чтение.
+ * Сбой backend'а (сеть или 5xx) один раз повторяется на другом backend'е.
+ * При OLLAMA_HEDGE=1, если ответа нет дольше p95 этого backend'а, тот же
+ * запрос уходит на второй backend; берётся первый валидный ответ, а
+ * проигравший запрос отменяется закрытием сокета.
+ * Возвращает тело ответа (освободить через http_free_response()) или NULL;
+ * *inner — раскодированное поле "response" внутри него.
+ */
+static char *exchange_generate(const char *json_data, unsigned long long deadline_ms,
+                               char **inner, size_t *inner_len) {
+    generate_attempt_t attempts[OLLAMA_MAX_ATTEMPTS];
+    http_client_request_t *reqs[OLLAMA_MAX_ATTEMPTS];
+    const ollama_backend_t *last_backend = NULL;
+    size_t max_attempts = ollama_backends_count() > 1 ? OLLAMA_MAX_ATTEMPTS : 1;
+    size_t started = 0;
+    size_t i;
+    int hedge_slot = -1;
+    unsigned long long hedge_at = 0;
+    char *result = NULL;
+
+    memset(attempts, 0, sizeof(attempts));
+
+    for (;;) {
+        ollama_backend_t *backend;
+        unsigned long long until = deadline_ms;
+        size_t active = 0;
+        int idx;
+        int outcome;
+
+        for (i = 0; i < started; i++) {
+            reqs[i] = attempts[i].req;
+            if (reqs[i]) active++;
+        }
+
+        if (active == 0) {
+            // Ждать нечего: первая попытка или повтор после сбоя.
+            if (started >= max_attempts) break;
+            if (deadline_ms && http_now_ms() >= deadline_ms) break;
+
+            backend = last_backend ? ollama_backend_try_acquire_other(last_backend) : NULL;
+            if (!backend) backend = ollama_backend_acquire(deadline_ms);
+            if (!backend) break;
 
-    escaped_prompt = escape_json(prompt);
+            last_backend = backend;
+            if (attempt_start(&attempts[started++], backend, json_data) == 0 &&
+                OLLAMA_HEDGE && started == 1 && max_attempts > 1) {
+                unsigned long long p95 = ollama_backend_p95_ms(backend);
+
+                if (p95) {
+                    hedge_at = attempts[0].started_ms + (p95 > OLLAMA_HEDGE_MIN_MS ? p95 : OLLAMA_HEDGE_MIN_MS);
+                }
+            }
+            continue;
+        }
+
+        if (hedge_at && (!until || hedge_at < until)) until = hedge_at;
+
+        idx = http_client_wait(reqs, started, until);
+        if (idx < 0) {
+            if (hedge_at && (!deadline_ms || http_now_ms() < deadline_ms)) {
+                hedge_at = 0;
+                if (started >= max_attempts) continue;
+
+                backend = ollama_backend_try_acquire_other(attempts[0].backend);
+                if (!backend) continue;
+
+                DEBUG_PRINT_OLLAMA("hedging to %s:%s", backend->host, backend->port);
+                hedge_slot = (int) started;
+                last_backend = backend;
+                attempt_start(&attempts[started++], backend, json_data);
+                continue;
+            }
+            ERROR_PRINT("deadline exceeded waiting for /api/generate");
+            ollama_backends_note_timeout();
+            break;
+        }
+
+        if (http_client_status(reqs[idx]) == HTTP_CLIENT_DONE) {
+            result = extract_generate_response(reqs[idx], &outcome, inner, inner_len);
+        } else {
+            outcome = OLLAMA_BACKEND_FAILED;
+        }
+        attempt_finish(&attempts[idx], outcome);
+
+        if (result) {
+            if (hedge_slot >= 0) ollama_backends_note_hedge(idx == hedge_slot);
+            break;
+        }
+    }
+
+    // Проигравший hedge отменяется; незавершённый к дедлайну запрос — сбой backend'а.
+    for (i = 0; i < started; i++) {
+        if (attempts[i].req) {
+            attempt_finish(&attempts[i], result ? OLLAMA_BACKEND_CANCELLED : OLLAMA_BACKEND_FAILED);
+        }
+    }
+
+    return result;
+}
+
+/*
+ * Отправляет промпт в /api/generate. schema — JSON-схема ожидаемого ответа:
+ * по OLLAMA_FORMAT уходит в "format" целиком, как "json" или не уходит.
+ * Возвращает буфер ответа, в котором *inner — раскодированное поле
+ * "response" длиной *inner_len. NULL при любой ошибке.
+ */
+static char *generate_raw_response(const char *prompt, const char *schema, unsigned long long deadline_ms,
+                                   char **inner, size_t *inner_len) {
+    char *escaped_prompt = NULL;
+    char *json_data = NULL;
+    char *result = NULL;
+    const char *format = NULL;
+
+    if (!prompt) goto cleanup;
+    escaped_prompt = json_escape_dup(prompt, strlen(prompt), NULL);
     if (!escaped_prompt) goto cleanup;
 
-    json_data = build_json_payload(escaped_prompt);
-    if (!json_data) goto cleanup;
+    if (OLLAMA_FORMAT == OLLAMA_FORMAT_SCHEMA) format = schema;
+    else if (OLLAMA_FORMAT == OLLAMA_FORMAT_JSON) format = "\"json\"";
 
+    json_data = build_json_payload(escaped_prompt, format);
+    if (!json_data) goto cleanup;
 
-	DEBUG_PRINT_OLLAMA("OLLAMA_HOST=%s, OLLAMA_PORT=%s", OLLAMA_HOST, OLLAMA_PORT);
+    result = exchange_generate(json_data, deadline_ms, inner, inner_len);
 
-	if (http_post(OLLAMA_HOST, OLLAMA_PORT, API_GENERATE_PATH, json_data, headers, &response) < 0 || !response) {
-		ERROR_PRINT("http_post failed or returned NULL response");
-		goto cleanup;
-	}
+cleanup:
+    free(escaped_prompt);
+    free(json_data);
+    return result;
+}
 
-    body = find_http_body(response);
-    if (!body) body = response;
+/*
+ * Дозапрашивает у модели только поля из missing и подставляет в view
+ * те, что пришли непустыми. Строки ответа живут в *repair_buffer
+ * (освободить через http_free_response()).
+ * Возвращает маску полей, которых по-прежнему нет.
+ */
+static unsigned card_repair(const char *word, word_card_t *view, unsigned missing,
+                            unsigned long long deadline_ms, char **repair_buffer) {
+    char *prompt = NULL;
+    char *schema = NULL;
+    char *inner = NULL;
+    size_t inner_len = 0;
+    word_card_t patch;
+    json_scan_t scan;
+    int next = 0;
+    int i;
+
+    *repair_buffer = NULL;
+
+    prompt = build_repair_prompt(word, missing);
+    schema = build_card_schema(missing);
+    if (!prompt || !schema) goto cleanup;
+
+    *repair_buffer = generate_raw_response(prompt, schema, deadline_ms, &inner, &inner_len);
+    if (!*repair_buffer) goto cleanup;
+
+    json_scan_init(&scan, inner, inner_len);
+    if (scan_card_object(&scan, &patch) != 0) {
+        ERROR_PRINT("repair response for '%s' is not a valid JSON object", word);
+    }
 
-    if (strstr(response, "Transfer-Encoding: chunked")) {
-        decoded = decode_chunked_body(body);
+    if ((missing & CARD_FIELD_TRANSLATION) && !card_text_blank(patch.translation)) {
+        view->translation = patch.translation;
+    }
+    if ((missing & CARD_FIELD_TRANSCRIPTION) && !card_text_blank(patch.transcription)) {
+        view->transcription = patch.transcription;
+    }
+    // Примеры из ответа заполняют пропуски по порядку.
+    for (i = 0; i < NUMBER_OF_EXAMPLES; i++) {
+        if (!(missing & CARD_FIELD_EXAMPLE(i))) continue;
+        while (next < NUMBER_OF_EXAMPLES && card_text_blank(patch.examples[next])) next++;
+        if (next == NUMBER_OF_EXAMPLES) break;
+        view->examples[i] = patch.examples[next++];
     }
 
-    const char *json_str = decoded ? decoded : body;
+cleanup:
+    free(prompt);
+    free(schema);
+    return card_missing_fields(view);
+}
 
-    // Ответ модели — это JSON с полем response, внутри которого — вложенный JSON.
-    cJSON *full = cJSON_Parse(json_str);
-    if (!full) goto cleanup;
+/*
+ * Проверяет разобранную карточку и собирает её в одну аллокацию.
+ * Потерянное слово берётся из запроса; у карточки с чужим словом
+ * содержимое отбрасывается и запрашивается заново. Остальные пропуски
+ * дозапрашиваются (до OLLAMA_REPAIR_ATTEMPTS раз в пределах дедлайна)
+ * без повторной генерации всей карточки. *buffer — буфер ответа, на
+ * который указывает view: если все поля в нём, он становится хранилищем
+ * карточки и обнуляется. buffer == NULL — строки всегда копируются.
+ * Возвращает NULL, если карточку восстановить не удалось.
+ */
+static word_card_t *card_finalize(const char *word, word_card_t *view, char **buffer,
+                                  unsigned long long deadline_ms) {
+    word_card_t *packed = NULL;
+    word_card_t *card = NULL;
+    int external = 0;
+    unsigned missing;
+    int attempt;
+
+    if (card_text_blank(view->word)) {
+        view->word = (char *) word;
+        external = 1;
+    } else if (strcasecmp(view->word, word) != 0) {
+        // Карточка про другое слово: её перевод и примеры не годятся,
+        // все поля дозапрашиваются заново для запрошенного слова.
+        DEBUG_PRINT_OLLAMA("card '%s': model answered for '%s', dropping fields", word, view->word);
+        memset(view, 0, sizeof(*view));
+        view->word = (char *) word;
+        external = 1;
+    }
 
-    cJSON *inner = cJSON_GetObjectItem(full, "response");
-    if (!inner || !cJSON_IsString(inner)) {
-        cJSON_Delete(full);
+    missing = card_missing_fields(view);
+    for (attempt = 0; missing && attempt < OLLAMA_REPAIR_ATTEMPTS; attempt++) {
+        char *repair_buffer = NULL;
+        unsigned still;
+
+        if (deadline_ms && http_now_ms() >= deadline_ms) break;
+
+        DEBUG_PRINT_OLLAMA("card '%s': re-requesting fields 0x%x", word, missing);
+        still = card_repair(word, view, missing, deadline_ms, &repair_buffer);
+        ollama_backends_note_repair(still == 0);
+
+        if (still != missing) {
+            // Поля из двух ответов сводятся в одну аллокацию.
+            word_card_t *next = card_pack_copy(view);
+
+            if (!next) {
+                if (repair_buffer) http_free_response(repair_buffer);
+                goto cleanup;
+            }
+            free_word_card(packed);
+            packed = next;
+            *view = *packed;
+            external = 1;
+        }
+        if (repair_buffer) http_free_response(repair_buffer);
+        missing = still;
+    }
+
+    if (missing) {
+        ERROR_PRINT("card '%s' is incomplete, missing fields 0x%x", word, missing);
         goto cleanup;
     }
 
-    card = parse_card_from_json(inner->valuestring);
-    cJSON_Delete(full);
+    if (packed) {
+        card = packed;
+        packed = NULL;
+    } else if (external || !buffer || !*buffer) {
+        card = card_pack_copy(view);
+    } else {
+        // Буфер ответа становится хранилищем строк карточки.
+        card = card_compact_into(*buffer, view);
+        if (card) *buffer = NULL;
+    }
+
+cleanup:
+    free_word_card(packed);
+    return card;
+}
+
+word_card_t *generate_word_card(const char *word, unsigned long long deadline_ms) {
+    char *prompt = NULL;
+    char *schema = NULL;
+    char *buffer = NULL;
+    char *inner = NULL;
+    size_t inner_len = 0;
+    word_card_t view;
+    word_card_t *card = NULL;
+    json_scan_t scan;
+
+    // Ensure Ollama is running
+    ensure_ollama_running();
+
+    prompt = build_prompt_for_word(word);
+    schema = build_card_schema(CARD_FIELD_ALL);
+    if (!prompt || !schema) goto cleanup;
+
+    buffer = generate_raw_response(prompt, schema, deadline_ms, &inner, &inner_len);
+    if (!buffer) goto cleanup;
+
+    // Даже при обрыве JSON уже прочитанные поля сохраняются: дозапрос
+    // в card_finalize() коснётся только недостающих.
+    json_scan_init(&scan, inner, inner_len);
+    if (scan_card_object(&scan, &view) != 0) {
+        ERROR_PRINT("model response for '%s' is not a valid JSON object", word);
+    }
+
+    card = card_finalize(word, &view, &buffer, deadline_ms);
 
 cleanup:
     free(prompt);
-    free(escaped_prompt);
-    free(json_data);
-    if (decoded) free(decoded);
-    if (response) http_free_response(response);
+    free(schema);
+    if (buffer) http_free_response(buffer);
     return card;
 }
 
+/*
+ * Генерирует карточки для пачки слов одним запросом.
+ * out_cards[i] получает карточку для words[i] или NULL, если для этого
+ * слова модель не вернула карточку и дозапрос полей не помог. Карточка
+ * попадает в слот только по совпадению поля "word"; по позиции — лишь
+ * если "word" пустое. Карточка с чужим словом отбрасывается, и её слот
+ * остаётся пустым (вызывающий дозапросит слово отдельно). Возвращает число готовых карточек или -1 при ошибке запроса.
+ */
+int generate_word_cards(const char *const *words, size_t count, word_card_t **out_cards,
+                        unsigned long long deadline_ms) {
+    char *prompt = NULL;
+    char *schema = NULL;
+    char *buffer = NULL;
+    char *inner = NULL;
+    size_t inner_len = 0;
+    word_card_t *views = NULL;
+    json_scan_t scan;
+    size_t i;
+    size_t index = 0;
+    int parsed = -1;
+
+    if (!words || !out_cards || count == 0) return -1;
+
+    for (i = 0; i < count; i++) {
+        out_cards[i] = NULL;
+    }
+
+    ensure_ollama_running();
+
+    prompt = build_prompt_for_words(words, count);
+    schema = build_batch_schema(count);
+    views = calloc(count, sizeof(*views));
+    if (!prompt || !schema || !views) goto cleanup;
+
+    buffer = generate_raw_response(prompt, schema, deadline_ms, &inner, &inner_len);
+    if (!buffer) goto cleanup;
+
+    // Массив карточек — либо сам ответ, либо поле "cards" объекта.
+    json_scan_init(&scan, inner, inner_len);
+    if (json_scan_peek(&scan) == '{') {
+        scan.p++;
+        for (;;) {
+            char *key;
+
+            if (json_scan_string(&scan, &key, NULL) != 0 || json_scan_expect(&scan, ':') != 0) break;
+            if (strcmp(key, "cards") == 0) break;
+            if (json_scan_skip_value(&scan) != 0 || json_scan_expect(&scan, ',') != 0) break;
+        }
+    }
+    if (json_scan_expect(&scan, '[') != 0) {
+        ERROR_PRINT("batch response has no array of cards");
+        goto cleanup;
+    }
+
+    while (json_scan_peek(&scan) != ']') {
+        word_card_t view;
+        size_t slot = count;
+        int valid = 0;
+
+        if (json_scan_peek(&scan) == '{') {
+            valid = scan_card_object(&scan, &view) == 0;
+            if (!valid) ERROR_PRINT("batch item %zu is not a valid JSON object", index);
+
+            // Пустой слот: в views ещё нет ни одного поля.
+            if (!card_text_blank(view.word)) {
+                for (i = 0; i < count; i++) {
+                    if (card_missing_fields(&views[i]) == CARD_FIELD_ALL &&
+                        strcasecmp(words[i], view.word) == 0) {
+                        slot = i;
+                        break;
+                    }
+                }
+            } else if (index < count && card_missing_fields(&views[index]) == CARD_FIELD_ALL) {
+                // Без слова в ответе остаётся только позиция. Карточку с чужим
+                // словом по позиции не берём: модель могла пропустить или
+                // переставить элементы, слот уйдёт в одиночный запрос.
+                slot = index;
+            }
+            if (slot < count) views[slot] = view;
+        } else if (json_scan_skip_value(&scan) != 0) {
+            break;
+        } else {
+            valid = 1;
+        }
+        index++;
+
+        if (!valid || json_scan_peek(&scan) != ',') break;
+        scan.p++;
+    }
+
+    // Карточки делят один буфер ответа, поэтому каждая копируется.
+    parsed = 0;
+    for (i = 0; i < count; i++) {
+        if (card_missing_fields(&views[i]) == CARD_FIELD_ALL) continue;
+        out_cards[i] = card_finalize(words[i], &views[i], NULL, deadline_ms);
+        if (out_cards[i]) parsed++;
+    }
+
+    DEBUG_PRINT_OLLAMA("batch of %zu words: %d cards parsed", count, parsed);
+
+cleanup:
+    free(prompt);
+    free(schema);
+    free(views);
+    if (buffer) http_free_response(buffer);
+    return parsed;
+}
+
 void print_word_card(const word_card_t *card) {
     if (!card) return;
     printf("Word: %s\n", card->word);
@@ -591,11 +1342,15 @@ void free_word_card(word_card_t *card)
 	if (card == NULL)
 		return;
 
-	free(card->word);
-	free(card->translation);
-	free(card->transcription);
-	for (int j = 0; j < NUMBER_OF_EXAMPLES; ++j)
-		free(card->examples[j]);
+	if (card->storage) {
+		free(card->storage);
+	} else {
+		free(card->word);
+		free(card->translation);
+		free(card->transcription);
+		for (int j = 0; j < NUMBER_OF_EXAMPLES; ++j)
+			free(card->examples[j]);
+	}
 	free(card);
 	card = NULL;
 }
@@ -2,6 +2,8 @@
 #ifndef OLLAMA_H
 #define OLLAMA_H
 
+#include <stddef.h>
+
 #define NUMBER_OF_EXAMPLES 2
 
 typedef struct {
@@ -9,10 +11,18 @@ typedef struct {
     char *translation;
     char *transcription;
     char *examples[NUMBER_OF_EXAMPLES];
+    /* Единственная аллокация, в которой лежат все строки карточки. */
+    char *storage;
 } word_card_t;
 
 void ollama_init(void);
-word_card_t *generate_word_card(const char *word);
+/*
+ * deadline_ms — абсолютное время http_now_ms(), к которому ответ модели
+ * должен быть получен; 0 — без ограничения.
+ */
+word_card_t *generate_word_card(const char *word, unsigned long long deadline_ms);
+int generate_word_cards(const char *const *words, size_t count, word_card_t **out_cards,
+                        unsigned long long deadline_ms);
 void print_word_card(const word_card_t *card);
 void free_word_card(word_card_t *card);
 
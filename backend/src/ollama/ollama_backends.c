@@ -0,0 +1,372 @@
+#include "ollama_backends.h"
+
+#include "dbug.h"
+#include "libs/http.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define OLLAMA_BACKEND_DEFAULT_MAX_IN_FLIGHT 4
+#define OLLAMA_BACKEND_DEFAULT_MAX_FAILS 3
+#define OLLAMA_BACKEND_DEFAULT_EJECT_MS 10000
+#define OLLAMA_BACKEND_MIN_SAMPLES 20
+
+static ollama_backend_t g_backends[OLLAMA_MAX_BACKENDS];
+static size_t g_backend_count = 0;
+static size_t g_rr_cursor = 0;
+static int g_max_fails = OLLAMA_BACKEND_DEFAULT_MAX_FAILS;
+static unsigned long long g_eject_ms = OLLAMA_BACKEND_DEFAULT_EJECT_MS;
+static pthread_mutex_t g_backends_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t g_backends_once = PTHREAD_ONCE_INIT;
+static pthread_cond_t g_backends_cond;
+static ollama_backends_stats_t g_stats;
+
+/* Ожидание с дедлайном считается по CLOCK_MONOTONIC, как и http_now_ms(). */
+static void backends_cond_init(void)
+{
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_backends_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static long backends_env_long(const char *name, long fallback)
+{
+    const char *value = getenv(name);
+    char *endptr;
+    long parsed;
+
+    if (!value || value[0] == '\0') {
+        return fallback;
+    }
+
+    parsed = strtol(value, &endptr, 10);
+    if (*endptr != '\0' || parsed <= 0) {
+        return fallback;
+    }
+
+    return parsed;
+}
+
+/*
+ * Разбирает одну запись "host:port[@max_in_flight]".
+ * Возвращает 0 при успехе, -1 если запись некорректна.
+ */
+static int backends_parse_entry(const char *entry, int default_limit, ollama_backend_t *out)
+{
+    char buf[192];
+    char *colon;
+    char *at;
+    long limit = default_limit;
+
+    if (snprintf(buf, sizeof(buf), "%s", entry) >= (int) sizeof(buf)) {
+        return -1;
+    }
+
+    at = strchr(buf, '@');
+    if (at) {
+        char *endptr;
+
+        *at = '\0';
+        limit = strtol(at + 1, &endptr, 10);
+        if (*endptr != '\0' || limit <= 0) {
+            return -1;
+        }
+    }
+
+    colon = strrchr(buf, ':');
+    if (!colon || colon == buf || colon[1] == '\0') {
+        return -1;
+    }
+    *colon = '\0';
+
+    memset(out, 0, sizeof(*out));
+    if (snprintf(out->host, sizeof(out->host), "%s", buf) >= (int) sizeof(out->host) ||
+        snprintf(out->port, sizeof(out->port), "%s", colon + 1) >= (int) sizeof(out->port)) {
+        return -1;
+    }
+    out->max_in_flight = (int) limit;
+    out->healthy = 1;
+    return 0;
+}
+
+void ollama_backends_init(const char *default_host, const char *default_port)
+{
+    const char *list = getenv("OLLAMA_BACKENDS");
+    int default_limit = (int) backends_env_long("OLLAMA_BACKEND_MAX_IN_FLIGHT",
+                                                OLLAMA_BACKEND_DEFAULT_MAX_IN_FLIGHT);
+
+    pthread_once(&g_backends_once, backends_cond_init);
+    pthread_mutex_lock(&g_backends_lock);
+
+    g_backend_count = 0;
+    g_rr_cursor = 0;
+    g_max_fails = (int) backends_env_long("OLLAMA_BACKEND_MAX_FAILS", OLLAMA_BACKEND_DEFAULT_MAX_FAILS);
+    g_eject_ms = (unsigned long long) backends_env_long("OLLAMA_BACKEND_EJECT_MS", OLLAMA_BACKEND_DEFAULT_EJECT_MS);
+
+    if (list && list[0] != '\0') {
+        char *copy = strdup(list);
+        char *saveptr = NULL;
+        char *token;
+
+        for (token = copy ? strtok_r(copy, ", ", &saveptr) : NULL;
+             token && g_backend_count < OLLAMA_MAX_BACKENDS;
+             token = strtok_r(NULL, ", ", &saveptr)) {
+            if (backends_parse_entry(token, default_limit, &g_backends[g_backend_count]) != 0) {
+                ERROR_PRINT("ignoring malformed OLLAMA_BACKENDS entry '%s'", token);
+                continue;
+            }
+            g_backend_count++;
+        }
+        free(copy);
+    }
+
+    if (g_backend_count == 0) {
+        ollama_backend_t *backend = &g_backends[0];
+
+        memset(backend, 0, sizeof(*backend));
+        snprintf(backend->host, sizeof(backend->host), "%s", default_host);
+        snprintf(backend->port, sizeof(backend->port), "%s", default_port);
+        backend->max_in_flight = default_limit;
+        backend->healthy = 1;
+        g_backend_count = 1;
+    }
+
+    DEBUG_PRINT_OLLAMA("configured %zu ollama backend(s)", g_backend_count);
+
+    pthread_mutex_unlock(&g_backends_lock);
+}
+
+size_t ollama_backends_count(void)
+{
+    size_t count;
+
+    pthread_mutex_lock(&g_backends_lock);
+    count = g_backend_count;
+    pthread_mutex_unlock(&g_backends_lock);
+    return count;
+}
+
+/*
+ * Выбор backend'а для нового запроса. Вызывается под g_backends_lock.
+ * *any_available — есть ли backend'ы, которые примут запрос позже.
+ */
+static ollama_backend_t *backends_pick(const ollama_backend_t *exclude, int *any_available)
+{
+    ollama_backend_t *best = NULL;
+    unsigned long long now = http_now_ms();
+    size_t n;
+
+    *any_available = 0;
+
+    for (n = 0; n < g_backend_count; n++) {
+        ollama_backend_t *backend = &g_backends[(g_rr_cursor + n) % g_backend_count];
+
+        if (backend == exclude) {
+            continue;
+        }
+        if (!backend->healthy) {
+            if (now < backend->ejected_until_ms) {
+                continue;
+            }
+            /* half-open: исключённый backend получает один пробный запрос */
+            *any_available = 1;
+            if (backend->in_flight > 0) {
+                continue;
+            }
+        } else {
+            *any_available = 1;
+        }
+
+        if (backend->in_flight >= backend->max_in_flight) {
+            continue;
+        }
+        if (!best || backend->in_flight < best->in_flight) {
+            best = backend;
+        }
+    }
+
+    if (best) {
+        best->in_flight++;
+        best->requests++;
+        g_rr_cursor = (g_rr_cursor + 1) % g_backend_count;
+    }
+    return best;
+}
+
+ollama_backend_t *ollama_backend_acquire(unsigned long long deadline_ms)
+{
+    ollama_backend_t *best = NULL;
+
+    pthread_once(&g_backends_once, backends_cond_init);
+    pthread_mutex_lock(&g_backends_lock);
+
+    for (;;) {
+        int any_available;
+
+        best = backends_pick(NULL, &any_available);
+        if (best) {
+            break;
+        }
+        if (!any_available) {
+            ERROR_PRINT("no healthy ollama backends available");
+            break;
+        }
+
+        if (deadline_ms) {
+            struct timespec ts;
+
+            ts.tv_sec = (time_t) (deadline_ms / 1000ULL);
+            ts.tv_nsec = (long) (deadline_ms % 1000ULL) * 1000000L;
+            if (pthread_cond_timedwait(&g_backends_cond, &g_backends_lock, &ts) != 0 &&
+                http_now_ms() >= deadline_ms) {
+                ERROR_PRINT("deadline exceeded while waiting for an ollama backend");
+                g_stats.timeouts++;
+                break;
+            }
+        } else {
+            pthread_cond_wait(&g_backends_cond, &g_backends_lock);
+        }
+    }
+
+    pthread_mutex_unlock(&g_backends_lock);
+    return best;
+}
+
+ollama_backend_t *ollama_backend_try_acquire_other(const ollama_backend_t *exclude)
+{
+    ollama_backend_t *backend;
+    int any_available;
+
+    pthread_mutex_lock(&g_backends_lock);
+    backend = backends_pick(exclude, &any_available);
+    pthread_mutex_unlock(&g_backends_lock);
+    return backend;
+}
+
+void ollama_backend_release(ollama_backend_t *backend, int outcome,
+                            unsigned long long latency_ms)
+{
+    if (!backend) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_backends_lock);
+
+    if (backend->in_flight > 0) {
+        backend->in_flight--;
+    }
+
+    if (outcome == OLLAMA_BACKEND_OK) {
+        backend->consecutive_failures = 0;
+        backend->latency_ms[backend->latency_next] = latency_ms;
+        backend->latency_next = (backend->latency_next + 1) % OLLAMA_BACKEND_LATENCY_SAMPLES;
+        if (backend->latency_count < OLLAMA_BACKEND_LATENCY_SAMPLES) {
+            backend->latency_count++;
+        }
+        if (!backend->healthy) {
+            backend->healthy = 1;
+            DEBUG_PRINT_OLLAMA("backend %s:%s re-admitted", backend->host, backend->port);
+        }
+    } else if (outcome == OLLAMA_BACKEND_FAILED) {
+        backend->failures++;
+        backend->consecutive_failures++;
+        if (!backend->healthy || backend->consecutive_failures >= g_max_fails) {
+            backend->healthy = 0;
+            backend->ejected_until_ms = http_now_ms() + g_eject_ms;
+            ERROR_PRINT("backend %s:%s ejected for %llu ms after %d failure(s)",
+                        backend->host, backend->port, g_eject_ms, backend->consecutive_failures);
+        }
+    }
+
+    pthread_cond_broadcast(&g_backends_cond);
+    pthread_mutex_unlock(&g_backends_lock);
+}
+
+static int latency_cmp(const void *a, const void *b)
+{
+    unsigned long long x = *(const unsigned long long *) a;
+    unsigned long long y = *(const unsigned long long *) b;
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+unsigned long long ollama_backend_p95_ms(const ollama_backend_t *backend)
+{
+    unsigned long long sorted[OLLAMA_BACKEND_LATENCY_SAMPLES];
+    size_t count;
+
+    if (!backend) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&g_backends_lock);
+    count = backend->latency_count;
+    memcpy(sorted, backend->latency_ms, count * sizeof(sorted[0]));
+    pthread_mutex_unlock(&g_backends_lock);
+
+    if (count < OLLAMA_BACKEND_MIN_SAMPLES) {
+        return 0;
+    }
+
+    qsort(sorted, count, sizeof(sorted[0]), latency_cmp);
+    return sorted[(count * 95 - 1) / 100];
+}
+
+void ollama_backends_note_hedge(int won)
+{
+    pthread_mutex_lock(&g_backends_lock);
+    g_stats.hedges++;
+    if (won) {
+        g_stats.hedge_wins++;
+    }
+    pthread_mutex_unlock(&g_backends_lock);
+}
+
+void ollama_backends_note_timeout(void)
+{
+    pthread_mutex_lock(&g_backends_lock);
+    g_stats.timeouts++;
+    pthread_mutex_unlock(&g_backends_lock);
+}
+
+void ollama_backends_note_repair(int repaired)
+{
+    pthread_mutex_lock(&g_backends_lock);
+    g_stats.repairs++;
+    if (!repaired) {
+        g_stats.repairs_failed++;
+    }
+    pthread_mutex_unlock(&g_backends_lock);
+}
+
+void ollama_backends_get_stats(ollama_backends_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_backends_lock);
+    *out = g_stats;
+    pthread_mutex_unlock(&g_backends_lock);
+}
+
+size_t ollama_backends_snapshot(ollama_backend_t *out, size_t max)
+{
+    size_t count;
+
+    if (!out) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&g_backends_lock);
+    count = g_backend_count < max ? g_backend_count : max;
+    memcpy(out, g_backends, count * sizeof(*out));
+    pthread_mutex_unlock(&g_backends_lock);
+    return count;
+}
@@ -0,0 +1,91 @@
+#ifndef OLLAMA_BACKENDS_H
+#define OLLAMA_BACKENDS_H
+
+#include <stddef.h>
+
+#define OLLAMA_MAX_BACKENDS 16
+#define OLLAMA_BACKEND_LATENCY_SAMPLES 64
+
+enum {
+    OLLAMA_BACKEND_OK = 0,
+    OLLAMA_BACKEND_FAILED = 1,
+    /* Запрос отменён (проиграл hedge) — не успех и не сбой backend'а. */
+    OLLAMA_BACKEND_CANCELLED = 2
+};
+
+typedef struct {
+    char host[128];
+    char port[16];
+    int max_in_flight;
+    int in_flight;
+    int healthy;
+    int consecutive_failures;
+    unsigned long long ejected_until_ms;
+    unsigned long long requests;
+    unsigned long long failures;
+    /* Кольцевой буфер длительностей последних успешных запросов, мс. */
+    unsigned long long latency_ms[OLLAMA_BACKEND_LATENCY_SAMPLES];
+    size_t latency_count;
+    size_t latency_next;
+} ollama_backend_t;
+
+typedef struct {
+    unsigned long long hedges;
+    unsigned long long hedge_wins;
+    unsigned long long timeouts;
+    /* Дозапросы недостающих полей карточки и неудачные из них. */
+    unsigned long long repairs;
+    unsigned long long repairs_failed;
+} ollama_backends_stats_t;
+
+/*
+ * Список upstream-серверов модели.
+ * OLLAMA_BACKENDS="host:port[@max_in_flight],..." — если не задан,
+ * используется единственный OLLAMA_HOST:OLLAMA_PORT.
+ * Лимит по умолчанию — OLLAMA_BACKEND_MAX_IN_FLIGHT (4).
+ */
+void ollama_backends_init(const char *default_host, const char *default_port);
+size_t ollama_backends_count(void);
+
+/*
+ * Выбирает здоровый backend с наименьшим числом запросов в работе
+ * (least outstanding requests) и занимает на нём слот. Если все здоровые
+ * backend'ы заняты, ждёт освобождения, но не дольше deadline_ms
+ * (абсолютное время http_now_ms(), 0 — без ограничения). Backend,
+ * исключённый после OLLAMA_BACKEND_MAX_FAILS ошибок подряд, по истечении
+ * OLLAMA_BACKEND_EJECT_MS получает один пробный запрос.
+ * Возвращает NULL, если доступных backend'ов нет.
+ */
+ollama_backend_t *ollama_backend_acquire(unsigned long long deadline_ms);
+
+/*
+ * Без ожидания занимает слот на любом свободном backend'е, кроме exclude.
+ * Используется для hedge-запросов; NULL, если такого нет.
+ */
+ollama_backend_t *ollama_backend_try_acquire_other(const ollama_backend_t *exclude);
+
+/*
+ * Освобождает слот. outcome — OLLAMA_BACKEND_*; для успешных запросов
+ * latency_ms попадает в статистику задержек backend'а.
+ */
+void ollama_backend_release(ollama_backend_t *backend, int outcome,
+                            unsigned long long latency_ms);
+
+/*
+ * p95 задержки backend'а по последним успешным запросам;
+ * 0, пока выборка меньше OLLAMA_BACKEND_MIN_SAMPLES.
+ */
+unsigned long long ollama_backend_p95_ms(const ollama_backend_t *backend);
+
+void ollama_backends_note_hedge(int won);
+void ollama_backends_note_timeout(void);
+void ollama_backends_note_repair(int repaired);
+void ollama_backends_get_stats(ollama_backends_stats_t *out);
+
+/*
+ * Копирует состояние backend'ов в out (не более max штук).
+ * Возвращает число скопированных.
+ */
+size_t ollama_backends_snapshot(ollama_backend_t *out, size_t max);
+
+#endif
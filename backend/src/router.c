@@ -3,6 +3,7 @@
 #include "handlers/card_handler.h"
 #include "handlers/generate_handler.h"
 #include "handlers/generation_job_handler.h"
+#include "handlers/metrics_handler.h"
 #include "handlers/profile_handler.h"
 #include "handlers/user_handler.h"
 #include "dbug/dbug.h"
@@ -50,5 +51,9 @@ void init_router(void)
 	if (http_register_handler("GET", "/events", handle_realtime_sse) != 0) {
 		ERROR_PRINT("Failed to register handler for GET /events\n");
 	}
+
+	if (http_register_handler("GET", "/metrics", handle_metrics) != 0) {
+		ERROR_PRINT("Failed to register handler for GET /metrics\n");
+	}
 }
 
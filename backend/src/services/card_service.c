@@ -95,8 +95,22 @@ int card_service_update(const card_service_update_input_t *input)
 
 int card_service_delete(const card_service_delete_input_t *input)
 {
-    (void)input;
-    return CARD_SERVICE_ERR_NOT_IMPLEMENTED;
+    if (!input) return CARD_SERVICE_ERR_INVALID_ARGUMENT;
+
+    card_api_delete_input_t delete_input;
+    delete_input.user_id = input->user_id;
+    delete_input.card_id = input->card_id;
+
+    switch (card_api_delete(&delete_input)) {
+    case CARD_API_OK:
+        return CARD_SERVICE_OK;
+    case CARD_API_ERR_INVALID_ARGUMENT:
+        return CARD_SERVICE_ERR_INVALID_ARGUMENT;
+    case CARD_API_ERR_NOT_FOUND:
+        return CARD_SERVICE_ERR_NOT_FOUND;
+    default:
+        return CARD_SERVICE_ERR_SERVER;
+    }
 }
 
 int card_service_exists(const card_service_exists_query_t *query,
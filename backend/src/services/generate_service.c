@@ -29,7 +29,12 @@ int generate_service_generate(const generate_service_request_t *request,
     llm_api_word_card_t generated;
     memset(&generated, 0, sizeof(generated));
 
-    int llm_rc = llm_api_generate_word_card(request->word, &generated);
+    llm_api_request_options_t options;
+    options.user_id = request->user_id;
+    options.priority = LLM_API_PRIORITY_INTERACTIVE;
+    options.deadline_ms = 0;
+
+    int llm_rc = llm_api_generate_word_card(request->word, &options, &generated);
     if (llm_rc == LLM_API_ERR_INVALID_ARGUMENT) {
         return GENERATE_SERVICE_ERR_INVALID_WORD;
     }
@@ -42,6 +47,7 @@ int generate_service_generate(const generate_service_request_t *request,
     out_card->transcription = generated.transcription;
     out_card->examples[0] = generated.examples[0];
     out_card->examples[1] = generated.examples[1];
+    out_card->storage = generated.storage;
     out_card->owner_user_id = request->user_id;
     out_card->was_persisted = 0;
 
@@ -70,24 +76,104 @@ int generate_service_generate(const generate_service_request_t *request,
     return GENERATE_SERVICE_OK;
 }
 
+static int generate_service_map_llm_rc(int llm_rc)
+{
+    if (llm_rc == LLM_API_OK) {
+        return GENERATE_SERVICE_OK;
+    }
+    if (llm_rc == LLM_API_ERR_INVALID_ARGUMENT) {
+        return GENERATE_SERVICE_ERR_INVALID_WORD;
+    }
+    return GENERATE_SERVICE_ERR_UPSTREAM;
+}
+
+int generate_service_generate_batch(const generate_service_batch_request_t *request,
+                                    generate_service_card_t *out_cards,
+                                    int *out_results)
+{
+    llm_api_request_options_t options;
+    llm_api_word_card_t *generated;
+    int *llm_results;
+    size_t i;
+    int llm_rc;
+
+    if (!request || !request->words || request->word_count == 0 ||
+        !out_cards || !out_results) {
+        return GENERATE_SERVICE_ERR_INVALID_ARGUMENT;
+    }
+
+    for (i = 0; i < request->word_count; i++) {
+        generate_service_reset_card(&out_cards[i]);
+        out_results[i] = GENERATE_SERVICE_ERR_UPSTREAM;
+    }
+
+    generated = calloc(request->word_count, sizeof(*generated));
+    llm_results = calloc(request->word_count, sizeof(*llm_results));
+    if (!generated || !llm_results) {
+        free(generated);
+        free(llm_results);
+        return GENERATE_SERVICE_ERR_SERVER;
+    }
+
+    options.user_id = request->user_id;
+    options.priority = LLM_API_PRIORITY_BATCH;
+    options.deadline_ms = 0;
+
+    llm_rc = llm_api_generate_word_cards(request->words, request->word_count,
+                                         &options, generated, llm_results);
+    if (llm_rc != LLM_API_OK) {
+        free(generated);
+        free(llm_results);
+        return llm_rc == LLM_API_ERR_INVALID_ARGUMENT ? GENERATE_SERVICE_ERR_INVALID_WORD
+                                                      : GENERATE_SERVICE_ERR_SERVER;
+    }
+
+    for (i = 0; i < request->word_count; i++) {
+        out_results[i] = generate_service_map_llm_rc(llm_results[i]);
+        if (out_results[i] != GENERATE_SERVICE_OK) {
+            continue;
+        }
+
+        out_cards[i].word = generated[i].word;
+        out_cards[i].translation = generated[i].translation;
+        out_cards[i].transcription = generated[i].transcription;
+        out_cards[i].examples[0] = generated[i].examples[0];
+        out_cards[i].examples[1] = generated[i].examples[1];
+        out_cards[i].storage = generated[i].storage;
+        out_cards[i].owner_user_id = request->user_id;
+        out_cards[i].was_persisted = 0;
+    }
+
+    free(generated);
+    free(llm_results);
+    return GENERATE_SERVICE_OK;
+}
+
 void generate_service_free_card(generate_service_card_t *card)
 {
     int i;
 
     if (!card) return;
 
-    free(card->word);
-    free(card->translation);
-    free(card->transcription);
+    if (card->storage) {
+        free(card->storage);
+    } else {
+        free(card->word);
+        free(card->translation);
+        free(card->transcription);
+        for (i = 0; i < GENERATE_SERVICE_EXAMPLE_COUNT; ++i) {
+            free(card->examples[i]);
+        }
+    }
 
     for (i = 0; i < GENERATE_SERVICE_EXAMPLE_COUNT; ++i) {
-        free(card->examples[i]);
         card->examples[i] = NULL;
     }
 
     card->word = NULL;
     card->translation = NULL;
     card->transcription = NULL;
+    card->storage = NULL;
     card->owner_user_id = 0;
     card->was_persisted = 0;
 }
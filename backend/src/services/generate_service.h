@@ -1,6 +1,8 @@
 #ifndef GENERATE_SERVICE_H
 #define GENERATE_SERVICE_H
 
+#include <stddef.h>
+
 enum {
     GENERATE_SERVICE_EXAMPLE_COUNT = 2
 };
@@ -11,11 +13,19 @@ typedef struct {
     int persist_if_authenticated;
 } generate_service_request_t;
 
+typedef struct {
+    const char *const *words;
+    size_t word_count;
+    int user_id;
+} generate_service_batch_request_t;
+
 typedef struct {
     char *word;
     char *translation;
     char *transcription;
     char *examples[GENERATE_SERVICE_EXAMPLE_COUNT];
+    /* Если не NULL — все строки лежат в этой одной аллокации. */
+    char *storage;
     int owner_user_id;
     int was_persisted;
 } generate_service_card_t;
@@ -40,6 +50,16 @@ enum {
 int generate_service_generate(const generate_service_request_t *request,
                               generate_service_card_t *out_card);
 
+/*
+ * Пакетная генерация без сохранения:
+ * - out_cards и out_results — массивы длины request->word_count;
+ * - out_results[i] получает код GENERATE_SERVICE_* для words[i];
+ * - успешные карточки освобождаются через generate_service_free_card().
+ */
+int generate_service_generate_batch(const generate_service_batch_request_t *request,
+                                    generate_service_card_t *out_cards,
+                                    int *out_results);
+
 /*
  * DTO boundary:
  * - наружу generate_service возвращает generate_service_card_t;
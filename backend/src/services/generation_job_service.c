@@ -1,21 +1,170 @@
 #include "services/generation_job_service.h"
 
+#include "internal_api/generation_job_api.h"
+#include "internal_api/profile_api.h"
 #include "internal_api/realtime_api.h"
 #include "libs/cJSON.h"
 #include "services/card_service.h"
 #include "services/generate_service.h"
+#include "libs/http.h"
+#include "utils/hash.h"
+#include "utils/lemmatizer.h"
+#include "utils/stopwords.h"
 #include "utils/tokenizer.h"
+#include "utils/word_rank.h"
 
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-
-#define GENERATION_JOB_MAX_JOBS 128
-
-static generation_job_t g_jobs[GENERATION_JOB_MAX_JOBS];
+#include <strings.h>
+#include <time.h>
+
+#define GENERATION_JOB_INDEX_MIN_CAPACITY 64
+#define GENERATION_JOB_DEFAULT_TTL_SEC 3600
+#define GENERATION_JOB_DEFAULT_MEMORY_MB 64
+#define GENERATION_JOB_DEFAULT_FLUSH_MS 500
+#define GENERATION_JOB_DEFAULT_DEDUP_WINDOW_SEC 600
+#define GENERATION_JOB_DEDUP_BUCKETS 1024
+#define GENERATION_JOB_DEFAULT_PROGRESS_INTERVAL_MS 100
+#define GENERATION_JOB_DEFAULT_BATCH_SIZE 8
+#define GENERATION_JOB_MAX_BATCH_SIZE 32
+#define GENERATION_JOB_DEFAULT_WORKERS 4
+#define GENERATION_JOB_MAX_WORKERS 32
+#define GENERATION_JOB_DEFAULT_PARALLELISM 4
+#define GENERATION_JOB_DEFAULT_WORD_RANKS_PATH "data/word_ranks.bin"
+/* 0 — срез по рангу выключен, частые слова отсекает known_level. */
+#define GENERATION_JOB_DEFAULT_SKIP_TOP_RANK 0
+#define GENERATION_JOB_DEFAULT_MAX_WORDS 200
+#define GENERATION_JOB_MAX_PARALLELISM 16
+/* Запас на лемму длиннее словоформы ("lit" -> "light"). */
+#define GENERATION_JOB_LEMMA_SLACK 16
+
+/*
+ * Запись хранилища. job — первое поле, поэтому запись получается
+ * из указателя на задачу приведением типа.
+ */
+typedef struct generation_job_entry {
+    generation_job_t job;
+    size_t bytes;
+    int busy;
+    int finished;
+    unsigned long long finished_at_ms;
+    struct generation_job_entry *queue_next;
+    struct generation_job_entry *finished_prev;
+    struct generation_job_entry *finished_next;
+    /* Несохранённые изменения: строка задачи и отмеченные черновики. */
+    int dirty;
+    int flush_all;
+    int flushing;
+    unsigned char *draft_dirty;
+    size_t draft_dirty_capacity;
+    struct generation_job_entry *dirty_next;
+    /* Отпечаток нормализованного текста для поиска повторной отправки. */
+    uint64_t fingerprint;
+    unsigned long long created_at_ms;
+    int dedup_linked;
+    struct generation_job_entry *dedup_next;
+    /*
+     * Отсортированные слова всего текста задачи — для расширения задачи
+     * новым текстом. extend_text — ещё не обработанное добавление,
+     * extend_offset — длина source_text до него.
+     */
+    char **word_set;
+    int word_set_count;
+    char *extend_text;
+    size_t extend_offset;
+    /*
+     * Отложенные события генерации: последний прогресс и, при
+     * GENERATION_JOB_BATCH_DRAFT_EVENTS, накопленные черновики
+     * (JSON-объекты через запятую).
+     */
+    unsigned long long events_sent_ms;
+    const char *pending_step;
+    int pending_progress;
+    char *pending_drafts;
+    size_t pending_drafts_len;
+    size_t pending_drafts_capacity;
+    int events_queued;
+} generation_job_entry_t;
+
+/*
+ * Индекс job_id -> запись: открытая адресация с линейным пробированием,
+ * заполнение не выше половины. Завершённые задачи связаны в список по
+ * времени завершения и выселяются с головы по TTL или при превышении
+ * лимита памяти. busy — задача в очереди или у воркера, её не трогаем;
+ * так же не выселяются задачи с ещё не записанными в БД изменениями.
+ */
+static generation_job_entry_t **g_index = NULL;
+static size_t g_index_capacity = 0;
 static size_t g_job_count = 0;
+static size_t g_store_bytes = 0;
+static size_t g_memory_limit = (size_t) GENERATION_JOB_DEFAULT_MEMORY_MB * 1024 * 1024;
+static unsigned long long g_ttl_ms = (unsigned long long) GENERATION_JOB_DEFAULT_TTL_SEC * 1000;
+static generation_job_entry_t *g_finished_head = NULL;
+static generation_job_entry_t *g_finished_tail = NULL;
 static int g_next_job_id = 1;
 static int g_next_draft_id = 1;
+static int g_batch_size = GENERATION_JOB_DEFAULT_BATCH_SIZE;
+static int g_parallelism = GENERATION_JOB_DEFAULT_PARALLELISM;
+/*
+ * Леммы с рангом 1..g_skip_top_rank не генерируются; 0 — не отсекать.
+ * Срез общий для всех пользователей, поэтому по умолчанию выключен:
+ * частые слова отсеивает is_common_word() по known_level пользователя.
+ */
+static int g_skip_top_rank = GENERATION_JOB_DEFAULT_SKIP_TOP_RANK;
+/* Предел черновиков на задачу; 0 — без предела. */
+static int g_max_words = GENERATION_JOB_DEFAULT_MAX_WORDS;
+
+/*
+ * Хранилище задач и очередь воркеров защищены одним мьютексом.
+ * Пока задача busy, запись не освобождается, поэтому воркер держит
+ * указатель на неё и без блокировки.
+ */
+static pthread_mutex_t g_jobs_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_queue_cond = PTHREAD_COND_INITIALIZER;
+static generation_job_entry_t *g_queue_head = NULL;
+static generation_job_entry_t *g_queue_tail = NULL;
+static pthread_t g_workers[GENERATION_JOB_MAX_WORKERS];
+static int g_worker_count = 0;
+static int g_stopping = 0;
+
+/*
+ * Состояние задач пишется в БД фоновым потоком пачками раз в
+ * GENERATION_JOB_FLUSH_MS: изменения копятся в списке g_dirty_head.
+ */
+static int g_persist = 0;
+static int g_flush_ms = GENERATION_JOB_DEFAULT_FLUSH_MS;
+static pthread_cond_t g_flush_cond;
+static pthread_t g_flusher;
+static int g_flusher_started = 0;
+static int g_flusher_stopping = 0;
+static generation_job_entry_t *g_dirty_head = NULL;
+
+/*
+ * Повторная отправка того же текста тем же пользователем в пределах
+ * GENERATION_JOB_DEDUP_WINDOW_SEC возвращает уже созданную задачу.
+ * Корзины по отпечатку, в цепочке новые записи идут первыми, поэтому
+ * хвост старше окна отрезается при поиске.
+ */
+static generation_job_entry_t *g_dedup[GENERATION_JOB_DEDUP_BUCKETS];
+static unsigned long long g_dedup_window_ms =
+    (unsigned long long) GENERATION_JOB_DEFAULT_DEDUP_WINDOW_SEC * 1000;
+
+/*
+ * Прогресс по черновикам уходит не чаще раза в g_progress_interval_ms
+ * на задачу (0 — каждое событие сразу); промежуточные значения
+ * заменяются последним. g_batch_draft_events собирает черновики за
+ * тот же интервал в одно событие generation.card.drafts. Отложенное
+ * по истечении интервала отправляет поток g_flusher; g_events_queued —
+ * число задач, у которых есть что отправить.
+ */
+static unsigned long long g_progress_interval_ms = GENERATION_JOB_DEFAULT_PROGRESS_INTERVAL_MS;
+static int g_batch_draft_events = 0;
+static size_t g_events_queued = 0;
 
 static char *job_strdup(const char *value)
 {
@@ -41,6 +190,7 @@ static void generation_draft_clear(generation_card_draft_t *draft)
         free(draft->examples[i]);
         draft->examples[i] = NULL;
     }
+    free(draft->forms);
     memset(draft, 0, sizeof(*draft));
 }
 
@@ -63,19 +213,406 @@ static void generation_job_clear(generation_job_t *job)
     memset(job, 0, sizeof(*job));
 }
 
+static size_t generation_job_index_slot(int job_id)
+{
+    /* id идут подряд, умножение Фибоначчи разносит их по таблице. */
+    return (size_t) (((unsigned) job_id * 2654435769u) & (unsigned) (g_index_capacity - 1));
+}
+
 static generation_job_t *generation_job_find(int job_id)
 {
-    size_t i;
+    size_t slot;
+
+    if (g_index_capacity == 0 || job_id <= 0) {
+        return NULL;
+    }
+
+    slot = generation_job_index_slot(job_id);
+    while (g_index[slot]) {
+        if (g_index[slot]->job.job_id == job_id) {
+            return &g_index[slot]->job;
+        }
+        slot = (slot + 1) & (g_index_capacity - 1);
+    }
+
+    return NULL;
+}
+
+static void generation_job_index_place(generation_job_entry_t *entry)
+{
+    size_t slot = generation_job_index_slot(entry->job.job_id);
+
+    while (g_index[slot]) {
+        slot = (slot + 1) & (g_index_capacity - 1);
+    }
+    g_index[slot] = entry;
+}
+
+static int generation_job_index_insert(generation_job_entry_t *entry)
+{
+    if ((g_job_count + 1) * 2 > g_index_capacity) {
+        generation_job_entry_t **old_index = g_index;
+        size_t old_capacity = g_index_capacity;
+        size_t capacity = old_capacity ? old_capacity * 2 : GENERATION_JOB_INDEX_MIN_CAPACITY;
+        size_t i;
+
+        g_index = calloc(capacity, sizeof(*g_index));
+        if (!g_index) {
+            g_index = old_index;
+            return -1;
+        }
+        g_index_capacity = capacity;
+        for (i = 0; i < old_capacity; i++) {
+            if (old_index[i]) {
+                generation_job_index_place(old_index[i]);
+            }
+        }
+        free(old_index);
+    }
+
+    generation_job_index_place(entry);
+    g_job_count++;
+    return 0;
+}
+
+/* Удаление со сдвигом назад: цепочки пробирования остаются без надгробий. */
+static void generation_job_index_remove(int job_id)
+{
+    size_t mask = g_index_capacity - 1;
+    size_t slot;
+    size_t next;
+
+    if (g_index_capacity == 0) {
+        return;
+    }
+
+    slot = generation_job_index_slot(job_id);
+    while (g_index[slot] && g_index[slot]->job.job_id != job_id) {
+        slot = (slot + 1) & mask;
+    }
+    if (!g_index[slot]) {
+        return;
+    }
+
+    g_index[slot] = NULL;
+    g_job_count--;
+    next = (slot + 1) & mask;
+    while (g_index[next]) {
+        size_t home = generation_job_index_slot(g_index[next]->job.job_id);
+
+        /* Запись остаётся, если её домашний слот циклически в (slot, next]. */
+        if ((next > slot && (home <= slot || home > next)) ||
+            (next < slot && (home <= slot && home > next))) {
+            g_index[slot] = g_index[next];
+            g_index[next] = NULL;
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
+static generation_job_entry_t *generation_job_entry_of(generation_job_t *job)
+{
+    return (generation_job_entry_t *) job;
+}
+
+static size_t generation_draft_bytes(const generation_card_draft_t *draft)
+{
+    size_t bytes = sizeof(*draft);
+
+    bytes += draft->status ? strlen(draft->status) + 1 : 0;
+    bytes += draft->word ? strlen(draft->word) + 1 : 0;
+    bytes += draft->transcription ? strlen(draft->transcription) + 1 : 0;
+    bytes += draft->translation ? strlen(draft->translation) + 1 : 0;
+    bytes += draft->examples[0] ? strlen(draft->examples[0]) + 1 : 0;
+    bytes += draft->examples[1] ? strlen(draft->examples[1]) + 1 : 0;
+    bytes += draft->forms ? strlen(draft->forms) + 1 : 0;
+    return bytes;
+}
+
+static void generation_job_account(generation_job_t *job, size_t added, size_t removed)
+{
+    generation_job_entry_t *entry = generation_job_entry_of(job);
+
+    entry->bytes = entry->bytes + added - removed;
+    g_store_bytes = g_store_bytes + added - removed;
+}
+
+/* Вызывается под g_jobs_lock. */
+static void generation_job_mark_dirty(generation_job_t *job)
+{
+    generation_job_entry_t *entry = generation_job_entry_of(job);
+
+    if (!g_persist || entry->dirty) {
+        return;
+    }
+    entry->dirty = 1;
+    entry->dirty_next = g_dirty_head;
+    g_dirty_head = entry;
+}
+
+/* Вызывается под g_jobs_lock. */
+static void generation_job_mark_draft_dirty(generation_job_t *job, const generation_card_draft_t *draft)
+{
+    generation_job_entry_t *entry = generation_job_entry_of(job);
+    size_t index = (size_t) (draft - job->drafts);
+
+    if (!g_persist) {
+        return;
+    }
+    generation_job_mark_dirty(job);
+
+    if (index >= entry->draft_dirty_capacity) {
+        size_t capacity = entry->draft_dirty_capacity ? entry->draft_dirty_capacity : 16;
+        unsigned char *tmp;
+
+        while (capacity <= index) {
+            capacity *= 2;
+        }
+        tmp = realloc(entry->draft_dirty, capacity);
+        if (!tmp) {
+            /* Без отметок следующая запись просто сохранит все черновики. */
+            entry->flush_all = 1;
+            return;
+        }
+        memset(tmp + entry->draft_dirty_capacity, 0, capacity - entry->draft_dirty_capacity);
+        entry->draft_dirty = tmp;
+        entry->draft_dirty_capacity = capacity;
+    }
+    entry->draft_dirty[index] = 1;
+}
+
+static void generation_job_entry_free(generation_job_entry_t *entry)
+{
+    generation_job_clear(&entry->job);
+    free(entry->draft_dirty);
+    free_word_list(entry->word_set, entry->word_set_count);
+    free(entry->extend_text);
+    free(entry->pending_drafts);
+    if (entry->events_queued) {
+        g_events_queued--;
+    }
+    free(entry);
+}
+
+/* Вызывается под g_jobs_lock. */
+static void generation_job_enqueue(generation_job_entry_t *entry)
+{
+    entry->busy = 1;
+    entry->queue_next = NULL;
+    if (g_queue_tail) {
+        g_queue_tail->queue_next = entry;
+    } else {
+        g_queue_head = entry;
+    }
+    g_queue_tail = entry;
+    pthread_cond_signal(&g_queue_cond);
+}
+
+/*
+ * Нормализованный текст для повторной отправки: ASCII-регистр не
+ * учитывается, пробельные промежутки сводятся к одному пробелу, по
+ * краям отбрасываются. Символы выдаются по одному, без копии текста.
+ */
+typedef struct {
+    const char *p;
+    int started;
+} generation_job_norm_t;
+
+static int generation_job_is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/* Следующий символ нормализованного текста или -1 в конце. */
+static int generation_job_norm_next(generation_job_norm_t *it)
+{
+    const char *p = it->p;
+    unsigned char c;
+    int space = 0;
+
+    while (generation_job_is_space(*p)) {
+        space = 1;
+        p++;
+    }
+    if (*p == '\0') {
+        it->p = p;
+        return -1;
+    }
+    if (space && it->started) {
+        it->p = p;
+        return ' ';
+    }
+    c = (unsigned char) *p;
+    it->p = p + 1;
+    it->started = 1;
+    return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+static int generation_job_text_same(const char *a, const char *b)
+{
+    generation_job_norm_t ia = { a, 0 };
+    generation_job_norm_t ib = { b, 0 };
+    int ca;
+    int cb;
+
+    do {
+        ca = generation_job_norm_next(&ia);
+        cb = generation_job_norm_next(&ib);
+    } while (ca == cb && ca >= 0);
+    return ca == cb;
+}
+
+/*
+ * Отпечаток нормализованного текста; user_id входит в seed, так что
+ * одинаковые тексты разных пользователей не совпадают.
+ */
+static int generation_job_fingerprint(const char *text, int user_id, uint64_t *out)
+{
+    generation_job_norm_t it = { text, 0 };
+    char *normalized = malloc(strlen(text) + 1);
+    size_t n = 0;
+    int c;
+
+    if (!normalized) {
+        return -1;
+    }
+
+    while ((c = generation_job_norm_next(&it)) >= 0) {
+        normalized[n++] = (char) c;
+    }
+
+    *out = hash_xxh64(normalized, n, (uint64_t) (unsigned) user_id);
+    free(normalized);
+    return 0;
+}
+
+static size_t generation_job_dedup_bucket(uint64_t fingerprint)
+{
+    return (size_t) (fingerprint & (GENERATION_JOB_DEDUP_BUCKETS - 1));
+}
+
+static void generation_job_dedup_link(generation_job_entry_t *entry)
+{
+    size_t bucket = generation_job_dedup_bucket(entry->fingerprint);
+
+    entry->dedup_next = g_dedup[bucket];
+    entry->dedup_linked = 1;
+    g_dedup[bucket] = entry;
+}
+
+static void generation_job_dedup_unlink(generation_job_entry_t *entry)
+{
+    generation_job_entry_t **link;
 
-    for (i = 0; i < g_job_count; i++) {
-        if (g_jobs[i].job_id == job_id) {
-            return &g_jobs[i];
+    if (!entry->dedup_linked) {
+        return;
+    }
+    link = &g_dedup[generation_job_dedup_bucket(entry->fingerprint)];
+    while (*link && *link != entry) {
+        link = &(*link)->dedup_next;
+    }
+    if (*link) {
+        *link = entry->dedup_next;
+    }
+    entry->dedup_next = NULL;
+    entry->dedup_linked = 0;
+}
+
+/*
+ * Самая свежая задача пользователя с тем же текстом в пределах окна:
+ * отпечаток только отбирает кандидатов, текст сверяется целиком.
+ * Упавшую или отменённую задачу не возвращаем: повторная отправка —
+ * это новая попытка.
+ */
+static generation_job_entry_t *generation_job_dedup_find(int user_id, uint64_t fingerprint,
+                                                         const char *text)
+{
+    unsigned long long now = http_now_ms();
+    generation_job_entry_t **link = &g_dedup[generation_job_dedup_bucket(fingerprint)];
+
+    while (*link) {
+        generation_job_entry_t *entry = *link;
+
+        if (now - entry->created_at_ms >= g_dedup_window_ms) {
+            /* Дальше по цепочке только более старые записи. */
+            *link = NULL;
+            while (entry) {
+                generation_job_entry_t *next = entry->dedup_next;
+
+                entry->dedup_next = NULL;
+                entry->dedup_linked = 0;
+                entry = next;
+            }
+            return NULL;
+        }
+        if (entry->fingerprint == fingerprint && entry->job.user_id == user_id &&
+            generation_job_text_same(entry->job.source_text, text)) {
+            if (strcmp(entry->job.status, GENERATION_JOB_STATE_FAILED) == 0 ||
+                strcmp(entry->job.status, GENERATION_JOB_STATE_CANCELED) == 0) {
+                return NULL;
+            }
+            return entry;
         }
+        link = &entry->dedup_next;
     }
 
     return NULL;
 }
 
+static void generation_job_finished_unlink(generation_job_entry_t *entry)
+{
+    if (!entry->finished) {
+        return;
+    }
+    if (entry->finished_prev) {
+        entry->finished_prev->finished_next = entry->finished_next;
+    } else {
+        g_finished_head = entry->finished_next;
+    }
+    if (entry->finished_next) {
+        entry->finished_next->finished_prev = entry->finished_prev;
+    } else {
+        g_finished_tail = entry->finished_prev;
+    }
+    entry->finished_prev = NULL;
+    entry->finished_next = NULL;
+    entry->finished = 0;
+}
+
+static void generation_job_evict(generation_job_entry_t *entry)
+{
+    generation_job_finished_unlink(entry);
+    generation_job_dedup_unlink(entry);
+    generation_job_index_remove(entry->job.job_id);
+    g_store_bytes -= entry->bytes;
+    generation_job_entry_free(entry);
+}
+
+/*
+ * Выселяет завершённые задачи старше TTL, а также самые старые из них,
+ * пока хранилищу не хватает места под reserve байт.
+ */
+static void generation_job_store_sweep(size_t reserve)
+{
+    unsigned long long now = http_now_ms();
+    generation_job_entry_t *entry = g_finished_head;
+
+    while (entry) {
+        generation_job_entry_t *next = entry->finished_next;
+        int expired = now - entry->finished_at_ms >= g_ttl_ms;
+        int over_limit = g_store_bytes + reserve > g_memory_limit;
+
+        if (!expired && !over_limit) {
+            break;
+        }
+        if (!entry->busy && !entry->dirty && !entry->flushing) {
+            generation_job_evict(entry);
+        }
+        entry = next;
+    }
+}
+
 static generation_card_draft_t *generation_job_find_draft(generation_job_t *job, int draft_id)
 {
     size_t i;
@@ -108,6 +645,25 @@ static int generation_job_set_status(generation_job_t *job, const char *status)
 
     free(job->status);
     job->status = copy;
+    generation_job_mark_dirty(job);
+
+    if (strcmp(status, GENERATION_JOB_STATE_COMPLETED) == 0 ||
+        strcmp(status, GENERATION_JOB_STATE_FAILED) == 0 ||
+        strcmp(status, GENERATION_JOB_STATE_CANCELED) == 0) {
+        generation_job_entry_t *entry = generation_job_entry_of(job);
+
+        if (!entry->finished) {
+            entry->finished = 1;
+            entry->finished_at_ms = http_now_ms();
+            entry->finished_prev = g_finished_tail;
+            if (g_finished_tail) {
+                g_finished_tail->finished_next = entry;
+            } else {
+                g_finished_head = entry;
+            }
+            g_finished_tail = entry;
+        }
+    }
     return 0;
 }
 
@@ -128,36 +684,41 @@ static int generation_job_set_error(generation_job_t *job, const char *message)
 
     free(job->error_message);
     job->error_message = copy;
+    generation_job_mark_dirty(job);
     return 0;
 }
 
-static int is_common_word(const char *word)
+/*
+ * Частые слова и явный мусор, на который не стоит тратить вызовы LLM.
+ * Токенизатор уже отбросил ссылки, токены с цифрами и слишком длинные;
+ * здесь — короткие слова, растянутые междометия ("zzz", "soooo": три
+ * одинаковые буквы подряд в словаре не встречаются) и стоп-слова до
+ * уровня known_level пользователя (служебные слова и сокращения — всегда).
+ */
+static int is_common_word(const char *word, int known_level)
 {
-    static const char *common_words[] = {
-        "the", "a", "an", "and", "or", "but", "to", "of", "in", "on",
-        "at", "for", "with", "from", "by", "is", "am", "are", "was",
-        "were", "be", "been", "being", "it", "this", "that", "these",
-        "those", "i", "you", "he", "she", "we", "they", "my", "your",
-        "his", "her", "our", "their", "me", "him", "them", "as", "if",
-        "than", "then", "so", "do", "does", "did", "have", "has", "had"
-    };
+    size_t chars = 0;
     size_t i;
 
     if (!word || word[0] == '\0') {
         return 1;
     }
 
-    if (strlen(word) <= 2) {
-        return 1;
-    }
-
-    for (i = 0; i < sizeof(common_words) / sizeof(common_words[0]); i++) {
-        if (strcmp(common_words[i], word) == 0) {
+    for (i = 0; word[i]; i++) {
+        /* Символы UTF-8, а не байты: продолжения вида 10xxxxxx не считаем. */
+        if (((unsigned char) word[i] & 0xC0) != 0x80) {
+            chars++;
+        }
+        if (i >= 2 && word[i] == word[i - 1] && word[i] == word[i - 2] &&
+            ((unsigned char) word[i] & 0x80) == 0) {
             return 1;
         }
     }
+    if (chars <= 2) {
+        return 1;
+    }
 
-    return 0;
+    return stopword_is_known(word, known_level);
 }
 
 static char *build_progress_payload(const char *step, int progress, const char *status)
@@ -199,6 +760,7 @@ static char *build_job_payload(const generation_job_t *job)
     cJSON_AddStringToObject(root, "status", job->status ? job->status : "");
     cJSON_AddNumberToObject(root, "generated_drafts", job->generated_drafts);
     cJSON_AddNumberToObject(root, "reviewed_drafts", job->reviewed_drafts);
+    cJSON_AddNumberToObject(root, "failed_words", job->failed_words);
     if (job->error_message) {
         cJSON_AddStringToObject(root, "error", job->error_message);
     }
@@ -230,6 +792,7 @@ static char *build_draft_payload(const generation_card_draft_t *draft)
     cJSON_AddStringToObject(root, "word", draft->word ? draft->word : "");
     cJSON_AddStringToObject(root, "transcription", draft->transcription ? draft->transcription : "");
     cJSON_AddStringToObject(root, "translation", draft->translation ? draft->translation : "");
+    cJSON_AddStringToObject(root, "forms", draft->forms ? draft->forms : "");
     if (draft->saved_card_id > 0) {
         cJSON_AddNumberToObject(root, "card_id", draft->saved_card_id);
     }
@@ -280,6 +843,145 @@ static void emit_draft_event(generation_job_t *job, const generation_card_draft_
     cJSON_free(payload);
 }
 
+/* Вызывается под g_jobs_lock. Отправляет всё отложенное по задаче. */
+static void generation_job_flush_events(generation_job_t *job)
+{
+    generation_job_entry_t *entry = generation_job_entry_of(job);
+
+    if (entry->pending_drafts_len > 0) {
+        static const char prefix[] = "{\"drafts\":[";
+        char *payload = malloc(sizeof(prefix) - 1 + entry->pending_drafts_len + 3);
+
+        if (payload) {
+            memcpy(payload, prefix, sizeof(prefix) - 1);
+            memcpy(payload + sizeof(prefix) - 1, entry->pending_drafts, entry->pending_drafts_len);
+            memcpy(payload + sizeof(prefix) - 1 + entry->pending_drafts_len, "]}", 3);
+            realtime_emit_event(REALTIME_EVENT_GENERATION_CARD_DRAFTS, job->job_id, payload);
+            free(payload);
+        }
+        entry->pending_drafts_len = 0;
+    }
+    if (entry->pending_step) {
+        emit_progress_event(job, entry->pending_step, entry->pending_progress);
+        entry->pending_step = NULL;
+    }
+    entry->events_sent_ms = http_now_ms();
+    if (entry->events_queued) {
+        entry->events_queued = 0;
+        g_events_queued--;
+    }
+}
+
+/* Вызывается под g_jobs_lock. У задачи появились отложенные события. */
+static void generation_job_events_queued(generation_job_entry_t *entry)
+{
+    if (entry->events_queued) {
+        return;
+    }
+    entry->events_queued = 1;
+    /* Поток записи мог заснуть без срока — будим, чтобы он завёл таймер. */
+    if (g_events_queued++ == 0 && g_flusher_started) {
+        pthread_cond_signal(&g_flush_cond);
+    }
+}
+
+/* Вызывается под g_jobs_lock. */
+static void generation_job_flush_events_if_due(generation_job_t *job)
+{
+    generation_job_entry_t *entry = generation_job_entry_of(job);
+
+    if (http_now_ms() - entry->events_sent_ms >= g_progress_interval_ms) {
+        generation_job_flush_events(job);
+    }
+}
+
+/*
+ * Вызывается под g_jobs_lock из потока g_flusher: отправляет события
+ * задач, у которых истёк интервал. Возвращает момент ближайшей
+ * следующей отправки по http_now_ms(); 0 — отложенного больше нет.
+ */
+static unsigned long long generation_job_flush_due_events(unsigned long long now)
+{
+    unsigned long long next = 0;
+    size_t i;
+
+    for (i = 0; g_events_queued > 0 && i < g_index_capacity; i++) {
+        generation_job_entry_t *entry = g_index[i];
+        unsigned long long due;
+
+        if (!entry || !entry->events_queued) {
+            continue;
+        }
+        due = entry->events_sent_ms + g_progress_interval_ms;
+        if (due <= now) {
+            generation_job_flush_events(&entry->job);
+        } else if (next == 0 || due < next) {
+            next = due;
+        }
+    }
+    return next;
+}
+
+/* Вызывается под g_jobs_lock. */
+static void generation_job_queue_progress(generation_job_t *job, const char *step, int progress)
+{
+    generation_job_entry_t *entry = generation_job_entry_of(job);
+
+    if (g_progress_interval_ms == 0) {
+        emit_progress_event(job, step, progress);
+        return;
+    }
+    entry->pending_step = step;
+    entry->pending_progress = progress;
+    generation_job_events_queued(entry);
+}
+
+/* Вызывается под g_jobs_lock. */
+static void generation_job_queue_draft(generation_job_t *job, const generation_card_draft_t *draft)
+{
+    generation_job_entry_t *entry = generation_job_entry_of(job);
+    char *payload;
+    size_t len;
+    size_t needed;
+
+    if (!g_batch_draft_events || g_progress_interval_ms == 0) {
+        emit_draft_event(job, draft, REALTIME_EVENT_GENERATION_CARD_DRAFT);
+        return;
+    }
+
+    payload = build_draft_payload(draft);
+    if (!payload) {
+        return;
+    }
+    len = strlen(payload);
+    needed = entry->pending_drafts_len + len + 1;
+    if (needed > entry->pending_drafts_capacity) {
+        size_t capacity = entry->pending_drafts_capacity ? entry->pending_drafts_capacity : 1024;
+        char *tmp;
+
+        while (capacity < needed) {
+            capacity *= 2;
+        }
+        tmp = realloc(entry->pending_drafts, capacity);
+        if (!tmp) {
+            /* Не влезло в пачку — отправляем отдельным событием. */
+            cJSON_free(payload);
+            emit_draft_event(job, draft, REALTIME_EVENT_GENERATION_CARD_DRAFT);
+            return;
+        }
+        entry->pending_drafts = tmp;
+        generation_job_account(job, capacity, entry->pending_drafts_capacity);
+        entry->pending_drafts_capacity = capacity;
+    }
+    if (entry->pending_drafts_len > 0) {
+        entry->pending_drafts[entry->pending_drafts_len++] = ',';
+    }
+    memcpy(entry->pending_drafts + entry->pending_drafts_len, payload, len);
+    entry->pending_drafts_len += len;
+    cJSON_free(payload);
+    generation_job_events_queued(entry);
+}
+
 static void emit_job_event(generation_job_t *job, const char *event_type)
 {
     char *payload;
@@ -297,7 +999,8 @@ static void emit_job_event(generation_job_t *job, const char *event_type)
     cJSON_free(payload);
 }
 
-static int generation_job_append_draft(generation_job_t *job, const generate_service_card_t *card)
+static int generation_job_append_draft(generation_job_t *job, const generate_service_card_t *card,
+                                       const char *forms)
 {
     generation_card_draft_t *tmp;
     generation_card_draft_t *draft;
@@ -323,403 +1026,1863 @@ static int generation_job_append_draft(generation_job_t *job, const generate_ser
     draft->translation = job_strdup(card->translation ? card->translation : "");
     draft->examples[0] = job_strdup(card->examples[0] ? card->examples[0] : "");
     draft->examples[1] = job_strdup(card->examples[1] ? card->examples[1] : "");
+    draft->forms = job_strdup(forms ? forms : "");
 
     if (!draft->status || !draft->word || !draft->transcription ||
-        !draft->translation || !draft->examples[0] || !draft->examples[1]) {
+        !draft->translation || !draft->examples[0] || !draft->examples[1] || !draft->forms) {
         generation_draft_clear(draft);
         return -1;
     }
 
     job->draft_count++;
     job->generated_drafts = (int) job->draft_count;
+    generation_job_account(job, generation_draft_bytes(draft), 0);
+    generation_job_mark_draft_dirty(job, draft);
     return 0;
 }
 
-static void generation_job_finalize_if_review_complete(generation_job_t *job)
+static int generation_draft_copy(const generation_card_draft_t *src, generation_card_draft_t *dst)
 {
-    size_t i;
-
-    if (!job || !job->status) {
-        return;
-    }
-    if (strcmp(job->status, GENERATION_JOB_STATE_CANCELED) == 0 ||
-        strcmp(job->status, GENERATION_JOB_STATE_FAILED) == 0 ||
-        strcmp(job->status, GENERATION_JOB_STATE_COMPLETED) == 0) {
-        return;
+    memset(dst, 0, sizeof(*dst));
+    dst->job_id = src->job_id;
+    dst->draft_id = src->draft_id;
+    dst->user_id = src->user_id;
+    dst->saved_card_id = src->saved_card_id;
+    dst->status = job_strdup(src->status ? src->status : "");
+    dst->word = job_strdup(src->word ? src->word : "");
+    dst->transcription = job_strdup(src->transcription ? src->transcription : "");
+    dst->translation = job_strdup(src->translation ? src->translation : "");
+    dst->examples[0] = job_strdup(src->examples[0] ? src->examples[0] : "");
+    dst->examples[1] = job_strdup(src->examples[1] ? src->examples[1] : "");
+    dst->forms = job_strdup(src->forms ? src->forms : "");
+
+    if (!dst->status || !dst->word || !dst->transcription ||
+        !dst->translation || !dst->examples[0] || !dst->examples[1] || !dst->forms) {
+        generation_draft_clear(dst);
+        return -1;
     }
+    return 0;
+}
 
-    for (i = 0; i < job->draft_count; i++) {
-        if (job->drafts[i].status &&
-            strcmp(job->drafts[i].status, GENERATION_DRAFT_STATUS_PENDING) == 0) {
-            return;
+/* Копия полей задачи без черновиков. */
+static int generation_job_copy_row(const generation_job_t *src, generation_job_t *dst)
+{
+    memset(dst, 0, sizeof(*dst));
+    dst->job_id = src->job_id;
+    dst->user_id = src->user_id;
+    dst->total_words = src->total_words;
+    dst->filtered_words = src->filtered_words;
+    dst->existing_words = src->existing_words;
+    dst->generated_drafts = src->generated_drafts;
+    dst->reviewed_drafts = src->reviewed_drafts;
+    dst->failed_words = src->failed_words;
+    dst->status = job_strdup(src->status ? src->status : "");
+    dst->source_text = job_strdup(src->source_text ? src->source_text : "");
+    if (src->error_message) {
+        dst->error_message = job_strdup(src->error_message);
+        if (!dst->error_message) {
+            generation_job_clear(dst);
+            return -1;
         }
     }
-
-    if (generation_job_set_status(job, GENERATION_JOB_STATE_COMPLETED) == 0) {
-        emit_job_event(job, REALTIME_EVENT_GENERATION_JOB_COMPLETED);
+    if (!dst->status || !dst->source_text) {
+        generation_job_clear(dst);
+        return -1;
     }
+    return 0;
 }
 
-static int generation_job_run_pipeline(generation_job_t *job)
+/* Снимок задачи для вызывающего: воркеры продолжают менять оригинал. */
+static int generation_job_copy(const generation_job_t *src, generation_job_t *dst)
 {
-    char **words = NULL;
-    char **candidates = NULL;
-    int word_count = 0;
-    int candidate_count = 0;
-    int i;
+    size_t i;
 
-    if (!job || !job->source_text) {
-        return GENERATION_JOB_SERVICE_ERR_INVALID_ARGUMENT;
+    if (generation_job_copy_row(src, dst) != 0) {
+        return -1;
     }
 
-    if (generation_job_set_status(job, GENERATION_JOB_STATE_TOKENIZING) != 0) {
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
+    if (src->draft_count > 0) {
+        dst->drafts = calloc(src->draft_count, sizeof(*dst->drafts));
+        if (!dst->drafts) {
+            generation_job_clear(dst);
+            return -1;
+        }
+        for (i = 0; i < src->draft_count; i++) {
+            if (generation_draft_copy(&src->drafts[i], &dst->drafts[i]) != 0) {
+                generation_job_clear(dst);
+                return -1;
+            }
+            dst->draft_count++;
+        }
     }
-    emit_progress_event(job, GENERATION_JOB_STATE_TOKENIZING, 10);
 
-    words = extract_unique_words(job->source_text, &word_count);
-    if (!words && word_count != 0) {
-        generation_job_set_status(job, GENERATION_JOB_STATE_FAILED);
-        generation_job_set_error(job, "tokenization_failed");
-        emit_job_event(job, REALTIME_EVENT_GENERATION_JOB_FAILED);
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
-    }
-    job->total_words = word_count;
+    return 0;
+}
 
-    if (generation_job_set_status(job, GENERATION_JOB_STATE_FILTERING_COMMON_WORDS) != 0) {
-        free_word_list(words, word_count);
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
-    }
-    emit_progress_event(job, GENERATION_JOB_STATE_FILTERING_COMMON_WORDS, 25);
+/* Вызывается под g_jobs_lock. */
+static int generation_job_has_draft_for(const generation_job_t *job, const char *word)
+{
+    size_t i;
 
-    if (word_count > 0) {
-        candidates = calloc((size_t) word_count, sizeof(*candidates));
-        if (!candidates) {
-            free_word_list(words, word_count);
-            return GENERATION_JOB_SERVICE_ERR_SERVER;
+    for (i = 0; i < job->draft_count; i++) {
+        if (job->drafts[i].word && strcasecmp(job->drafts[i].word, word) == 0) {
+            return 1;
         }
     }
+    return 0;
+}
+
+/* Вызывается под g_jobs_lock. */
+static int generation_job_is_stopped(const generation_job_t *job)
+{
+    return g_stopping || strcmp(job->status, GENERATION_JOB_STATE_CANCELED) == 0;
+}
+
+static int generation_job_check_stopped(generation_job_t *job)
+{
+    int stopped;
+
+    pthread_mutex_lock(&g_jobs_lock);
+    stopped = generation_job_is_stopped(job);
+    pthread_mutex_unlock(&g_jobs_lock);
+    return stopped;
+}
+
+/*
+ * Переводит задачу на следующую стадию. Отменённую задачу не трогает:
+ * статус canceled выставляет generation_job_service_cancel, и воркер
+ * не должен его перезаписать.
+ */
+static int generation_job_enter_stage(generation_job_t *job, const char *state, int progress)
+{
+    int rc = GENERATION_JOB_SERVICE_OK;
+
+    pthread_mutex_lock(&g_jobs_lock);
+    if (generation_job_is_stopped(job)) {
+        rc = GENERATION_JOB_SERVICE_ERR_CONFLICT;
+    } else if (generation_job_set_status(job, state) != 0) {
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+    } else {
+        emit_progress_event(job, state, progress);
+    }
+    pthread_mutex_unlock(&g_jobs_lock);
+    return rc;
+}
+
+static void generation_job_fail(generation_job_t *job, const char *message)
+{
+    pthread_mutex_lock(&g_jobs_lock);
+    generation_job_flush_events(job);
+    if (!generation_job_is_stopped(job)) {
+        generation_job_set_status(job, GENERATION_JOB_STATE_FAILED);
+        generation_job_set_error(job, message);
+        emit_job_event(job, REALTIME_EVENT_GENERATION_JOB_FAILED);
+    }
+    pthread_mutex_unlock(&g_jobs_lock);
+}
+
+/* Вызывается под g_jobs_lock. */
+static void generation_job_finalize_if_review_complete(generation_job_t *job)
+{
+    size_t i;
+
+    if (!job || !job->status) {
+        return;
+    }
+    /* Пока воркер генерирует, черновики ещё добавляются. */
+    if (strcmp(job->status, GENERATION_JOB_STATE_REVIEW_READY) != 0) {
+        return;
+    }
+
+    for (i = 0; i < job->draft_count; i++) {
+        if (job->drafts[i].status &&
+            strcmp(job->drafts[i].status, GENERATION_DRAFT_STATUS_PENDING) == 0) {
+            return;
+        }
+    }
+
+    if (generation_job_set_status(job, GENERATION_JOB_STATE_COMPLETED) == 0) {
+        emit_job_event(job, REALTIME_EVENT_GENERATION_JOB_COMPLETED);
+    }
+}
+
+/*
+ * Кандидаты — строки из блока generation_job_group_lemmas: сразу за
+ * леммой лежат её словоформы из текста.
+ */
+static const char *generation_job_lemma_forms(const char *lemma)
+{
+    return lemma + strlen(lemma) + 1;
+}
+
+/*
+ * Стадия GENERATING одной задачи: до g_parallelism потоков разбирают
+ * пачки кандидатов через общий курсор. Поля, кроме неизменяемых
+ * job/candidates/candidate_count, меняются под g_jobs_lock.
+ */
+typedef struct {
+    generation_job_t *job;
+    char **candidates;
+    int candidate_count;
+    int resumed_count;
+    int next_index;
+    int processed;
+    int rc;
+} generation_job_fanout_t;
+
+/* Вызывается под g_jobs_lock. Черновики добавляются в порядке готовности. */
+static void generation_job_collect_batch(generation_job_fanout_t *fanout,
+                                         generate_service_card_t *cards,
+                                         const int *results,
+                                         int start,
+                                         int batch_count,
+                                         int batch_rc)
+{
+    generation_job_t *job = fanout->job;
+    int stopped = generation_job_is_stopped(job);
+    int j;
+
+    for (j = 0; j < batch_count; j++) {
+        int ok = batch_rc == GENERATE_SERVICE_OK && results[j] == GENERATE_SERVICE_OK;
+
+        fanout->processed++;
+        /* Отмена во время запроса к LLM: результат отбрасывается. */
+        if (stopped || fanout->rc != GENERATION_JOB_SERVICE_OK) {
+            generate_service_free_card(&cards[j]);
+            continue;
+        }
+
+        if (!ok) {
+            job->failed_words++;
+            generation_job_mark_dirty(job);
+        } else if (generation_job_append_draft(job, &cards[j],
+                                               generation_job_lemma_forms(fanout->candidates[start + j])) != 0) {
+            fanout->rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        } else {
+            generation_job_queue_draft(job, &job->drafts[job->draft_count - 1]);
+        }
+        if (fanout->rc == GENERATION_JOB_SERVICE_OK) {
+            generation_job_queue_progress(job, GENERATION_JOB_STATE_GENERATING,
+                                          60 + ((fanout->resumed_count + fanout->processed) * 35) /
+                                               (fanout->resumed_count + fanout->candidate_count));
+        }
+        generate_service_free_card(&cards[j]);
+    }
+    generation_job_flush_events_if_due(job);
+}
+
+static void *generation_job_generate_main(void *arg)
+{
+    generation_job_fanout_t *fanout = arg;
+    generation_job_t *job = fanout->job;
+
+    for (;;) {
+        generate_service_batch_request_t request;
+        generate_service_card_t cards[GENERATION_JOB_MAX_BATCH_SIZE];
+        int results[GENERATION_JOB_MAX_BATCH_SIZE];
+        int start;
+        int batch_count;
+        int batch_rc;
+
+        pthread_mutex_lock(&g_jobs_lock);
+        if (fanout->rc != GENERATION_JOB_SERVICE_OK || generation_job_is_stopped(job) ||
+            fanout->next_index >= fanout->candidate_count) {
+            pthread_mutex_unlock(&g_jobs_lock);
+            break;
+        }
+        start = fanout->next_index;
+        batch_count = fanout->candidate_count - start < g_batch_size ?
+                      fanout->candidate_count - start : g_batch_size;
+        fanout->next_index += batch_count;
+        pthread_mutex_unlock(&g_jobs_lock);
+
+        request.words = (const char *const *) &fanout->candidates[start];
+        request.word_count = (size_t) batch_count;
+        request.user_id = job->user_id;
+
+        batch_rc = generate_service_generate_batch(&request, cards, results);
+
+        pthread_mutex_lock(&g_jobs_lock);
+        generation_job_collect_batch(fanout, cards, results, start, batch_count, batch_rc);
+        pthread_mutex_unlock(&g_jobs_lock);
+    }
+
+    return NULL;
+}
+
+/*
+ * Общий предел одновременных запросов к LLM держит llm_scheduler,
+ * здесь ограничивается только доля одной задачи.
+ */
+static int generation_job_generate_drafts(generation_job_t *job, char **candidates,
+                                          int candidate_count, int resumed_count)
+{
+    generation_job_fanout_t fanout;
+    pthread_t helpers[GENERATION_JOB_MAX_PARALLELISM];
+    int batches = (candidate_count + g_batch_size - 1) / g_batch_size;
+    int helper_count = 0;
+    int wanted;
+    int i;
+
+    memset(&fanout, 0, sizeof(fanout));
+    fanout.job = job;
+    fanout.candidates = candidates;
+    fanout.candidate_count = candidate_count;
+    fanout.resumed_count = resumed_count;
+    fanout.rc = GENERATION_JOB_SERVICE_OK;
+
+    /* Текущий воркер сам разбирает пачки наравне с помощниками. */
+    wanted = (batches < g_parallelism ? batches : g_parallelism) - 1;
+    for (i = 0; i < wanted; i++) {
+        if (pthread_create(&helpers[helper_count], NULL, generation_job_generate_main, &fanout) != 0) {
+            break;
+        }
+        helper_count++;
+    }
+
+    generation_job_generate_main(&fanout);
+    for (i = 0; i < helper_count; i++) {
+        pthread_join(helpers[i], NULL);
+    }
+
+    return fanout.rc;
+}
+
+static int generation_job_word_cmp(const void *a, const void *b)
+{
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+static size_t generation_job_word_set_bytes(char **words, int count)
+{
+    size_t bytes = (size_t) count * sizeof(*words);
+    int i;
+
+    for (i = 0; i < count; i++) {
+        bytes += strlen(words[i]) + 1;
+    }
+    return bytes;
+}
+
+/*
+ * Сохраняет слова текста в записи задачи. Массив words переходит
+ * в запись (сортируется на месте), *words обнуляется.
+ */
+static void generation_job_keep_word_set(generation_job_entry_t *entry, char ***words, int count)
+{
+    size_t bytes = generation_job_word_set_bytes(*words, count);
+
+    qsort(*words, (size_t) count, sizeof(**words), generation_job_word_cmp);
+
+    pthread_mutex_lock(&g_jobs_lock);
+    generation_job_account(&entry->job, bytes,
+                           generation_job_word_set_bytes(entry->word_set, entry->word_set_count));
+    pthread_mutex_unlock(&g_jobs_lock);
+
+    free_word_list(entry->word_set, entry->word_set_count);
+    entry->word_set = *words;
+    entry->word_set_count = count;
+    *words = NULL;
+}
+
+/*
+ * Вливает новые слова в отсортированный набор задачи. Список слов
+ * токенизатора — один блок, поэтому набор собирается заново тем же
+ * способом: указатели, за ними копии строк.
+ */
+static void generation_job_merge_word_set(generation_job_entry_t *entry, char **fresh, int fresh_count)
+{
+    int total = entry->word_set_count + fresh_count;
+    size_t header = (size_t) total * sizeof(char *);
+    size_t old_bytes = generation_job_word_set_bytes(entry->word_set, entry->word_set_count);
+    size_t bytes = header;
+    char **merged;
+    char *arena;
+    int a = 0;
+    int b = 0;
+    int m;
+
+    if (fresh_count == 0) {
+        return;
+    }
+    for (m = 0; m < entry->word_set_count; m++) {
+        bytes += strlen(entry->word_set[m]) + 1;
+    }
+    for (m = 0; m < fresh_count; m++) {
+        bytes += strlen(fresh[m]) + 1;
+    }
+
+    merged = malloc(bytes);
+    if (!merged) {
+        /* Набор неполон: повторная добавка этих слов просто пройдёт проверку в БД ещё раз. */
+        return;
+    }
+    arena = (char *) merged + header;
+    qsort(fresh, (size_t) fresh_count, sizeof(*fresh), generation_job_word_cmp);
+    for (m = 0; m < total; m++) {
+        const char *word;
+        size_t len;
+
+        if (b >= fresh_count ||
+            (a < entry->word_set_count && strcmp(entry->word_set[a], fresh[b]) < 0)) {
+            word = entry->word_set[a++];
+        } else {
+            word = fresh[b++];
+        }
+        len = strlen(word) + 1;
+        memcpy(arena, word, len);
+        merged[m] = arena;
+        arena += len;
+    }
+
+    pthread_mutex_lock(&g_jobs_lock);
+    generation_job_account(&entry->job, generation_job_word_set_bytes(merged, total), old_bytes);
+    pthread_mutex_unlock(&g_jobs_lock);
+
+    free_word_list(entry->word_set, entry->word_set_count);
+    entry->word_set = merged;
+    entry->word_set_count = total;
+}
+
+typedef struct {
+    const char *lemma;
+    int index;          /* позиция словоформы в words */
+} generation_job_lemma_item_t;
+
+typedef struct {
+    int start;          /* словоформы группы: items[start, end) */
+    int end;
+    int first;          /* первое появление в тексте */
+} generation_job_lemma_group_t;
+
+static int generation_job_lemma_item_cmp(const void *a, const void *b)
+{
+    const generation_job_lemma_item_t *x = a;
+    const generation_job_lemma_item_t *y = b;
+    int c = strcmp(x->lemma, y->lemma);
+
+    return c ? c : (x->index > y->index) - (x->index < y->index);
+}
+
+static int generation_job_lemma_group_cmp(const void *a, const void *b)
+{
+    const generation_job_lemma_group_t *x = a;
+    const generation_job_lemma_group_t *y = b;
+
+    return (x->first > y->first) - (x->first < y->first);
+}
+
+/*
+ * Стадия LEMMATIZING: словоформы одного слова ("runs", "running", "ran")
+ * сливаются в одного кандидата "run" — одна проверка в БД и один вызов
+ * LLM вместо четырёх. Результат — один блок, как у extract_unique_words
+ * (освобождается free_word_list), леммы в порядке первого появления.
+ * За каждой леммой в блоке лежит строка её словоформ через ", " без
+ * самой леммы — для показа в черновике (generation_job_lemma_forms).
+ */
+static char **generation_job_group_lemmas(char **words, int word_count, int *out_count)
+{
+    generation_job_lemma_item_t *items = NULL;
+    generation_job_lemma_group_t *groups = NULL;
+    char *lemma_arena = NULL;
+    char **lemmas = NULL;
+    size_t arena_size = 0;
+    size_t used = 0;
+    size_t total = 0;
+    size_t header;
+    char *out;
+    int group_count = 0;
+    int i;
+    int g;
+
+    *out_count = 0;
+    for (i = 0; i < word_count; i++) {
+        arena_size += strlen(words[i]) + GENERATION_JOB_LEMMA_SLACK;
+    }
+    items = malloc((size_t) (word_count > 0 ? word_count : 1) * sizeof(*items));
+    groups = malloc((size_t) (word_count > 0 ? word_count : 1) * sizeof(*groups));
+    lemma_arena = malloc(arena_size + 1);
+    if (!items || !groups || !lemma_arena) {
+        goto cleanup;
+    }
 
     for (i = 0; i < word_count; i++) {
-        if (is_common_word(words[i])) {
-            job->filtered_words++;
+        size_t len = strlen(words[i]);
+        size_t room = len + GENERATION_JOB_LEMMA_SLACK;
+        size_t n = lemmatize(words[i], lemma_arena + used, room);
+
+        if (n >= room) {
+            memcpy(lemma_arena + used, words[i], len + 1);
+            n = len;
+        }
+        items[i].lemma = lemma_arena + used;
+        items[i].index = i;
+        used += n + 1;
+    }
+    qsort(items, (size_t) word_count, sizeof(*items), generation_job_lemma_item_cmp);
+
+    for (i = 0; i < word_count; ) {
+        generation_job_lemma_group_t *group = &groups[group_count++];
+        int k;
+
+        group->start = i;
+        group->first = items[i].index;
+        while (i < word_count && strcmp(items[i].lemma, items[group->start].lemma) == 0) {
+            i++;
+        }
+        group->end = i;
+
+        total += strlen(items[group->start].lemma) + 2;
+        for (k = group->start; k < group->end; k++) {
+            total += strlen(words[items[k].index]) + 2;
+        }
+    }
+    qsort(groups, (size_t) group_count, sizeof(*groups), generation_job_lemma_group_cmp);
+
+    header = (size_t) (group_count > 0 ? group_count : 1) * sizeof(char *);
+    lemmas = malloc(header + total);
+    if (!lemmas) {
+        goto cleanup;
+    }
+    out = (char *) lemmas + header;
+    for (g = 0; g < group_count; g++) {
+        const char *lemma = items[groups[g].start].lemma;
+        size_t len = strlen(lemma);
+        int forms = 0;
+        int k;
+
+        lemmas[g] = out;
+        memcpy(out, lemma, len + 1);
+        out += len + 1;
+        /* Внутри группы словоформы уже по порядку появления. */
+        for (k = groups[g].start; k < groups[g].end; k++) {
+            const char *form = words[items[k].index];
+
+            if (strcmp(form, lemma) == 0) {
+                continue;
+            }
+            if (forms++ > 0) {
+                memcpy(out, ", ", 2);
+                out += 2;
+            }
+            len = strlen(form);
+            memcpy(out, form, len);
+            out += len;
+        }
+        *out++ = '\0';
+    }
+    *out_count = group_count;
+
+cleanup:
+    free(items);
+    free(groups);
+    free(lemma_arena);
+    return lemmas;
+}
+
+/*
+ * known_level пользователя; без пользователя или при ошибке профиля —
+ * 0, то есть отсекаются только служебные слова.
+ */
+static int generation_job_known_level(const generation_job_t *job)
+{
+    int level = 0;
+
+    if (job->user_id <= 0 ||
+        profile_api_get_known_level(job->user_id, &level) != PROFILE_API_OK) {
+        return 0;
+    }
+    return level;
+}
+
+typedef struct {
+    unsigned rank;
+    int index;
+    char *word;
+} generation_job_ranked_t;
+
+/* Сначала частые (меньший ранг), слова вне словаря — в конце; внутри — порядок текста. */
+static int generation_job_ranked_cmp(const void *a, const void *b)
+{
+    const generation_job_ranked_t *left = a;
+    const generation_job_ranked_t *right = b;
+    unsigned left_rank = left->rank ? left->rank : UINT_MAX;
+    unsigned right_rank = right->rank ? right->rank : UINT_MAX;
+
+    if (left_rank != right_rank) {
+        return left_rank < right_rank ? -1 : 1;
+    }
+    return (left->index > right->index) - (left->index < right->index);
+}
+
+/*
+ * Кандидаты — не частые слова; указывают на строки из words. Порядок —
+ * по частотному рангу: до LLM и под предел GENERATION_JOB_MAX_WORDS
+ * первыми попадают самые полезные для ученика слова. Без словаря рангов
+ * (или без памяти на сортировку) остаётся порядок текста.
+ */
+static int generation_job_select_candidates(char **words, int word_count, int known_level,
+                                            char **candidates, int *out_filtered)
+{
+    generation_job_ranked_t *ranked = NULL;
+    int candidate_count = 0;
+    int filtered = 0;
+    int i;
+
+    if (word_rank_count() > 0 && word_count > 1) {
+        ranked = malloc((size_t) word_count * sizeof(*ranked));
+    }
+
+    for (i = 0; i < word_count; i++) {
+        unsigned rank;
+
+        if (is_common_word(words[i], known_level)) {
+            filtered++;
+            continue;
+        }
+        rank = word_rank(words[i]);
+        if (rank > 0 && rank <= (unsigned) g_skip_top_rank) {
+            filtered++;
             continue;
         }
+        if (ranked) {
+            ranked[candidate_count].rank = rank;
+            ranked[candidate_count].index = candidate_count;
+            ranked[candidate_count].word = words[i];
+        }
         candidates[candidate_count++] = words[i];
     }
 
-    if (generation_job_set_status(job, GENERATION_JOB_STATE_CHECKING_DATABASE) != 0) {
-        free(candidates);
-        free_word_list(words, word_count);
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
+    if (ranked) {
+        qsort(ranked, (size_t) candidate_count, sizeof(*ranked), generation_job_ranked_cmp);
+        for (i = 0; i < candidate_count; i++) {
+            candidates[i] = ranked[i].word;
+        }
+        free(ranked);
+    }
+
+    *out_filtered = filtered;
+    return candidate_count;
+}
+
+/*
+ * Обрезает ранжированных кандидатов до предела g_max_words с учётом
+ * drafts уже готовых черновиков задачи; отброшенные слова считаются
+ * отфильтрованными. Вызывается под g_jobs_lock.
+ */
+static void generation_job_cap_candidates_locked(generation_job_t *job, int *candidate_count, int drafts)
+{
+    int room;
+
+    if (g_max_words <= 0) {
+        return;
+    }
+    room = g_max_words > drafts ? g_max_words - drafts : 0;
+    if (*candidate_count > room) {
+        job->filtered_words += *candidate_count - room;
+        *candidate_count = room;
+        generation_job_mark_dirty(job);
+    }
+}
+
+/* Убирает из кандидатов слова, которые уже есть в карточках пользователя. */
+static int generation_job_drop_existing(generation_job_t *job, char **candidates,
+                                        int *candidate_count, int *out_existing)
+{
+    int write_index = 0;
+    int existing = 0;
+    int i;
+
+    for (i = 0; i < *candidate_count; i++) {
+        card_service_exists_query_t exists_query;
+        int exists = 0;
+
+        if (generation_job_check_stopped(job)) {
+            return GENERATION_JOB_SERVICE_ERR_CONFLICT;
+        }
+
+        exists_query.user_id = job->user_id;
+        exists_query.word = candidates[i];
+        if (card_service_exists(&exists_query, &exists) == CARD_SERVICE_OK && exists) {
+            existing++;
+            continue;
+        }
+        candidates[write_index++] = candidates[i];
+    }
+
+    *candidate_count = write_index;
+    *out_existing = existing;
+    return GENERATION_JOB_SERVICE_OK;
+}
+
+/* Итог стадии GENERATING: review_ready, completed или failed. */
+static int generation_job_finish_generation(generation_job_t *job)
+{
+    int rc = GENERATION_JOB_SERVICE_OK;
+
+    pthread_mutex_lock(&g_jobs_lock);
+    /* Хвост отложенных событий уходит раньше итогового статуса. */
+    generation_job_flush_events(job);
+    if (generation_job_is_stopped(job)) {
+        rc = GENERATION_JOB_SERVICE_ERR_CONFLICT;
+    } else if (job->draft_count == 0 && job->failed_words > 0) {
+        /* Отдельные неудачные слова пропускаются; провал — только если не вышло ни одного. */
+        generation_job_set_status(job, GENERATION_JOB_STATE_FAILED);
+        generation_job_set_error(job, "llm_generation_failed");
+        emit_job_event(job, REALTIME_EVENT_GENERATION_JOB_FAILED);
+        rc = GENERATION_JOB_SERVICE_ERR_UPSTREAM;
+    } else if (job->draft_count == 0) {
+        if (generation_job_set_status(job, GENERATION_JOB_STATE_COMPLETED) != 0) {
+            rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        } else {
+            emit_job_event(job, REALTIME_EVENT_GENERATION_JOB_COMPLETED);
+        }
+    } else if (generation_job_set_status(job, GENERATION_JOB_STATE_REVIEW_READY) != 0) {
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+    } else {
+        emit_progress_event(job, GENERATION_JOB_STATE_REVIEW_READY, 100);
+        /* Все черновики могли успеть разобрать, пока шла генерация. */
+        generation_job_finalize_if_review_complete(job);
+    }
+    pthread_mutex_unlock(&g_jobs_lock);
+
+    return rc;
+}
+
+/*
+ * Выполняется в воркере. source_text меняется только у задачи, которая
+ * не busy, поэтому воркер читает его без блокировки; всё остальное
+ * состояние задачи — под g_jobs_lock, который не держится во время
+ * запросов к БД и LLM. Отмена проверяется между словами.
+ */
+static int generation_job_run_pipeline(generation_job_entry_t *entry)
+{
+    generation_job_t *job = &entry->job;
+    char **words = NULL;
+    char **lemmas = NULL;
+    char **candidates = NULL;
+    int word_count = 0;
+    int lemma_count = 0;
+    int candidate_count = 0;
+    int filtered = 0;
+    int existing = 0;
+    int resumed;
+    int rc;
+    int i;
+
+    if (!job->source_text) {
+        return GENERATION_JOB_SERVICE_ERR_INVALID_ARGUMENT;
+    }
+
+    rc = generation_job_enter_stage(job, GENERATION_JOB_STATE_TOKENIZING, 10);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        goto cleanup;
+    }
+
+    words = extract_unique_words(job->source_text, &word_count);
+    if (!words) {
+        generation_job_fail(job, "tokenization_failed");
+        rc = GENERATION_JOB_SERVICE_ERR_UPSTREAM;
+        goto cleanup;
+    }
+
+    rc = generation_job_enter_stage(job, GENERATION_JOB_STATE_LEMMATIZING, 18);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        goto cleanup;
+    }
+
+    lemmas = generation_job_group_lemmas(words, word_count, &lemma_count);
+    if (!lemmas) {
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        goto cleanup;
+    }
+
+    if (lemma_count > 0) {
+        candidates = calloc((size_t) lemma_count, sizeof(*candidates));
+        if (!candidates) {
+            rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+            goto cleanup;
+        }
+    }
+    candidate_count = generation_job_select_candidates(lemmas, lemma_count,
+                                                       generation_job_known_level(job),
+                                                       candidates, &filtered);
+
+    pthread_mutex_lock(&g_jobs_lock);
+    job->total_words = word_count;
+    job->filtered_words = filtered;
+    generation_job_mark_dirty(job);
+    pthread_mutex_unlock(&g_jobs_lock);
+
+    rc = generation_job_enter_stage(job, GENERATION_JOB_STATE_FILTERING_COMMON_WORDS, 25);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        goto cleanup;
+    }
+    rc = generation_job_enter_stage(job, GENERATION_JOB_STATE_CHECKING_DATABASE, 40);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        goto cleanup;
     }
-    emit_progress_event(job, GENERATION_JOB_STATE_CHECKING_DATABASE, 40);
 
     if (job->user_id > 0) {
+        rc = generation_job_drop_existing(job, candidates, &candidate_count, &existing);
+        if (rc != GENERATION_JOB_SERVICE_OK) {
+            goto cleanup;
+        }
+
+        pthread_mutex_lock(&g_jobs_lock);
+        job->existing_words = existing;
+        generation_job_mark_dirty(job);
+        pthread_mutex_unlock(&g_jobs_lock);
+    }
+
+    rc = generation_job_enter_stage(job, GENERATION_JOB_STATE_GENERATING, 60);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        goto cleanup;
+    }
+
+    /*
+     * После рестарта у задачи уже есть черновики из БД: за их словами
+     * в LLM повторно не ходим. Неудачные слова пробуются заново. Предел
+     * применяется до этого отсева: верхушка рейтинга та же, что до рестарта.
+     */
+    pthread_mutex_lock(&g_jobs_lock);
+    generation_job_cap_candidates_locked(job, &candidate_count, 0);
+    resumed = (int) job->draft_count;
+    if (resumed > 0) {
         int write_index = 0;
-        for (i = 0; i < candidate_count; i++) {
-            card_service_exists_query_t exists_query;
-            int exists = 0;
 
-            exists_query.user_id = job->user_id;
-            exists_query.word = candidates[i];
-            if (card_service_exists(&exists_query, &exists) == CARD_SERVICE_OK && exists) {
-                job->existing_words++;
-                continue;
+        for (i = 0; i < candidate_count; i++) {
+            if (!generation_job_has_draft_for(job, candidates[i])) {
+                candidates[write_index++] = candidates[i];
             }
-            candidates[write_index++] = candidates[i];
         }
         candidate_count = write_index;
     }
+    job->failed_words = 0;
+    generation_job_mark_dirty(job);
+    pthread_mutex_unlock(&g_jobs_lock);
 
-    if (generation_job_set_status(job, GENERATION_JOB_STATE_GENERATING) != 0) {
-        free(candidates);
+    if (candidate_count > 0) {
+        rc = generation_job_generate_drafts(job, candidates, candidate_count, resumed);
+        if (rc != GENERATION_JOB_SERVICE_OK) {
+            goto cleanup;
+        }
+    }
+
+    rc = generation_job_finish_generation(job);
+    if (rc == GENERATION_JOB_SERVICE_OK && words) {
+        generation_job_keep_word_set(entry, &words, word_count);
+    }
+
+cleanup:
+    free(candidates);
+    if (lemmas) {
+        free_word_list(lemmas, lemma_count);
+    }
+    if (words) {
         free_word_list(words, word_count);
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
     }
-    emit_progress_event(job, GENERATION_JOB_STATE_GENERATING, 60);
+    return rc;
+}
+
+/*
+ * Расширение задачи добавленным текстом: токенизируется только
+ * добавка, и через проверку в БД и LLM идут лишь слова, которых не было
+ * в тексте задачи. Черновики дописываются к той же задаче, счётчики
+ * увеличиваются.
+ */
+static int generation_job_run_extension(generation_job_entry_t *entry, const char *text)
+{
+    generation_job_t *job = &entry->job;
+    char **words = NULL;
+    char **fresh = NULL;
+    char **lemmas = NULL;
+    char **candidates = NULL;
+    int word_count = 0;
+    int fresh_count = 0;
+    int lemma_count = 0;
+    int candidate_count = 0;
+    int filtered = 0;
+    int existing = 0;
+    int resumed;
+    int rc;
+    int i;
+
+    rc = generation_job_enter_stage(job, GENERATION_JOB_STATE_TOKENIZING, 10);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        goto cleanup;
+    }
 
-    for (i = 0; i < candidate_count; i++) {
-        generate_service_request_t request;
-        generate_service_card_t card;
-        int rc;
-        int progress;
+    /* После рестарта набора слов нет: восстанавливаем по прежнему тексту. */
+    if (!entry->word_set) {
+        char *previous = strndup(job->source_text, entry->extend_offset);
+        char **previous_words;
+        int previous_count = 0;
 
-        memset(&card, 0, sizeof(card));
-        request.word = candidates[i];
-        request.user_id = job->user_id;
-        request.persist_if_authenticated = 0;
+        if (!previous) {
+            rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+            goto cleanup;
+        }
+        previous_words = extract_unique_words(previous, &previous_count);
+        free(previous);
+        if (!previous_words) {
+            rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+            goto cleanup;
+        }
+        generation_job_keep_word_set(entry, &previous_words, previous_count);
+    }
+
+    words = extract_unique_words(text, &word_count);
+    if (!words) {
+        generation_job_fail(job, "tokenization_failed");
+        rc = GENERATION_JOB_SERVICE_ERR_UPSTREAM;
+        goto cleanup;
+    }
 
-        rc = generate_service_generate(&request, &card);
-        if (rc != GENERATE_SERVICE_OK) {
-            generation_job_set_status(job, GENERATION_JOB_STATE_FAILED);
-            generation_job_set_error(job, "llm_generation_failed");
-            generate_service_free_card(&card);
-            free(candidates);
-            free_word_list(words, word_count);
-            emit_job_event(job, REALTIME_EVENT_GENERATION_JOB_FAILED);
-            return GENERATION_JOB_SERVICE_ERR_UPSTREAM;
+    if (word_count > 0) {
+        fresh = calloc((size_t) word_count, sizeof(*fresh));
+        candidates = calloc((size_t) word_count, sizeof(*candidates));
+        if (!fresh || !candidates) {
+            rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+            goto cleanup;
+        }
+    }
+    for (i = 0; i < word_count; i++) {
+        if (!bsearch(&words[i], entry->word_set, (size_t) entry->word_set_count,
+                     sizeof(*entry->word_set), generation_job_word_cmp)) {
+            fresh[fresh_count++] = words[i];
         }
+    }
+
+    rc = generation_job_enter_stage(job, GENERATION_JOB_STATE_LEMMATIZING, 18);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        goto cleanup;
+    }
+    lemmas = generation_job_group_lemmas(fresh, fresh_count, &lemma_count);
+    if (!lemmas) {
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        goto cleanup;
+    }
+    candidate_count = generation_job_select_candidates(lemmas, lemma_count,
+                                                       generation_job_known_level(job),
+                                                       candidates, &filtered);
+
+    pthread_mutex_lock(&g_jobs_lock);
+    job->total_words += fresh_count;
+    job->filtered_words += filtered;
+    generation_job_mark_dirty(job);
+    pthread_mutex_unlock(&g_jobs_lock);
+
+    rc = generation_job_enter_stage(job, GENERATION_JOB_STATE_FILTERING_COMMON_WORDS, 25);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        goto cleanup;
+    }
+    rc = generation_job_enter_stage(job, GENERATION_JOB_STATE_CHECKING_DATABASE, 40);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        goto cleanup;
+    }
 
-        if (generation_job_append_draft(job, &card) != 0) {
-            generate_service_free_card(&card);
-            free(candidates);
-            free_word_list(words, word_count);
-            return GENERATION_JOB_SERVICE_ERR_SERVER;
+    if (job->user_id > 0) {
+        rc = generation_job_drop_existing(job, candidates, &candidate_count, &existing);
+        if (rc != GENERATION_JOB_SERVICE_OK) {
+            goto cleanup;
         }
 
-        emit_draft_event(job, &job->drafts[job->draft_count - 1], REALTIME_EVENT_GENERATION_CARD_DRAFT);
-        progress = 60 + (int) (((i + 1) * 35) / (candidate_count > 0 ? candidate_count : 1));
-        emit_progress_event(job, GENERATION_JOB_STATE_GENERATING, progress);
-        generate_service_free_card(&card);
+        pthread_mutex_lock(&g_jobs_lock);
+        job->existing_words += existing;
+        generation_job_mark_dirty(job);
+        pthread_mutex_unlock(&g_jobs_lock);
+    }
+
+    rc = generation_job_enter_stage(job, GENERATION_JOB_STATE_GENERATING, 60);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        goto cleanup;
     }
 
+    pthread_mutex_lock(&g_jobs_lock);
+    resumed = (int) job->draft_count;
+    /* Новой может оказаться только словоформа уже готовой леммы. */
+    if (resumed > 0) {
+        int write_index = 0;
+
+        for (i = 0; i < candidate_count; i++) {
+            if (!generation_job_has_draft_for(job, candidates[i])) {
+                candidates[write_index++] = candidates[i];
+            }
+        }
+        candidate_count = write_index;
+    }
+    generation_job_cap_candidates_locked(job, &candidate_count, resumed);
+    pthread_mutex_unlock(&g_jobs_lock);
+
+    if (candidate_count > 0) {
+        rc = generation_job_generate_drafts(job, candidates, candidate_count, resumed);
+        if (rc != GENERATION_JOB_SERVICE_OK) {
+            goto cleanup;
+        }
+    }
+
+    rc = generation_job_finish_generation(job);
+    if (rc == GENERATION_JOB_SERVICE_OK) {
+        generation_job_merge_word_set(entry, fresh, fresh_count);
+    }
+
+cleanup:
     free(candidates);
+    if (lemmas) {
+        free_word_list(lemmas, lemma_count);
+    }
+    free(fresh);
     free_word_list(words, word_count);
+    return rc;
+}
 
-    if (job->draft_count == 0) {
-        if (generation_job_set_status(job, GENERATION_JOB_STATE_COMPLETED) != 0) {
-            return GENERATION_JOB_SERVICE_ERR_SERVER;
+static void *generation_job_worker_main(void *arg)
+{
+    (void) arg;
+
+    for (;;) {
+        generation_job_entry_t *entry;
+        char *extend_text;
+        int rc;
+
+        pthread_mutex_lock(&g_jobs_lock);
+        while (!g_stopping && !g_queue_head) {
+            pthread_cond_wait(&g_queue_cond, &g_jobs_lock);
         }
-        emit_job_event(job, REALTIME_EVENT_GENERATION_JOB_COMPLETED);
-        return GENERATION_JOB_SERVICE_OK;
+        if (g_stopping) {
+            pthread_mutex_unlock(&g_jobs_lock);
+            break;
+        }
+        entry = g_queue_head;
+        g_queue_head = entry->queue_next;
+        if (!g_queue_head) {
+            g_queue_tail = NULL;
+        }
+        entry->queue_next = NULL;
+        extend_text = entry->extend_text;
+        entry->extend_text = NULL;
+        pthread_mutex_unlock(&g_jobs_lock);
+
+        if (extend_text) {
+            rc = generation_job_run_extension(entry, extend_text);
+            pthread_mutex_lock(&g_jobs_lock);
+            generation_job_account(&entry->job, 0, strlen(extend_text) + 1);
+            pthread_mutex_unlock(&g_jobs_lock);
+            free(extend_text);
+        } else {
+            rc = generation_job_run_pipeline(entry);
+        }
+        if (rc == GENERATION_JOB_SERVICE_ERR_SERVER) {
+            generation_job_fail(&entry->job, "internal_error");
+        }
+
+        pthread_mutex_lock(&g_jobs_lock);
+        entry->busy = 0;
+        pthread_mutex_unlock(&g_jobs_lock);
     }
 
-    if (generation_job_set_status(job, GENERATION_JOB_STATE_REVIEW_READY) != 0) {
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
+    return NULL;
+}
+
+/*
+ * Одна пачка записи в БД. Изменения копируются под блокировкой, сама
+ * запись идёт без неё; при ошибке задачи снова помечаются целиком.
+ */
+static void generation_job_flush(void)
+{
+    generation_job_entry_t *entry;
+    generation_job_entry_t **flushed = NULL;
+    generation_job_t *jobs = NULL;
+    generation_card_draft_t *drafts = NULL;
+    size_t job_count = 0;
+    size_t draft_count = 0;
+    size_t drafts_total = 0;
+    size_t i;
+    int rc = GENERATION_JOB_SERVICE_OK;
+
+    pthread_mutex_lock(&g_jobs_lock);
+    for (entry = g_dirty_head; entry; entry = entry->dirty_next) {
+        job_count++;
+        for (i = 0; i < entry->job.draft_count; i++) {
+            if (entry->flush_all || (i < entry->draft_dirty_capacity && entry->draft_dirty[i])) {
+                drafts_total++;
+            }
+        }
     }
-    emit_progress_event(job, GENERATION_JOB_STATE_REVIEW_READY, 100);
-    return GENERATION_JOB_SERVICE_OK;
+    if (job_count == 0) {
+        pthread_mutex_unlock(&g_jobs_lock);
+        return;
+    }
+
+    flushed = calloc(job_count, sizeof(*flushed));
+    jobs = calloc(job_count, sizeof(*jobs));
+    drafts = drafts_total > 0 ? calloc(drafts_total, sizeof(*drafts)) : NULL;
+    if (!flushed || !jobs || (drafts_total > 0 && !drafts)) {
+        pthread_mutex_unlock(&g_jobs_lock);
+        job_count = 0;
+        goto cleanup;
+    }
+
+    job_count = 0;
+    for (entry = g_dirty_head; entry; entry = entry->dirty_next) {
+        if (generation_job_copy_row(&entry->job, &jobs[job_count]) != 0) {
+            rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+            break;
+        }
+        flushed[job_count++] = entry;
+        for (i = 0; i < entry->job.draft_count && rc == GENERATION_JOB_SERVICE_OK; i++) {
+            if (!entry->flush_all && (i >= entry->draft_dirty_capacity || !entry->draft_dirty[i])) {
+                continue;
+            }
+            if (generation_draft_copy(&entry->job.drafts[i], &drafts[draft_count]) != 0) {
+                rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+                break;
+            }
+            draft_count++;
+        }
+        if (rc != GENERATION_JOB_SERVICE_OK) {
+            break;
+        }
+    }
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        /* Список не трогаем: попробуем в следующий раз. */
+        pthread_mutex_unlock(&g_jobs_lock);
+        goto cleanup;
+    }
+
+    for (i = 0; i < job_count; i++) {
+        entry = flushed[i];
+        entry->dirty = 0;
+        entry->flush_all = 0;
+        entry->flushing = 1;
+        entry->dirty_next = NULL;
+        if (entry->draft_dirty) {
+            memset(entry->draft_dirty, 0, entry->draft_dirty_capacity);
+        }
+    }
+    g_dirty_head = NULL;
+    pthread_mutex_unlock(&g_jobs_lock);
+
+    rc = generation_job_api_save(jobs, job_count, drafts, draft_count) == GENERATION_JOB_API_OK ?
+         GENERATION_JOB_SERVICE_OK : GENERATION_JOB_SERVICE_ERR_SERVER;
+
+    pthread_mutex_lock(&g_jobs_lock);
+    for (i = 0; i < job_count; i++) {
+        flushed[i]->flushing = 0;
+        if (rc != GENERATION_JOB_SERVICE_OK) {
+            generation_job_mark_dirty(&flushed[i]->job);
+            flushed[i]->flush_all = 1;
+        }
+    }
+    pthread_mutex_unlock(&g_jobs_lock);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        fprintf(stderr, "generation jobs: failed to save %zu jobs, will retry\n", job_count);
+    }
+
+cleanup:
+    for (i = 0; i < job_count; i++) {
+        generation_job_clear(&jobs[i]);
+    }
+    for (i = 0; i < draft_count; i++) {
+        generation_draft_clear(&drafts[i]);
+    }
+    free(drafts);
+    free(jobs);
+    free(flushed);
+}
+
+/*
+ * Поток записи: раз в g_flush_ms пишет изменения в БД (при g_persist)
+ * и в промежутках отправляет отложенные события задач, как только у
+ * них истекает g_progress_interval_ms.
+ */
+static void *generation_job_flusher_main(void *arg)
+{
+    unsigned long long write_ms = http_now_ms() + (unsigned long long) g_flush_ms;
+
+    (void) arg;
+
+    for (;;) {
+        struct timespec deadline;
+        unsigned long long wake_ms;
+        unsigned long long events_ms;
+        int stopping;
+
+        pthread_mutex_lock(&g_jobs_lock);
+        events_ms = generation_job_flush_due_events(http_now_ms());
+        wake_ms = g_persist ? write_ms : 0;
+        if (events_ms && (!wake_ms || events_ms < wake_ms)) {
+            wake_ms = events_ms;
+        }
+        if (!g_flusher_stopping) {
+            if (wake_ms) {
+                deadline.tv_sec = (time_t) (wake_ms / 1000);
+                deadline.tv_nsec = (long) (wake_ms % 1000) * 1000000L;
+                pthread_cond_timedwait(&g_flush_cond, &g_jobs_lock, &deadline);
+            } else {
+                pthread_cond_wait(&g_flush_cond, &g_jobs_lock);
+            }
+        }
+        stopping = g_flusher_stopping;
+        pthread_mutex_unlock(&g_jobs_lock);
+
+        /* Последняя запись при остановке — после того, как встали воркеры. */
+        if (g_persist && (stopping || http_now_ms() >= write_ms)) {
+            generation_job_flush();
+            write_ms = http_now_ms() + (unsigned long long) g_flush_ms;
+        }
+        if (stopping) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Поднимает незавершённые задачи из БД: review_ready ждут разбора,
+ * остальные снова ставятся в очередь и продолжаются с уже готовыми
+ * черновиками. Вызывается до запуска воркеров.
+ */
+static void generation_job_restore(void)
+{
+    generation_job_t *jobs = NULL;
+    size_t count = 0;
+    size_t restored = 0;
+    size_t i;
+    size_t d;
+
+    if (generation_job_api_load_unfinished(&jobs, &count) != GENERATION_JOB_API_OK) {
+        fprintf(stderr, "generation jobs: failed to load unfinished jobs\n");
+        return;
+    }
+
+    for (i = 0; i < count; i++) {
+        generation_job_entry_t *entry = calloc(1, sizeof(*entry));
+
+        if (!entry) {
+            break;
+        }
+        entry->job = jobs[i];
+        memset(&jobs[i], 0, sizeof(jobs[i]));
+
+        entry->bytes = sizeof(*entry) + strlen(entry->job.source_text) + 1;
+        for (d = 0; d < entry->job.draft_count; d++) {
+            entry->bytes += generation_draft_bytes(&entry->job.drafts[d]);
+        }
+        if (generation_job_index_insert(entry) != 0) {
+            generation_job_entry_free(entry);
+            break;
+        }
+        g_store_bytes += entry->bytes;
+        restored++;
+
+        /* Время создания не хранится: окно отсчитывается от рестарта. */
+        if (g_dedup_window_ms > 0 && entry->job.user_id > 0 &&
+            generation_job_fingerprint(entry->job.source_text, entry->job.user_id,
+                                       &entry->fingerprint) == 0) {
+            entry->created_at_ms = http_now_ms();
+            generation_job_dedup_link(entry);
+        }
+
+        if (strcmp(entry->job.status, GENERATION_JOB_STATE_REVIEW_READY) == 0) {
+            continue;
+        }
+        generation_job_enqueue(entry);
+    }
+
+    generation_job_api_free_jobs(jobs, count);
+    if (restored > 0) {
+        printf("generation jobs: restored %zu unfinished jobs\n", restored);
+    }
+}
+
+static int generation_job_env_int(const char *name, int fallback, int min_value, int max_value)
+{
+    const char *value = getenv(name);
+    char *endptr;
+    long parsed;
+
+    if (!value || value[0] == '\0') {
+        return fallback;
+    }
+
+    parsed = strtol(value, &endptr, 10);
+    if (*endptr != '\0' || parsed < min_value || parsed > max_value) {
+        return fallback;
+    }
+
+    return (int) parsed;
 }
 
 void generation_job_service_init(void)
 {
-    memset(g_jobs, 0, sizeof(g_jobs));
+    pthread_condattr_t cond_attr;
+    sigset_t blocked;
+    sigset_t previous;
+    const char *ranks_path;
+    int workers;
+    int i;
+
+    g_index = NULL;
+    g_index_capacity = 0;
     g_job_count = 0;
+    g_store_bytes = 0;
+    g_finished_head = NULL;
+    g_finished_tail = NULL;
     g_next_job_id = 1;
     g_next_draft_id = 1;
+    g_queue_head = NULL;
+    g_queue_tail = NULL;
+    g_stopping = 0;
+    g_ttl_ms = (unsigned long long) generation_job_env_int("GENERATION_JOB_TTL_SEC",
+                                                           GENERATION_JOB_DEFAULT_TTL_SEC,
+                                                           1, 7 * 24 * 3600) * 1000;
+    g_memory_limit = (size_t) generation_job_env_int("GENERATION_JOB_MEMORY_MB",
+                                                     GENERATION_JOB_DEFAULT_MEMORY_MB,
+                                                     1, 64 * 1024) * 1024 * 1024;
+    g_batch_size = generation_job_env_int("GENERATION_JOB_BATCH_SIZE",
+                                          GENERATION_JOB_DEFAULT_BATCH_SIZE,
+                                          1, GENERATION_JOB_MAX_BATCH_SIZE);
+    g_parallelism = generation_job_env_int("GENERATION_JOB_PARALLELISM",
+                                           GENERATION_JOB_DEFAULT_PARALLELISM,
+                                           1, GENERATION_JOB_MAX_PARALLELISM);
+    workers = generation_job_env_int("GENERATION_JOB_WORKERS",
+                                     GENERATION_JOB_DEFAULT_WORKERS,
+                                     1, GENERATION_JOB_MAX_WORKERS);
+    g_flush_ms = generation_job_env_int("GENERATION_JOB_FLUSH_MS",
+                                        GENERATION_JOB_DEFAULT_FLUSH_MS,
+                                        10, 60000);
+    g_persist = generation_job_env_int("GENERATION_JOB_PERSIST", 1, 0, 1);
+    g_dedup_window_ms = (unsigned long long) generation_job_env_int("GENERATION_JOB_DEDUP_WINDOW_SEC",
+                                                                    GENERATION_JOB_DEFAULT_DEDUP_WINDOW_SEC,
+                                                                    0, 7 * 24 * 3600) * 1000;
+    memset(g_dedup, 0, sizeof(g_dedup));
+    g_progress_interval_ms = (unsigned long long) generation_job_env_int("GENERATION_JOB_PROGRESS_INTERVAL_MS",
+                                                                         GENERATION_JOB_DEFAULT_PROGRESS_INTERVAL_MS,
+                                                                         0, 60000);
+    g_batch_draft_events = generation_job_env_int("GENERATION_JOB_BATCH_DRAFT_EVENTS", 0, 0, 1);
+    g_skip_top_rank = generation_job_env_int("GENERATION_JOB_SKIP_TOP_RANK",
+                                             GENERATION_JOB_DEFAULT_SKIP_TOP_RANK,
+                                             0, 100000);
+    g_max_words = generation_job_env_int("GENERATION_JOB_MAX_WORDS",
+                                         GENERATION_JOB_DEFAULT_MAX_WORDS,
+                                         0, 100000);
+    ranks_path = getenv("WORD_RANKS_PATH");
+    if (!ranks_path || ranks_path[0] == '\0') {
+        ranks_path = GENERATION_JOB_DEFAULT_WORD_RANKS_PATH;
+    }
+    if (word_rank_open(ranks_path) != 0) {
+        fprintf(stderr, "generation jobs: word ranks '%s' unavailable, candidates keep text order\n",
+                ranks_path);
+    }
+    g_dirty_head = NULL;
+    g_events_queued = 0;
+    g_flusher_stopping = 0;
+
+    /*
+     * Без БД id начали бы заново с 1 и затёрли старые строки,
+     * поэтому при недоступной БД состояние просто не сохраняется.
+     */
+    if (g_persist &&
+        generation_job_api_next_ids(&g_next_job_id, &g_next_draft_id) != GENERATION_JOB_API_OK) {
+        fprintf(stderr, "generation jobs: database unavailable, job state will not be persisted\n");
+        g_next_job_id = 1;
+        g_next_draft_id = 1;
+        g_persist = 0;
+    }
+    if (g_persist) {
+        generation_job_restore();
+    }
+
+    /* SIGINT/SIGTERM должен получать главный поток с циклом epoll. */
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+
+    /* Поток записи нужен и без БД: он отправляет отложенные события. */
+    g_flusher_started = 0;
+    if (g_persist || g_progress_interval_ms > 0) {
+        pthread_condattr_init(&cond_attr);
+        pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&g_flush_cond, &cond_attr);
+        pthread_condattr_destroy(&cond_attr);
+        if (pthread_create(&g_flusher, NULL, generation_job_flusher_main, NULL) == 0) {
+            g_flusher_started = 1;
+        } else {
+            fprintf(stderr, "generation jobs: failed to start flusher\n");
+            pthread_cond_destroy(&g_flush_cond);
+            g_persist = 0;
+            g_progress_interval_ms = 0;
+        }
+    }
+
+    g_worker_count = 0;
+    for (i = 0; i < workers; i++) {
+        if (pthread_create(&g_workers[g_worker_count], NULL, generation_job_worker_main, NULL) != 0) {
+            fprintf(stderr, "generation jobs: failed to start worker %d\n", i);
+            break;
+        }
+        g_worker_count++;
+    }
+
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
 }
 
 void generation_job_service_shutdown(void)
 {
     size_t i;
+    int w;
+
+    pthread_mutex_lock(&g_jobs_lock);
+    g_stopping = 1;
+    pthread_cond_broadcast(&g_queue_cond);
+    pthread_mutex_unlock(&g_jobs_lock);
+
+    for (w = 0; w < g_worker_count; w++) {
+        pthread_join(g_workers[w], NULL);
+    }
+    g_worker_count = 0;
 
-    for (i = 0; i < g_job_count; i++) {
-        generation_job_clear(&g_jobs[i]);
+    if (g_flusher_started) {
+        pthread_mutex_lock(&g_jobs_lock);
+        g_flusher_stopping = 1;
+        pthread_cond_signal(&g_flush_cond);
+        pthread_mutex_unlock(&g_jobs_lock);
+        pthread_join(g_flusher, NULL);
+        pthread_cond_destroy(&g_flush_cond);
+        g_flusher_started = 0;
     }
+
+    for (i = 0; i < g_index_capacity; i++) {
+        if (g_index[i]) {
+            generation_job_entry_free(g_index[i]);
+        }
+    }
+    free(g_index);
+    g_index = NULL;
+    g_index_capacity = 0;
     g_job_count = 0;
+    g_store_bytes = 0;
+    g_finished_head = NULL;
+    g_finished_tail = NULL;
+    g_queue_head = NULL;
+    g_queue_tail = NULL;
+    g_dirty_head = NULL;
+    memset(g_dedup, 0, sizeof(g_dedup));
+    word_rank_close();
+}
+
+void generation_job_service_free_job(generation_job_t *job)
+{
+    generation_job_clear(job);
+}
+
+void generation_job_service_free_draft(generation_card_draft_t *draft)
+{
+    generation_draft_clear(draft);
+}
+
+void generation_job_service_free_drafts(generation_card_draft_t *drafts, size_t count)
+{
+    size_t i;
+
+    if (!drafts) {
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        generation_draft_clear(&drafts[i]);
+    }
+    free(drafts);
 }
 
 int generation_job_service_create(const generation_job_create_input_t *input,
-                                  const generation_job_t **out_job)
+                                  generation_job_t *out_job,
+                                  int *out_existing)
 {
+    generation_job_entry_t *entry;
     generation_job_t *job;
+    uint64_t fingerprint = 0;
+    int dedup = 0;
+    size_t bytes;
+    int rc = GENERATION_JOB_SERVICE_OK;
 
     if (!input || !out_job || !input->text || input->text[0] == '\0') {
         return GENERATION_JOB_SERVICE_ERR_INVALID_ARGUMENT;
     }
-    if (g_job_count >= GENERATION_JOB_MAX_JOBS) {
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
+    if (out_existing) {
+        *out_existing = 0;
     }
 
-    job = &g_jobs[g_job_count];
-    memset(job, 0, sizeof(*job));
-    job->job_id = g_next_job_id++;
+    bytes = sizeof(*entry) + strlen(input->text) + 1;
+    /*
+     * Хешируем до блокировки: текст может быть длинным. Анонимные задачи
+     * не склеиваются: у разных анонимных клиентов один user_id 0.
+     */
+    if (g_dedup_window_ms > 0 && input->user_id > 0 &&
+        generation_job_fingerprint(input->text, input->user_id, &fingerprint) == 0) {
+        dedup = 1;
+    }
+
+    pthread_mutex_lock(&g_jobs_lock);
+    if (g_worker_count == 0) {
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        goto unlock;
+    }
+
+    if (dedup) {
+        entry = generation_job_dedup_find(input->user_id, fingerprint, input->text);
+        if (entry) {
+            if (generation_job_copy(&entry->job, out_job) != 0) {
+                rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+            } else if (out_existing) {
+                *out_existing = 1;
+            }
+            goto unlock;
+        }
+    }
+
+    /* Лимит памяти проверяется при приёме: черновики идущих задач могут его превысить. */
+    generation_job_store_sweep(bytes);
+    if (g_store_bytes + bytes > g_memory_limit) {
+        rc = GENERATION_JOB_SERVICE_ERR_BUSY;
+        goto unlock;
+    }
+
+    entry = calloc(1, sizeof(*entry));
+    if (!entry) {
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        goto unlock;
+    }
+    job = &entry->job;
+    job->job_id = g_next_job_id;
     job->user_id = input->user_id;
     job->source_text = job_strdup(input->text);
     job->status = job_strdup(GENERATION_JOB_STATE_QUEUED);
-    if (!job->source_text || !job->status) {
+    if (!job->source_text || !job->status ||
+        generation_job_copy(job, out_job) != 0) {
         generation_job_clear(job);
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
+        free(entry);
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        goto unlock;
+    }
+    if (generation_job_index_insert(entry) != 0) {
+        generation_job_clear(out_job);
+        generation_job_clear(job);
+        free(entry);
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        goto unlock;
     }
 
-    g_job_count++;
-    *out_job = job;
+    g_next_job_id++;
+    entry->bytes = bytes;
+    g_store_bytes += bytes;
+    generation_job_mark_dirty(job);
+    if (dedup) {
+        entry->fingerprint = fingerprint;
+        entry->created_at_ms = http_now_ms();
+        generation_job_dedup_link(entry);
+    }
+
+    generation_job_enqueue(entry);
 
     realtime_emit_event(REALTIME_EVENT_GENERATION_JOB_CREATED,
                         job->job_id,
                         "{\"status\":\"queued\"}");
 
-    return generation_job_run_pipeline(job);
+unlock:
+    pthread_mutex_unlock(&g_jobs_lock);
+    return rc;
 }
 
-int generation_job_service_get(int job_id, const generation_job_t **out_job)
+int generation_job_service_get(int job_id, generation_job_t *out_job)
 {
     generation_job_t *job;
+    int rc = GENERATION_JOB_SERVICE_OK;
 
     if (!out_job || job_id <= 0) {
         return GENERATION_JOB_SERVICE_ERR_INVALID_ARGUMENT;
     }
 
+    pthread_mutex_lock(&g_jobs_lock);
+    generation_job_store_sweep(0);
     job = generation_job_find(job_id);
     if (!job) {
-        return GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+        rc = GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+    } else if (generation_job_copy(job, out_job) != 0) {
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
     }
-
-    *out_job = job;
-    return GENERATION_JOB_SERVICE_OK;
+    pthread_mutex_unlock(&g_jobs_lock);
+    return rc;
 }
 
 int generation_job_service_list_drafts(int job_id,
-                                       const generation_card_draft_t **out_drafts,
+                                       generation_card_draft_t **out_drafts,
                                        size_t *out_count)
 {
     generation_job_t *job;
+    generation_card_draft_t *drafts = NULL;
+    size_t count = 0;
+    int rc = GENERATION_JOB_SERVICE_OK;
 
     if (!out_drafts || !out_count) {
         return GENERATION_JOB_SERVICE_ERR_INVALID_ARGUMENT;
     }
 
+    pthread_mutex_lock(&g_jobs_lock);
     job = generation_job_find(job_id);
     if (!job) {
-        return GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+        rc = GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+        goto unlock;
+    }
+
+    if (job->draft_count > 0) {
+        drafts = calloc(job->draft_count, sizeof(*drafts));
+        if (!drafts) {
+            rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+            goto unlock;
+        }
+        for (count = 0; count < job->draft_count; count++) {
+            if (generation_draft_copy(&job->drafts[count], &drafts[count]) != 0) {
+                generation_job_service_free_drafts(drafts, count);
+                drafts = NULL;
+                count = 0;
+                rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+                goto unlock;
+            }
+        }
     }
 
-    *out_drafts = job->drafts;
-    *out_count = job->draft_count;
+    *out_drafts = drafts;
+    *out_count = count;
+
+unlock:
+    pthread_mutex_unlock(&g_jobs_lock);
+    return rc;
+}
+
+/* Копирует задачу и черновик в выходные параметры. Вызывается под g_jobs_lock. */
+static int generation_job_copy_result(const generation_job_t *job,
+                                      const generation_card_draft_t *draft,
+                                      generation_job_t *out_job,
+                                      generation_card_draft_t *out_draft)
+{
+    if (generation_job_copy(job, out_job) != 0) {
+        return GENERATION_JOB_SERVICE_ERR_SERVER;
+    }
+    if (out_draft && generation_draft_copy(draft, out_draft) != 0) {
+        generation_job_clear(out_job);
+        return GENERATION_JOB_SERVICE_ERR_SERVER;
+    }
     return GENERATION_JOB_SERVICE_OK;
 }
 
 int generation_job_service_approve(int job_id, int draft_id,
-                                   const generation_job_t **out_job,
-                                   const generation_card_draft_t **out_draft)
+                                   generation_job_t *out_job,
+                                   generation_card_draft_t *out_draft)
 {
     generation_job_t *job;
     generation_card_draft_t *draft;
     card_service_create_input_t create_input;
+    card_service_delete_input_t delete_input;
+    char *word = NULL;
+    char *transcription = NULL;
+    char *translation = NULL;
+    char *example = NULL;
+    int user_id = 0;
     int card_id = 0;
     char *status_copy;
+    int rc = GENERATION_JOB_SERVICE_OK;
 
     if (!out_job || !out_draft) {
         return GENERATION_JOB_SERVICE_ERR_INVALID_ARGUMENT;
     }
 
+    pthread_mutex_lock(&g_jobs_lock);
     job = generation_job_find(job_id);
-    if (!job) {
-        return GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
-    }
     draft = generation_job_find_draft(job, draft_id);
-    if (!draft) {
-        return GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
-    }
-    if (job->user_id <= 0) {
-        return GENERATION_JOB_SERVICE_ERR_UNAUTHORIZED;
-    }
-    if (strcmp(job->status, GENERATION_JOB_STATE_CANCELED) == 0 ||
-        strcmp(job->status, GENERATION_JOB_STATE_FAILED) == 0) {
-        return GENERATION_JOB_SERVICE_ERR_CONFLICT;
+    if (!job || !draft) {
+        rc = GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+    } else if (job->user_id <= 0) {
+        rc = GENERATION_JOB_SERVICE_ERR_UNAUTHORIZED;
+    } else if (strcmp(job->status, GENERATION_JOB_STATE_CANCELED) == 0 ||
+               strcmp(job->status, GENERATION_JOB_STATE_FAILED) == 0 ||
+               (draft->status && strcmp(draft->status, GENERATION_DRAFT_STATUS_PENDING) != 0)) {
+        rc = GENERATION_JOB_SERVICE_ERR_CONFLICT;
+    } else {
+        user_id = job->user_id;
+        word = job_strdup(draft->word ? draft->word : "");
+        transcription = job_strdup(draft->transcription ? draft->transcription : "");
+        translation = job_strdup(draft->translation ? draft->translation : "");
+        example = job_strdup(draft->examples[0] ? draft->examples[0] : "");
+        if (!word || !transcription || !translation || !example) {
+            rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        }
     }
-    if (draft->status && strcmp(draft->status, GENERATION_DRAFT_STATUS_PENDING) != 0) {
-        return GENERATION_JOB_SERVICE_ERR_CONFLICT;
+    pthread_mutex_unlock(&g_jobs_lock);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        goto cleanup;
     }
 
-    create_input.user_id = job->user_id;
-    create_input.word = draft->word ? draft->word : "";
-    create_input.transcription = draft->transcription ? draft->transcription : "";
-    create_input.translation = draft->translation ? draft->translation : "";
-    create_input.example = draft->examples[0] ? draft->examples[0] : "";
+    /* Запись карточки в БД идёт без блокировки: воркеры тем временем продолжают. */
+    create_input.user_id = user_id;
+    create_input.word = word;
+    create_input.transcription = transcription;
+    create_input.translation = translation;
+    create_input.example = example;
 
     if (card_service_create(&create_input, &card_id) != CARD_SERVICE_OK) {
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        goto cleanup;
     }
 
-    status_copy = job_strdup(GENERATION_DRAFT_STATUS_APPROVED);
-    if (!status_copy) {
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
+    pthread_mutex_lock(&g_jobs_lock);
+    /* Пока шла запись, черновик могли разобрать или задачу — отменить. */
+    job = generation_job_find(job_id);
+    draft = generation_job_find_draft(job, draft_id);
+    status_copy = NULL;
+    if (!job || !draft) {
+        rc = GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+    } else if (strcmp(job->status, GENERATION_JOB_STATE_CANCELED) == 0 ||
+               strcmp(job->status, GENERATION_JOB_STATE_FAILED) == 0 ||
+               (draft->status && strcmp(draft->status, GENERATION_DRAFT_STATUS_PENDING) != 0)) {
+        rc = GENERATION_JOB_SERVICE_ERR_CONFLICT;
+    } else {
+        status_copy = job_strdup(GENERATION_DRAFT_STATUS_APPROVED);
+        if (!status_copy) {
+            rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        }
+    }
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        pthread_mutex_unlock(&g_jobs_lock);
+        /* Карточка не привязалась к черновику — не оставляем дубль. */
+        delete_input.user_id = user_id;
+        delete_input.card_id = card_id;
+        (void) card_service_delete(&delete_input);
+        goto cleanup;
     }
 
     free(draft->status);
     draft->status = status_copy;
     draft->saved_card_id = card_id;
     job->reviewed_drafts++;
+    generation_job_mark_draft_dirty(job, draft);
 
     emit_draft_event(job, draft, REALTIME_EVENT_GENERATION_CARD_SAVED);
     generation_job_finalize_if_review_complete(job);
 
-    *out_job = job;
-    *out_draft = draft;
-    return GENERATION_JOB_SERVICE_OK;
+    rc = generation_job_copy_result(job, draft, out_job, out_draft);
+    pthread_mutex_unlock(&g_jobs_lock);
+
+cleanup:
+    free(word);
+    free(transcription);
+    free(translation);
+    free(example);
+    return rc;
 }
 
 int generation_job_service_reject(int job_id, int draft_id,
-                                  const generation_job_t **out_job,
-                                  const generation_card_draft_t **out_draft)
+                                  generation_job_t *out_job,
+                                  generation_card_draft_t *out_draft)
 {
     generation_job_t *job;
     generation_card_draft_t *draft;
     char *status_copy;
+    int rc;
 
     if (!out_job || !out_draft) {
         return GENERATION_JOB_SERVICE_ERR_INVALID_ARGUMENT;
     }
 
+    pthread_mutex_lock(&g_jobs_lock);
     job = generation_job_find(job_id);
     if (!job) {
-        return GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+        rc = GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+        goto unlock;
     }
     draft = generation_job_find_draft(job, draft_id);
     if (!draft) {
-        return GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+        rc = GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+        goto unlock;
     }
     if (draft->status && strcmp(draft->status, GENERATION_DRAFT_STATUS_PENDING) != 0) {
-        return GENERATION_JOB_SERVICE_ERR_CONFLICT;
+        rc = GENERATION_JOB_SERVICE_ERR_CONFLICT;
+        goto unlock;
     }
 
     status_copy = job_strdup(GENERATION_DRAFT_STATUS_REJECTED);
     if (!status_copy) {
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        goto unlock;
     }
 
     free(draft->status);
     draft->status = status_copy;
     job->reviewed_drafts++;
+    generation_job_mark_draft_dirty(job, draft);
     generation_job_finalize_if_review_complete(job);
 
-    *out_job = job;
-    *out_draft = draft;
-    return GENERATION_JOB_SERVICE_OK;
+    rc = generation_job_copy_result(job, draft, out_job, out_draft);
+
+unlock:
+    pthread_mutex_unlock(&g_jobs_lock);
+    return rc;
 }
 
 int generation_job_service_regenerate(int job_id, int draft_id,
-                                      const generation_job_t **out_job,
-                                      const generation_card_draft_t **out_draft)
+                                      generation_job_t *out_job,
+                                      generation_card_draft_t *out_draft)
 {
     generation_job_t *job;
     generation_card_draft_t *draft;
     generate_service_request_t request;
     generate_service_card_t card;
+    char *word = NULL;
     char *status_copy;
     char *word_copy;
     char *transcription_copy;
     char *translation_copy;
     char *example_0;
     char *example_1;
+    int rc = GENERATION_JOB_SERVICE_OK;
 
     if (!out_job || !out_draft) {
         return GENERATION_JOB_SERVICE_ERR_INVALID_ARGUMENT;
     }
 
+    pthread_mutex_lock(&g_jobs_lock);
     job = generation_job_find(job_id);
-    if (!job) {
-        return GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
-    }
     draft = generation_job_find_draft(job, draft_id);
-    if (!draft) {
-        return GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+    if (!job || !draft) {
+        rc = GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+    } else if (strcmp(job->status, GENERATION_JOB_STATE_CANCELED) == 0 ||
+               strcmp(job->status, GENERATION_JOB_STATE_FAILED) == 0) {
+        rc = GENERATION_JOB_SERVICE_ERR_CONFLICT;
+    } else {
+        word = job_strdup(draft->word ? draft->word : "");
+        request.user_id = job->user_id;
+        if (!word) {
+            rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        }
     }
-    if (strcmp(job->status, GENERATION_JOB_STATE_CANCELED) == 0 ||
-        strcmp(job->status, GENERATION_JOB_STATE_FAILED) == 0) {
-        return GENERATION_JOB_SERVICE_ERR_CONFLICT;
+    pthread_mutex_unlock(&g_jobs_lock);
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        return rc;
     }
 
+    /* Запрос к LLM идёт без блокировки: воркеры тем временем продолжают. */
     memset(&card, 0, sizeof(card));
-    request.word = draft->word;
-    request.user_id = job->user_id;
+    request.word = word;
     request.persist_if_authenticated = 0;
 
     if (generate_service_generate(&request, &card) != GENERATE_SERVICE_OK) {
+        free(word);
         return GENERATION_JOB_SERVICE_ERR_UPSTREAM;
     }
+    free(word);
 
     status_copy = job_strdup(GENERATION_DRAFT_STATUS_PENDING);
     word_copy = job_strdup(card.word ? card.word : "");
@@ -727,15 +2890,25 @@ int generation_job_service_regenerate(int job_id, int draft_id,
     translation_copy = job_strdup(card.translation ? card.translation : "");
     example_0 = job_strdup(card.examples[0] ? card.examples[0] : "");
     example_1 = job_strdup(card.examples[1] ? card.examples[1] : "");
+    generate_service_free_card(&card);
     if (!status_copy || !word_copy || !transcription_copy || !translation_copy || !example_0 || !example_1) {
-        free(status_copy);
-        free(word_copy);
-        free(transcription_copy);
-        free(translation_copy);
-        free(example_0);
-        free(example_1);
-        generate_service_free_card(&card);
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        goto discard;
+    }
+
+    pthread_mutex_lock(&g_jobs_lock);
+    /* Массив черновиков мог перераспределиться, пока шла генерация. */
+    job = generation_job_find(job_id);
+    draft = generation_job_find_draft(job, draft_id);
+    if (!job || !draft) {
+        rc = GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+    } else if (strcmp(job->status, GENERATION_JOB_STATE_CANCELED) == 0 ||
+               strcmp(job->status, GENERATION_JOB_STATE_FAILED) == 0) {
+        rc = GENERATION_JOB_SERVICE_ERR_CONFLICT;
+    }
+    if (rc != GENERATION_JOB_SERVICE_OK) {
+        pthread_mutex_unlock(&g_jobs_lock);
+        goto discard;
     }
 
     if (draft->status && strcmp(draft->status, GENERATION_DRAFT_STATUS_PENDING) != 0 &&
@@ -743,6 +2916,7 @@ int generation_job_service_regenerate(int job_id, int draft_id,
         job->reviewed_drafts--;
     }
 
+    generation_job_account(job, 0, generation_draft_bytes(draft));
     free(draft->status);
     free(draft->word);
     free(draft->transcription);
@@ -757,38 +2931,140 @@ int generation_job_service_regenerate(int job_id, int draft_id,
     draft->examples[0] = example_0;
     draft->examples[1] = example_1;
     draft->saved_card_id = 0;
+    generation_job_account(job, generation_draft_bytes(draft), 0);
+    generation_job_mark_draft_dirty(job, draft);
 
     emit_draft_event(job, draft, REALTIME_EVENT_GENERATION_CARD_UPDATED);
-    generate_service_free_card(&card);
 
-    *out_job = job;
-    *out_draft = draft;
-    return GENERATION_JOB_SERVICE_OK;
+    rc = generation_job_copy_result(job, draft, out_job, out_draft);
+    pthread_mutex_unlock(&g_jobs_lock);
+    return rc;
+
+discard:
+    free(status_copy);
+    free(word_copy);
+    free(transcription_copy);
+    free(translation_copy);
+    free(example_0);
+    free(example_1);
+    return rc;
 }
 
-int generation_job_service_cancel(int job_id, const generation_job_t **out_job)
+int generation_job_service_extend(int job_id, const char *text, generation_job_t *out_job)
 {
+    generation_job_entry_t *entry;
     generation_job_t *job;
+    size_t old_len;
+    size_t text_len;
+    char *source;
+    char *pending;
+    int rc;
+
+    if (!text || text[0] == '\0' || !out_job) {
+        return GENERATION_JOB_SERVICE_ERR_INVALID_ARGUMENT;
+    }
+    text_len = strlen(text);
+
+    pthread_mutex_lock(&g_jobs_lock);
+    job = generation_job_find(job_id);
+    if (!job) {
+        rc = GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+        goto unlock;
+    }
+    entry = generation_job_entry_of(job);
+    /* Расширять можно только задачу, по которой генерация уже закончилась. */
+    if (entry->busy ||
+        (strcmp(job->status, GENERATION_JOB_STATE_REVIEW_READY) != 0 &&
+         strcmp(job->status, GENERATION_JOB_STATE_COMPLETED) != 0)) {
+        rc = GENERATION_JOB_SERVICE_ERR_CONFLICT;
+        goto unlock;
+    }
+
+    generation_job_store_sweep(text_len * 2 + 2);
+    if (g_store_bytes + text_len * 2 + 2 > g_memory_limit) {
+        rc = GENERATION_JOB_SERVICE_ERR_BUSY;
+        goto unlock;
+    }
+
+    old_len = strlen(job->source_text);
+    source = malloc(old_len + 1 + text_len + 1);
+    pending = job_strdup(text);
+    if (!source || !pending) {
+        free(source);
+        free(pending);
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        goto unlock;
+    }
+    memcpy(source, job->source_text, old_len);
+    source[old_len] = '\n';
+    memcpy(source + old_len + 1, text, text_len + 1);
+
+    if (generation_job_set_status(job, GENERATION_JOB_STATE_QUEUED) != 0) {
+        free(source);
+        free(pending);
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        goto unlock;
+    }
+    free(job->source_text);
+    job->source_text = source;
+    entry->extend_text = pending;
+    entry->extend_offset = old_len;
+    generation_job_account(job, text_len * 2 + 2, 0);
+    generation_job_finished_unlink(entry);
+    generation_job_mark_dirty(job);
+
+    /* Повторная отправка уже расширенного текста должна найти эту задачу. */
+    if (g_dedup_window_ms > 0 && job->user_id > 0) {
+        generation_job_dedup_unlink(entry);
+        if (generation_job_fingerprint(job->source_text, job->user_id, &entry->fingerprint) == 0) {
+            entry->created_at_ms = http_now_ms();
+            generation_job_dedup_link(entry);
+        }
+    }
+
+    generation_job_enqueue(entry);
+    emit_progress_event(job, GENERATION_JOB_STATE_QUEUED, 0);
+
+    rc = generation_job_copy_result(job, NULL, out_job, NULL);
+
+unlock:
+    pthread_mutex_unlock(&g_jobs_lock);
+    return rc;
+}
+
+int generation_job_service_cancel(int job_id, generation_job_t *out_job)
+{
+    generation_job_t *job;
+    int rc;
 
     if (!out_job) {
         return GENERATION_JOB_SERVICE_ERR_INVALID_ARGUMENT;
     }
 
+    pthread_mutex_lock(&g_jobs_lock);
     job = generation_job_find(job_id);
     if (!job) {
-        return GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+        rc = GENERATION_JOB_SERVICE_ERR_NOT_FOUND;
+        goto unlock;
     }
     if (strcmp(job->status, GENERATION_JOB_STATE_COMPLETED) == 0 ||
         strcmp(job->status, GENERATION_JOB_STATE_FAILED) == 0 ||
         strcmp(job->status, GENERATION_JOB_STATE_CANCELED) == 0) {
-        return GENERATION_JOB_SERVICE_ERR_CONFLICT;
+        rc = GENERATION_JOB_SERVICE_ERR_CONFLICT;
+        goto unlock;
     }
 
+    /* Воркер увидит статус перед следующим словом и остановится. */
     if (generation_job_set_status(job, GENERATION_JOB_STATE_CANCELED) != 0) {
-        return GENERATION_JOB_SERVICE_ERR_SERVER;
+        rc = GENERATION_JOB_SERVICE_ERR_SERVER;
+        goto unlock;
     }
+    generation_job_flush_events(job);
     emit_progress_event(job, GENERATION_JOB_STATE_CANCELED, 100);
 
-    *out_job = job;
-    return GENERATION_JOB_SERVICE_OK;
+    rc = generation_job_copy_result(job, NULL, out_job, NULL);
+
+unlock:
+    pthread_mutex_unlock(&g_jobs_lock);
+    return rc;
 }
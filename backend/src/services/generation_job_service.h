@@ -12,27 +12,48 @@ enum {
     GENERATION_JOB_SERVICE_ERR_CONFLICT = -3,
     GENERATION_JOB_SERVICE_ERR_UNAUTHORIZED = -4,
     GENERATION_JOB_SERVICE_ERR_UPSTREAM = -5,
-    GENERATION_JOB_SERVICE_ERR_SERVER = -6
+    GENERATION_JOB_SERVICE_ERR_SERVER = -6,
+    GENERATION_JOB_SERVICE_ERR_BUSY = -7
 };
 
 void generation_job_service_init(void);
 void generation_job_service_shutdown(void);
 
+/*
+ * Задача выполняется пулом воркеров (GENERATION_JOB_WORKERS), create только
+ * ставит её в очередь. Все выходные out_job/out_draft — копии, которыми
+ * владеет вызывающий: освобождать через generation_job_service_free_*.
+ *
+ * Если тот же пользователь недавно отправил тот же текст, create
+ * возвращает существующую задачу и выставляет *out_existing (может быть NULL).
+ */
 int generation_job_service_create(const generation_job_create_input_t *input,
-                                  const generation_job_t **out_job);
-int generation_job_service_get(int job_id, const generation_job_t **out_job);
+                                  generation_job_t *out_job,
+                                  int *out_existing);
+int generation_job_service_get(int job_id, generation_job_t *out_job);
 int generation_job_service_list_drafts(int job_id,
-                                       const generation_card_draft_t **out_drafts,
+                                       generation_card_draft_t **out_drafts,
                                        size_t *out_count);
 int generation_job_service_approve(int job_id, int draft_id,
-                                   const generation_job_t **out_job,
-                                   const generation_card_draft_t **out_draft);
+                                   generation_job_t *out_job,
+                                   generation_card_draft_t *out_draft);
 int generation_job_service_reject(int job_id, int draft_id,
-                                  const generation_job_t **out_job,
-                                  const generation_card_draft_t **out_draft);
+                                  generation_job_t *out_job,
+                                  generation_card_draft_t *out_draft);
 int generation_job_service_regenerate(int job_id, int draft_id,
-                                      const generation_job_t **out_job,
-                                      const generation_card_draft_t **out_draft);
-int generation_job_service_cancel(int job_id, const generation_job_t **out_job);
+                                      generation_job_t *out_job,
+                                      generation_card_draft_t *out_draft);
+int generation_job_service_cancel(int job_id, generation_job_t *out_job);
+
+/*
+ * Дописывает text к тексту задачи в статусе review_ready/completed и снова
+ * ставит её в очередь: новые черновики добавляются к той же задаче,
+ * в генерацию идут только слова, которых в задаче ещё не было.
+ */
+int generation_job_service_extend(int job_id, const char *text, generation_job_t *out_job);
+
+void generation_job_service_free_job(generation_job_t *job);
+void generation_job_service_free_draft(generation_card_draft_t *draft);
+void generation_job_service_free_drafts(generation_card_draft_t *drafts, size_t count);
 
 #endif
@@ -4,6 +4,7 @@
 #include "internal_api/auth_api.h"
 #include "internal_api/profile_api.h"
 #include "libs/validate.h"
+#include "utils/stopwords.h"
 
 #include <string.h>
 
@@ -65,6 +66,35 @@ int user_service_get_profile(const char *cookie_header, user_profile_t *profile)
     memcpy(profile->username, profile_data.username, sizeof(profile->username));
     profile->words_learned = profile_data.words_learned;
     profile->active_lessons = profile_data.active_lessons;
+    profile->known_level = profile_data.known_level;
 
     return USER_SERVICE_OK;
 }
+
+int user_service_set_known_level(const char *cookie_header, int level)
+{
+    if (!cookie_header) {
+        return USER_SERVICE_ERR_SERVER;
+    }
+    if (level < 0 || level > stopword_max_level()) {
+        return USER_SERVICE_ERR_INVALID_ARGUMENT;
+    }
+
+    int user_id = 0;
+    int auth_rc = auth_api_validate_session(cookie_header, &user_id);
+    if (auth_rc == AUTH_API_ERR_UNAUTHORIZED) return USER_SERVICE_ERR_UNAUTHORIZED;
+    if (auth_rc != AUTH_API_OK) return USER_SERVICE_ERR_SERVER;
+
+    int rc = profile_api_set_known_level(user_id, level);
+    if (rc != PROFILE_API_OK) {
+        ERROR_PRINT("user_service_set_known_level: profile_api_set_known_level failed rc=%d", rc);
+        return USER_SERVICE_ERR_SERVER;
+    }
+
+    return USER_SERVICE_OK;
+}
+
+int user_service_max_known_level(void)
+{
+    return stopword_max_level();
+}
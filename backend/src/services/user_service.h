@@ -7,6 +7,7 @@ typedef struct {
     char username[256];
     int words_learned;
     int active_lessons;
+    int known_level;
 } user_profile_t;
 
 enum {
@@ -16,7 +17,8 @@ enum {
     USER_SERVICE_ERR_CONFLICT = -3,
     USER_SERVICE_ERR_UNAUTHORIZED = -4,
     USER_SERVICE_ERR_INVALID_EMAIL = -5,
-    USER_SERVICE_ERR_PASSWORD_TOO_SHORT = -6
+    USER_SERVICE_ERR_PASSWORD_TOO_SHORT = -6,
+    USER_SERVICE_ERR_INVALID_ARGUMENT = -7
 };
 
 int user_service_login(const char *username, const char *password,
@@ -25,4 +27,8 @@ int user_service_register(const char *username, const char *email,
                           const char *password, int *user_id);
 int user_service_get_profile(const char *cookie_header, user_profile_t *profile);
 
+/* 0..user_service_max_known_level(); слова этих уровней не предлагаются в карточки. */
+int user_service_set_known_level(const char *cookie_header, int level);
+int user_service_max_known_level(void);
+
 #endif
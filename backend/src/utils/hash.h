@@ -0,0 +1,21 @@
+#ifndef UTILS_HASH_H
+#define UTILS_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * 64-битный некриптографический хеш по схеме XXH64: четыре независимые
+ * полосы по 8 байт, затем хвост и финальное перемешивание. Результат
+ * совпадает с эталонным XXH64 для того же seed.
+ */
+uint64_t hash_xxh64(const void *data, size_t len, uint64_t seed);
+
+/*
+ * FNV-1a по строке до '\0' с затравкой в начальном значении. Им строятся
+ * совершенные хеш-таблицы из tools/: генераторы считают тот же хеш
+ * (fnv() в tools/stopwords/gen_stopword_table.py).
+ */
+uint32_t hash_fnv1a_str(const char *str, uint32_t seed);
+
+#endif
@@ -0,0 +1,649 @@
+#include "utils/json.h"
+#include "utils/unicode.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define JSON_SSE2 1
+#endif
+
+#define JSON_SCAN_MAX_DEPTH 64
+
+void json_scan_init(json_scan_t *scan, char *data, size_t len)
+{
+    scan->p = data;
+    scan->end = data + len;
+}
+
+char json_scan_peek(json_scan_t *scan)
+{
+    while (scan->p < scan->end &&
+           (*scan->p == ' ' || *scan->p == '\t' || *scan->p == '\n' || *scan->p == '\r')) {
+        scan->p++;
+    }
+    return scan->p < scan->end ? *scan->p : '\0';
+}
+
+int json_scan_expect(json_scan_t *scan, char c)
+{
+    if (json_scan_peek(scan) != c) {
+        return -1;
+    }
+    scan->p++;
+    return 0;
+}
+
+static int json_hex4(const char *p, unsigned *out)
+{
+    unsigned value = 0;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        char c = p[i];
+
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value |= (unsigned) (c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            value |= (unsigned) (c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            value |= (unsigned) (c - 'A' + 10);
+        } else {
+            return -1;
+        }
+    }
+
+    *out = value;
+    return 0;
+}
+
+static char *json_put_utf8(char *dst, unsigned cp)
+{
+    if (cp < 0x80) {
+        *dst++ = (char) cp;
+    } else if (cp < 0x800) {
+        *dst++ = (char) (0xC0 | (cp >> 6));
+        *dst++ = (char) (0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *dst++ = (char) (0xE0 | (cp >> 12));
+        *dst++ = (char) (0x80 | ((cp >> 6) & 0x3F));
+        *dst++ = (char) (0x80 | (cp & 0x3F));
+    } else {
+        *dst++ = (char) (0xF0 | (cp >> 18));
+        *dst++ = (char) (0x80 | ((cp >> 12) & 0x3F));
+        *dst++ = (char) (0x80 | ((cp >> 6) & 0x3F));
+        *dst++ = (char) (0x80 | (cp & 0x3F));
+    }
+    return dst;
+}
+
+int json_scan_string(json_scan_t *scan, char **out, size_t *out_len)
+{
+    char *src;
+    char *dst;
+    char *start;
+
+    if (json_scan_expect(scan, '"') != 0) {
+        return -1;
+    }
+
+    start = dst = src = scan->p;
+
+    /* Без escape-последовательностей строка остаётся на месте. */
+    while (src < scan->end && *src != '"' && *src != '\\') {
+        src++;
+    }
+    dst = src;
+
+    while (src < scan->end && *src != '"') {
+        unsigned cp;
+
+        if (*src != '\\') {
+            *dst++ = *src++;
+            continue;
+        }
+        if (src + 1 >= scan->end) {
+            return -1;
+        }
+
+        src++;
+        switch (*src++) {
+        case '"':  *dst++ = '"';  break;
+        case '\\': *dst++ = '\\'; break;
+        case '/':  *dst++ = '/';  break;
+        case 'b':  *dst++ = '\b'; break;
+        case 'f':  *dst++ = '\f'; break;
+        case 'n':  *dst++ = '\n'; break;
+        case 'r':  *dst++ = '\r'; break;
+        case 't':  *dst++ = '\t'; break;
+        case 'u':
+            if (scan->end - src < 4 || json_hex4(src, &cp) != 0) {
+                return -1;
+            }
+            src += 4;
+            /* Суррогатная пара \uD8xx\uDCxx — один символ вне BMP. */
+            if (cp >= 0xD800 && cp <= 0xDBFF && scan->end - src >= 6 &&
+                src[0] == '\\' && src[1] == 'u') {
+                unsigned low;
+
+                if (json_hex4(src + 2, &low) == 0 && low >= 0xDC00 && low <= 0xDFFF) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    src += 6;
+                }
+            }
+            dst = json_put_utf8(dst, cp);
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    if (src >= scan->end) {
+        return -1;
+    }
+
+    /* dst <= src, поэтому '\0' не затирает ещё не прочитанные данные. */
+    *dst = '\0';
+    scan->p = src + 1;
+
+    if (out) {
+        *out = start;
+    }
+    if (out_len) {
+        *out_len = (size_t) (dst - start);
+    }
+    return 0;
+}
+
+int json_scan_skip_value(json_scan_t *scan)
+{
+    int depth = 0;
+
+    for (;;) {
+        char c = json_scan_peek(scan);
+
+        if (c == '"') {
+            char *q = scan->p + 1;
+
+            /* Пропуск строки без раскодирования. */
+            while (q < scan->end && *q != '"') {
+                q += (*q == '\\') ? 2 : 1;
+            }
+            if (q >= scan->end) {
+                return -1;
+            }
+            scan->p = q + 1;
+        } else if (c == '{' || c == '[') {
+            if (++depth > JSON_SCAN_MAX_DEPTH) {
+                return -1;
+            }
+            scan->p++;
+            continue;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0) {
+                return -1;
+            }
+            depth--;
+            scan->p++;
+        } else if (c == '\0') {
+            return -1;
+        } else {
+            /* Число или литерал true/false/null. */
+            while (scan->p < scan->end && strchr(",:}] \t\r\n", *scan->p) == NULL) {
+                scan->p++;
+            }
+        }
+
+        if (depth == 0) {
+            return 0;
+        }
+
+        /* Внутри контейнера: разделители между элементами. */
+        c = json_scan_peek(scan);
+        if (c == ',' || c == ':') {
+            scan->p++;
+        }
+    }
+}
+
+char *json_scan_find_string(char *data, size_t len, const char *key, size_t *out_len)
+{
+    json_scan_t scan;
+
+    json_scan_init(&scan, data, len);
+    if (json_scan_expect(&scan, '{') != 0) {
+        return NULL;
+    }
+    if (json_scan_peek(&scan) == '}') {
+        return NULL;
+    }
+
+    for (;;) {
+        char *name;
+
+        if (json_scan_string(&scan, &name, NULL) != 0 || json_scan_expect(&scan, ':') != 0) {
+            return NULL;
+        }
+
+        if (strcmp(name, key) == 0) {
+            char *value;
+
+            if (json_scan_peek(&scan) != '"' || json_scan_string(&scan, &value, out_len) != 0) {
+                return NULL;
+            }
+            return value;
+        }
+
+        if (json_scan_skip_value(&scan) != 0) {
+            return NULL;
+        }
+        if (json_scan_expect(&scan, ',') != 0) {
+            return NULL;
+        }
+    }
+}
+
+/* --- Запись --- */
+
+void json_writer_init(json_writer_t *w, char *buf, size_t size)
+{
+    memset(w, 0, sizeof(*w));
+    w->buf = buf;
+    w->cap = buf ? size : 0;
+}
+
+void json_writer_free(json_writer_t *w)
+{
+    free(w->heap);
+    w->heap = NULL;
+    w->buf = NULL;
+    w->len = 0;
+    w->cap = 0;
+}
+
+/* Гарантирует место под extra байт и завершающий '\0'. */
+static int json_writer_reserve(json_writer_t *w, size_t extra)
+{
+    size_t need;
+    size_t cap;
+    char *grown;
+
+    if (w->failed) {
+        return -1;
+    }
+    need = w->len + extra + 1;
+    if (need <= w->cap) {
+        return 0;
+    }
+
+    cap = w->cap > 0 ? w->cap : 256;
+    while (cap < need) {
+        cap *= 2;
+    }
+    if (w->heap) {
+        grown = realloc(w->heap, cap);
+    } else {
+        grown = malloc(cap);
+        if (grown && w->len > 0) {
+            memcpy(grown, w->buf, w->len);
+        }
+    }
+    if (!grown) {
+        w->failed = 1;
+        return -1;
+    }
+    w->heap = grown;
+    w->buf = grown;
+    w->cap = cap;
+    return 0;
+}
+
+static void json_writer_put(json_writer_t *w, const char *data, size_t len)
+{
+    if (json_writer_reserve(w, len) != 0) {
+        return;
+    }
+    memcpy(w->buf + w->len, data, len);
+    w->len += len;
+}
+
+/* Запятая перед очередным значением контейнера. */
+static void json_writer_separate(json_writer_t *w)
+{
+    uint64_t bit;
+
+    if (w->after_key) {
+        w->after_key = 0;
+        return;
+    }
+    if (w->depth == 0) {
+        return;
+    }
+    bit = 1ULL << (w->depth - 1);
+    if (w->has_items & bit) {
+        json_writer_put(w, ",", 1);
+    }
+    w->has_items |= bit;
+}
+
+/* Символы, которые cJSON экранирует: 0 — копируется как есть. */
+static const char json_escape_char[128] = {
+    ['\b'] = 'b', ['\f'] = 'f', ['\n'] = 'n', ['\r'] = 'r', ['\t'] = 't',
+    [0x00] = 'u', [0x01] = 'u', [0x02] = 'u', [0x03] = 'u', [0x04] = 'u',
+    [0x05] = 'u', [0x06] = 'u', [0x07] = 'u', [0x0B] = 'u', [0x0E] = 'u',
+    [0x0F] = 'u', [0x10] = 'u', [0x11] = 'u', [0x12] = 'u', [0x13] = 'u',
+    [0x14] = 'u', [0x15] = 'u', [0x16] = 'u', [0x17] = 'u', [0x18] = 'u',
+    [0x19] = 'u', [0x1A] = 'u', [0x1B] = 'u', [0x1C] = 'u', [0x1D] = 'u',
+    [0x1E] = 'u', [0x1F] = 'u',
+    ['"'] = '"', ['\\'] = '\\'
+};
+
+#ifdef JSON_SSE2
+/* Беззнаковое lo <= x <= hi через знаковое сравнение, как в токенизаторе. */
+#define JSON_SSE_IN_RANGE(x, lo, hi) \
+    _mm_cmplt_epi8(_mm_xor_si128(_mm_sub_epi8((x), _mm_set1_epi8((char) (lo))), _mm_set1_epi8((char) 0x80)), \
+                   _mm_set1_epi8((char) (((hi) - (lo) + 1) ^ 0x80)))
+
+/*
+ * Маска байтов блока, которые нельзя скопировать как есть: экранируемые
+ * символы и всё не-ASCII, кроме корректных двухбайтовых символов UTF-8
+ * (кириллица, латиница с диакритикой), целиком лежащих внутри блока.
+ */
+static unsigned json_escape_mask_sse2(__m128i x)
+{
+    unsigned high = (unsigned) _mm_movemask_epi8(x);
+    /* Знаковое x < 0x20 ловит и байты >= 0x80 — их убирает ~high. */
+    unsigned special = ((unsigned) _mm_movemask_epi8(_mm_cmplt_epi8(x, _mm_set1_epi8(0x20))) & ~high) |
+                       (unsigned) _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('"')),
+                                                                 _mm_cmpeq_epi8(x, _mm_set1_epi8('\\'))));
+    unsigned lead;
+    unsigned cont;
+
+    if (!high) {
+        return special;
+    }
+    lead = (unsigned) _mm_movemask_epi8(JSON_SSE_IN_RANGE(x, 0xC2, 0xDF));
+    cont = (unsigned) _mm_movemask_epi8(JSON_SSE_IN_RANGE(x, 0x80, 0xBF));
+    /* Ведущий байт без продолжения следом (в том числе в последнем байте блока)
+     * и продолжение без ведущего перед ним разбираются по одному символу. */
+    return special | (high & ~(lead | cont)) | (lead & ~(cont >> 1)) | (cont & ~(lead << 1));
+}
+#endif
+
+/*
+ * Экранирует из [*src, end) столько, сколько помещается в cap байт dst
+ * (при cap >= JSON_ESCAPE_MAX_EXPANSION хотя бы один символ), сдвигает
+ * *src и возвращает число записанных байт.
+ */
+static size_t json_escape_chunk(char *dst, size_t cap, const unsigned char **src,
+                                const unsigned char *end)
+{
+    static const char hex[] = "0123456789abcdef";
+    const unsigned char *s = *src;
+    char *d = dst;
+    char *dend = dst + cap;
+
+    while (s < end) {
+        unsigned char c;
+
+#ifdef JSON_SSE2
+        /* Блок копируется сразу и проверяется после: до первого особого байта копия верна. */
+        while (end - s >= 16 && dend - d >= 16) {
+            __m128i x = _mm_loadu_si128((const __m128i *) s);
+            unsigned mask;
+
+            _mm_storeu_si128((__m128i *) d, x);
+            mask = json_escape_mask_sse2(x);
+            if (mask) {
+                s += __builtin_ctz(mask);
+                d += __builtin_ctz(mask);
+                break;
+            }
+            s += 16;
+            d += 16;
+        }
+#endif
+        while (s < end && d < dend && *s < 0x80 && json_escape_char[*s] == 0) {
+            *d++ = (char) *s++;
+        }
+        if (s == end || d == dend) {
+            break;
+        }
+
+        c = *s;
+        if (c < 0x80) {
+            char esc = json_escape_char[c];
+
+            if (dend - d < (esc == 'u' ? 6 : 2)) {
+                break;
+            }
+            *d++ = '\\';
+            *d++ = esc;
+            if (esc == 'u') {
+                *d++ = '0';
+                *d++ = '0';
+                *d++ = hex[c >> 4];
+                *d++ = hex[c & 0x0F];
+            }
+            s++;
+            continue;
+        }
+
+        /* Символ UTF-8, который не прошёл проверку блока целиком. */
+        if (c >= 0xC2 && c <= 0xDF && end - s >= 2 && (s[1] & 0xC0) == 0x80) {
+            if (dend - d < 2) {
+                break;
+            }
+            d[0] = (char) s[0];
+            d[1] = (char) s[1];
+            d += 2;
+            s += 2;
+        } else {
+            size_t seq_len;
+            uint32_t cp = utf8_decode(s, end, &seq_len);
+
+            /* Битый UTF-8 сделал бы весь ответ невалидным — заменяем байт на U+FFFD. */
+            if (cp == UNICODE_REPLACEMENT && seq_len == 1) {
+                if (dend - d < 6) {
+                    break;
+                }
+                memcpy(d, "\\ufffd", 6);
+                d += 6;
+            } else {
+                if ((size_t) (dend - d) < seq_len) {
+                    break;
+                }
+                memcpy(d, s, seq_len);
+                d += seq_len;
+            }
+            s += seq_len;
+        }
+    }
+
+    *src = s;
+    return (size_t) (d - dst);
+}
+
+size_t json_escape(char *dst, const char *src, size_t len)
+{
+    const unsigned char *p = (const unsigned char *) src;
+
+    return json_escape_chunk(dst, len * JSON_ESCAPE_MAX_EXPANSION, &p, p + len);
+}
+
+char *json_escape_dup(const char *src, size_t len, size_t *out_len)
+{
+    char *out;
+    char *shrunk;
+    size_t written;
+
+    if (!src || len > (SIZE_MAX - 1) / JSON_ESCAPE_MAX_EXPANSION) {
+        return NULL;
+    }
+
+    out = malloc(len * JSON_ESCAPE_MAX_EXPANSION + 1);
+    if (!out) {
+        return NULL;
+    }
+    written = json_escape(out, src, len);
+    out[written] = '\0';
+
+    /* Запас в 6 раз нужен только на худший случай — лишнее отдаём. */
+    shrunk = realloc(out, written + 1);
+    if (shrunk) {
+        out = shrunk;
+    }
+    if (out_len) {
+        *out_len = written;
+    }
+    return out;
+}
+
+static void json_writer_put_escaped(json_writer_t *w, const char *value, size_t len)
+{
+    const unsigned char *p = (const unsigned char *) value;
+    const unsigned char *end = p + len;
+
+    json_writer_put(w, "\"", 1);
+    while (p < end) {
+        /* Чистый текст помещается за один проход; экранирование может потребовать ещё. */
+        if (json_writer_reserve(w, (size_t) (end - p) + JSON_ESCAPE_MAX_EXPANSION) != 0) {
+            return;
+        }
+        w->len += json_escape_chunk(w->buf + w->len, w->cap - w->len - 1, &p, end);
+    }
+    json_writer_put(w, "\"", 1);
+}
+
+static void json_writer_open(json_writer_t *w, char bracket)
+{
+    json_writer_separate(w);
+    if (w->depth >= JSON_WRITER_MAX_DEPTH) {
+        w->failed = 1;
+        return;
+    }
+    json_writer_put(w, &bracket, 1);
+    w->depth++;
+    w->has_items &= ~(1ULL << (w->depth - 1));
+}
+
+static void json_writer_close(json_writer_t *w, char bracket)
+{
+    if (w->depth == 0 || w->after_key) {
+        w->failed = 1;
+        return;
+    }
+    w->depth--;
+    json_writer_put(w, &bracket, 1);
+}
+
+const char *json_writer_finish(json_writer_t *w, size_t *out_len)
+{
+    if (w->depth != 0 || w->after_key || json_writer_reserve(w, 0) != 0) {
+        w->failed = 1;
+        return NULL;
+    }
+    w->buf[w->len] = '\0';
+    if (out_len) {
+        *out_len = w->len;
+    }
+    return w->buf;
+}
+
+void json_write_object_begin(json_writer_t *w)
+{
+    json_writer_open(w, '{');
+}
+
+void json_write_object_end(json_writer_t *w)
+{
+    json_writer_close(w, '}');
+}
+
+void json_write_array_begin(json_writer_t *w)
+{
+    json_writer_open(w, '[');
+}
+
+void json_write_array_end(json_writer_t *w)
+{
+    json_writer_close(w, ']');
+}
+
+void json_write_key(json_writer_t *w, const char *key)
+{
+    if (w->after_key || w->depth == 0) {
+        w->failed = 1;
+        return;
+    }
+    json_writer_separate(w);
+    json_writer_put_escaped(w, key, strlen(key));
+    json_writer_put(w, ":", 1);
+    w->after_key = 1;
+}
+
+void json_write_string_len(json_writer_t *w, const char *value, size_t len)
+{
+    json_writer_separate(w);
+    json_writer_put_escaped(w, value ? value : "", value ? len : 0);
+}
+
+void json_write_string(json_writer_t *w, const char *value)
+{
+    json_write_string_len(w, value, value ? strlen(value) : 0);
+}
+
+void json_write_int(json_writer_t *w, long long value)
+{
+    char digits[24];
+    char *p = digits + sizeof(digits);
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long) value
+                                             : (unsigned long long) value;
+
+    do {
+        *--p = (char) ('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        *--p = '-';
+    }
+    json_writer_separate(w);
+    json_writer_put(w, p, (size_t) (digits + sizeof(digits) - p));
+}
+
+void json_write_bool(json_writer_t *w, int value)
+{
+    json_writer_separate(w);
+    if (value) {
+        json_writer_put(w, "true", 4);
+    } else {
+        json_writer_put(w, "false", 5);
+    }
+}
+
+void json_write_null(json_writer_t *w)
+{
+    json_writer_separate(w);
+    json_writer_put(w, "null", 4);
+}
+
+void json_write_field_string(json_writer_t *w, const char *key, const char *value)
+{
+    json_write_key(w, key);
+    json_write_string(w, value);
+}
+
+void json_write_field_int(json_writer_t *w, const char *key, long long value)
+{
+    json_write_key(w, key);
+    json_write_int(w, value);
+}
+
+void json_write_field_bool(json_writer_t *w, const char *key, int value)
+{
+    json_write_key(w, key);
+    json_write_bool(w, value);
+}
@@ -1 +1,105 @@
-//(We rely on cJSON library; no custom JSON utils beyond including cJSON.)
\ No newline at end of file
+#ifndef UTILS_JSON_H
+#define UTILS_JSON_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Однопроходный сканер JSON для горячих путей, где дерево cJSON не нужно.
+ * Работает прямо по буферу вызывающего: строки раскодируются на месте
+ * (результат не длиннее исходной записи) и завершаются '\0', поэтому
+ * буфер должен быть изменяемым. Указатели на строки остаются валидными,
+ * пока жив буфер.
+ */
+typedef struct {
+    char *p;
+    char *end;
+} json_scan_t;
+
+void json_scan_init(json_scan_t *scan, char *data, size_t len);
+
+/* Пропускает пробелы и возвращает следующий символ ('\0' в конце данных). */
+char json_scan_peek(json_scan_t *scan);
+
+/* Съедает символ c после пробелов. 0 — успех, -1 — другой символ. */
+int json_scan_expect(json_scan_t *scan, char c);
+
+/*
+ * Читает строку в кавычках, раскодирует escape-последовательности
+ * (включая \uXXXX) на месте. *out указывает внутрь буфера, *out_len — длина.
+ */
+int json_scan_string(json_scan_t *scan, char **out, size_t *out_len);
+
+/* Пропускает одно значение любого типа. */
+int json_scan_skip_value(json_scan_t *scan);
+
+/*
+ * Находит поле key в объекте верхнего уровня и раскодирует его
+ * строковое значение на месте. NULL, если поля нет или это не строка.
+ */
+char *json_scan_find_string(char *data, size_t len, const char *key, size_t *out_len);
+
+/*
+ * Экранирование строки для записи внутрь кавычек JSON — общее для
+ * json_writer_t и мест, где JSON собирается вручную. Кавычка, обратная
+ * косая черта и управляющие символы экранируются так же, как в cJSON;
+ * корректный UTF-8 копируется как есть, а байты битого UTF-8 заменяются
+ * на \ufffd, так что результат всегда валидный JSON. Чистый текст
+ * идёт блоками по 16 байт (SSE2) со скоростью, близкой к memcpy.
+ */
+#define JSON_ESCAPE_MAX_EXPANSION 6
+
+/* В dst должно быть len * JSON_ESCAPE_MAX_EXPANSION байт; возвращает длину без '\0'. */
+size_t json_escape(char *dst, const char *src, size_t len);
+/* malloc-строка с '\0' или NULL; out_len может быть NULL. */
+char *json_escape_dup(const char *src, size_t len, size_t *out_len);
+
+/*
+ * Потоковая запись JSON для ответов без дерева cJSON: значения пишутся
+ * подряд в один буфер, запятые и вложенность отслеживает сам writer.
+ * Буфер начинается с памяти вызывающего (обычно на стеке) и переезжает
+ * в кучу, только если не поместился, так что типичный ответ собирается
+ * без единого malloc. Строки экранирует json_escape.
+ *
+ * Ошибки (нет памяти, вложенность глубже JSON_WRITER_MAX_DEPTH,
+ * незакрытый контейнер) запоминаются: вызовы после ошибки ничего не
+ * делают, а json_writer_finish вернёт NULL.
+ */
+#define JSON_WRITER_MAX_DEPTH 64
+
+typedef struct {
+    char *buf;
+    size_t len;
+    size_t cap;
+    char *heap;
+    int depth;
+    int failed;
+    /* Бит уровня: в текущем контейнере уже есть элемент, нужна запятая. */
+    uint64_t has_items;
+    /* Только что записан ключ: значение идёт без запятой. */
+    int after_key;
+} json_writer_t;
+
+void json_writer_init(json_writer_t *w, char *buf, size_t size);
+/* Готовый текст (без '\0' в длине) или NULL при ошибке; живёт до json_writer_free. */
+const char *json_writer_finish(json_writer_t *w, size_t *out_len);
+void json_writer_free(json_writer_t *w);
+
+void json_write_object_begin(json_writer_t *w);
+void json_write_object_end(json_writer_t *w);
+void json_write_array_begin(json_writer_t *w);
+void json_write_array_end(json_writer_t *w);
+void json_write_key(json_writer_t *w, const char *key);
+/* NULL пишется как пустая строка — так же отвечали обработчики на cJSON. */
+void json_write_string(json_writer_t *w, const char *value);
+void json_write_string_len(json_writer_t *w, const char *value, size_t len);
+void json_write_int(json_writer_t *w, long long value);
+void json_write_bool(json_writer_t *w, int value);
+void json_write_null(json_writer_t *w);
+
+/* Пара "ключ": значение внутри объекта. */
+void json_write_field_string(json_writer_t *w, const char *key, const char *value);
+void json_write_field_int(json_writer_t *w, const char *key, long long value);
+void json_write_field_bool(json_writer_t *w, const char *key, int value);
+
+#endif
@@ -0,0 +1,195 @@
+#include "utils/json_arena.h"
+
+#include "libs/cJSON.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#define JSON_ARENA_DEFAULT_KB 32
+#define JSON_ARENA_MAX_KB (16 * 1024)
+#define JSON_ARENA_ALIGN 16
+
+typedef struct json_arena_chunk_s {
+    struct json_arena_chunk_s *next;
+    size_t used;
+} json_arena_chunk_t;
+
+/* Данные куска начинаются после заголовка, выровненного под JSON_ARENA_ALIGN. */
+#define JSON_ARENA_HEADER \
+    ((sizeof(json_arena_chunk_t) + JSON_ARENA_ALIGN - 1) & ~(size_t) (JSON_ARENA_ALIGN - 1))
+
+typedef struct {
+    int active;
+    /* Текущий кусок; цепочка заканчивается first. */
+    json_arena_chunk_t *head;
+    /* Кусок, который остаётся у потока между запросами. */
+    json_arena_chunk_t *first;
+    size_t bytes;
+    unsigned long long allocations;
+    unsigned long long heap_allocations;
+    unsigned long long extra_chunks;
+} json_arena_t;
+
+static pthread_once_t g_arena_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t g_arena_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t g_chunk_size = 0;
+static json_arena_stats_t g_stats;
+static __thread json_arena_t t_arena;
+
+static unsigned char *json_arena_data(json_arena_chunk_t *chunk)
+{
+    return (unsigned char *) chunk + JSON_ARENA_HEADER;
+}
+
+static int json_arena_owns(const json_arena_t *arena, const void *ptr)
+{
+    const unsigned char *p = ptr;
+    json_arena_chunk_t *chunk;
+
+    for (chunk = arena->head; chunk; chunk = chunk->next) {
+        const unsigned char *data = json_arena_data(chunk);
+
+        if (p >= data && p < data + g_chunk_size) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void *json_arena_malloc(size_t size)
+{
+    json_arena_t *arena = &t_arena;
+    json_arena_chunk_t *chunk;
+    void *ptr;
+
+    if (!arena->active) {
+        return malloc(size);
+    }
+
+    size = (size + JSON_ARENA_ALIGN - 1) & ~(size_t) (JSON_ARENA_ALIGN - 1);
+    /* Крупный блок съел бы кусок целиком — такие идут мимо арены. */
+    if (size == 0 || size > g_chunk_size / 4) {
+        arena->heap_allocations++;
+        return malloc(size);
+    }
+
+    chunk = arena->head;
+    if (!chunk || g_chunk_size - chunk->used < size) {
+        chunk = malloc(JSON_ARENA_HEADER + g_chunk_size);
+        if (!chunk) {
+            arena->heap_allocations++;
+            return malloc(size);
+        }
+        chunk->used = 0;
+        chunk->next = arena->head;
+        if (!arena->first) {
+            arena->first = chunk;
+        } else {
+            arena->extra_chunks++;
+        }
+        arena->head = chunk;
+    }
+
+    ptr = json_arena_data(chunk) + chunk->used;
+    chunk->used += size;
+    arena->bytes += size;
+    arena->allocations++;
+    return ptr;
+}
+
+static void json_arena_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    /* Блоки арены освобождаются все вместе в json_arena_end. */
+    if (t_arena.active && json_arena_owns(&t_arena, ptr)) {
+        return;
+    }
+    free(ptr);
+}
+
+static void json_arena_init_once(void)
+{
+    const char *value = getenv("JSON_ARENA_KB");
+    cJSON_Hooks hooks = { json_arena_malloc, json_arena_free };
+    long kb = JSON_ARENA_DEFAULT_KB;
+    char *endptr;
+
+    if (value && value[0] != '\0') {
+        long parsed = strtol(value, &endptr, 10);
+
+        if (*endptr == '\0' && parsed >= 0 && parsed <= JSON_ARENA_MAX_KB) {
+            kb = parsed;
+        }
+    }
+    if (kb == 0) {
+        return;
+    }
+
+    g_chunk_size = (size_t) kb * 1024;
+    cJSON_InitHooks(&hooks);
+}
+
+void json_arena_init(void)
+{
+    pthread_once(&g_arena_once, json_arena_init_once);
+}
+
+void json_arena_begin(void)
+{
+    json_arena_t *arena = &t_arena;
+
+    if (g_chunk_size == 0 || arena->active) {
+        return;
+    }
+
+    arena->active = 1;
+    arena->bytes = 0;
+    arena->allocations = 0;
+    arena->heap_allocations = 0;
+    arena->extra_chunks = 0;
+}
+
+void json_arena_end(void)
+{
+    json_arena_t *arena = &t_arena;
+
+    if (!arena->active) {
+        return;
+    }
+
+    while (arena->head && arena->head != arena->first) {
+        json_arena_chunk_t *next = arena->head->next;
+
+        free(arena->head);
+        arena->head = next;
+    }
+    if (arena->head) {
+        arena->head->used = 0;
+    }
+    arena->active = 0;
+
+    pthread_mutex_lock(&g_arena_lock);
+    g_stats.requests++;
+    g_stats.allocations += arena->allocations;
+    g_stats.bytes += arena->bytes;
+    g_stats.heap_allocations += arena->heap_allocations;
+    g_stats.extra_chunks += arena->extra_chunks;
+    if (arena->bytes > g_stats.peak_bytes) {
+        g_stats.peak_bytes = arena->bytes;
+    }
+    pthread_mutex_unlock(&g_arena_lock);
+}
+
+void json_arena_get_stats(json_arena_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_arena_lock);
+    *out = g_stats;
+    out->chunk_size = g_chunk_size;
+    pthread_mutex_unlock(&g_arena_lock);
+}
@@ -0,0 +1,42 @@
+#ifndef UTILS_JSON_ARENA_H
+#define UTILS_JSON_ARENA_H
+
+#include <stddef.h>
+
+typedef struct {
+    size_t chunk_size;                  /* 0 — арена выключена */
+    size_t peak_bytes;                  /* максимум за один запрос */
+    unsigned long long requests;
+    unsigned long long allocations;     /* выдано из арены */
+    unsigned long long bytes;
+    unsigned long long heap_allocations; /* крупные блоки и нехватка памяти — мимо арены */
+    unsigned long long extra_chunks;    /* куски сверх первого */
+} json_arena_stats_t;
+
+/*
+ * Арена для всех выделений cJSON на время одного HTTP-запроса: узлы и
+ * строки разбора и сборки берутся подряд из одного куска памяти, free
+ * для них ничего не делает, а в json_arena_end, когда ответ уже отправлен,
+ * всё освобождается разом. Обработчики по-прежнему вызывают cJSON_Delete
+ * и cJSON_free, как без арены.
+ *
+ * Арена своя у каждого потока и включена только между begin и end; в
+ * остальное время (воркеры задач, LLM, realtime) cJSON работает через
+ * обычный malloc. Отсюда ограничение: память cJSON, полученная внутри
+ * запроса, не должна переживать json_arena_end и уходить в другие потоки,
+ * а результат cJSON_Print* освобождается только через cJSON_free.
+ *
+ * Размер куска — JSON_ARENA_KB (0 — арена выключена). Первый кусок
+ * остаётся у потока между запросами; блоки больше четверти куска
+ * (например, буфер печати большого ответа) выделяются обычным malloc.
+ *
+ * json_arena_init ставит хуки cJSON и вызывается из main до запуска
+ * потоков.
+ */
+void json_arena_init(void);
+void json_arena_begin(void);
+void json_arena_end(void);
+
+void json_arena_get_stats(json_arena_stats_t *out);
+
+#endif
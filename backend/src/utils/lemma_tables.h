@@ -0,0 +1,793 @@
+/* Сгенерировано tools/lemmas/gen_lemma_tables.py из irregular.txt. Не править вручную. */
+#ifndef UTILS_LEMMA_TABLES_H
+#define UTILS_LEMMA_TABLES_H
+
+#include <stdint.h>
+
+/* 469 строк, 3052 байт. */
+static const char lemma_strings[] =
+    "ached\0"
+    "ache\0"
+    "aches\0"
+    "aching\0"
+    "added\0"
+    "add\0"
+    "adding\0"
+    "agreed\0"
+    "agree\0"
+    "always\0"
+    "am\0"
+    "be\0"
+    "amazing\0"
+    "analyses\0"
+    "analysis\0"
+    "annoying\0"
+    "anything\0"
+    "are\0"
+    "arisen\0"
+    "arise\0"
+    "arose\0"
+    "arranged\0"
+    "arrange\0"
+    "arranging\0"
+    "ate\0"
+    "eat\0"
+    "athletics\0"
+    "atlas\0"
+    "beaten\0"
+    "beat\0"
+    "became\0"
+    "become\0"
+    "been\0"
+    "began\0"
+    "begin\0"
+    "begun\0"
+    "being\0"
+    "bent\0"
+    "bend\0"
+    "best\0"
+    "good\0"
+    "better\0"
+    "bias\0"
+    "biased\0"
+    "bitten\0"
+    "bite\0"
+    "bled\0"
+    "bleed\0"
+    "blew\0"
+    "blow\0"
+    "blown\0"
+    "boring\0"
+    "born\0"
+    "bear\0"
+    "borne\0"
+    "bought\0"
+    "buy\0"
+    "bred\0"
+    "breed\0"
+    "broke\0"
+    "break\0"
+    "broken\0"
+    "brought\0"
+    "bring\0"
+    "built\0"
+    "build\0"
+    "burnt\0"
+    "burn\0"
+    "buses\0"
+    "bus\0"
+    "calves\0"
+    "calf\0"
+    "came\0"
+    "come\0"
+    "canvas\0"
+    "caught\0"
+    "catch\0"
+    "ceiling\0"
+    "challenged\0"
+    "challenge\0"
+    "challenging\0"
+    "changed\0"
+    "change\0"
+    "changing\0"
+    "chaos\0"
+    "charming\0"
+    "children\0"
+    "child\0"
+    "chose\0"
+    "choose\0"
+    "chosen\0"
+    "clothes\0"
+    "competed\0"
+    "compete\0"
+    "competing\0"
+    "completed\0"
+    "complete\0"
+    "completing\0"
+    "confusing\0"
+    "created\0"
+    "create\0"
+    "creating\0"
+    "crises\0"
+    "crisis\0"
+    "criteria\0"
+    "criterion\0"
+    "dealt\0"
+    "deal\0"
+    "deleted\0"
+    "delete\0"
+    "deleting\0"
+    "did\0"
+    "do\0"
+    "died\0"
+    "die\0"
+    "dies\0"
+    "disagreed\0"
+    "disagree\0"
+    "disappointing\0"
+    "does\0"
+    "doing\0"
+    "done\0"
+    "drank\0"
+    "drink\0"
+    "drawn\0"
+    "draw\0"
+    "dreamt\0"
+    "dream\0"
+    "drew\0"
+    "driven\0"
+    "drive\0"
+    "drove\0"
+    "drunk\0"
+    "dug\0"
+    "dig\0"
+    "during\0"
+    "dying\0"
+    "eaten\0"
+    "economics\0"
+    "elves\0"
+    "elf\0"
+    "embarrassing\0"
+    "ethics\0"
+    "evening\0"
+    "everything\0"
+    "exceed\0"
+    "exchanged\0"
+    "exchange\0"
+    "exchanging\0"
+    "excited\0"
+    "excite\0"
+    "exciting\0"
+    "explored\0"
+    "explore\0"
+    "exploring\0"
+    "fallen\0"
+    "fall\0"
+    "farther\0"
+    "far\0"
+    "farthest\0"
+    "fed\0"
+    "feed\0"
+    "feet\0"
+    "foot\0"
+    "fell\0"
+    "felt\0"
+    "feel\0"
+    "fled\0"
+    "flee\0"
+    "flew\0"
+    "fly\0"
+    "flown\0"
+    "focused\0"
+    "focus\0"
+    "focuses\0"
+    "focusing\0"
+    "focussed\0"
+    "focussing\0"
+    "forgave\0"
+    "forgive\0"
+    "forgiven\0"
+    "forgot\0"
+    "forget\0"
+    "forgotten\0"
+    "fought\0"
+    "fight\0"
+    "found\0"
+    "find\0"
+    "freed\0"
+    "free\0"
+    "frightening\0"
+    "froze\0"
+    "freeze\0"
+    "frozen\0"
+    "further\0"
+    "furthest\0"
+    "gave\0"
+    "give\0"
+    "geese\0"
+    "goose\0"
+    "given\0"
+    "goes\0"
+    "go\0"
+    "going\0"
+    "gone\0"
+    "got\0"
+    "get\0"
+    "gotten\0"
+    "grew\0"
+    "grow\0"
+    "grown\0"
+    "guaranteed\0"
+    "guarantee\0"
+    "had\0"
+    "have\0"
+    "halves\0"
+    "half\0"
+    "has\0"
+    "having\0"
+    "headaches\0"
+    "headache\0"
+    "heard\0"
+    "hear\0"
+    "held\0"
+    "hold\0"
+    "hid\0"
+    "hide\0"
+    "hidden\0"
+    "hundred\0"
+    "hung\0"
+    "hang\0"
+    "ignored\0"
+    "ignore\0"
+    "ignoring\0"
+    "interesting\0"
+    "invited\0"
+    "invite\0"
+    "inviting\0"
+    "is\0"
+    "jeans\0"
+    "kept\0"
+    "keep\0"
+    "kindred\0"
+    "knew\0"
+    "know\0"
+    "knives\0"
+    "knife\0"
+    "known\0"
+    "learnt\0"
+    "learn\0"
+    "leaves\0"
+    "led\0"
+    "lead\0"
+    "left\0"
+    "leave\0"
+    "lens\0"
+    "lent\0"
+    "lend\0"
+    "lied\0"
+    "lie\0"
+    "lies\0"
+    "lit\0"
+    "light\0"
+    "lives\0"
+    "life\0"
+    "loaves\0"
+    "loaf\0"
+    "lost\0"
+    "lose\0"
+    "lying\0"
+    "made\0"
+    "make\0"
+    "mathematics\0"
+    "meant\0"
+    "mean\0"
+    "men\0"
+    "man\0"
+    "met\0"
+    "meet\0"
+    "mice\0"
+    "mouse\0"
+    "mistaken\0"
+    "mistake\0"
+    "mistook\0"
+    "morning\0"
+    "naked\0"
+    "news\0"
+    "nothing\0"
+    "overcame\0"
+    "overcome\0"
+    "overseas\0"
+    "oxen\0"
+    "ox\0"
+    "paid\0"
+    "pay\0"
+    "pants\0"
+    "perhaps\0"
+    "persons\0"
+    "person\0"
+    "persuaded\0"
+    "persuade\0"
+    "persuading\0"
+    "phenomena\0"
+    "phenomenon\0"
+    "physics\0"
+    "politics\0"
+    "proceed\0"
+    "pudding\0"
+    "quizzes\0"
+    "quiz\0"
+    "quoted\0"
+    "quote\0"
+    "quoting\0"
+    "ragged\0"
+    "ran\0"
+    "run\0"
+    "rang\0"
+    "ring\0"
+    "ranged\0"
+    "range\0"
+    "ranging\0"
+    "relaxing\0"
+    "restored\0"
+    "restore\0"
+    "restoring\0"
+    "ridden\0"
+    "ride\0"
+    "risen\0"
+    "rise\0"
+    "rode\0"
+    "rose\0"
+    "rugged\0"
+    "rung\0"
+    "sacred\0"
+    "said\0"
+    "say\0"
+    "sang\0"
+    "sing\0"
+    "sat\0"
+    "sit\0"
+    "saw\0"
+    "see\0"
+    "says\0"
+    "scarves\0"
+    "scarf\0"
+    "scissors\0"
+    "seen\0"
+    "sent\0"
+    "send\0"
+    "series\0"
+    "shaken\0"
+    "shake\0"
+    "shelves\0"
+    "shelf\0"
+    "shoes\0"
+    "shoe\0"
+    "shone\0"
+    "shine\0"
+    "shook\0"
+    "shot\0"
+    "shoot\0"
+    "slept\0"
+    "sleep\0"
+    "slid\0"
+    "slide\0"
+    "sold\0"
+    "sell\0"
+    "something\0"
+    "sometimes\0"
+    "sought\0"
+    "seek\0"
+    "species\0"
+    "spelt\0"
+    "spell\0"
+    "spent\0"
+    "spend\0"
+    "spilt\0"
+    "spill\0"
+    "spoke\0"
+    "speak\0"
+    "spoken\0"
+    "stole\0"
+    "steal\0"
+    "stolen\0"
+    "stood\0"
+    "stand\0"
+    "struck\0"
+    "strike\0"
+    "stuck\0"
+    "stick\0"
+    "succeed\0"
+    "sung\0"
+    "surprising\0"
+    "swam\0"
+    "swim\0"
+    "swum\0"
+    "swung\0"
+    "swing\0"
+    "taken\0"
+    "take\0"
+    "taught\0"
+    "teach\0"
+    "teeth\0"
+    "tooth\0"
+    "theses\0"
+    "thesis\0"
+    "thieves\0"
+    "thief\0"
+    "thought\0"
+    "think\0"
+    "threw\0"
+    "throw\0"
+    "thrown\0"
+    "tied\0"
+    "tie\0"
+    "ties\0"
+    "tiring\0"
+    "toes\0"
+    "toe\0"
+    "told\0"
+    "tell\0"
+    "took\0"
+    "tore\0"
+    "tear\0"
+    "torn\0"
+    "trousers\0"
+    "tying\0"
+    "understood\0"
+    "understand\0"
+    "undertaken\0"
+    "undertake\0"
+    "undertook\0"
+    "united\0"
+    "unite\0"
+    "uniting\0"
+    "used\0"
+    "use\0"
+    "uses\0"
+    "using\0"
+    "was\0"
+    "wedding\0"
+    "went\0"
+    "were\0"
+    "whereas\0"
+    "wicked\0"
+    "willing\0"
+    "withdrawn\0"
+    "withdraw\0"
+    "withdrew\0"
+    "wives\0"
+    "wife\0"
+    "woke\0"
+    "wake\0"
+    "woken\0"
+    "wolves\0"
+    "wolf\0"
+    "women\0"
+    "woman\0"
+    "won\0"
+    "win\0"
+    "wore\0"
+    "wear\0"
+    "worn\0"
+    "worse\0"
+    "bad\0"
+    "worst\0"
+    "written\0"
+    "write\0"
+    "wrote\0"
+    ;
+
+/* {форма, лемма}: смещения в lemma_strings, по возрастанию формы (strcmp). */
+static const uint16_t lemma_pairs[][2] = {
+    {0, 6}, /* ached -> ache */
+    {11, 6}, /* aches -> ache */
+    {17, 6}, /* aching -> ache */
+    {24, 30}, /* added -> add */
+    {34, 30}, /* adding -> add */
+    {41, 48}, /* agreed -> agree */
+    {54, 54}, /* always -> always */
+    {61, 64}, /* am -> be */
+    {67, 67}, /* amazing -> amazing */
+    {75, 84}, /* analyses -> analysis */
+    {93, 93}, /* annoying -> annoying */
+    {102, 102}, /* anything -> anything */
+    {111, 64}, /* are -> be */
+    {115, 122}, /* arisen -> arise */
+    {128, 122}, /* arose -> arise */
+    {134, 143}, /* arranged -> arrange */
+    {151, 143}, /* arranging -> arrange */
+    {161, 165}, /* ate -> eat */
+    {169, 169}, /* athletics -> athletics */
+    {179, 179}, /* atlas -> atlas */
+    {185, 192}, /* beaten -> beat */
+    {197, 204}, /* became -> become */
+    {211, 64}, /* been -> be */
+    {216, 222}, /* began -> begin */
+    {228, 222}, /* begun -> begin */
+    {234, 64}, /* being -> be */
+    {240, 245}, /* bent -> bend */
+    {250, 255}, /* best -> good */
+    {260, 255}, /* better -> good */
+    {267, 267}, /* bias -> bias */
+    {272, 267}, /* biased -> bias */
+    {279, 286}, /* bitten -> bite */
+    {291, 296}, /* bled -> bleed */
+    {302, 307}, /* blew -> blow */
+    {312, 307}, /* blown -> blow */
+    {318, 318}, /* boring -> boring */
+    {325, 330}, /* born -> bear */
+    {335, 330}, /* borne -> bear */
+    {341, 348}, /* bought -> buy */
+    {352, 357}, /* bred -> breed */
+    {363, 369}, /* broke -> break */
+    {375, 369}, /* broken -> break */
+    {382, 390}, /* brought -> bring */
+    {396, 402}, /* built -> build */
+    {408, 414}, /* burnt -> burn */
+    {419, 425}, /* buses -> bus */
+    {429, 436}, /* calves -> calf */
+    {441, 446}, /* came -> come */
+    {451, 451}, /* canvas -> canvas */
+    {458, 465}, /* caught -> catch */
+    {471, 471}, /* ceiling -> ceiling */
+    {479, 490}, /* challenged -> challenge */
+    {500, 490}, /* challenging -> challenge */
+    {512, 520}, /* changed -> change */
+    {527, 520}, /* changing -> change */
+    {536, 536}, /* chaos -> chaos */
+    {542, 542}, /* charming -> charming */
+    {551, 560}, /* children -> child */
+    {566, 572}, /* chose -> choose */
+    {579, 572}, /* chosen -> choose */
+    {586, 586}, /* clothes -> clothes */
+    {594, 603}, /* competed -> compete */
+    {611, 603}, /* competing -> compete */
+    {621, 631}, /* completed -> complete */
+    {640, 631}, /* completing -> complete */
+    {651, 651}, /* confusing -> confusing */
+    {661, 669}, /* created -> create */
+    {676, 669}, /* creating -> create */
+    {685, 692}, /* crises -> crisis */
+    {699, 708}, /* criteria -> criterion */
+    {718, 724}, /* dealt -> deal */
+    {729, 737}, /* deleted -> delete */
+    {744, 737}, /* deleting -> delete */
+    {753, 757}, /* did -> do */
+    {760, 765}, /* died -> die */
+    {769, 765}, /* dies -> die */
+    {774, 784}, /* disagreed -> disagree */
+    {793, 793}, /* disappointing -> disappointing */
+    {807, 757}, /* does -> do */
+    {812, 757}, /* doing -> do */
+    {818, 757}, /* done -> do */
+    {823, 829}, /* drank -> drink */
+    {835, 841}, /* drawn -> draw */
+    {846, 853}, /* dreamt -> dream */
+    {859, 841}, /* drew -> draw */
+    {864, 871}, /* driven -> drive */
+    {877, 871}, /* drove -> drive */
+    {883, 829}, /* drunk -> drink */
+    {889, 893}, /* dug -> dig */
+    {897, 897}, /* during -> during */
+    {904, 765}, /* dying -> die */
+    {910, 165}, /* eaten -> eat */
+    {916, 916}, /* economics -> economics */
+    {926, 932}, /* elves -> elf */
+    {936, 936}, /* embarrassing -> embarrassing */
+    {949, 949}, /* ethics -> ethics */
+    {956, 956}, /* evening -> evening */
+    {964, 964}, /* everything -> everything */
+    {975, 975}, /* exceed -> exceed */
+    {982, 992}, /* exchanged -> exchange */
+    {1001, 992}, /* exchanging -> exchange */
+    {1012, 1020}, /* excited -> excite */
+    {1027, 1027}, /* exciting -> exciting */
+    {1036, 1045}, /* explored -> explore */
+    {1053, 1045}, /* exploring -> explore */
+    {1063, 1070}, /* fallen -> fall */
+    {1075, 1083}, /* farther -> far */
+    {1087, 1083}, /* farthest -> far */
+    {1096, 1100}, /* fed -> feed */
+    {1105, 1110}, /* feet -> foot */
+    {1115, 1070}, /* fell -> fall */
+    {1120, 1125}, /* felt -> feel */
+    {1130, 1135}, /* fled -> flee */
+    {1140, 1145}, /* flew -> fly */
+    {1149, 1145}, /* flown -> fly */
+    {1155, 1163}, /* focused -> focus */
+    {1169, 1163}, /* focuses -> focus */
+    {1177, 1163}, /* focusing -> focus */
+    {1186, 1163}, /* focussed -> focus */
+    {1195, 1163}, /* focussing -> focus */
+    {1205, 1213}, /* forgave -> forgive */
+    {1221, 1213}, /* forgiven -> forgive */
+    {1230, 1237}, /* forgot -> forget */
+    {1244, 1237}, /* forgotten -> forget */
+    {1254, 1261}, /* fought -> fight */
+    {1267, 1273}, /* found -> find */
+    {1278, 1284}, /* freed -> free */
+    {1289, 1289}, /* frightening -> frightening */
+    {1301, 1307}, /* froze -> freeze */
+    {1314, 1307}, /* frozen -> freeze */
+    {1321, 1083}, /* further -> far */
+    {1329, 1083}, /* furthest -> far */
+    {1338, 1343}, /* gave -> give */
+    {1348, 1354}, /* geese -> goose */
+    {1360, 1343}, /* given -> give */
+    {1366, 1371}, /* goes -> go */
+    {1374, 1371}, /* going -> go */
+    {1380, 1371}, /* gone -> go */
+    {1385, 1389}, /* got -> get */
+    {1393, 1389}, /* gotten -> get */
+    {1400, 1405}, /* grew -> grow */
+    {1410, 1405}, /* grown -> grow */
+    {1416, 1427}, /* guaranteed -> guarantee */
+    {1437, 1441}, /* had -> have */
+    {1446, 1453}, /* halves -> half */
+    {1458, 1441}, /* has -> have */
+    {1462, 1441}, /* having -> have */
+    {1469, 1479}, /* headaches -> headache */
+    {1488, 1494}, /* heard -> hear */
+    {1499, 1504}, /* held -> hold */
+    {1509, 1513}, /* hid -> hide */
+    {1518, 1513}, /* hidden -> hide */
+    {1525, 1525}, /* hundred -> hundred */
+    {1533, 1538}, /* hung -> hang */
+    {1543, 1551}, /* ignored -> ignore */
+    {1558, 1551}, /* ignoring -> ignore */
+    {1567, 1567}, /* interesting -> interesting */
+    {1579, 1587}, /* invited -> invite */
+    {1594, 1587}, /* inviting -> invite */
+    {1603, 64}, /* is -> be */
+    {1606, 1606}, /* jeans -> jeans */
+    {1612, 1617}, /* kept -> keep */
+    {1622, 1622}, /* kindred -> kindred */
+    {1630, 1635}, /* knew -> know */
+    {1640, 1647}, /* knives -> knife */
+    {1653, 1635}, /* known -> know */
+    {1659, 1666}, /* learnt -> learn */
+    {1672, 1672}, /* leaves -> leaves */
+    {1679, 1683}, /* led -> lead */
+    {1688, 1693}, /* left -> leave */
+    {1699, 1699}, /* lens -> lens */
+    {1704, 1709}, /* lent -> lend */
+    {1714, 1719}, /* lied -> lie */
+    {1723, 1719}, /* lies -> lie */
+    {1728, 1732}, /* lit -> light */
+    {1738, 1744}, /* lives -> life */
+    {1749, 1756}, /* loaves -> loaf */
+    {1761, 1766}, /* lost -> lose */
+    {1771, 1719}, /* lying -> lie */
+    {1777, 1782}, /* made -> make */
+    {1787, 1787}, /* mathematics -> mathematics */
+    {1799, 1805}, /* meant -> mean */
+    {1810, 1814}, /* men -> man */
+    {1818, 1822}, /* met -> meet */
+    {1827, 1832}, /* mice -> mouse */
+    {1838, 1847}, /* mistaken -> mistake */
+    {1855, 1847}, /* mistook -> mistake */
+    {1863, 1863}, /* morning -> morning */
+    {1871, 1871}, /* naked -> naked */
+    {1877, 1877}, /* news -> news */
+    {1882, 1882}, /* nothing -> nothing */
+    {1890, 1899}, /* overcame -> overcome */
+    {1908, 1908}, /* overseas -> overseas */
+    {1917, 1922}, /* oxen -> ox */
+    {1925, 1930}, /* paid -> pay */
+    {1934, 1934}, /* pants -> pants */
+    {1940, 1940}, /* perhaps -> perhaps */
+    {1948, 1956}, /* persons -> person */
+    {1963, 1973}, /* persuaded -> persuade */
+    {1982, 1973}, /* persuading -> persuade */
+    {1993, 2003}, /* phenomena -> phenomenon */
+    {2014, 2014}, /* physics -> physics */
+    {2022, 2022}, /* politics -> politics */
+    {2031, 2031}, /* proceed -> proceed */
+    {2039, 2039}, /* pudding -> pudding */
+    {2047, 2055}, /* quizzes -> quiz */
+    {2060, 2067}, /* quoted -> quote */
+    {2073, 2067}, /* quoting -> quote */
+    {2081, 2081}, /* ragged -> ragged */
+    {2088, 2092}, /* ran -> run */
+    {2096, 2101}, /* rang -> ring */
+    {2106, 2113}, /* ranged -> range */
+    {2119, 2113}, /* ranging -> range */
+    {2127, 2127}, /* relaxing -> relaxing */
+    {2136, 2145}, /* restored -> restore */
+    {2153, 2145}, /* restoring -> restore */
+    {2163, 2170}, /* ridden -> ride */
+    {2175, 2181}, /* risen -> rise */
+    {2186, 2170}, /* rode -> ride */
+    {2191, 2181}, /* rose -> rise */
+    {2196, 2196}, /* rugged -> rugged */
+    {2203, 2101}, /* rung -> ring */
+    {2208, 2208}, /* sacred -> sacred */
+    {2215, 2220}, /* said -> say */
+    {2224, 2229}, /* sang -> sing */
+    {2234, 2238}, /* sat -> sit */
+    {2242, 2246}, /* saw -> see */
+    {2250, 2220}, /* says -> say */
+    {2255, 2263}, /* scarves -> scarf */
+    {2269, 2269}, /* scissors -> scissors */
+    {2278, 2246}, /* seen -> see */
+    {2283, 2288}, /* sent -> send */
+    {2293, 2293}, /* series -> series */
+    {2300, 2307}, /* shaken -> shake */
+    {2313, 2321}, /* shelves -> shelf */
+    {2327, 2333}, /* shoes -> shoe */
+    {2338, 2344}, /* shone -> shine */
+    {2350, 2307}, /* shook -> shake */
+    {2356, 2361}, /* shot -> shoot */
+    {2367, 2373}, /* slept -> sleep */
+    {2379, 2384}, /* slid -> slide */
+    {2390, 2395}, /* sold -> sell */
+    {2400, 2400}, /* something -> something */
+    {2410, 2410}, /* sometimes -> sometimes */
+    {2420, 2427}, /* sought -> seek */
+    {2432, 2432}, /* species -> species */
+    {2440, 2446}, /* spelt -> spell */
+    {2452, 2458}, /* spent -> spend */
+    {2464, 2470}, /* spilt -> spill */
+    {2476, 2482}, /* spoke -> speak */
+    {2488, 2482}, /* spoken -> speak */
+    {2495, 2501}, /* stole -> steal */
+    {2507, 2501}, /* stolen -> steal */
+    {2514, 2520}, /* stood -> stand */
+    {2526, 2533}, /* struck -> strike */
+    {2540, 2546}, /* stuck -> stick */
+    {2552, 2552}, /* succeed -> succeed */
+    {2560, 2229}, /* sung -> sing */
+    {2565, 2565}, /* surprising -> surprising */
+    {2576, 2581}, /* swam -> swim */
+    {2586, 2581}, /* swum -> swim */
+    {2591, 2597}, /* swung -> swing */
+    {2603, 2609}, /* taken -> take */
+    {2614, 2621}, /* taught -> teach */
+    {2627, 2633}, /* teeth -> tooth */
+    {2639, 2646}, /* theses -> thesis */
+    {2653, 2661}, /* thieves -> thief */
+    {2667, 2675}, /* thought -> think */
+    {2681, 2687}, /* threw -> throw */
+    {2693, 2687}, /* thrown -> throw */
+    {2700, 2705}, /* tied -> tie */
+    {2709, 2705}, /* ties -> tie */
+    {2714, 2714}, /* tiring -> tiring */
+    {2721, 2726}, /* toes -> toe */
+    {2730, 2735}, /* told -> tell */
+    {2740, 2609}, /* took -> take */
+    {2745, 2750}, /* tore -> tear */
+    {2755, 2750}, /* torn -> tear */
+    {2760, 2760}, /* trousers -> trousers */
+    {2769, 2705}, /* tying -> tie */
+    {2775, 2786}, /* understood -> understand */
+    {2797, 2808}, /* undertaken -> undertake */
+    {2818, 2808}, /* undertook -> undertake */
+    {2828, 2835}, /* united -> unite */
+    {2841, 2835}, /* uniting -> unite */
+    {2849, 2854}, /* used -> use */
+    {2858, 2854}, /* uses -> use */
+    {2863, 2854}, /* using -> use */
+    {2869, 64}, /* was -> be */
+    {2873, 2873}, /* wedding -> wedding */
+    {2881, 1371}, /* went -> go */
+    {2886, 64}, /* were -> be */
+    {2891, 2891}, /* whereas -> whereas */
+    {2899, 2899}, /* wicked -> wicked */
+    {2906, 2906}, /* willing -> willing */
+    {2914, 2924}, /* withdrawn -> withdraw */
+    {2933, 2924}, /* withdrew -> withdraw */
+    {2942, 2948}, /* wives -> wife */
+    {2953, 2958}, /* woke -> wake */
+    {2963, 2958}, /* woken -> wake */
+    {2969, 2976}, /* wolves -> wolf */
+    {2981, 2987}, /* women -> woman */
+    {2993, 2997}, /* won -> win */
+    {3001, 3006}, /* wore -> wear */
+    {3011, 3006}, /* worn -> wear */
+    {3016, 3022}, /* worse -> bad */
+    {3026, 3022}, /* worst -> bad */
+    {3032, 3040}, /* written -> write */
+    {3046, 3040}, /* wrote -> write */
+};
+
+#endif
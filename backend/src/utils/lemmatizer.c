@@ -0,0 +1,215 @@
+#include "utils/lemmatizer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/lemma_tables.h"
+#include "utils/word_rank.h"
+
+#define LEMMATIZER_MAX_WORD 64
+
+static int lemma_pair_cmp(const void *key, const void *item)
+{
+    const uint16_t *pair = item;
+
+    return strcmp((const char *) key, lemma_strings + pair[0]);
+}
+
+static const char *lemma_lookup(const char *word)
+{
+    const uint16_t *pair = bsearch(word, lemma_pairs, sizeof(lemma_pairs) / sizeof(lemma_pairs[0]),
+                                   sizeof(lemma_pairs[0]), lemma_pair_cmp);
+
+    return pair ? lemma_strings + pair[1] : NULL;
+}
+
+/* Согласная в позиции i; "y" после согласной — гласная, "u" после "q" — нет. */
+static int lemma_is_consonant(const char *s, size_t i)
+{
+    switch (s[i]) {
+    case 'a':
+    case 'e':
+    case 'i':
+    case 'o':
+        return 0;
+    case 'u':
+        return i > 0 && s[i - 1] == 'q';
+    case 'y':
+        return i == 0 ? 1 : !lemma_is_consonant(s, i - 1);
+    default:
+        return 1;
+    }
+}
+
+/* Число пар "гласные-согласные" в s[0, n) — мера длины основы по Портеру. */
+static int lemma_measure(const char *s, size_t n)
+{
+    int m = 0;
+    size_t i = 0;
+
+    while (i < n && lemma_is_consonant(s, i)) {
+        i++;
+    }
+    while (i < n) {
+        while (i < n && !lemma_is_consonant(s, i)) {
+            i++;
+        }
+        if (i == n) {
+            break;
+        }
+        m++;
+        while (i < n && lemma_is_consonant(s, i)) {
+            i++;
+        }
+    }
+    return m;
+}
+
+static int lemma_has_vowel(const char *s, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (!lemma_is_consonant(s, i)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Основа кончается на согласная-гласная-согласная, последняя не w/x/y ("hop", "mak"). */
+static int lemma_is_cvc(const char *s, size_t n)
+{
+    return n >= 3 && lemma_is_consonant(s, n - 3) && !lemma_is_consonant(s, n - 2) &&
+           lemma_is_consonant(s, n - 1) && !strchr("wxy", s[n - 1]);
+}
+
+/* Согласная, гласная из vowels и последняя буква основы: "decid", "translat". */
+static int lemma_ends_cv(const char *s, size_t n, const char *vowels)
+{
+    return n >= 3 && lemma_is_consonant(s, n - 3) && strchr(vowels, s[n - 2]) != NULL;
+}
+
+/*
+ * Основа после отсечения -ed/-ing: "running" -> "runn" -> "run",
+ * "making" -> "mak" -> "make". Немая "e" восстанавливается только там,
+ * где английские основы без неё почти не встречаются; спорные случаи
+ * (change/belong, complete/target) решает таблица.
+ */
+static size_t lemma_restore_stem(char *s, size_t n)
+{
+    char last = s[n - 1];
+
+    if (n >= 2 && s[n - 2] == last && lemma_is_consonant(s, n - 1)) {
+        if ((last == 'l' && lemma_measure(s, n - 1) > 1) || !strchr("lsz", last)) {
+            n--;
+        }
+        return n;
+    }
+
+    if (last == 'v' || last == 'c' || last == 'z' || last == 's' || last == 'u' ||
+        (last == 'g' && strchr("dlr", s[n - 2])) ||
+        (last == 'g' && lemma_ends_cv(s, n, "a")) ||
+        (last == 'l' && lemma_is_consonant(s, n - 2) && !strchr("lrw", s[n - 2])) ||
+        (last == 'l' && lemma_ends_cv(s, n, "iou")) ||
+        (last == 'r' && lemma_ends_cv(s, n, "aiu")) ||
+        (last == 'n' && lemma_ends_cv(s, n, "i")) ||
+        (last == 'm' && lemma_ends_cv(s, n, "ou")) ||
+        (last == 'd' && lemma_ends_cv(s, n, "iou")) ||
+        (last == 't' && lemma_ends_cv(s, n, "aou")) ||
+        (last == 'k' && lemma_ends_cv(s, n, "o")) ||
+        (last == 'p' && lemma_ends_cv(s, n, "a")) ||
+        (lemma_is_cvc(s, n) && lemma_measure(s, n) == 1)) {
+        s[n++] = 'e';
+    }
+    return n;
+}
+
+static int lemma_ends_with(const char *s, size_t n, const char *suffix)
+{
+    size_t len = strlen(suffix);
+
+    return n >= len && memcmp(s + n - len, suffix, len) == 0;
+}
+
+/* Правила для слова s длины n; s с запасом места под восстановленную букву. */
+static size_t lemma_apply_rules(char *s, size_t n)
+{
+    if (lemma_ends_with(s, n, "ies")) {
+        if (n > 4) {
+            s[n - 3] = 'y';
+            return n - 2;
+        }
+        return n - 1;
+    }
+    if (lemma_ends_with(s, n, "sses") || lemma_ends_with(s, n, "shes") || lemma_ends_with(s, n, "ches") ||
+        lemma_ends_with(s, n, "xes") || lemma_ends_with(s, n, "zzes") ||
+        (lemma_ends_with(s, n, "oes") && n > 4)) {
+        return n - 2;
+    }
+    if (lemma_ends_with(s, n, "s")) {
+        /* "-as" у существительных обычно часть основы ("atlas", "canvas"),
+           а не окончание; исключение — "ideas", "areas". */
+        if (n >= 4 && !lemma_ends_with(s, n, "ss") && !lemma_ends_with(s, n, "us") &&
+            !lemma_ends_with(s, n, "is") &&
+            (!lemma_ends_with(s, n, "as") || lemma_ends_with(s, n, "eas"))) {
+            return n - 1;
+        }
+        return n;
+    }
+
+    if (lemma_ends_with(s, n, "ied")) {
+        if (n > 4) {
+            s[n - 3] = 'y';
+            return n - 2;
+        }
+        return n;
+    }
+    if (lemma_ends_with(s, n, "eed")) {
+        return n;
+    }
+    if (lemma_ends_with(s, n, "ed") && n - 2 >= 3 && lemma_has_vowel(s, n - 2)) {
+        return lemma_restore_stem(s, n - 2);
+    }
+    if (lemma_ends_with(s, n, "ing") && n - 3 >= 3 && lemma_has_vowel(s, n - 3)) {
+        return lemma_restore_stem(s, n - 3);
+    }
+    return n;
+}
+
+size_t lemmatize(const char *word, char *out, size_t out_size)
+{
+    char stem[LEMMATIZER_MAX_WORD + 2];
+    const char *lemma;
+    size_t len;
+    size_t i;
+
+    /* Сокращения, составные слова ("well-known") и не-ASCII не трогаем. */
+    len = strlen(word);
+    for (i = 0; i < len; i++) {
+        unsigned char c = (unsigned char) word[i];
+        if (c >= 0x80 || c == '\'' || c == '-') {
+            len = 0;
+            break;
+        }
+    }
+    if (len < 3 || len > LEMMATIZER_MAX_WORD) {
+        return (size_t) snprintf(out, out_size, "%s", word);
+    }
+
+    lemma = lemma_lookup(word);
+    if (!lemma) {
+        memcpy(stem, word, len);
+        len = lemma_apply_rules(stem, len);
+        stem[len] = '\0';
+        lemma = stem;
+        /*
+         * Правила угадывают и несуществующие основы ("pudding" -> "pud").
+         * Со словарём рангов результат правил берётся, только если это
+         * известная в нём лемма.
+         */
+        if (word_rank_count() > 0 && word_rank(stem) == 0) {
+            lemma = word;
+        }
+    }
+    return (size_t) snprintf(out, out_size, "%s", lemma);
+}
@@ -0,0 +1,22 @@
+#ifndef UTILS_LEMMATIZER_H
+#define UTILS_LEMMATIZER_H
+
+#include <stddef.h>
+
+/*
+ * Начальная форма английского слова ("running" -> "run", "ran" -> "run",
+ * "cities" -> "city"). Слово — как его отдаёт токенизатор: в нижнем
+ * регистре. Неправильные формы берутся из сгенерированной таблицы,
+ * остальное — правила отсечения -s/-es/-ed/-ing с восстановлением
+ * удвоенной согласной и немой "e". Если загружен словарь рангов
+ * (word_rank_open), результат правил принимается только для известной
+ * в нём леммы, иначе слово остаётся как есть. Слова с апострофом,
+ * дефисом и не-ASCII возвращаются как есть.
+ *
+ * Пишет лемму в out как snprintf: возвращает её длину; если она >=
+ * out_size, результат обрезан. Из глобального состояния читает только
+ * словарь рангов.
+ */
+size_t lemmatize(const char *word, char *out, size_t out_size);
+
+#endif
@@ -0,0 +1,292 @@
+/* Сгенерировано tools/stopwords/gen_stopword_table.py из tools/stopwords/stopwords.txt. Не править вручную. */
+#ifndef UTILS_STOPWORD_TABLE_H
+#define UTILS_STOPWORD_TABLE_H
+
+#include <stdint.h>
+
+#define STOPWORD_COUNT 797
+#define STOPWORD_MAX_LEVEL 2
+
+/* Сдвиг корзины: > 0 — затравка второго хеша, < 0 — слот -d - 1. */
+static const int32_t stopword_displace[STOPWORD_COUNT] = {
+    -797, -796, 0, 0, 0, 0, 1, -793, -787, 1, 0, 2,
+    -783, 0, 1, -781, 0, 0, 1, 1, 1, -780, 0, 1,
+    1, 0, 3, -774, 1, 0, 0, -773, 0, 0, 0, 0,
+    0, 1, 0, 2, 1, 0, 0, -767, -763, 0, 1, 0,
+    0, 0, 0, 0, 1, 1, 0, 0, -762, -760, 1, -758,
+    -756, 0, 0, -754, -750, 0, -747, -746, -741, -737, -731, 2,
+    1, 0, -728, 2, -725, 0, 2, 6, -722, 0, 0, -716,
+    2, 0, 1, 2, 1, 1, 0, 10, 0, -713, -712, -711,
+    -710, 1, 0, 5, -709, 2, -705, 0, -694, 0, 1, 0,
+    0, 0, 1, -692, 0, 0, 0, -686, -684, 1, -679, -674,
+    0, 0, -670, 2, -667, -666, 1, -665, 0, -658, 0, -656,
+    1, -654, 0, 0, -651, 0, -650, 0, -649, -648, -646, -644,
+    1, 1, -643, 0, -642, 1, 0, -641, 1, 0, 0, -637,
+    0, 2, 0, 0, 0, 1, -634, 2, 2, 0, -632, 0,
+    -631, -628, 0, 0, 0, 2, -625, -624, 0, -623, 3, 0,
+    2, 0, -619, -618, 0, -614, 0, -613, 0, 1, 0, 0,
+    -608, 1, 0, 1, 2, -606, -601, -599, -598, 2, -596, 2,
+    0, 0, -594, 0, 2, -593, -591, 0, -590, 0, -587, 0,
+    1, -585, -581, -578, 0, 0, -576, 0, 0, 1, 0, 0,
+    -574, -572, 0, -569, 1, 0, 0, 0, -567, 2, -566, 4,
+    -564, 2, 3, -563, -561, 0, -560, 0, 0, -558, 0, 0,
+    0, -554, 0, -553, 0, -552, -540, 0, 1, 2, -536, -534,
+    1, -533, -531, -521, -511, -509, 7, -504, 0, 0, -503, 0,
+    -502, -499, 0, 0, 5, -497, -496, 0, 0, 5, 2, 2,
+    -492, 0, -487, 0, -486, 2, -484, 3, -480, 0, 0, 0,
+    0, 1, 1, 7, 3, -470, -469, -468, -464, -463, -460, 1,
+    -459, 3, 0, 0, 0, -458, 4, -453, -452, 7, 0, -450,
+    0, -443, 1, 0, 0, 7, -442, 2, 1, -439, 4, 0,
+    2, -435, -429, 0, -428, -427, -426, 3, 3, 0, 0, 1,
+    0, 0, 10, 0, 0, 4, 1, -423, 1, 0, -422, -421,
+    0, 8, 0, 0, 5, -420, 0, -415, -414, 2, 0, -413,
+    0, -409, 4, 7, 1, -408, 5, 0, -406, -405, 0, 0,
+    -404, 14, 1, 1, 4, 3, -398, 0, 0, 6, -397, -395,
+    7, -393, -392, 2, -391, 0, -388, 0, -385, 0, 2, 2,
+    0, -381, -379, -376, 0, 0, 0, -374, -366, 0, 4, -361,
+    0, -360, 3, 0, 5, -352, 0, 3, 3, 1, -350, 2,
+    -349, -348, 5, -345, 0, -341, 0, 1, 0, 2, 1, 1,
+    0, 0, 0, 1, -337, -328, -327, 3, -320, -314, 4, -312,
+    1, 0, -307, 0, 9, -306, -302, 0, 0, 0, 0, 0,
+    0, -293, -290, 0, 5, 0, 2, -286, 0, 0, 1, -280,
+    0, 4, 1, -276, -272, 0, 0, 1, 0, -267, 6, 0,
+    -266, 7, -264, 0, 0, 0, 1, 0, -259, 0, 0, 0,
+    -258, -257, 6, -255, 0, 0, -254, 6, 0, 4, -250, 3,
+    3, 0, 1, 6, -246, -235, -233, 0, 0, 1, -228, 0,
+    0, 0, 0, 6, 1, 1, 0, 5, -227, -226, 0, -223,
+    1, 1, 4, -207, 0, -203, -202, -199, 0, -195, 1, -194,
+    0, 3, -192, 5, 0, 0, 6, -191, 0, 0, 0, -190,
+    12, 0, 0, 0, -188, 2, 0, 1, 0, 1, 0, 0,
+    -183, -182, 1, 1, -181, 0, 0, 4, 0, 0, -177, 10,
+    5, -176, -173, -172, 6, 0, 0, 0, -170, 0, -167, 0,
+    0, 5, -164, 0, 0, 0, 2, 3, 1, 1, 3, -161,
+    3, -159, 0, -157, -155, 0, 0, -154, 0, 0, 1, 0,
+    0, 1, -153, 0, 0, 0, 0, 0, 1, -152, -146, -145,
+    0, 0, 0, -144, 3, 3, -143, -141, 4, 0, -140, 6,
+    8, 0, 1, -136, -133, 8, 0, 0, -132, 1, 5, 0,
+    4, 3, 9, 0, 0, 0, -130, 0, 8, 0, -129, 0,
+    -117, 0, -115, 0, 8, -114, 0, -109, -105, 0, -104, 6,
+    1, 0, 17, 0, 6, -102, -101, 0, 0, 0, -94, 9,
+    13, -90, -87, -84, 1, 2, -80, -78, 0, -71, -69, 0,
+    -67, 0, -66, 0, 0, 0, 3, 0, -64, 0, 0, 0,
+    0, 3, 0, 0, 2, 11, 0, 0, 0, -60, -59, 1,
+    0, -58, -57, -51, 0, 1, 0, 0, -49, 0, 6, 0,
+    1, 1, 0, -46, -43, 9, 2, -42, -41, 0, -39, -37,
+    0, 1, 0, 0, -32, 8, -31, 0, -28, 3, 0, -23,
+    8, 2, -17, 0, 3, 0, 0, -16, 0, 3, 0, -12,
+    -11, -9, 4, 0, 4, -4, 1, 6, 0, -3, 3, 0,
+    0, 0, -2, 0, 1,
+};
+
+static const uint8_t stopword_levels[STOPWORD_COUNT] = {
+    1, 1, 2, 1, 0, 1, 1, 1, 2, 0, 0, 2, 1, 0, 1, 0, 0, 1, 0, 0, 1, 0, 2, 2,
+    2, 2, 1, 2, 1, 2, 0, 1, 1, 1, 2, 1, 0, 2, 1, 1, 1, 1, 0, 0, 0, 2, 0, 0,
+    0, 2, 0, 0, 2, 0, 2, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 1, 2, 1, 0, 1, 0, 0,
+    1, 0, 1, 1, 1, 2, 2, 1, 2, 1, 1, 0, 1, 2, 0, 1, 1, 1, 2, 1, 1, 0, 2, 1,
+    1, 1, 2, 2, 0, 2, 2, 0, 1, 0, 0, 1, 1, 1, 2, 1, 0, 1, 1, 0, 0, 2, 0, 1,
+    1, 0, 1, 2, 1, 0, 2, 1, 0, 2, 2, 1, 1, 1, 1, 1, 2, 1, 1, 0, 2, 0, 2, 0,
+    0, 2, 1, 0, 0, 2, 1, 2, 1, 0, 0, 2, 2, 0, 0, 2, 1, 0, 0, 1, 2, 1, 2, 0,
+    0, 1, 1, 0, 1, 0, 1, 0, 0, 1, 0, 1, 0, 1, 2, 0, 0, 1, 2, 1, 2, 0, 1, 2,
+    1, 2, 0, 0, 1, 2, 2, 2, 0, 1, 0, 2, 2, 2, 1, 2, 1, 2, 2, 1, 2, 1, 1, 0,
+    0, 2, 1, 1, 2, 0, 0, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 0, 2, 2, 1, 1, 2, 1,
+    0, 0, 1, 0, 0, 2, 0, 0, 0, 2, 2, 0, 0, 1, 0, 1, 1, 2, 1, 1, 0, 1, 0, 0,
+    1, 2, 1, 2, 2, 0, 1, 0, 1, 1, 0, 2, 0, 1, 2, 1, 1, 2, 2, 1, 2, 2, 1, 0,
+    1, 1, 1, 1, 2, 1, 2, 1, 2, 1, 2, 1, 0, 2, 0, 1, 0, 0, 1, 1, 1, 0, 0, 2,
+    1, 0, 2, 1, 0, 0, 2, 2, 1, 1, 0, 0, 2, 1, 2, 0, 0, 2, 1, 2, 1, 1, 1, 1,
+    2, 1, 2, 1, 1, 1, 1, 2, 1, 1, 1, 0, 1, 1, 2, 2, 0, 1, 0, 0, 2, 2, 1, 0,
+    2, 2, 1, 0, 0, 2, 2, 0, 0, 2, 1, 2, 2, 0, 0, 2, 1, 2, 2, 1, 2, 2, 2, 1,
+    1, 0, 1, 1, 2, 1, 0, 1, 0, 0, 0, 2, 2, 1, 2, 0, 0, 0, 1, 1, 0, 1, 1, 2,
+    2, 0, 0, 1, 2, 2, 0, 2, 1, 0, 0, 0, 0, 1, 2, 2, 2, 1, 2, 0, 1, 2, 0, 2,
+    1, 1, 2, 2, 1, 0, 1, 2, 0, 1, 1, 1, 1, 0, 1, 1, 2, 1, 0, 2, 0, 1, 1, 2,
+    0, 0, 1, 2, 1, 2, 2, 0, 0, 0, 2, 2, 1, 1, 0, 1, 1, 1, 0, 1, 2, 1, 2, 0,
+    2, 2, 1, 0, 1, 0, 2, 2, 2, 1, 0, 2, 2, 0, 2, 1, 0, 0, 0, 1, 2, 1, 0, 1,
+    0, 1, 1, 2, 2, 1, 2, 0, 2, 1, 0, 1, 2, 2, 1, 0, 2, 0, 2, 0, 1, 1, 1, 1,
+    2, 0, 1, 1, 0, 2, 2, 0, 2, 0, 1, 0, 0, 1, 1, 1, 0, 2, 0, 0, 1, 1, 1, 1,
+    1, 0, 1, 1, 1, 0, 1, 0, 2, 0, 0, 2, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 0, 2,
+    2, 2, 2, 1, 1, 2, 0, 1, 1, 0, 2, 1, 1, 1, 0, 1, 1, 2, 1, 0, 1, 2, 2, 2,
+    0, 2, 1, 0, 0, 0, 1, 2, 2, 1, 0, 2, 1, 0, 1, 1, 2, 0, 2, 1, 2, 2, 2, 1,
+    1, 2, 0, 2, 0, 2, 2, 1, 2, 2, 0, 1, 2, 2, 2, 2, 0, 1, 1, 1, 0, 0, 1, 2,
+    2, 1, 2, 1, 2, 0, 1, 0, 1, 1, 1, 2, 0, 1, 1, 0, 1, 1, 1, 1, 2, 2, 1, 1,
+    0, 2, 1, 2, 0, 2, 1, 2, 1, 1, 0, 2, 1, 2, 1, 2, 2, 1, 0, 0, 1, 2, 1, 2,
+    0, 1, 1, 2, 2, 1, 0, 1, 0, 1, 2, 1, 0, 2, 1, 1, 1, 2, 2, 0, 0, 2, 2, 2,
+    2, 0, 2, 1, 2, 2, 1, 0, 1, 1, 0, 1, 2, 0, 2, 1, 0, 1, 1, 1, 0, 0, 0, 1,
+    0, 2, 2, 1, 2, 2, 1, 2, 2, 1, 2, 1, 1, 0, 1, 0, 1, 1, 0, 0, 1, 1, 2, 0,
+    1, 1, 2, 1, 1, 1, 1, 2, 1, 0, 2, 0, 2, 0, 2, 0, 1, 2, 1, 0, 1, 0, 0, 0,
+    1, 2, 1, 1, 2,
+};
+
+static const uint16_t stopword_offsets[STOPWORD_COUNT] = {
+    0, 5, 11, 19, 23, 30, 39, 44, 49, 56, 61, 66,
+    74, 81, 86, 92, 97, 103, 107, 116, 127, 132, 140, 145,
+    152, 159, 169, 174, 182, 187, 192, 201, 206, 212, 219, 223,
+    230, 233, 239, 247, 252, 262, 267, 272, 280, 285, 291, 298,
+    303, 307, 313, 320, 331, 338, 345, 352, 359, 365, 371, 377,
+    382, 392, 397, 403, 407, 413, 421, 429, 433, 438, 443, 446,
+    453, 460, 468, 473, 478, 483, 489, 494, 499, 507, 512, 517,
+    522, 527, 533, 539, 543, 549, 553, 562, 566, 573, 580, 589,
+    594, 601, 605, 612, 617, 622, 630, 636, 642, 652, 660, 665,
+    669, 676, 683, 691, 696, 699, 705, 710, 714, 721, 730, 735,
+    741, 745, 751, 756, 761, 769, 773, 781, 786, 791, 800, 806,
+    811, 815, 822, 826, 830, 839, 848, 853, 860, 866, 873, 880,
+    890, 900, 906, 911, 919, 925, 933, 940, 945, 950, 953, 957,
+    965, 969, 976, 980, 988, 993, 1001, 1006, 1011, 1017, 1022, 1028,
+    1034, 1039, 1045, 1054, 1065, 1070, 1075, 1080, 1084, 1088, 1093, 1097,
+    1101, 1108, 1113, 1120, 1123, 1130, 1137, 1147, 1154, 1160, 1164, 1170,
+    1176, 1184, 1191, 1197, 1203, 1209, 1214, 1224, 1232, 1235, 1241, 1249,
+    1257, 1263, 1270, 1274, 1283, 1287, 1294, 1299, 1303, 1311, 1319, 1324,
+    1329, 1334, 1344, 1349, 1357, 1362, 1372, 1376, 1386, 1394, 1399, 1405,
+    1409, 1416, 1425, 1430, 1434, 1441, 1445, 1452, 1461, 1468, 1474, 1480,
+    1490, 1496, 1504, 1508, 1511, 1515, 1521, 1529, 1534, 1537, 1549, 1558,
+    1564, 1570, 1576, 1587, 1594, 1602, 1609, 1614, 1619, 1626, 1630, 1634,
+    1638, 1644, 1649, 1655, 1662, 1669, 1673, 1677, 1683, 1687, 1692, 1696,
+    1701, 1706, 1712, 1717, 1720, 1725, 1733, 1740, 1746, 1752, 1758, 1762,
+    1766, 1771, 1775, 1781, 1786, 1793, 1801, 1808, 1811, 1817, 1825, 1831,
+    1836, 1840, 1847, 1855, 1860, 1868, 1875, 1882, 1887, 1893, 1898, 1901,
+    1908, 1916, 1923, 1929, 1936, 1940, 1946, 1951, 1959, 1964, 1973, 1978,
+    1985, 1993, 1997, 2004, 2008, 2013, 2022, 2028, 2033, 2038, 2043, 2052,
+    2059, 2064, 2070, 2079, 2084, 2090, 2094, 2099, 2108, 2113, 2117, 2124,
+    2129, 2136, 2141, 2145, 2152, 2158, 2164, 2170, 2178, 2185, 2194, 2199,
+    2203, 2210, 2219, 2226, 2230, 2233, 2239, 2246, 2250, 2256, 2267, 2275,
+    2280, 2285, 2291, 2301, 2305, 2310, 2315, 2325, 2329, 2333, 2338, 2344,
+    2351, 2355, 2363, 2367, 2372, 2381, 2387, 2394, 2398, 2403, 2409, 2412,
+    2419, 2427, 2432, 2440, 2447, 2454, 2462, 2466, 2471, 2478, 2486, 2492,
+    2497, 2505, 2509, 2518, 2525, 2535, 2540, 2546, 2553, 2558, 2564, 2570,
+    2577, 2583, 2590, 2595, 2601, 2607, 2613, 2623, 2631, 2637, 2649, 2653,
+    2660, 2665, 2672, 2679, 2684, 2691, 2697, 2706, 2712, 2715, 2722, 2726,
+    2733, 2738, 2744, 2750, 2757, 2764, 2772, 2776, 2781, 2785, 2791, 2796,
+    2802, 2808, 2814, 2818, 2824, 2833, 2841, 2849, 2851, 2859, 2867, 2874,
+    2879, 2885, 2889, 2894, 2899, 2904, 2909, 2914, 2920, 2926, 2931, 2936,
+    2941, 2947, 2952, 2960, 2965, 2976, 2985, 2990, 2999, 3006, 3012, 3018,
+    3025, 3030, 3035, 3039, 3043, 3050, 3054, 3062, 3066, 3070, 3079, 3087,
+    3094, 3096, 3101, 3108, 3118, 3125, 3130, 3135, 3140, 3147, 3155, 3161,
+    3167, 3176, 3182, 3186, 3192, 3199, 3202, 3209, 3212, 3217, 3226, 3232,
+    3240, 3247, 3252, 3259, 3264, 3268, 3273, 3282, 3287, 3293, 3296, 3303,
+    3308, 3313, 3319, 3324, 3328, 3334, 3339, 3345, 3348, 3353, 3358, 3363,
+    3367, 3372, 3375, 3379, 3385, 3391, 3402, 3408, 3412, 3417, 3421, 3426,
+    3432, 3442, 3448, 3453, 3458, 3462, 3470, 3475, 3481, 3484, 3489, 3493,
+    3503, 3509, 3515, 3521, 3526, 3531, 3537, 3544, 3549, 3553, 3559, 3564,
+    3569, 3574, 3579, 3587, 3595, 3601, 3607, 3613, 3621, 3627, 3633, 3641,
+    3646, 3654, 3659, 3664, 3671, 3676, 3681, 3687, 3694, 3699, 3706, 3715,
+    3721, 3731, 3739, 3744, 3753, 3758, 3763, 3770, 3775, 3781, 3787, 3792,
+    3797, 3802, 3808, 3815, 3822, 3827, 3831, 3839, 3843, 3851, 3858, 3865,
+    3870, 3875, 3881, 3889, 3896, 3901, 3910, 3916, 3921, 3928, 3934, 3940,
+    3945, 3952, 3957, 3962, 3968, 3976, 3982, 3987, 3993, 3998, 4003, 4009,
+    4015, 4020, 4026, 4030, 4039, 4045, 4052, 4058, 4062, 4069, 4076, 4081,
+    4086, 4089, 4095, 4100, 4106, 4112, 4117, 4123, 4132, 4138, 4143, 4148,
+    4153, 4158, 4164, 4168, 4180, 4187, 4195, 4199, 4204, 4210, 4217, 4221,
+    4226, 4235, 4239, 4243, 4248, 4256, 4261, 4266, 4272, 4279, 4285, 4292,
+    4302, 4305, 4314, 4320, 4326, 4332, 4337, 4343, 4350, 4357, 4363, 4367,
+    4374, 4379, 4387, 4394, 4400, 4408, 4414, 4423, 4430, 4436, 4442, 4450,
+    4457, 4464, 4469, 4475, 4480, 4484, 4489, 4495, 4499, 4506, 4512, 4520,
+    4525, 4528, 4533, 4542, 4547, 4554, 4562, 4567, 4574, 4579, 4583, 4588,
+    4593, 4597, 4604, 4613, 4616, 4622, 4627, 4635, 4642, 4648, 4655, 4660,
+    4665, 4670, 4676, 4682, 4688, 4692, 4697, 4704, 4709, 4719, 4727, 4734,
+    4743, 4752, 4762, 4768, 4772, 4777, 4783, 4788, 4791, 4799, 4805, 4810,
+    4816, 4822, 4827, 4832, 4839,
+};
+
+/* Слова в порядке слотов. */
+static const char stopword_strings[] =
+    "blue\0" "drive\0" "blanket\0" "low\0" "either\0" "thousand\0" "meat\0" "grey\0"
+    "museum\0" "this\0" "must\0" "journey\0" "office\0" "does\0" "dance\0" "till\0"
+    "might\0" "old\0" "whatever\0" "everything\0" "name\0" "weren't\0" "send\0" "ticket\0"
+    "lesson\0" "neighbour\0" "work\0" "careful\0" "sure\0" "body\0" "although\0" "stop\0"
+    "green\0" "banana\0" "kid\0" "eleven\0" "my\0" "climb\0" "kitchen\0" "snow\0"
+    "important\0" "many\0" "such\0" "himself\0" "than\0" "agree\0" "they'd\0" "once\0"
+    "out\0" "empty\0" "aren't\0" "yourselves\0" "return\0" "you've\0" "hungry\0" "didn't\0"
+    "after\0" "spend\0" "often\0" "then\0" "shouldn't\0" "wine\0" "jeans\0" "end\0"
+    "seven\0" "country\0" "healthy\0" "dad\0" "ours\0" "wall\0" "we\0" "itself\0"
+    "listen\0" "between\0" "next\0" "talk\0" "town\0" "teach\0" "oven\0" "most\0"
+    "airport\0" "keep\0" "wear\0" "some\0" "five\0" "skirt\0" "can't\0" "cat\0"
+    "speak\0" "car\0" "medicine\0" "key\0" "august\0" "hasn't\0" "homework\0" "baby\0"
+    "coffee\0" "dog\0" "shower\0" "seem\0" "well\0" "popular\0" "shout\0" "among\0"
+    "afternoon\0" "someone\0" "near\0" "sit\0" "people\0" "change\0" "special\0" "shop\0"
+    "be\0" "today\0" "call\0" "can\0" "around\0" "mountain\0" "none\0" "month\0"
+    "pen\0" "while\0" "hard\0" "hurt\0" "holiday\0" "off\0" "village\0" "meet\0"
+    "upon\0" "trousers\0" "build\0" "book\0" "arm\0" "number\0" "leg\0" "tea\0"
+    "suitcase\0" "february\0" "love\0" "wasn't\0" "worry\0" "behind\0" "boring\0" "ourselves\0"
+    "something\0" "price\0" "full\0" "whether\0" "which\0" "century\0" "minute\0" "weak\0"
+    "moon\0" "on\0" "and\0" "believe\0" "win\0" "across\0" "its\0" "message\0"
+    "tree\0" "beneath\0" "were\0" "true\0" "laugh\0" "sell\0" "cheap\0" "it'll\0"
+    "done\0" "leave\0" "tomorrow\0" "underneath\0" "face\0" "just\0" "wash\0" "nor\0"
+    "for\0" "make\0" "was\0" "eat\0" "except\0" "same\0" "happen\0" "if\0"
+    "beyond\0" "parent\0" "vegetable\0" "person\0" "bored\0" "may\0" "small\0" "fruit\0"
+    "husband\0" "decide\0" "we're\0" "could\0" "mouth\0" "hide\0" "favourite\0" "biscuit\0"
+    "or\0" "right\0" "besides\0" "quickly\0" "shirt\0" "pillow\0" "see\0" "teenager\0"
+    "six\0" "arrive\0" "poor\0" "sky\0" "receive\0" "student\0" "wife\0" "i'll\0"
+    "into\0" "dangerous\0" "give\0" "hundred\0" "back\0" "everybody\0" "who\0" "beautiful\0"
+    "morning\0" "year\0" "table\0" "day\0" "potato\0" "stranger\0" "news\0" "pay\0"
+    "twenty\0" "did\0" "driver\0" "possible\0" "friday\0" "happy\0" "salad\0" "breakfast\0"
+    "whose\0" "another\0" "box\0" "no\0" "but\0" "pizza\0" "whereas\0" "mine\0"
+    "up\0" "interesting\0" "internet\0" "along\0" "yours\0" "watch\0" "themselves\0" "window\0"
+    "teacher\0" "cousin\0" "live\0" "milk\0" "hadn't\0" "try\0" "are\0" "her\0"
+    "night\0" "boat\0" "clean\0" "cheese\0" "forest\0" "you\0" "boy\0" "would\0"
+    "egg\0" "park\0" "i'm\0" "join\0" "over\0" "study\0" "soon\0" "ok\0"
+    "tall\0" "stomach\0" "church\0" "train\0" "story\0" "cloud\0" "buy\0" "his\0"
+    "open\0" "bus\0" "water\0" "nice\0" "bright\0" "chicken\0" "travel\0" "go\0"
+    "hotel\0" "goodbye\0" "storm\0" "less\0" "she\0" "cookie\0" "because\0" "last\0"
+    "towards\0" "inside\0" "dinner\0" "play\0" "white\0" "with\0" "in\0" "strong\0"
+    "january\0" "myself\0" "dress\0" "little\0" "i'd\0" "quite\0" "dark\0" "perhaps\0"
+    "hair\0" "birthday\0" "down\0" "theirs\0" "company\0" "sun\0" "choose\0" "now\0"
+    "even\0" "customer\0" "lunch\0" "roof\0" "nose\0" "hour\0" "daughter\0" "garden\0"
+    "busy\0" "chair\0" "sandwich\0" "hand\0" "learn\0" "bed\0" "road\0" "probably\0"
+    "word\0" "few\0" "pencil\0" "he'd\0" "father\0" "july\0" "wet\0" "fridge\0"
+    "where\0" "eight\0" "won't\0" "without\0" "mirror\0" "favorite\0" "week\0" "not\0"
+    "stairs\0" "passport\0" "flower\0" "via\0" "an\0" "share\0" "simple\0" "him\0"
+    "until\0" "restaurant\0" "station\0" "aunt\0" "wish\0" "being\0" "whichever\0" "dry\0"
+    "tell\0" "safe\0" "newspaper\0" "get\0" "ill\0" "idea\0" "adult\0" "school\0"
+    "fly\0" "they've\0" "new\0" "june\0" "describe\0" "clock\0" "unless\0" "red\0"
+    "from\0" "there\0" "of\0" "farmer\0" "clothes\0" "show\0" "strange\0" "rather\0"
+    "you're\0" "whoever\0" "toy\0" "time\0" "though\0" "tuesday\0" "black\0" "exam\0"
+    "meeting\0" "all\0" "wouldn't\0" "letter\0" "difficult\0" "kick\0" "she'd\0" "jacket\0"
+    "more\0" "never\0" "since\0" "before\0" "shall\0" "monday\0" "test\0" "angry\0"
+    "uncle\0" "young\0" "chocolate\0" "that'll\0" "sleep\0" "grandfather\0" "our\0" "invite\0"
+    "take\0" "market\0" "bridge\0" "lamp\0" "orange\0" "isn't\0" "computer\0" "beach\0"
+    "to\0" "please\0" "run\0" "thanks\0" "help\0" "ought\0" "glass\0" "twelve\0"
+    "police\0" "october\0" "the\0" "miss\0" "too\0" "great\0" "four\0" "quiet\0"
+    "again\0" "their\0" "cow\0" "throw\0" "remember\0" "library\0" "thirsty\0" "i\0"
+    "against\0" "they'll\0" "bottle\0" "menu\0" "think\0" "mum\0" "whom\0" "wait\0"
+    "much\0" "come\0" "have\0" "close\0" "rainy\0" "gray\0" "flat\0" "they\0"
+    "tooth\0" "pain\0" "weather\0" "we'd\0" "understand\0" "somebody\0" "soap\0" "together\0"
+    "prefer\0" "april\0" "we'll\0" "autumn\0" "coat\0" "each\0" "map\0" "eye\0"
+    "almost\0" "one\0" "neither\0" "sad\0" "fix\0" "saturday\0" "they're\0" "sunday\0"
+    "a\0" "cold\0" "friend\0" "apartment\0" "finish\0" "easy\0" "plan\0" "past\0"
+    "tomato\0" "weekend\0" "under\0" "drink\0" "neighbor\0" "wrong\0" "ten\0" "he'll\0"
+    "moment\0" "he\0" "carpet\0" "us\0" "rice\0" "bathroom\0" "house\0" "million\0"
+    "slowly\0" "only\0" "really\0" "fish\0" "yes\0" "taxi\0" "cupboard\0" "onto\0"
+    "funny\0" "so\0" "yellow\0" "here\0" "both\0" "plate\0" "need\0" "bag\0"
+    "other\0" "beer\0" "these\0" "is\0" "nine\0" "late\0" "swim\0" "big\0"
+    "turn\0" "at\0" "cup\0" "floor\0" "bread\0" "throughout\0" "thank\0" "why\0"
+    "sick\0" "how\0" "ever\0" "catch\0" "september\0" "those\0" "boot\0" "feel\0"
+    "say\0" "anybody\0" "sofa\0" "every\0" "me\0" "fill\0" "any\0" "expensive\0"
+    "heavy\0" "enjoy\0" "tired\0" "rain\0" "head\0" "pasta\0" "toward\0" "room\0"
+    "job\0" "above\0" "lose\0" "sing\0" "food\0" "bike\0" "nothing\0" "evening\0"
+    "three\0" "nurse\0" "march\0" "despite\0" "woman\0" "smile\0" "usually\0" "jump\0"
+    "herself\0" "boss\0" "find\0" "within\0" "hers\0" "when\0" "thing\0" "worker\0"
+    "fall\0" "forget\0" "yourself\0" "later\0" "wednesday\0" "through\0" "door\0" "november\0"
+    "loud\0" "also\0" "useful\0" "slow\0" "visit\0" "maybe\0" "lake\0" "high\0"
+    "bird\0" "guest\0" "unlike\0" "island\0" "your\0" "cry\0" "example\0" "two\0"
+    "manager\0" "winter\0" "beside\0" "know\0" "ship\0" "onion\0" "visitor\0" "famous\0"
+    "will\0" "hospital\0" "world\0" "pink\0" "anyone\0" "you'd\0" "stand\0" "lend\0"
+    "season\0" "move\0" "wind\0" "sorry\0" "discuss\0" "about\0" "read\0" "doing\0"
+    "cook\0" "warm\0" "money\0" "email\0" "what\0" "dirty\0" "lot\0" "everyone\0"
+    "paper\0" "answer\0" "brown\0" "son\0" "garage\0" "summer\0" "cake\0" "fast\0"
+    "by\0" "lucky\0" "ball\0" "sunny\0" "don't\0" "grow\0" "river\0" "question\0"
+    "class\0" "city\0" "i've\0" "bath\0" "good\0" "plane\0" "ask\0" "grandmother\0"
+    "future\0" "brother\0" "has\0" "that\0" "phone\0" "corner\0" "use\0" "hope\0"
+    "couldn't\0" "ear\0" "sea\0" "shoe\0" "explain\0" "free\0" "them\0" "juice\0"
+    "always\0" "hello\0" "cloudy\0" "different\0" "am\0" "friendly\0" "early\0" "begin\0"
+    "write\0" "soup\0" "shelf\0" "having\0" "you'll\0" "heart\0" "hat\0" "become\0"
+    "sock\0" "haven't\0" "borrow\0" "carry\0" "problem\0" "break\0" "december\0" "should\0"
+    "sugar\0" "start\0" "doesn't\0" "family\0" "butter\0" "very\0" "towel\0" "salt\0"
+    "yet\0" "left\0" "child\0" "bad\0" "during\0" "still\0" "outside\0" "girl\0"
+    "do\0" "bank\0" "business\0" "hear\0" "carrot\0" "website\0" "want\0" "doctor\0"
+    "save\0" "hot\0" "rich\0" "stay\0" "put\0" "nobody\0" "thursday\0" "as\0"
+    "short\0" "okay\0" "oneself\0" "she'll\0" "horse\0" "street\0" "post\0" "been\0"
+    "home\0" "bring\0" "light\0" "first\0" "man\0" "foot\0" "sister\0" "trip\0"
+    "yesterday\0" "already\0" "spring\0" "anything\0" "magazine\0" "sometimes\0" "ready\0" "had\0"
+    "walk\0" "order\0" "look\0" "it\0" "picture\0" "we've\0" "like\0" "below\0"
+    "apple\0" "hate\0" "long\0" "mother\0" "cost\0"
+    ;
+
+#endif
@@ -0,0 +1,36 @@
+#include "utils/stopwords.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "utils/hash.h"
+#include "utils/stopword_table.h"
+
+int stopword_level(const char *word)
+{
+    int32_t d;
+    uint32_t slot;
+
+    if (!word) {
+        return -1;
+    }
+    d = stopword_displace[hash_fnv1a_str(word, 0) % STOPWORD_COUNT];
+    slot = d < 0 ? (uint32_t) (-d - 1) : hash_fnv1a_str(word, (uint32_t) d) % STOPWORD_COUNT;
+    /* Таблица знает только свои слова: чужое тоже попадает в какой-то слот. */
+    if (strcmp(stopword_strings + stopword_offsets[slot], word) != 0) {
+        return -1;
+    }
+    return stopword_levels[slot];
+}
+
+int stopword_is_known(const char *word, int known_level)
+{
+    int level = stopword_level(word);
+
+    return level >= 0 && level <= (known_level > 0 ? known_level : 0);
+}
+
+int stopword_max_level(void)
+{
+    return STOPWORD_MAX_LEVEL;
+}
@@ -0,0 +1,19 @@
+#ifndef UTILS_STOPWORDS_H
+#define UTILS_STOPWORDS_H
+
+/*
+ * Список стоп-слов собирается при сборке из tools/stopwords/stopwords.txt
+ * в минимальную совершенную хеш-таблицу: проверка — O(1) при любой длине
+ * списка. Уровень 0 — служебные слова, уровни 1..stopword_max_level() —
+ * базовая лексика, которую знает ученик с таким known_level.
+ */
+
+/* Уровень слова или -1, если его нет в списке. */
+int stopword_level(const char *word);
+
+/* 1, если слово служебное или уже известно на уровне known_level. */
+int stopword_is_known(const char *word, int known_level);
+
+int stopword_max_level(void);
+
+#endif
@@ -1,58 +1,507 @@
-
 #include "tokenizer.h"
-#include <ctype.h>
+#include "utils/hash.h"
+#include "utils/unicode.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
-#include <stdio.h>
 
-#define MAX_WORDS 1024
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TOKENIZER_X86 1
+#endif
+
+#define TOKENIZER_MIN_SET_CAPACITY 256
+#define TOKENIZER_BLOCK 32
+#define TOKENIZER_MIN_WORD 2      // в кодовых точках
+#define TOKENIZER_MAX_WORD 40
+
+// Уникальное слово: указатель в scratch или out, длина в байтах и хеш
+typedef struct {
+    const char *ptr;
+    size_t len;
+    uint64_t hash;
+} token_entry_t;
+
+// Состояние одного вызова: никаких static, можно звать из любых потоков
+typedef struct {
+    char *scratch;            // копия текста в нижнем регистре (быстрый путь)
+    char *out;                // свёрнутые слова медленного пути, создаётся по требованию
+    size_t out_used;
+    size_t text_len;
+    size_t word_bytes;        // сумма длин уникальных слов вместе с '\0'
+    token_entry_t *entries;   // уникальные слова в порядке появления
+    size_t count;
+    size_t entries_capacity;
+    uint32_t *set;            // открытая адресация: индекс в entries + 1, 0 — пусто
+    size_t set_capacity;
+} tokenizer_t;
 
-// Удаляет пунктуацию и приводит к нижнему регистру
-static void normalize_word(char *word) {
-    for (char *p = word; *p; ++p) {
-        if (ispunct((unsigned char)*p)) *p = '\0';
-        else *p = tolower(*p);
+// Разбор блока из 32 байт: копия в нижнем регистре в dst и битовые маски
+// пробельных байтов (' ', \t..\r) и латинских букв
+typedef void (*tokenizer_classify_fn)(const unsigned char *src, unsigned char *dst,
+                                      uint32_t *space, uint32_t *alpha);
+
+static void classify_scalar(const unsigned char *src, unsigned char *dst,
+                            uint32_t *space, uint32_t *alpha) {
+    uint32_t s = 0;
+    uint32_t a = 0;
+
+    for (int i = 0; i < TOKENIZER_BLOCK; ++i) {
+        unsigned char c = src[i];
+
+        if (c == ' ' || (c >= '\t' && c <= '\r')) {
+            s |= 1u << i;
+        } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') {
+            a |= 1u << i;
+        }
+        dst[i] = (c >= 'A' && c <= 'Z') ? (unsigned char) (c + 32) : c;
     }
+    *space = s;
+    *alpha = a;
 }
 
-char **extract_unique_words(const char *text, int *count) {
-    char **words = calloc(MAX_WORDS, sizeof(char *));
-    int word_count = 0;
-    char *copy = strdup(text);
-    char *token = strtok(copy, " \t\r\n");
-
-    while (token && word_count < MAX_WORDS) {
-        normalize_word(token);
-        if (strlen(token) == 0) {
-            token = strtok(NULL, " \t\r\n");
+#ifdef TOKENIZER_X86
+// Беззнаковое lo <= x <= hi через знаковое сравнение: сдвигаем диапазон к -128
+#define SSE_IN_RANGE(x, lo, hi) \
+    _mm_cmplt_epi8(_mm_xor_si128(_mm_sub_epi8((x), _mm_set1_epi8((char) (lo))), _mm_set1_epi8((char) 0x80)), \
+                   _mm_set1_epi8((char) (((hi) - (lo) + 1) ^ 0x80)))
+
+static uint32_t classify_sse2_half(const unsigned char *src, unsigned char *dst, uint32_t *alpha) {
+    __m128i x = _mm_loadu_si128((const __m128i *) src);
+    __m128i s = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')), SSE_IN_RANGE(x, '\t', '\r'));
+    __m128i a = SSE_IN_RANGE(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 'z');
+    __m128i upper = SSE_IN_RANGE(x, 'A', 'Z');
+
+    _mm_storeu_si128((__m128i *) dst, _mm_add_epi8(x, _mm_and_si128(upper, _mm_set1_epi8(32))));
+    *alpha = (uint32_t) _mm_movemask_epi8(a);
+    return (uint32_t) _mm_movemask_epi8(s);
+}
+
+static void classify_sse2(const unsigned char *src, unsigned char *dst,
+                          uint32_t *space, uint32_t *alpha) {
+    uint32_t a_lo;
+    uint32_t a_hi;
+    uint32_t s_lo = classify_sse2_half(src, dst, &a_lo);
+    uint32_t s_hi = classify_sse2_half(src + 16, dst + 16, &a_hi);
+
+    *space = s_lo | (s_hi << 16);
+    *alpha = a_lo | (a_hi << 16);
+}
+
+#define AVX2_IN_RANGE(x, lo, hi) \
+    _mm256_cmpgt_epi8(_mm256_set1_epi8((char) (((hi) - (lo) + 1) ^ 0x80)), \
+                      _mm256_xor_si256(_mm256_sub_epi8((x), _mm256_set1_epi8((char) (lo))), \
+                                       _mm256_set1_epi8((char) 0x80)))
+
+__attribute__((target("avx2")))
+static void classify_avx2(const unsigned char *src, unsigned char *dst,
+                          uint32_t *space, uint32_t *alpha) {
+    __m256i x = _mm256_loadu_si256((const __m256i *) src);
+    __m256i s = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')), AVX2_IN_RANGE(x, '\t', '\r'));
+    __m256i a = AVX2_IN_RANGE(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), 'a', 'z');
+    __m256i upper = AVX2_IN_RANGE(x, 'A', 'Z');
+
+    _mm256_storeu_si256((__m256i *) dst, _mm256_add_epi8(x, _mm256_and_si256(upper, _mm256_set1_epi8(32))));
+    *space = (uint32_t) _mm256_movemask_epi8(s);
+    *alpha = (uint32_t) _mm256_movemask_epi8(a);
+}
+#endif
+
+int tokenizer_kernel_available(tokenizer_kernel_t kernel) {
+    switch (kernel) {
+    case TOKENIZER_KERNEL_AUTO:
+    case TOKENIZER_KERNEL_SCALAR:
+        return 1;
+#ifdef TOKENIZER_X86
+    case TOKENIZER_KERNEL_SSE2:
+        return __builtin_cpu_supports("sse2");
+    case TOKENIZER_KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return 0;
+    }
+}
+
+const char *tokenizer_kernel_name(tokenizer_kernel_t kernel) {
+    switch (kernel) {
+    case TOKENIZER_KERNEL_AUTO:
+        return "auto";
+    case TOKENIZER_KERNEL_SCALAR:
+        return "scalar";
+    case TOKENIZER_KERNEL_SSE2:
+        return "sse2";
+    case TOKENIZER_KERNEL_AVX2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+static tokenizer_classify_fn tokenizer_pick(tokenizer_kernel_t kernel) {
+    if (kernel == TOKENIZER_KERNEL_AUTO) {
+        kernel = tokenizer_kernel_available(TOKENIZER_KERNEL_AVX2) ? TOKENIZER_KERNEL_AVX2 :
+                 tokenizer_kernel_available(TOKENIZER_KERNEL_SSE2) ? TOKENIZER_KERNEL_SSE2 :
+                 TOKENIZER_KERNEL_SCALAR;
+    }
+    if (!tokenizer_kernel_available(kernel)) {
+        return NULL;
+    }
+    switch (kernel) {
+#ifdef TOKENIZER_X86
+    case TOKENIZER_KERNEL_SSE2:
+        return classify_sse2;
+    case TOKENIZER_KERNEL_AVX2:
+        return classify_avx2;
+#endif
+    default:
+        return classify_scalar;
+    }
+}
+
+static int tokenizer_set_grow(tokenizer_t *t) {
+    size_t capacity = t->set_capacity ? t->set_capacity * 2 : TOKENIZER_MIN_SET_CAPACITY;
+    uint32_t *set = calloc(capacity, sizeof(*set));
+
+    if (!set) {
+        return -1;
+    }
+    for (size_t i = 0; i < t->count; ++i) {
+        size_t slot = (size_t) t->entries[i].hash & (capacity - 1);
+        while (set[slot]) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        set[slot] = (uint32_t) (i + 1);
+    }
+    free(t->set);
+    t->set = set;
+    t->set_capacity = capacity;
+    return 0;
+}
+
+// Слово [word, word + len); 1 — новое, 0 — повтор, -1 — ошибка
+static int tokenizer_add(tokenizer_t *t, const char *word, size_t len) {
+    uint64_t hash = hash_xxh64(word, len, 0);
+    size_t slot;
+
+    // Заполнение таблицы не выше половины
+    if ((t->count + 1) * 2 > t->set_capacity && tokenizer_set_grow(t) != 0) {
+        return -1;
+    }
+
+    slot = (size_t) hash & (t->set_capacity - 1);
+    while (t->set[slot]) {
+        const token_entry_t *e = &t->entries[t->set[slot] - 1];
+        if (e->hash == hash && e->len == len && memcmp(e->ptr, word, len) == 0) {
+            return 0;
+        }
+        slot = (slot + 1) & (t->set_capacity - 1);
+    }
+
+    if (t->count == t->entries_capacity) {
+        size_t capacity = t->entries_capacity ? t->entries_capacity * 2 : TOKENIZER_MIN_SET_CAPACITY;
+        token_entry_t *tmp = realloc(t->entries, capacity * sizeof(*tmp));
+        if (!tmp) {
+            return -1;
+        }
+        t->entries = tmp;
+        t->entries_capacity = capacity;
+    }
+
+    t->entries[t->count].ptr = word;
+    t->entries[t->count].len = len;
+    t->entries[t->count].hash = hash;
+    t->count++;
+    t->set[slot] = (uint32_t) t->count;
+    t->word_bytes += len + 1;
+    return 1;
+}
+
+typedef enum {
+    CP_OTHER = 0,
+    CP_LETTER,
+    CP_DIGIT,
+    CP_APOSTROPHE,
+    CP_HYPHEN
+} cp_class_t;
+
+static cp_class_t tokenizer_class(uint32_t cp) {
+    if (cp >= '0' && cp <= '9') {
+        return CP_DIGIT;
+    }
+    // ' ’ ʼ
+    if (cp == '\'' || cp == 0x2019 || cp == 0x02BC) {
+        return CP_APOSTROPHE;
+    }
+    // - ‐ ‑ (тире и минус — границы слов)
+    if (cp == '-' || cp == 0x2010 || cp == 0x2011) {
+        return CP_HYPHEN;
+    }
+    return unicode_is_letter(cp) ? CP_LETTER : CP_OTHER;
+}
+
+// Ссылки и адреса целиком — мусор для словаря
+static int tokenizer_chunk_is_link(const unsigned char *s, size_t n) {
+    if (n >= 4 && (s[0] | 0x20) == 'w' && (s[1] | 0x20) == 'w' && (s[2] | 0x20) == 'w' && s[3] == '.') {
+        return 1;
+    }
+    if (memchr(s, '@', n)) {
+        return 1;
+    }
+    for (size_t i = 0; i + 3 <= n; ++i) {
+        if (s[i] == ':' && s[i + 1] == '/' && s[i + 2] == '/') {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Слово собрано в out + out_used; отрезаем притяжательное 's и проверяем длину
+static int tokenizer_emit(tokenizer_t *t, size_t len, size_t cps) {
+    char *word = t->out + t->out_used;
+    int rc;
+
+    if (len >= 2 && word[len - 2] == '\'' && word[len - 1] == 's') {
+        len -= 2;
+        cps -= 2;
+    }
+    if (cps < TOKENIZER_MIN_WORD || cps > TOKENIZER_MAX_WORD) {
+        return 0;
+    }
+    rc = tokenizer_add(t, word, len);
+    if (rc == 1) {
+        t->out_used += len + 1;
+    }
+    return rc < 0 ? -1 : 0;
+}
+
+/*
+ * Медленный путь для кусков с не-ASCII, цифрами или пунктуацией.
+ * Токен — непрерывная цепочка букв, цифр и соединителей; токены с
+ * цифрами отбрасываются целиком. Апостроф или дефис остаётся в слове,
+ * только если стоит между двумя буквами, иначе режет слово.
+ * Каждое выданное слово занимает не меньше двух исходных байт и не
+ * больше чем вдвое больше места в out, поэтому out размера 2 * len
+ * не переполняется.
+ */
+static int tokenizer_chunk(tokenizer_t *t, const unsigned char *s, size_t n) {
+    const unsigned char *end = s + n;
+    size_t i = 0;
+
+    if (tokenizer_chunk_is_link(s, n)) {
+        return 0;
+    }
+    if (!t->out) {
+        t->out = malloc(t->text_len * 2 + 16);
+        if (!t->out) {
+            return -1;
+        }
+    }
+
+    while (i < n) {
+        size_t token_start;
+        size_t token_end;
+        size_t clen;
+        int has_digit = 0;
+        size_t len = 0;
+        size_t cps = 0;
+        cp_class_t prev = CP_OTHER;
+
+        if (tokenizer_class(utf8_decode(s + i, end, &clen)) == CP_OTHER) {
+            i += clen;
             continue;
         }
+        token_start = i;
+        while (i < n) {
+            cp_class_t c = tokenizer_class(utf8_decode(s + i, end, &clen));
+            if (c == CP_OTHER) {
+                break;
+            }
+            has_digit |= c == CP_DIGIT;
+            i += clen;
+        }
+        token_end = i;
+        if (has_digit) {
+            continue;
+        }
+
+        for (size_t j = token_start; j < token_end; j += clen) {
+            uint32_t cp = utf8_decode(s + j, end, &clen);
+            cp_class_t c = tokenizer_class(cp);
+            char *word = t->out + t->out_used;
+
+            if (c == CP_LETTER) {
+                len += utf8_encode(unicode_fold(cp), word + len);
+                cps++;
+            } else {
+                size_t next_len;
+                int inner = prev == CP_LETTER && j + clen < token_end &&
+                            tokenizer_class(utf8_decode(s + j + clen, end, &next_len)) == CP_LETTER;
+
+                if (inner) {
+                    word[len++] = c == CP_APOSTROPHE ? '\'' : '-';
+                    cps++;
+                } else {
+                    if (tokenizer_emit(t, len, cps) < 0) {
+                        return -1;
+                    }
+                    len = 0;
+                    cps = 0;
+                }
+            }
+            prev = c;
+        }
+        if (tokenizer_emit(t, len, cps) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Проход по тексту блоками: ядро даёт маски, автомат идёт по битам и
+ * режет текст на куски между пробельными байтами. Кусок только из
+ * латинских букв — слово как есть из копии в нижнем регистре; всё
+ * остальное разбирает медленный путь с декодированием UTF-8.
+ */
+static int tokenizer_scan(tokenizer_t *t, const unsigned char *text, size_t len,
+                          tokenizer_classify_fn classify) {
+    int in_chunk = 0;
+    int ascii_word = 0;
+    size_t chunk_start = 0;
+
+    for (size_t pos = 0; pos < len; pos += TOKENIZER_BLOCK) {
+        size_t n = len - pos < TOKENIZER_BLOCK ? len - pos : TOKENIZER_BLOCK;
+        uint32_t valid = n == TOKENIZER_BLOCK ? 0xFFFFFFFFu : (1u << n) - 1;
+        uint32_t space;
+        uint32_t alpha;
+        int cur = 0;
+
+        if (n == TOKENIZER_BLOCK) {
+            classify(text + pos, (unsigned char *) t->scratch + pos, &space, &alpha);
+        } else {
+            // Хвост: ядро всегда читает полный блок
+            unsigned char in[TOKENIZER_BLOCK] = {0};
+            unsigned char out[TOKENIZER_BLOCK];
+
+            memcpy(in, text + pos, n);
+            classify(in, out, &space, &alpha);
+            memcpy(t->scratch + pos, out, n);
+        }
+        space &= valid;
+        alpha &= valid;
+
+        while (cur < TOKENIZER_BLOCK) {
+            uint32_t from = (0xFFFFFFFFu << cur) & valid;
+            uint32_t m;
+            int b;
+
+            if (!in_chunk) {
+                m = ~space & from;
+                if (!m) {
+                    break;
+                }
+                b = __builtin_ctz(m);
+                chunk_start = pos + (size_t) b;
+                in_chunk = 1;
+                ascii_word = 1;
+                cur = b;
+                continue;
+            }
 
-        // Проверка на уникальность
-        int is_unique = 1;
-        for (int i = 0; i < word_count; ++i) {
-            if (strcmp(words[i], token) == 0) {
-                is_unique = 0;
+            m = space & from;
+            b = m ? __builtin_ctz(m) : TOKENIZER_BLOCK;
+            if (~alpha & from & (b == TOKENIZER_BLOCK ? 0xFFFFFFFFu : (1u << b) - 1)) {
+                ascii_word = 0;
+            }
+            if (!m) {
                 break;
             }
+
+            if (ascii_word) {
+                size_t word_len = pos + (size_t) b - chunk_start;
+                if (word_len >= TOKENIZER_MIN_WORD && word_len <= TOKENIZER_MAX_WORD &&
+                    tokenizer_add(t, t->scratch + chunk_start, word_len) < 0) {
+                    return -1;
+                }
+            } else if (tokenizer_chunk(t, text + chunk_start, pos + (size_t) b - chunk_start) < 0) {
+                return -1;
+            }
+            in_chunk = 0;
+            cur = b + 1;
         }
+    }
 
-        if (is_unique) {
-            words[word_count++] = strdup(token);
+    if (in_chunk) {
+        if (ascii_word) {
+            size_t word_len = len - chunk_start;
+            if (word_len >= TOKENIZER_MIN_WORD && word_len <= TOKENIZER_MAX_WORD &&
+                tokenizer_add(t, t->scratch + chunk_start, word_len) < 0) {
+                return -1;
+            }
+        } else if (tokenizer_chunk(t, text + chunk_start, len - chunk_start) < 0) {
+            return -1;
         }
+    }
+    return 0;
+}
 
-        token = strtok(NULL, " \t\r\n");
+// Итог — один блок: массив указателей, за ним строки
+static char **tokenizer_finish(tokenizer_t *t) {
+    size_t header = (t->count ? t->count : 1) * sizeof(char *);
+    char **words = malloc(header + t->word_bytes);
+    char *arena;
+
+    if (!words) {
+        return NULL;
+    }
+    arena = (char *) words + header;
+    for (size_t i = 0; i < t->count; ++i) {
+        memcpy(arena, t->entries[i].ptr, t->entries[i].len);
+        arena[t->entries[i].len] = '\0';
+        words[i] = arena;
+        arena += t->entries[i].len + 1;
+    }
+    return words;
+}
+
+char **extract_unique_words_with(const char *text, int *count, tokenizer_kernel_t kernel) {
+    tokenizer_classify_fn classify = tokenizer_pick(kernel);
+    tokenizer_t t;
+    char **words = NULL;
+    size_t len;
+
+    *count = 0;
+    if (!text || !classify) {
+        return NULL;
+    }
+
+    memset(&t, 0, sizeof(t));
+    len = strlen(text);
+    t.text_len = len;
+    t.scratch = malloc(len + 1);
+    if (!t.scratch) {
+        return NULL;
+    }
+
+    if (tokenizer_scan(&t, (const unsigned char *) text, len, classify) == 0) {
+        words = tokenizer_finish(&t);
+        if (words) {
+            *count = (int) t.count;
+        }
     }
 
-    free(copy);
-    *count = word_count;
+    free(t.scratch);
+    free(t.out);
+    free(t.entries);
+    free(t.set);
     return words;
 }
 
+char **extract_unique_words(const char *text, int *count) {
+    return extract_unique_words_with(text, count, TOKENIZER_KERNEL_AUTO);
+}
+
 void free_word_list(char **words, int count) {
-    for (int i = 0; i < count; ++i) {
-        free(words[i]);
-    }
+    (void) count;
     free(words);
 }
-
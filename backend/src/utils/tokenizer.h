@@ -1,10 +1,32 @@
 #ifndef TOKENIZER_H
 #define TOKENIZER_H
 
-// Возвращает список уникальных слов из текста.
-// Выделяет память, caller должен освободить.
+// Возвращает список уникальных слов из текста в порядке первого появления.
+// Текст — UTF-8. Слово — буквы любого алфавита, внутри допускаются
+// апостроф и дефис между буквами ("don't", "well-known"); ’ и ʼ
+// приводятся к ', ‐ и ‑ к -. Регистр свёрнут по таблицам Unicode.
+// Мусор отбрасывается сразу: токены с цифрами, ссылки и адреса почты,
+// слова короче 2 и длиннее 40 символов; притяжательное 's отрезается.
+// Массив и строки лежат в одном блоке памяти, caller освобождает его
+// через free_word_list. Без глобального состояния — безопасно из потоков.
+// NULL — ошибка выделения памяти.
 char **extract_unique_words(const char *text, int *count);
 
 void free_word_list(char **words, int count);
 
+// Ядро разбора текста. AUTO выбирает лучшее доступное на этом процессоре
+// (AVX2, затем SSE2, иначе скалярное); результат у всех ядер одинаковый.
+typedef enum {
+    TOKENIZER_KERNEL_AUTO = 0,
+    TOKENIZER_KERNEL_SCALAR,
+    TOKENIZER_KERNEL_SSE2,
+    TOKENIZER_KERNEL_AVX2
+} tokenizer_kernel_t;
+
+// Для сверки и замеров: явный выбор ядра. NULL, если ядро недоступно.
+char **extract_unique_words_with(const char *text, int *count, tokenizer_kernel_t kernel);
+
+int tokenizer_kernel_available(tokenizer_kernel_t kernel);
+const char *tokenizer_kernel_name(tokenizer_kernel_t kernel);
+
 #endif // TOKENIZER_H
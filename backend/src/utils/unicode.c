@@ -0,0 +1,126 @@
+#include "utils/unicode.h"
+
+#include "utils/unicode_tables.h"
+
+uint32_t utf8_decode(const unsigned char *p, const unsigned char *end, size_t *out_len)
+{
+    unsigned char c = p[0];
+    uint32_t cp;
+    uint32_t min;
+    size_t len;
+    size_t i;
+
+    *out_len = 1;
+    if (c < 0x80) {
+        return c;
+    }
+    if (c >= 0xC2 && c <= 0xDF) {
+        len = 2;
+        cp = c & 0x1F;
+        min = 0x80;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        len = 3;
+        cp = c & 0x0F;
+        min = 0x800;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        len = 4;
+        cp = c & 0x07;
+        min = 0x10000;
+    } else {
+        return UNICODE_REPLACEMENT;
+    }
+
+    if ((size_t) (end - p) < len) {
+        return UNICODE_REPLACEMENT;
+    }
+    for (i = 1; i < len; i++) {
+        if ((p[i] & 0xC0) != 0x80) {
+            return UNICODE_REPLACEMENT;
+        }
+        cp = (cp << 6) | (p[i] & 0x3F);
+    }
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+        return UNICODE_REPLACEMENT;
+    }
+
+    *out_len = len;
+    return cp;
+}
+
+size_t utf8_encode(uint32_t cp, char *out)
+{
+    if (cp < 0x80) {
+        out[0] = (char) cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char) (0xC0 | (cp >> 6));
+        out[1] = (char) (0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char) (0xE0 | (cp >> 12));
+        out[1] = (char) (0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char) (0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char) (0xF0 | (cp >> 18));
+    out[1] = (char) (0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char) (0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char) (0x80 | (cp & 0x3F));
+    return 4;
+}
+
+int unicode_is_letter(uint32_t cp)
+{
+    size_t lo = 0;
+    size_t hi = sizeof(unicode_letter_ranges) / sizeof(unicode_letter_ranges[0]);
+
+    if (cp < 0x80) {
+        return (cp | 0x20) >= 'a' && (cp | 0x20) <= 'z';
+    }
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+
+        if (cp < unicode_letter_ranges[mid][0]) {
+            hi = mid;
+        } else if (cp > unicode_letter_ranges[mid][1]) {
+            lo = mid + 1;
+        } else {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+uint32_t unicode_fold(uint32_t cp)
+{
+    size_t lo = 0;
+    size_t hi = sizeof(unicode_fold_runs) / sizeof(unicode_fold_runs[0]);
+    const unicode_fold_run_t *run;
+    uint32_t offset;
+
+    if (cp < 0x80) {
+        return cp >= 'A' && cp <= 'Z' ? cp + 32 : cp;
+    }
+
+    /* Последняя серия с start <= cp; серии не перекрываются (проверяет генератор). */
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+
+        if (unicode_fold_runs[mid].start <= cp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        return cp;
+    }
+    run = &unicode_fold_runs[lo - 1];
+    offset = cp - run->start;
+    if (offset % run->stride == 0 && offset / run->stride < run->count) {
+        return (uint32_t) ((int32_t) cp + run->delta);
+    }
+    return cp;
+}
@@ -0,0 +1,26 @@
+#ifndef UTILS_UNICODE_H
+#define UTILS_UNICODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define UNICODE_REPLACEMENT 0xFFFD
+
+/*
+ * Декодирует один символ UTF-8 из [p, end). *out_len — сколько байт
+ * он занял (не меньше 1). Некорректные последовательности (обрезанные,
+ * избыточно длинные, суррогаты, > U+10FFFF) дают UNICODE_REPLACEMENT
+ * и съедают один байт.
+ */
+uint32_t utf8_decode(const unsigned char *p, const unsigned char *end, size_t *out_len);
+
+/* Кодирует cp в out (до 4 байт), возвращает длину. */
+size_t utf8_encode(uint32_t cp, char *out);
+
+/* Буква или комбинируемый знак (категории L* и M*). */
+int unicode_is_letter(uint32_t cp);
+
+/* Простое приведение регистра 1:1 (casefold, где он не меняет длину). */
+uint32_t unicode_fold(uint32_t cp);
+
+#endif
@@ -0,0 +1,125 @@
+#include "utils/word_rank.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utils/hash.h"
+
+/* Раскладка файла описана в tools/wordrank/gen_word_ranks.py. */
+#define WORD_RANK_MAGIC "WRANK01"
+#define WORD_RANK_HEADER_SIZE 16
+
+typedef struct {
+    void *map;
+    size_t map_size;
+    uint32_t count;
+    uint32_t strings_size;
+    const unsigned char *displace;
+    const unsigned char *offsets;
+    const unsigned char *ranks;
+    const char *strings;
+} word_rank_dict_t;
+
+static word_rank_dict_t g_dict;
+
+/* Файл little-endian; memcpy — массивы в отображении могут быть не выровнены. */
+static uint32_t word_rank_read32(const unsigned char *p)
+{
+    uint32_t value;
+
+    memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    return value;
+}
+
+int word_rank_open(const char *path)
+{
+    word_rank_dict_t dict;
+    struct stat st;
+    const unsigned char *base;
+    uint64_t expected;
+    int fd;
+
+    if (!path) {
+        return -1;
+    }
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size < WORD_RANK_HEADER_SIZE) {
+        close(fd);
+        return -1;
+    }
+
+    memset(&dict, 0, sizeof(dict));
+    dict.map_size = (size_t) st.st_size;
+    dict.map = mmap(NULL, dict.map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (dict.map == MAP_FAILED) {
+        return -1;
+    }
+
+    base = dict.map;
+    dict.count = word_rank_read32(base + 8);
+    dict.strings_size = word_rank_read32(base + 12);
+    expected = WORD_RANK_HEADER_SIZE + (uint64_t) dict.count * 12 + dict.strings_size;
+    /*
+     * Все смещения проверяются при поиске, здесь — только то, без чего
+     * нельзя искать: размеры сходятся и последняя строка закрыта '\0'.
+     */
+    if (memcmp(base, WORD_RANK_MAGIC, sizeof(WORD_RANK_MAGIC)) != 0 ||
+        dict.count == 0 || dict.strings_size == 0 || expected != dict.map_size ||
+        base[dict.map_size - 1] != '\0') {
+        munmap(dict.map, dict.map_size);
+        return -1;
+    }
+    dict.displace = base + WORD_RANK_HEADER_SIZE;
+    dict.offsets = dict.displace + (size_t) dict.count * 4;
+    dict.ranks = dict.offsets + (size_t) dict.count * 4;
+    dict.strings = (const char *) (dict.ranks + (size_t) dict.count * 4);
+
+    word_rank_close();
+    g_dict = dict;
+    return 0;
+}
+
+void word_rank_close(void)
+{
+    if (g_dict.map) {
+        munmap(g_dict.map, g_dict.map_size);
+    }
+    memset(&g_dict, 0, sizeof(g_dict));
+}
+
+unsigned word_rank(const char *word)
+{
+    int32_t d;
+    uint32_t slot;
+    uint32_t offset;
+
+    if (!word || g_dict.count == 0) {
+        return 0;
+    }
+    d = (int32_t) word_rank_read32(g_dict.displace + (size_t) (hash_fnv1a_str(word, 0) % g_dict.count) * 4);
+    slot = d < 0 ? (uint32_t) (-(int64_t) d - 1) : hash_fnv1a_str(word, (uint32_t) d) % g_dict.count;
+    if (slot >= g_dict.count) {
+        return 0;
+    }
+    offset = word_rank_read32(g_dict.offsets + (size_t) slot * 4);
+    if (offset >= g_dict.strings_size || strcmp(g_dict.strings + offset, word) != 0) {
+        return 0;
+    }
+    return word_rank_read32(g_dict.ranks + (size_t) slot * 4);
+}
+
+size_t word_rank_count(void)
+{
+    return g_dict.count;
+}
@@ -0,0 +1,26 @@
+#ifndef UTILS_WORD_RANK_H
+#define UTILS_WORD_RANK_H
+
+#include <stddef.h>
+
+/*
+ * Частотный ранг леммы из словаря data/word_ranks.bin (make word-ranks):
+ * 1 — самое частое слово корпуса. Файл отображается через mmap и не
+ * разбирается — открытие стоит один системный вызов и проверку
+ * заголовка, поиск — как у стоп-слов, по совершенной хеш-таблице.
+ *
+ * word_rank_open/close вызываются при старте и остановке сервера;
+ * поиск между ними только читает и безопасен из любых потоков.
+ */
+
+/* 0 — словарь загружен; -1 — файла нет или он повреждён (старый остаётся). */
+int word_rank_open(const char *path);
+void word_rank_close(void);
+
+/* Ранг слова или 0, если его нет в словаре или словарь не загружен. */
+unsigned word_rank(const char *word);
+
+/* Число слов в загруженном словаре, 0 — словаря нет. */
+size_t word_rank_count(void);
+
+#endif
@@ -0,0 +1,540 @@
+/*
+ * cardwarm — офлайн прогрев кэша карточек.
+ *
+ * Читает частотный список слов (по слову в строке, дальше могут идти
+ * частота и прочие колонки; строки с '#' пропускаются), генерирует
+ * карточки через тот же клиент ollama.c и складывает их в card_cache.
+ * Рабочие задания потом берут готовые карточки вместо ожидания модели.
+ *
+ *   bin/cardwarm [-c workers] [-b batch] [-r requests_per_sec]
+ *                [-n limit] [-t timeout_ms] wordlist.txt
+ *
+ * Перезапуск продолжает с того же места: слова, уже лежащие в
+ * card_cache, пропускаются. Ctrl+C дописывает готовые карточки и выходит.
+ * Окружение — как у сервера: PG* для базы, OLLAMA_HOST/OLLAMA_PORT или
+ * OLLAMA_BACKENDS для модели (годится и docker/ollama/mock_server.py).
+ */
+#include "db/db.h"
+#include "dbug/dbug.h"
+#include "libs/http.h"
+#include "ollama/ollama.h"
+
+#include <ctype.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CARDWARM_DEFAULT_WORKERS 8
+#define CARDWARM_DEFAULT_BATCH 8
+#define CARDWARM_DEFAULT_TIMEOUT_MS 180000
+#define CARDWARM_MAX_WORKERS 256
+#define CARDWARM_MAX_BATCH 32
+#define CARDWARM_MAX_WORD 64
+/* Порция слов на один запрос к card_cache при проверке на старте. */
+#define CARDWARM_CHECK_CHUNK 500
+/* Писатель сбрасывает накопленное не реже, чем раз в это время. */
+#define CARDWARM_FLUSH_MS 500
+
+typedef struct {
+    char **items;
+    size_t count;
+    size_t capacity;
+} word_list_t;
+
+typedef struct {
+    word_card_t **items;
+    size_t count;
+    size_t capacity;
+} card_queue_t;
+
+static volatile sig_atomic_t g_stop = 0;
+
+static word_list_t g_words;
+static size_t g_next_word = 0;
+static int g_batch = CARDWARM_DEFAULT_BATCH;
+static unsigned long long g_timeout_ms = CARDWARM_DEFAULT_TIMEOUT_MS;
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_queue_cond = PTHREAD_COND_INITIALIZER;
+static card_queue_t g_queue;
+static int g_workers_running = 0;
+static int g_workers_done = 0;
+
+/* Token bucket на запросы к модели: rate в секунду, ёмкость — секунда (не меньше 1). */
+static double g_rate = 0;
+static double g_tokens = 0;
+static unsigned long long g_tokens_at = 0;
+
+static size_t g_generated = 0;
+static size_t g_failed = 0;
+static size_t g_stored = 0;
+static size_t g_store_failed = 0;
+
+static void sigint_handler(int sig)
+{
+    (void) sig;
+    g_stop = 1;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-c workers] [-b batch] [-r requests_per_sec] [-n limit] [-t timeout_ms] wordlist\n"
+            "  -c  parallel requests to the model (default %d)\n"
+            "  -b  words per generation request (default %d, max %d)\n"
+            "  -r  request rate limit per second, 0 = unlimited (default 0)\n"
+            "  -n  take only the first N words of the list\n"
+            "  -t  deadline for one request in ms (default %d)\n",
+            prog, CARDWARM_DEFAULT_WORKERS, CARDWARM_DEFAULT_BATCH, CARDWARM_MAX_BATCH,
+            CARDWARM_DEFAULT_TIMEOUT_MS);
+}
+
+/*
+ * Первая колонка строки, приведённая к нижнему регистру.
+ * Возвращает 0, если это похоже на английское слово.
+ */
+static int parse_word(const char *line, char *out, size_t out_sz)
+{
+    size_t len = 0;
+
+    while (*line == ' ' || *line == '\t') line++;
+    if (*line == '#' || *line == '\0' || *line == '\n' || *line == '\r') {
+        return -1;
+    }
+
+    while (*line && !isspace((unsigned char) *line) && *line != ',') {
+        char c = (char) tolower((unsigned char) *line);
+
+        if (!(c >= 'a' && c <= 'z') && c != '\'' && c != '-') {
+            return -1;
+        }
+        if (len + 1 >= out_sz) {
+            return -1;
+        }
+        out[len++] = c;
+        line++;
+    }
+    out[len] = '\0';
+
+    return len > 0 && isalpha((unsigned char) out[0]) ? 0 : -1;
+}
+
+static int word_list_load(const char *path, size_t limit, word_list_t *list)
+{
+    FILE *f = fopen(path, "r");
+    char line[512];
+    char word[CARDWARM_MAX_WORD];
+    size_t skipped = 0;
+
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), f) && (limit == 0 || list->count < limit)) {
+        if (parse_word(line, word, sizeof(word)) != 0) {
+            skipped++;
+            continue;
+        }
+        if (list->count == list->capacity) {
+            size_t capacity = list->capacity ? list->capacity * 2 : 1024;
+            char **items = realloc(list->items, capacity * sizeof(*items));
+
+            if (!items) {
+                fclose(f);
+                return -1;
+            }
+            list->items = items;
+            list->capacity = capacity;
+        }
+        list->items[list->count] = strdup(word);
+        if (!list->items[list->count]) {
+            fclose(f);
+            return -1;
+        }
+        list->count++;
+    }
+
+    fclose(f);
+    if (skipped) {
+        fprintf(stderr, "cardwarm: skipped %zu line(s) without a usable word\n", skipped);
+    }
+    return 0;
+}
+
+/*
+ * Возобновление: убирает из списка слова, для которых карточка уже
+ * есть в card_cache, сохраняя порядок (частые слова — первыми).
+ */
+static int word_list_drop_cached(word_list_t *list)
+{
+    int *present = calloc(list->count ? list->count : 1, sizeof(*present));
+    size_t kept = 0;
+    size_t start;
+    size_t i;
+
+    if (!present) {
+        return -1;
+    }
+
+    for (start = 0; start < list->count; start += CARDWARM_CHECK_CHUNK) {
+        size_t n = list->count - start < CARDWARM_CHECK_CHUNK ? list->count - start : CARDWARM_CHECK_CHUNK;
+
+        if (db_card_cache_contains((const char *const *) &list->items[start], n, present + start) != DB_OK) {
+            free(present);
+            return -1;
+        }
+    }
+
+    for (i = 0; i < list->count; i++) {
+        if (present[i]) {
+            free(list->items[i]);
+        } else {
+            list->items[kept++] = list->items[i];
+        }
+    }
+
+    fprintf(stderr, "cardwarm: %zu word(s) already cached, %zu to generate\n",
+            list->count - kept, kept);
+    list->count = kept;
+    free(present);
+    return 0;
+}
+
+static void word_list_free(word_list_t *list)
+{
+    size_t i;
+
+    for (i = 0; i < list->count; i++) {
+        free(list->items[i]);
+    }
+    free(list->items);
+    memset(list, 0, sizeof(*list));
+}
+
+static void sleep_ms(unsigned long long ms)
+{
+    struct timespec ts;
+
+    ts.tv_sec = (time_t) (ms / 1000ULL);
+    ts.tv_nsec = (long) (ms % 1000ULL) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+/* Ждёт жетон token bucket'а. 0 — можно слать запрос, -1 — остановка. */
+static int rate_limit_take(void)
+{
+    double burst = g_rate < 1.0 ? 1.0 : g_rate;
+
+    for (;;) {
+        unsigned long long wait_ms;
+        unsigned long long now;
+
+        if (g_stop) {
+            return -1;
+        }
+        if (g_rate <= 0) {
+            return 0;
+        }
+
+        pthread_mutex_lock(&g_lock);
+        now = http_now_ms();
+        g_tokens += (double) (now - g_tokens_at) * g_rate / 1000.0;
+        if (g_tokens > burst) g_tokens = burst;
+        g_tokens_at = now;
+
+        if (g_tokens >= 1.0) {
+            g_tokens -= 1.0;
+            pthread_mutex_unlock(&g_lock);
+            return 0;
+        }
+        wait_ms = (unsigned long long) ((1.0 - g_tokens) * 1000.0 / g_rate) + 1;
+        pthread_mutex_unlock(&g_lock);
+
+        sleep_ms(wait_ms > 200 ? 200 : wait_ms);
+    }
+}
+
+static void queue_push(word_card_t *card)
+{
+    pthread_mutex_lock(&g_lock);
+    if (g_queue.count == g_queue.capacity) {
+        size_t capacity = g_queue.capacity ? g_queue.capacity * 2 : 64;
+        word_card_t **items = realloc(g_queue.items, capacity * sizeof(*items));
+
+        if (!items) {
+            g_store_failed++;
+            pthread_mutex_unlock(&g_lock);
+            free_word_card(card);
+            return;
+        }
+        g_queue.items = items;
+        g_queue.capacity = capacity;
+    }
+    g_queue.items[g_queue.count++] = card;
+    g_generated++;
+    pthread_cond_signal(&g_queue_cond);
+    pthread_mutex_unlock(&g_lock);
+}
+
+/*
+ * Рабочий поток: берёт следующие batch слов списка и генерирует их одним
+ * запросом; то, что не получилось пачкой, повторяется по одному слову.
+ */
+static void *worker_main(void *arg)
+{
+    const char *batch[CARDWARM_MAX_BATCH];
+    word_card_t *cards[CARDWARM_MAX_BATCH];
+
+    (void) arg;
+
+    for (;;) {
+        size_t count = 0;
+        size_t i;
+
+        if (rate_limit_take() != 0) {
+            break;
+        }
+
+        pthread_mutex_lock(&g_lock);
+        while (count < (size_t) g_batch && g_next_word < g_words.count) {
+            batch[count++] = g_words.items[g_next_word++];
+        }
+        pthread_mutex_unlock(&g_lock);
+
+        if (count == 0) {
+            break;
+        }
+
+        if (count == 1) {
+            cards[0] = generate_word_card(batch[0], http_now_ms() + g_timeout_ms);
+        } else if (generate_word_cards(batch, count, cards, http_now_ms() + g_timeout_ms) < 0) {
+            memset(cards, 0, count * sizeof(cards[0]));
+        }
+
+        for (i = 0; i < count; i++) {
+            if (!cards[i] && count > 1 && rate_limit_take() == 0) {
+                cards[i] = generate_word_card(batch[i], http_now_ms() + g_timeout_ms);
+            }
+            if (cards[i]) {
+                queue_push(cards[i]);
+            } else {
+                pthread_mutex_lock(&g_lock);
+                g_failed++;
+                pthread_mutex_unlock(&g_lock);
+                fprintf(stderr, "cardwarm: failed to generate '%s'\n", batch[i]);
+            }
+        }
+    }
+
+    pthread_mutex_lock(&g_lock);
+    g_workers_running--;
+    pthread_mutex_unlock(&g_lock);
+    return NULL;
+}
+
+static void store_cards(word_card_t **cards, size_t count)
+{
+    db_card_cache_input_t inputs[DB_CARD_CACHE_MAX_BATCH];
+    size_t i;
+    int rc;
+
+    for (i = 0; i < count; i++) {
+        inputs[i].word = cards[i]->word;
+        inputs[i].transcription = cards[i]->transcription;
+        inputs[i].translation = cards[i]->translation;
+        inputs[i].example_1 = cards[i]->examples[0];
+        inputs[i].example_2 = cards[i]->examples[1];
+    }
+
+    rc = db_card_cache_put_many(inputs, count);
+
+    pthread_mutex_lock(&g_lock);
+    if (rc == DB_OK) {
+        g_stored += count;
+    } else {
+        g_store_failed += count;
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    if (rc != DB_OK) {
+        fprintf(stderr, "cardwarm: failed to store %zu card(s)\n", count);
+    }
+}
+
+/*
+ * Единственный поток, который пишет в базу. Соединение в db.c своё у
+ * каждого потока и открывается на каждый вызов, поэтому рабочие потоки
+ * складывают карточки в очередь, а запись идёт пачками до
+ * DB_CARD_CACHE_MAX_BATCH строк — одно соединение и один INSERT на пачку.
+ */
+static void *writer_main(void *arg)
+{
+    word_card_t *pending[DB_CARD_CACHE_MAX_BATCH];
+
+    (void) arg;
+
+    for (;;) {
+        size_t count = 0;
+        int finished;
+        size_t i;
+
+        pthread_mutex_lock(&g_lock);
+        if (g_queue.count < DB_CARD_CACHE_MAX_BATCH && !g_workers_done) {
+            struct timespec ts;
+
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += (long) CARDWARM_FLUSH_MS * 1000000L;
+            ts.tv_sec += ts.tv_nsec / 1000000000L;
+            ts.tv_nsec %= 1000000000L;
+            pthread_cond_timedwait(&g_queue_cond, &g_lock, &ts);
+        }
+
+        count = g_queue.count < DB_CARD_CACHE_MAX_BATCH ? g_queue.count : DB_CARD_CACHE_MAX_BATCH;
+        memcpy(pending, g_queue.items + g_queue.count - count, count * sizeof(pending[0]));
+        g_queue.count -= count;
+        finished = g_workers_done && g_queue.count == 0;
+        pthread_mutex_unlock(&g_lock);
+
+        if (count > 0) {
+            store_cards(pending, count);
+            for (i = 0; i < count; i++) {
+                free_word_card(pending[i]);
+            }
+        }
+        if (finished) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static void print_progress(size_t total)
+{
+    pthread_mutex_lock(&g_lock);
+    fprintf(stderr, "cardwarm: %zu/%zu generated, %zu stored, %zu failed\n",
+            g_generated, total, g_stored, g_failed + g_store_failed);
+    pthread_mutex_unlock(&g_lock);
+}
+
+int main(int argc, char **argv)
+{
+    pthread_t workers[CARDWARM_MAX_WORKERS];
+    pthread_t writer;
+    struct sigaction sa;
+    sigset_t stop_signals;
+    int worker_count = CARDWARM_DEFAULT_WORKERS;
+    int started = 0;
+    size_t limit = 0;
+    size_t total;
+    int opt;
+    int i;
+
+    while ((opt = getopt(argc, argv, "c:b:r:n:t:h")) != -1) {
+        switch (opt) {
+        case 'c': worker_count = atoi(optarg); break;
+        case 'b': g_batch = atoi(optarg); break;
+        case 'r': g_rate = atof(optarg); break;
+        case 'n': limit = (size_t) strtoull(optarg, NULL, 10); break;
+        case 't': g_timeout_ms = strtoull(optarg, NULL, 10); break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind != argc - 1 || worker_count <= 0 || worker_count > CARDWARM_MAX_WORKERS ||
+        g_batch <= 0 || g_batch > CARDWARM_MAX_BATCH || g_rate < 0 || g_timeout_ms == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    sa.sa_handler = sigint_handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+
+    ollama_init();
+    db_init_conninfo();
+
+    if (word_list_load(argv[optind], limit, &g_words) != 0) {
+        word_list_free(&g_words);
+        return 1;
+    }
+    if (word_list_drop_cached(&g_words) != 0) {
+        fprintf(stderr, "cardwarm: card_cache is not reachable, check PG* settings\n");
+        word_list_free(&g_words);
+        return 1;
+    }
+    total = g_words.count;
+    if (total == 0) {
+        word_list_free(&g_words);
+        return 0;
+    }
+
+    /* Сигналы остановки получает только главный поток: запросы к модели
+     * в рабочих потоках не прерываются на полпути. */
+    pthread_sigmask(SIG_BLOCK, &stop_signals, NULL);
+    if (pthread_create(&writer, NULL, writer_main, NULL) != 0) {
+        perror("pthread_create");
+        word_list_free(&g_words);
+        return 1;
+    }
+    for (i = 0; i < worker_count; i++) {
+        pthread_mutex_lock(&g_lock);
+        g_workers_running++;
+        pthread_mutex_unlock(&g_lock);
+        if (pthread_create(&workers[i], NULL, worker_main, NULL) != 0) {
+            perror("pthread_create");
+            pthread_mutex_lock(&g_lock);
+            g_workers_running--;
+            pthread_mutex_unlock(&g_lock);
+            break;
+        }
+        started++;
+    }
+    pthread_sigmask(SIG_UNBLOCK, &stop_signals, NULL);
+
+    /* Прогресс раз в несколько секунд, пока рабочие потоки заняты. */
+    for (i = 1;; i++) {
+        int running;
+
+        sleep_ms(1000);
+        pthread_mutex_lock(&g_lock);
+        running = g_workers_running;
+        pthread_mutex_unlock(&g_lock);
+        if (running == 0) {
+            break;
+        }
+        if (i % 5 == 0) {
+            print_progress(total);
+        }
+    }
+
+    for (i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    pthread_mutex_lock(&g_lock);
+    g_workers_done = 1;
+    pthread_cond_signal(&g_queue_cond);
+    pthread_mutex_unlock(&g_lock);
+    pthread_join(writer, NULL);
+
+    print_progress(total);
+    if (g_stop) {
+        fprintf(stderr, "cardwarm: interrupted, rerun to continue\n");
+    }
+
+    free(g_queue.items);
+    word_list_free(&g_words);
+    return g_stop || g_failed + g_store_failed > 0 ? 1 : 0;
+}
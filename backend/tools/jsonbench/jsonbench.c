@@ -0,0 +1,632 @@
+/*
+ * jsonbench — сборка JSON ответа задачи генерации: дерево cJSON +
+ * cJSON_PrintUnformatted против потокового json_writer_t, а также
+ * разбор и сборка cJSON через malloc и через арену запроса.
+ *
+ * Ответ повторяет GET /api/v1/generation-jobs/{id}: задача и N
+ * черновиков с кавычками, переводами строк, управляющими символами и
+ * UTF-8 в полях. Перед замером тексты обоих способов сверяются
+ * побайтно; аллокации cJSON считаются через cJSON_InitHooks. Арена
+ * ставится последней (json_arena_init заменяет хуки) и берёт размер
+ * куска из JSON_ARENA_KB, как сервер. В конце — скорость json_escape на
+ * 1 МБ ASCII, кириллицы и текста с частым экранированием против memcpy
+ * и побайтовой эталонной реализации.
+ *
+ *   bin/jsonbench [-d drafts] [-n iterations] [-b stack_bytes]
+ *   bin/jsonbench -f cases
+ *
+ * -f — дифференциальный фаззинг json_escape, json_escape_dup и
+ * json_write_string: случайные строки (кавычки, управляющие символы,
+ * '\0', кириллица, битый UTF-8, сдвиги относительно блоков SSE2)
+ * сверяются с эталоном по определению, с cJSON на корректном UTF-8 и
+ * разбираются cJSON_Parse.
+ */
+#include "libs/cJSON.h"
+#include "utils/json.h"
+#include "utils/json_arena.h"
+#include "utils/unicode.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define JSONBENCH_DEFAULT_DRAFTS 20
+#define JSONBENCH_DEFAULT_ITERATIONS 20000
+#define JSONBENCH_DEFAULT_STACK 8192
+#define JSONBENCH_MAX_STACK (1024 * 1024)
+#define JSONBENCH_FUZZ_MAX_LEN 300
+#define JSONBENCH_ESCAPE_SIZE (1024 * 1024)
+#define JSONBENCH_ESCAPE_ITERATIONS 50
+
+typedef struct {
+    int draft_id;
+    char word[64];
+    char transcription[64];
+    char translation[128];
+    char forms[128];
+    char examples[2][256];
+} jsonbench_draft_t;
+
+typedef struct {
+    int job_id;
+    char *text;
+    jsonbench_draft_t *drafts;
+    int draft_count;
+} jsonbench_job_t;
+
+static unsigned long long g_allocs = 0;
+
+static void *jsonbench_malloc(size_t size)
+{
+    g_allocs++;
+    return malloc(size);
+}
+
+static double jsonbench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+static void jsonbench_fill(jsonbench_job_t *job, int draft_count)
+{
+    static const char *words[] = { "run", "quote", "naïve", "tab", "line" };
+    size_t text_len = 0;
+    int i;
+
+    job->job_id = 42;
+    job->draft_count = draft_count;
+    job->drafts = calloc((size_t) (draft_count > 0 ? draft_count : 1), sizeof(*job->drafts));
+    job->text = malloc((size_t) draft_count * 64 + 64);
+    if (!job->drafts || !job->text) {
+        fprintf(stderr, "jsonbench: out of memory\n");
+        exit(1);
+    }
+    job->text[0] = '\0';
+
+    for (i = 0; i < draft_count; i++) {
+        jsonbench_draft_t *d = &job->drafts[i];
+        const char *word = words[i % 5];
+
+        d->draft_id = 1000 + i;
+        snprintf(d->word, sizeof(d->word), "%s%d", word, i);
+        snprintf(d->transcription, sizeof(d->transcription), "[ˈwɜːd%d]", i);
+        snprintf(d->translation, sizeof(d->translation), "слово №%d \"в кавычках\"", i);
+        snprintf(d->forms, sizeof(d->forms), "%s, %ss, %sed\\%sing", word, word, word, word);
+        snprintf(d->examples[0], sizeof(d->examples[0]),
+                 "He said: \"%s\" —\tand left.\nNext line\x01.", word);
+        snprintf(d->examples[1], sizeof(d->examples[1]),
+                 "Пример %d: «%s» в предложении.\r", i, word);
+        text_len += (size_t) snprintf(job->text + text_len, 64, "%s \"%d\"\n", word, i);
+    }
+}
+
+static cJSON *jsonbench_cjson_draft(const jsonbench_job_t *job, const jsonbench_draft_t *d)
+{
+    cJSON *json = cJSON_CreateObject();
+    cJSON *examples = cJSON_CreateArray();
+    int i;
+
+    cJSON_AddNumberToObject(json, "draft_id", d->draft_id);
+    cJSON_AddNumberToObject(json, "job_id", job->job_id);
+    cJSON_AddNumberToObject(json, "user_id", 7);
+    cJSON_AddNumberToObject(json, "saved_card_id", 0);
+    cJSON_AddStringToObject(json, "status", "draft");
+    cJSON_AddStringToObject(json, "word", d->word);
+    cJSON_AddStringToObject(json, "transcription", d->transcription);
+    cJSON_AddStringToObject(json, "translation", d->translation);
+    cJSON_AddStringToObject(json, "forms", d->forms);
+    for (i = 0; i < 2; i++) {
+        cJSON_AddItemToArray(examples, cJSON_CreateString(d->examples[i]));
+    }
+    cJSON_AddItemToObject(json, "examples", examples);
+    return json;
+}
+
+static char *jsonbench_cjson(const jsonbench_job_t *job)
+{
+    cJSON *json = cJSON_CreateObject();
+    cJSON *drafts = cJSON_CreateArray();
+    char *out;
+    int i;
+
+    cJSON_AddNumberToObject(json, "job_id", job->job_id);
+    cJSON_AddNumberToObject(json, "user_id", 7);
+    cJSON_AddStringToObject(json, "status", "completed");
+    cJSON_AddStringToObject(json, "text", job->text);
+    cJSON_AddNumberToObject(json, "total_words", job->draft_count);
+    cJSON_AddNumberToObject(json, "filtered_words", 0);
+    cJSON_AddNumberToObject(json, "existing_words", 0);
+    cJSON_AddNumberToObject(json, "generated_drafts", job->draft_count);
+    cJSON_AddNumberToObject(json, "reviewed_drafts", 0);
+    cJSON_AddNumberToObject(json, "failed_words", 0);
+    for (i = 0; i < job->draft_count; i++) {
+        cJSON_AddItemToArray(drafts, jsonbench_cjson_draft(job, &job->drafts[i]));
+    }
+    cJSON_AddItemToObject(json, "drafts", drafts);
+
+    out = cJSON_PrintUnformatted(json);
+    cJSON_Delete(json);
+    return out;
+}
+
+static void jsonbench_writer_draft(json_writer_t *w, const jsonbench_job_t *job,
+                                   const jsonbench_draft_t *d)
+{
+    int i;
+
+    json_write_object_begin(w);
+    json_write_field_int(w, "draft_id", d->draft_id);
+    json_write_field_int(w, "job_id", job->job_id);
+    json_write_field_int(w, "user_id", 7);
+    json_write_field_int(w, "saved_card_id", 0);
+    json_write_field_string(w, "status", "draft");
+    json_write_field_string(w, "word", d->word);
+    json_write_field_string(w, "transcription", d->transcription);
+    json_write_field_string(w, "translation", d->translation);
+    json_write_field_string(w, "forms", d->forms);
+    json_write_key(w, "examples");
+    json_write_array_begin(w);
+    for (i = 0; i < 2; i++) {
+        json_write_string(w, d->examples[i]);
+    }
+    json_write_array_end(w);
+    json_write_object_end(w);
+}
+
+static void jsonbench_writer(json_writer_t *w, const jsonbench_job_t *job)
+{
+    int i;
+
+    json_write_object_begin(w);
+    json_write_field_int(w, "job_id", job->job_id);
+    json_write_field_int(w, "user_id", 7);
+    json_write_field_string(w, "status", "completed");
+    json_write_field_string(w, "text", job->text);
+    json_write_field_int(w, "total_words", job->draft_count);
+    json_write_field_int(w, "filtered_words", 0);
+    json_write_field_int(w, "existing_words", 0);
+    json_write_field_int(w, "generated_drafts", job->draft_count);
+    json_write_field_int(w, "reviewed_drafts", 0);
+    json_write_field_int(w, "failed_words", 0);
+    json_write_key(w, "drafts");
+    json_write_array_begin(w);
+    for (i = 0; i < job->draft_count; i++) {
+        jsonbench_writer_draft(w, job, &job->drafts[i]);
+    }
+    json_write_array_end(w);
+    json_write_object_end(w);
+}
+
+/* Разбор ответа и удаление дерева — как обработчик разбирает тело запроса. */
+static size_t jsonbench_parse(const char *text, size_t len)
+{
+    cJSON *root = cJSON_ParseWithLength(text, len);
+    size_t drafts;
+
+    if (!root) {
+        fprintf(stderr, "jsonbench: parse failed\n");
+        exit(1);
+    }
+    drafts = (size_t) cJSON_GetArraySize(cJSON_GetObjectItemCaseSensitive(root, "drafts"));
+    cJSON_Delete(root);
+    return drafts;
+}
+
+static double jsonbench_cjson_loop(const jsonbench_job_t *job, const char *reference, int iterations,
+                                   int arena, double *parse_ns)
+{
+    volatile size_t sink = 0;
+    size_t reference_len = strlen(reference);
+    double start;
+    double build_ns;
+    int i;
+
+    start = jsonbench_now_ns();
+    for (i = 0; i < iterations; i++) {
+        char *out;
+
+        if (arena) {
+            json_arena_begin();
+        }
+        out = jsonbench_cjson(job);
+        sink += strlen(out);
+        cJSON_free(out);
+        if (arena) {
+            json_arena_end();
+        }
+    }
+    build_ns = (jsonbench_now_ns() - start) / iterations;
+
+    start = jsonbench_now_ns();
+    for (i = 0; i < iterations; i++) {
+        if (arena) {
+            json_arena_begin();
+        }
+        sink += jsonbench_parse(reference, reference_len);
+        if (arena) {
+            json_arena_end();
+        }
+    }
+    *parse_ns = (jsonbench_now_ns() - start) / iterations;
+
+    (void) sink;
+    return build_ns;
+}
+
+static unsigned long long jsonbench_rand(unsigned long long *state)
+{
+    /* xorshift64*: воспроизводимые строки при одинаковых параметрах. */
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ULL;
+}
+
+/*
+ * Эталон по определению: побайтово, с utf8_decode на каждом символе.
+ * out вмещает len * JSON_ESCAPE_MAX_EXPANSION байт. *valid — весь ли
+ * вход корректный UTF-8.
+ */
+static size_t jsonbench_reference_escape(const char *src, size_t len, char *out, int *valid)
+{
+    static const char hex[] = "0123456789abcdef";
+    const unsigned char *p = (const unsigned char *) src;
+    const unsigned char *end = p + len;
+    char *d = out;
+
+    *valid = 1;
+    while (p < end) {
+        unsigned char c = *p;
+        size_t seq_len;
+        uint32_t cp;
+
+        if (c == '"' || c == '\\') {
+            *d++ = '\\';
+            *d++ = (char) c;
+            p++;
+            continue;
+        }
+        if (c < 0x20) {
+            *d++ = '\\';
+            switch (c) {
+            case '\b': *d++ = 'b'; break;
+            case '\f': *d++ = 'f'; break;
+            case '\n': *d++ = 'n'; break;
+            case '\r': *d++ = 'r'; break;
+            case '\t': *d++ = 't'; break;
+            default:
+                *d++ = 'u';
+                *d++ = '0';
+                *d++ = '0';
+                *d++ = hex[c >> 4];
+                *d++ = hex[c & 0x0F];
+                break;
+            }
+            p++;
+            continue;
+        }
+        cp = utf8_decode(p, end, &seq_len);
+        if (cp == UNICODE_REPLACEMENT && seq_len == 1 && c >= 0x80) {
+            memcpy(d, "\\ufffd", 6);
+            d += 6;
+            *valid = 0;
+        } else {
+            memcpy(d, p, seq_len);
+            d += seq_len;
+        }
+        p += seq_len;
+    }
+    return (size_t) (d - out);
+}
+
+static void jsonbench_fuzz_text(unsigned long long *state, char *text, size_t len)
+{
+    static const char *const pieces[] = {
+        "a", "Z", " ", "\"", "\\", "\n", "\r", "\t", "\b", "\f", "\x01", "\x1f", "\x7f", "/",
+        "\xd0\x94", "\xd0\xb4", "\xc3\xa9", "\xe2\x80\x94", "\xe2\x80\xa8", "\xef\xbf\xbd",
+        "\xf0\x9f\x98\x80", "\x80", "\xff", "\xc3", "\xe2\x80", "\xed\xa0\x80", "\xc0\xaf",
+        "\xf4\x90\x80\x80", "\xf0\x9f\x98"
+    };
+    unsigned long long r = jsonbench_rand(state);
+    /* Часть строк почти чистая — длинные прогоны через блоки по 16 байт. */
+    int sparse = (r & 3) == 0;
+    size_t i = 0;
+
+    while (i < len) {
+        r = jsonbench_rand(state);
+        if (sparse && (r & 31) != 0) {
+            text[i++] = (char) ('a' + (r >> 8) % 26);
+        } else if ((r & 7) != 0) {
+            const char *piece = pieces[(r >> 8) % (sizeof(pieces) / sizeof(pieces[0]))];
+            size_t plen = strlen(piece);
+
+            if (plen > len - i) {
+                plen = len - i;
+            }
+            memcpy(text + i, piece, plen);
+            i += plen;
+        } else {
+            /* Любой байт, включая '\0'. */
+            text[i++] = (char) ((r >> 16) & 0xFF);
+        }
+    }
+}
+
+static int jsonbench_fuzz(int cases)
+{
+    unsigned long long state = 0x9E3779B97F4A7C15ULL;
+    char buffer[JSONBENCH_FUZZ_MAX_LEN + 64];
+    char expected[(JSONBENCH_FUZZ_MAX_LEN + 64) * JSON_ESCAPE_MAX_EXPANSION + 2];
+    char got[(JSONBENCH_FUZZ_MAX_LEN + 64) * JSON_ESCAPE_MAX_EXPANSION + 2];
+    int failures = 0;
+    int c;
+
+    for (c = 0; c < cases; c++) {
+        /* Сдвиг начала — невыровненные загрузки и разные хвосты блоков. */
+        size_t offset = jsonbench_rand(&state) % 32;
+        size_t len = jsonbench_rand(&state) % (JSONBENCH_FUZZ_MAX_LEN - offset);
+        char *text = buffer + offset;
+        char small[16];
+        json_writer_t w;
+        const char *written;
+        char *dup;
+        char *quoted;
+        size_t expected_len;
+        size_t got_len;
+        int valid;
+        int failed = 0;
+        cJSON *parsed;
+
+        jsonbench_fuzz_text(&state, text, len);
+        expected_len = jsonbench_reference_escape(text, len, expected, &valid);
+
+        got_len = json_escape(got, text, len);
+        if (got_len != expected_len || memcmp(got, expected, got_len) != 0) {
+            fprintf(stderr, "jsonbench: case %d (len %zu): json_escape differs from reference\n", c, len);
+            failed = 1;
+        }
+
+        dup = json_escape_dup(text, len, &got_len);
+        if (!dup || got_len != expected_len || memcmp(dup, expected, got_len) != 0 || dup[got_len] != '\0') {
+            fprintf(stderr, "jsonbench: case %d (len %zu): json_escape_dup differs from reference\n", c, len);
+            failed = 1;
+        }
+        free(dup);
+
+        /* Маленький стартовый буфер — запись идёт через несколько расширений. */
+        json_writer_init(&w, small, sizeof(small));
+        json_write_string_len(&w, text, len);
+        written = json_writer_finish(&w, &got_len);
+        if (!written || got_len != expected_len + 2 || written[0] != '"' ||
+            memcmp(written + 1, expected, expected_len) != 0 || written[got_len - 1] != '"') {
+            fprintf(stderr, "jsonbench: case %d (len %zu): json_write_string differs from reference\n", c, len);
+            failed = 1;
+        }
+
+        parsed = written ? cJSON_ParseWithLength(written, got_len) : NULL;
+        if (!parsed || !cJSON_IsString(parsed)) {
+            fprintf(stderr, "jsonbench: case %d (len %zu): output is not valid JSON\n", c, len);
+            failed = 1;
+        }
+        cJSON_Delete(parsed);
+
+        /* На корректном UTF-8 без '\0' вывод совпадает с cJSON. */
+        if (valid && memchr(text, '\0', len) == NULL) {
+            text[len] = '\0';
+            parsed = cJSON_CreateString(text);
+            quoted = parsed ? cJSON_PrintUnformatted(parsed) : NULL;
+            if (!quoted || !written || strlen(quoted) != got_len || memcmp(quoted, written, got_len) != 0) {
+                fprintf(stderr, "jsonbench: case %d (len %zu): output differs from cJSON\n", c, len);
+                failed = 1;
+            }
+            cJSON_free(quoted);
+            cJSON_Delete(parsed);
+        }
+        json_writer_free(&w);
+        failures += failed;
+    }
+
+    printf("fuzz: %d cases, %d mismatches\n", cases, failures);
+    return failures;
+}
+
+static void jsonbench_escape_input(char *text, size_t size, int kind)
+{
+    static const char *const ascii[] = { "the ", "quick ", "brown ", "fox ", "jumps ", "over ", "a ", "lazy ", "dog. " };
+    static const char *const cyrillic[] = { "быстрая ", "рыжая ", "лиса ", "прыгает ", "через ", "ленивую ", "собаку. " };
+    static const char *const noisy[] = { "He said \"hi\"\n", "C:\\path\\to\t", "line\r\n", "ok ", "\x01\x02 " };
+    const char *const *pieces = kind == 0 ? ascii : kind == 1 ? cyrillic : noisy;
+    size_t count = kind == 0 ? 9 : kind == 1 ? 7 : 5;
+    unsigned long long state = 0x2545F4914F6CDD1DULL;
+    size_t i = 0;
+
+    while (i < size) {
+        const char *piece = pieces[jsonbench_rand(&state) % count];
+        size_t plen = strlen(piece);
+
+        if (plen > size - i) {
+            /* Кириллицу не режем посередине символа. */
+            memset(text + i, ' ', size - i);
+            break;
+        }
+        memcpy(text + i, piece, plen);
+        i += plen;
+    }
+}
+
+static void jsonbench_escape_speed(void)
+{
+    static const char *const names[] = { "ascii", "cyrillic", "escapes" };
+    char *text = malloc(JSONBENCH_ESCAPE_SIZE);
+    char *out = malloc((size_t) JSONBENCH_ESCAPE_SIZE * JSON_ESCAPE_MAX_EXPANSION);
+    volatile size_t sink = 0;
+    int kind;
+    int i;
+
+    if (!text || !out) {
+        fprintf(stderr, "jsonbench: out of memory\n");
+        free(text);
+        free(out);
+        return;
+    }
+
+    for (kind = 0; kind < 3; kind++) {
+        double mb = (double) JSONBENCH_ESCAPE_SIZE * JSONBENCH_ESCAPE_ITERATIONS / (1024.0 * 1024.0);
+        double memcpy_ms;
+        double escape_ms;
+        double reference_ms;
+        double start;
+        int valid;
+
+        jsonbench_escape_input(text, JSONBENCH_ESCAPE_SIZE, kind);
+
+        start = jsonbench_now_ns();
+        for (i = 0; i < JSONBENCH_ESCAPE_ITERATIONS; i++) {
+            memcpy(out, text, JSONBENCH_ESCAPE_SIZE);
+            sink += (unsigned char) out[i];
+        }
+        memcpy_ms = (jsonbench_now_ns() - start) / 1e6;
+
+        start = jsonbench_now_ns();
+        for (i = 0; i < JSONBENCH_ESCAPE_ITERATIONS; i++) {
+            sink += json_escape(out, text, JSONBENCH_ESCAPE_SIZE);
+        }
+        escape_ms = (jsonbench_now_ns() - start) / 1e6;
+
+        start = jsonbench_now_ns();
+        for (i = 0; i < JSONBENCH_ESCAPE_ITERATIONS; i++) {
+            sink += jsonbench_reference_escape(text, JSONBENCH_ESCAPE_SIZE, out, &valid);
+        }
+        reference_ms = (jsonbench_now_ns() - start) / 1e6;
+
+        printf("escape %-8s  memcpy %7.0f MB/s  json_escape %7.0f MB/s  bytewise %7.0f MB/s\n",
+               names[kind], mb / (memcpy_ms / 1000.0), mb / (escape_ms / 1000.0),
+               mb / (reference_ms / 1000.0));
+    }
+
+    (void) sink;
+    free(text);
+    free(out);
+}
+
+static void jsonbench_usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [-d drafts] [-n iterations] [-b stack_bytes]\n"
+                    "       %s -f cases\n", argv0, argv0);
+}
+
+int main(int argc, char **argv)
+{
+    cJSON_Hooks hooks = { jsonbench_malloc, free };
+    int draft_count = JSONBENCH_DEFAULT_DRAFTS;
+    int iterations = JSONBENCH_DEFAULT_ITERATIONS;
+    size_t stack_size = JSONBENCH_DEFAULT_STACK;
+    jsonbench_job_t job;
+    json_writer_t w;
+    char *stack;
+    char *reference;
+    const char *text;
+    size_t len;
+    unsigned long long spills = 0;
+    volatile size_t sink = 0;
+    json_arena_stats_t arena_stats;
+    double start;
+    double cjson_ns;
+    double parse_ns;
+    double writer_ns;
+    double arena_ns;
+    double arena_parse_ns;
+    int fuzz_cases = 0;
+    int opt;
+    int i;
+
+    while ((opt = getopt(argc, argv, "d:n:b:f:h")) != -1) {
+        switch (opt) {
+        case 'd':
+            draft_count = atoi(optarg);
+            break;
+        case 'n':
+            iterations = atoi(optarg);
+            break;
+        case 'b':
+            stack_size = (size_t) strtoul(optarg, NULL, 10);
+            break;
+        case 'f':
+            fuzz_cases = atoi(optarg);
+            break;
+        default:
+            jsonbench_usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (fuzz_cases > 0) {
+        return jsonbench_fuzz(fuzz_cases) == 0 ? 0 : 1;
+    }
+    if (draft_count < 0 || iterations <= 0 || stack_size > JSONBENCH_MAX_STACK) {
+        jsonbench_usage(argv[0]);
+        return 2;
+    }
+
+    cJSON_InitHooks(&hooks);
+    jsonbench_fill(&job, draft_count);
+    stack = malloc(stack_size > 0 ? stack_size : 1);
+    reference = jsonbench_cjson(&job);
+    if (!stack || !reference) {
+        fprintf(stderr, "jsonbench: out of memory\n");
+        return 1;
+    }
+
+    json_writer_init(&w, stack, stack_size);
+    jsonbench_writer(&w, &job);
+    text = json_writer_finish(&w, &len);
+    if (!text || len != strlen(reference) || memcmp(text, reference, len) != 0) {
+        fprintf(stderr, "jsonbench: writer output differs from cJSON\n  cjson:  %s\n  writer: %s\n",
+                reference, text ? text : "(null)");
+        return 1;
+    }
+    json_writer_free(&w);
+    printf("drafts=%d bytes=%zu identical\n", draft_count, len);
+
+    g_allocs = 0;
+    cjson_ns = jsonbench_cjson_loop(&job, reference, iterations, 0, &parse_ns);
+    printf("cjson   %10.0f ns/op  parse %10.0f ns/op  %6.1f allocs/op\n",
+           cjson_ns, parse_ns, (double) g_allocs / iterations);
+
+    start = jsonbench_now_ns();
+    for (i = 0; i < iterations; i++) {
+        json_writer_init(&w, stack, stack_size);
+        jsonbench_writer(&w, &job);
+        text = json_writer_finish(&w, &len);
+        sink += len;
+        spills += w.heap != NULL;
+        json_writer_free(&w);
+    }
+    writer_ns = (jsonbench_now_ns() - start) / iterations;
+    printf("writer  %10.0f ns/op  heap spills %llu/%d (stack %zu bytes)  x%.1f\n",
+           writer_ns, spills, iterations, stack_size, writer_ns > 0 ? cjson_ns / writer_ns : 0.0);
+
+    json_arena_init();
+    json_arena_get_stats(&arena_stats);
+    if (arena_stats.chunk_size > 0) {
+        arena_ns = jsonbench_cjson_loop(&job, reference, iterations, 1, &arena_parse_ns);
+        json_arena_get_stats(&arena_stats);
+        printf("arena   %10.0f ns/op  parse %10.0f ns/op  peak %zu bytes, %llu extra chunks, "
+               "%llu heap allocs (chunk %zu KB)\n",
+               arena_ns, arena_parse_ns, arena_stats.peak_bytes, arena_stats.extra_chunks,
+               arena_stats.heap_allocations, arena_stats.chunk_size / 1024);
+    }
+
+    jsonbench_escape_speed();
+
+    (void) sink;
+    free(reference);
+    free(stack);
+    free(job.text);
+    free(job.drafts);
+    return 0;
+}
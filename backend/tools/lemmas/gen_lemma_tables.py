@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+# tools/lemmas/gen_lemma_tables.py
+#
+# Генерирует src/utils/lemma_tables.h из tools/lemmas/irregular.txt:
+# все строки (формы и леммы, без повторов) лежат одним блоком
+# lemma_strings, пары {форма, лемма} — смещения в нём, отсортированные
+# по форме для двоичного поиска.
+#
+#   python3 tools/lemmas/gen_lemma_tables.py > src/utils/lemma_tables.h
+import os
+import sys
+
+SOURCE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "irregular.txt")
+
+
+def load_pairs(path):
+    pairs = {}
+    with open(path, encoding="utf-8") as f:
+        for number, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            lemma, _, forms = line.partition(":")
+            lemma = lemma.strip()
+            forms = forms.split()
+            if not lemma or not forms:
+                sys.exit("%s:%d: expected 'lemma: form ...'" % (path, number))
+            for form in forms:
+                if form in pairs and pairs[form] != lemma:
+                    sys.exit("%s:%d: '%s' already maps to '%s'" % (path, number, form, pairs[form]))
+                if not form.isascii() or form != form.lower():
+                    sys.exit("%s:%d: '%s' must be lowercase ASCII" % (path, number, form))
+                pairs[form] = lemma
+    return pairs
+
+
+def main():
+    pairs = load_pairs(SOURCE)
+    offsets = {}
+    blob = []
+    size = 0
+    for form in sorted(pairs):
+        for s in (form, pairs[form]):
+            if s not in offsets:
+                offsets[s] = size
+                blob.append(s)
+                size += len(s) + 1
+    if size > 0xFFFF:
+        sys.exit("string block is too large for uint16_t offsets")
+
+    out = sys.stdout
+    out.write("/* Сгенерировано tools/lemmas/gen_lemma_tables.py из irregular.txt. Не править вручную. */\n")
+    out.write("#ifndef UTILS_LEMMA_TABLES_H\n#define UTILS_LEMMA_TABLES_H\n\n")
+    out.write("#include <stdint.h>\n\n")
+    out.write("/* %d строк, %d байт. */\n" % (len(blob), size))
+    out.write("static const char lemma_strings[] =\n")
+    for s in blob:
+        out.write('    "%s\\0"\n' % s)
+    out.write("    ;\n\n")
+    out.write("/* {форма, лемма}: смещения в lemma_strings, по возрастанию формы (strcmp). */\n")
+    out.write("static const uint16_t lemma_pairs[][2] = {\n")
+    for form in sorted(pairs):
+        out.write("    {%d, %d}, /* %s -> %s */\n" % (offsets[form], offsets[pairs[form]], form, pairs[form]))
+    out.write("};\n\n#endif\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+# tools/stopwords/gen_stopword_table.py
+#
+# Собирает из списка стоп-слов (tools/stopwords/stopwords.txt) минимальную
+# совершенную хеш-таблицу для src/utils/stopwords.c: n слов в n слотах,
+# поиск — два хеша и одно сравнение строк. Схема "hash and displace":
+# слова раскладываются по n корзинам первым хешем, для каждой корзины
+# подбирается сдвиг d, при котором второй хеш разводит её слова по
+# свободным слотам. Корзина из одного слова получает свободный слот
+# напрямую (d < 0). Хеш — FNV-1a с затравкой, см. hash_fnv1a_str.
+#
+#   python3 tools/stopwords/gen_stopword_table.py stopwords.txt src/utils/stopword_table.h
+#
+# Файл перезаписывается, только если содержимое изменилось: make зовёт
+# генератор при каждой сборке, а stopwords.o пересобирается лишь при
+# правке списка или смене STOPWORDS.
+import io
+import os
+import sys
+
+FNV_BASIS = 0x811C9DC5
+FNV_PRIME = 0x01000193
+
+
+def fnv(seed, data):
+    h = FNV_BASIS ^ seed
+    for b in data:
+        h = ((h ^ b) * FNV_PRIME) & 0xFFFFFFFF
+    return h
+
+
+def load(path):
+    words = {}
+    level = 0
+    with open(path, encoding="utf-8") as f:
+        for number, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            if line.startswith("@level"):
+                try:
+                    level = int(line.split()[1])
+                except (IndexError, ValueError):
+                    sys.exit("%s:%d: expected '@level N'" % (path, number))
+                if not 0 <= level <= 255:
+                    sys.exit("%s:%d: level must be 0..255" % (path, number))
+                continue
+            for word in line.split():
+                if word != word.lower():
+                    sys.exit("%s:%d: '%s' must be lowercase" % (path, number, word))
+                # Повтор оставляет меньший уровень: слово известно раньше.
+                words[word] = min(level, words.get(word, level))
+    if not words:
+        sys.exit("%s: no words" % path)
+    return words
+
+
+def build(keys):
+    n = len(keys)
+    buckets = [[] for _ in range(n)]
+    for key in keys:
+        buckets[fnv(0, key) % n].append(key)
+
+    displace = [0] * n
+    slots = [None] * n
+    for b in sorted(range(n), key=lambda i: -len(buckets[i])):
+        bucket = buckets[b]
+        if len(bucket) <= 1:
+            break
+        d = 1
+        while True:
+            taken = [fnv(d, key) % n for key in bucket]
+            if len(set(taken)) == len(taken) and all(slots[s] is None for s in taken):
+                break
+            d += 1
+        displace[b] = d
+        for key, s in zip(bucket, taken):
+            slots[s] = key
+
+    free = [s for s in range(n) if slots[s] is None]
+    for b in range(n):
+        if len(buckets[b]) == 1:
+            s = free.pop()
+            displace[b] = -s - 1
+            slots[s] = buckets[b][0]
+    return displace, slots
+
+
+def lookup(displace, slots, key):
+    n = len(slots)
+    d = displace[fnv(0, key) % n]
+    s = -d - 1 if d < 0 else fnv(d, key) % n
+    return slots[s] == key
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: gen_stopword_table.py stopwords.txt output.h")
+    words = load(sys.argv[1])
+    keys = {w.encode("utf-8"): lvl for w, lvl in words.items()}
+    displace, slots = build(sorted(keys))
+    assert all(lookup(displace, slots, k) for k in keys)
+
+    offsets = []
+    size = 0
+    for key in slots:
+        offsets.append(size)
+        size += len(key) + 1
+    offset_type = "uint16_t" if size <= 0xFFFF else "uint32_t"
+
+    out = io.StringIO()
+    out.write("/* Сгенерировано tools/stopwords/gen_stopword_table.py из %s. Не править вручную. */\n"
+              % sys.argv[1])
+    out.write("#ifndef UTILS_STOPWORD_TABLE_H\n#define UTILS_STOPWORD_TABLE_H\n\n#include <stdint.h>\n\n")
+    out.write("#define STOPWORD_COUNT %d\n" % len(slots))
+    out.write("#define STOPWORD_MAX_LEVEL %d\n\n" % max(keys.values()))
+    out.write("/* Сдвиг корзины: > 0 — затравка второго хеша, < 0 — слот -d - 1. */\n")
+    out.write("static const int32_t stopword_displace[STOPWORD_COUNT] = {\n")
+    for i in range(0, len(displace), 12):
+        out.write("    " + ", ".join(str(d) for d in displace[i:i + 12]) + ",\n")
+    out.write("};\n\n")
+    out.write("static const uint8_t stopword_levels[STOPWORD_COUNT] = {\n")
+    levels = [keys[k] for k in slots]
+    for i in range(0, len(levels), 24):
+        out.write("    " + ", ".join(str(v) for v in levels[i:i + 24]) + ",\n")
+    out.write("};\n\n")
+    out.write("static const %s stopword_offsets[STOPWORD_COUNT] = {\n" % offset_type)
+    for i in range(0, len(offsets), 12):
+        out.write("    " + ", ".join(str(o) for o in offsets[i:i + 12]) + ",\n")
+    out.write("};\n\n")
+    # Каждое слово — отдельный литерал: иначе "\0" перед словом, которое
+    # начинается с цифры 0-7, склеится с ней в восьмеричную escape-последовательность.
+    out.write("/* Слова в порядке слотов. */\nstatic const char stopword_strings[] =\n")
+    for i in range(0, len(slots), 8):
+        chunk = " ".join('"%s\\0"' % k.decode("utf-8").replace("\\", "\\\\").replace('"', '\\"')
+                         for k in slots[i:i + 8])
+        out.write("    %s\n" % chunk)
+    out.write("    ;\n\n#endif\n")
+
+    text = out.getvalue()
+    try:
+        with open(sys.argv[2], encoding="utf-8") as f:
+            if f.read() == text:
+                return
+    except FileNotFoundError:
+        pass
+    tmp = sys.argv[2] + ".tmp"
+    with open(tmp, "w", encoding="utf-8") as f:
+        f.write(text)
+    os.replace(tmp, sys.argv[2])
+    print("stopwords: %d words, levels 0..%d -> %s" % (len(slots), max(keys.values()), sys.argv[2]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,515 @@
+/*
+ * tokbench — замер extract_unique_words на больших текстах.
+ *
+ * Без аргументов генерирует синтетический текст (по умолчанию 1 МБ):
+ * слова из словаря с распределением, близким к ципфовскому, случайный
+ * регистр и пунктуация. С файлом — токенизирует его содержимое.
+ *
+ *   bin/tokbench [-s size_kb] [-v vocabulary] [-n iterations]
+ *                [-t threads] [-k auto|scalar|sse2|avx2] [file]
+ *   bin/tokbench -f cases
+ *
+ * Без -k замеряются все доступные ядра. -t запускает одновременно
+ * несколько потоков на одном тексте и сверяет результат: токенизатор
+ * не должен зависеть от соседей.
+ *
+ * -f — дифференциальный фаззинг: случайные тексты (с упором на
+ * границы блоков, соединители, не-ASCII и битый UTF-8) прогоняются
+ * через все ядра и сверяются с эталонной реализацией по определению.
+ */
+#include "utils/tokenizer.h"
+#include "utils/unicode.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TOKBENCH_DEFAULT_SIZE_KB 1024
+#define TOKBENCH_DEFAULT_VOCABULARY 50000
+#define TOKBENCH_DEFAULT_ITERATIONS 20
+#define TOKBENCH_MAX_THREADS 64
+#define TOKBENCH_FUZZ_MAX_LEN 300
+
+static const tokenizer_kernel_t tokbench_kernels[] = {
+    TOKENIZER_KERNEL_SCALAR, TOKENIZER_KERNEL_SSE2, TOKENIZER_KERNEL_AVX2
+};
+
+typedef struct {
+    const char *text;
+    tokenizer_kernel_t kernel;
+    int iterations;
+    int word_count;
+    unsigned long long checksum;
+    double best_ms;
+    double total_ms;
+} tokbench_run_t;
+
+static double tokbench_now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1000.0 + (double) ts.tv_nsec / 1e6;
+}
+
+static unsigned long long tokbench_rand(unsigned long long *state)
+{
+    /* xorshift64*: воспроизводимый текст при одинаковых параметрах. */
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ULL;
+}
+
+static char *tokbench_generate(size_t size, int vocabulary)
+{
+    static const char punct[] = ".,;:!?\"')";
+    unsigned long long state = 0x9E3779B97F4A7C15ULL;
+    char *text = malloc(size + 64);
+    size_t used = 0;
+
+    if (!text) {
+        return NULL;
+    }
+
+    while (used < size) {
+        /* Куб равномерного числа смещает выбор к началу словаря. */
+        double u = (double) (tokbench_rand(&state) % 1000000) / 1000000.0;
+        unsigned long long id = (unsigned long long) (u * u * u * vocabulary);
+        unsigned long long r = tokbench_rand(&state);
+        /* Написание слова — функция его номера в словаре. */
+        unsigned long long h = (id + 1) * 0x9E3779B97F4A7C15ULL;
+        int len;
+        int i;
+
+        h ^= h >> 29;
+        len = 3 + (int) (h % 9);
+        for (i = 0; i < len; i++) {
+            char c = (char) ('a' + (h >> (i * 5 + 4)) % 26);
+            if (i == 0 && (r & 7) == 0) {
+                c = (char) (c - 'a' + 'A');
+            }
+            text[used++] = c;
+        }
+        if ((r >> 8) % 6 == 0) {
+            text[used++] = punct[(r >> 16) % (sizeof(punct) - 1)];
+        }
+        text[used++] = (r >> 24) % 12 == 0 ? '\n' : ' ';
+    }
+    text[used] = '\0';
+    return text;
+}
+
+static char *tokbench_read_file(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    char *text;
+    long size;
+
+    if (!f) {
+        perror(path);
+        return NULL;
+    }
+    if (fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) < 0 || fseek(f, 0, SEEK_SET) != 0) {
+        fclose(f);
+        return NULL;
+    }
+    text = malloc((size_t) size + 1);
+    if (text && fread(text, 1, (size_t) size, f) != (size_t) size) {
+        free(text);
+        text = NULL;
+    }
+    if (text) {
+        text[size] = '\0';
+    }
+    fclose(f);
+    return text;
+}
+
+static void *tokbench_main(void *arg)
+{
+    tokbench_run_t *run = arg;
+    int i;
+
+    run->best_ms = -1.0;
+    for (i = 0; i < run->iterations; i++) {
+        double started = tokbench_now_ms();
+        int count = 0;
+        char **words = extract_unique_words_with(run->text, &count, run->kernel);
+        double elapsed = tokbench_now_ms() - started;
+        unsigned long long checksum = 0;
+        int w;
+
+        if (!words) {
+            run->word_count = -1;
+            return NULL;
+        }
+        for (w = 0; w < count; w++) {
+            checksum = checksum * 1099511628211ULL + (unsigned char) words[w][0] + strlen(words[w]);
+        }
+        free_word_list(words, count);
+
+        run->word_count = count;
+        run->checksum = checksum;
+        run->total_ms += elapsed;
+        if (run->best_ms < 0 || elapsed < run->best_ms) {
+            run->best_ms = elapsed;
+        }
+    }
+    return NULL;
+}
+
+static int tokbench_ref_class(uint32_t cp)
+{
+    if (cp >= '0' && cp <= '9') {
+        return 'd';
+    }
+    if (cp == '\'' || cp == 0x2019 || cp == 0x02BC) {
+        return '\'';
+    }
+    if (cp == '-' || cp == 0x2010 || cp == 0x2011) {
+        return '-';
+    }
+    return unicode_is_letter(cp) ? 'L' : 0;
+}
+
+/*
+ * Эталон по определению, без блоков и быстрого пути: куски по пробельным
+ * байтам, ссылки и почта отбрасываются; в куске помечаем, какие символы
+ * остаются в словах (буквы и соединители между двумя буквами), токены с
+ * цифрами вычёркиваем, слова — отрезки помеченных символов.
+ */
+static char **tokbench_reference(const char *text, int *count)
+{
+    size_t len = strlen(text);
+    char *copy = strdup(text);
+    char *out = malloc(len * 2 + 16);
+    char **words = calloc(len / 2 + 2, sizeof(*words));
+    uint32_t *cps = malloc((len + 1) * sizeof(*cps));
+    char *keep = malloc(len + 1);
+    char *saveptr = NULL;
+    char *chunk;
+    size_t used = 0;
+    int n = 0;
+
+    if (!copy || !out || !words || !cps || !keep) {
+        free(copy);
+        free(out);
+        free(words);
+        free(cps);
+        free(keep);
+        return NULL;
+    }
+    for (chunk = strtok_r(copy, " \t\n\v\f\r", &saveptr); chunk; chunk = strtok_r(NULL, " \t\n\v\f\r", &saveptr)) {
+        const unsigned char *p = (const unsigned char *) chunk;
+        const unsigned char *end = p + strlen(chunk);
+        size_t m = 0;
+        size_t a;
+        size_t b;
+
+        if (strncasecmp(chunk, "www.", 4) == 0 || strchr(chunk, '@') || strstr(chunk, "://")) {
+            continue;
+        }
+        while (p < end) {
+            size_t clen;
+            cps[m++] = utf8_decode(p, end, &clen);
+            p += clen;
+        }
+        for (a = 0; a < m; a++) {
+            int c = tokbench_ref_class(cps[a]);
+            keep[a] = c == 'L' ||
+                      ((c == '\'' || c == '-') && a > 0 && a + 1 < m &&
+                       tokbench_ref_class(cps[a - 1]) == 'L' && tokbench_ref_class(cps[a + 1]) == 'L');
+        }
+        /* Токен с цифрой вычёркиваем целиком. */
+        for (a = 0; a < m; a = b) {
+            int digit = 0;
+
+            for (b = a; b < m && tokbench_ref_class(cps[b]) != 0; b++) {
+                digit |= tokbench_ref_class(cps[b]) == 'd';
+            }
+            if (digit) {
+                memset(keep + a, 0, b - a);
+            }
+            if (b == a) {
+                b++;
+            }
+        }
+        for (a = 0; a < m; a = b + 1) {
+            char *word = out + used;
+            size_t wlen = 0;
+            size_t wcps;
+            int i;
+
+            for (b = a; b < m && keep[b]; b++) {
+                int c = tokbench_ref_class(cps[b]);
+                if (c == 'L') {
+                    wlen += utf8_encode(unicode_fold(cps[b]), word + wlen);
+                } else {
+                    word[wlen++] = (char) c;
+                }
+            }
+            wcps = b - a;
+            if (wlen >= 2 && strncmp(word + wlen - 2, "'s", 2) == 0) {
+                wlen -= 2;
+                wcps -= 2;
+            }
+            if (wcps < 2 || wcps > 40) {
+                continue;
+            }
+            word[wlen] = '\0';
+            for (i = 0; i < n && strcmp(words[i], word) != 0; ++i) {
+            }
+            if (i == n) {
+                words[n++] = word;
+                used += wlen + 1;
+            }
+        }
+    }
+
+    free(copy);
+    free(cps);
+    free(keep);
+    *count = n;
+    /* Строки живут в out: вызывающий освобождает words[-1]. */
+    memmove(words + 1, words, (size_t) n * sizeof(*words));
+    words[0] = out;
+    return words + 1;
+}
+
+static void tokbench_fuzz_text(unsigned long long *state, char *text, size_t len)
+{
+    /* Фрагменты с подвохом: соединители, кавычки, тире, кириллица,
+     * символы с неоднозначной свёрткой, битый UTF-8, ссылки. */
+    static const char *const pieces[] = {
+        "a", "Z", "q", " ", "\t", "\r\n", "\v", ".", ",", "'", "-", "!", "@", "1", "7",
+        "\xe2\x80\x99", "\xca\xbc", "\xe2\x80\x90", "\xe2\x80\x91", "\xe2\x80\x94", "\xe2\x80\x9c",
+        "\xe2\x80\xa6", "\xc2\xa0", "\xd0\x94", "\xd0\xb4", "\xc3\x89", "\xc3\x9f", "\xce\xa3",
+        "\xe2\x84\xaa", "\xc8\xba", "\xcc\x81", "\xf0\x9f\x98\x80", "\xf0\x90\x90\x80",
+        "\x80", "\xff", "\xc3", "\xe2\x80", "\xed\xa0\x80", "\xc0\xaf",
+        "'s", "\xe2\x80\x99s", "http://", "www.", "://", "don't", "well-known"
+    };
+    unsigned long long r = tokbench_rand(state);
+    /* Часть текстов почти без разделителей — длинные токены через блоки. */
+    int sparse = (r & 3) == 0;
+    size_t i = 0;
+
+    while (i < len) {
+        r = tokbench_rand(state);
+        if (sparse && (r & 15) != 0) {
+            text[i++] = (char) ('a' + (r >> 8) % 26);
+        } else if ((r & 3) != 0) {
+            const char *piece = pieces[(r >> 8) % (sizeof(pieces) / sizeof(pieces[0]))];
+            size_t plen = strlen(piece);
+
+            if (plen > len - i) {
+                plen = len - i;
+            }
+            memcpy(text + i, piece, plen);
+            i += plen;
+        } else {
+            /* Любой ненулевой байт. */
+            text[i++] = (char) (1 + (r >> 16) % 255);
+        }
+    }
+    text[len] = '\0';
+}
+
+static int tokbench_fuzz(int cases)
+{
+    unsigned long long state = 0xD1B54A32D192ED03ULL;
+    char buffer[TOKBENCH_FUZZ_MAX_LEN + 64];
+    int failures = 0;
+    int c;
+
+    for (c = 0; c < cases; c++) {
+        /* Сдвиг начала — невыровненные загрузки и разные хвосты блоков. */
+        size_t offset = tokbench_rand(&state) % 32;
+        size_t len = tokbench_rand(&state) % (TOKBENCH_FUZZ_MAX_LEN - offset);
+        char *text = buffer + offset;
+        char **expected;
+        int expected_count = 0;
+        size_t k;
+
+        tokbench_fuzz_text(&state, text, len);
+        expected = tokbench_reference(text, &expected_count);
+        if (!expected) {
+            return -1;
+        }
+
+        for (k = 0; k < sizeof(tokbench_kernels) / sizeof(tokbench_kernels[0]); k++) {
+            tokenizer_kernel_t kernel = tokbench_kernels[k];
+            int count = 0;
+            char **words;
+            int i;
+
+            if (!tokenizer_kernel_available(kernel)) {
+                continue;
+            }
+            words = extract_unique_words_with(text, &count, kernel);
+            if (!words) {
+                free(expected[-1]);
+                free(expected - 1);
+                return -1;
+            }
+            for (i = 0; i < count && i < expected_count && strcmp(words[i], expected[i]) == 0; i++) {
+            }
+            if (count != expected_count || i != count) {
+                fprintf(stderr, "tokbench: case %d (len %zu, offset %zu): %s gave %d words, expected %d, first difference at %d\n",
+                        c, len, offset, tokenizer_kernel_name(kernel), count, expected_count, i);
+                failures++;
+            }
+            free_word_list(words, count);
+        }
+        free(expected[-1]);
+        free(expected - 1);
+    }
+
+    printf("fuzz: %d cases, %d mismatches\n", cases, failures);
+    return failures;
+}
+
+static int tokbench_parse_kernel(const char *name, tokenizer_kernel_t *out)
+{
+    tokenizer_kernel_t kernels[] = {
+        TOKENIZER_KERNEL_AUTO, TOKENIZER_KERNEL_SCALAR, TOKENIZER_KERNEL_SSE2, TOKENIZER_KERNEL_AVX2
+    };
+    size_t i;
+
+    for (i = 0; i < sizeof(kernels) / sizeof(kernels[0]); i++) {
+        if (strcmp(name, tokenizer_kernel_name(kernels[i])) == 0) {
+            *out = kernels[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* Один замер: thread_count потоков одного ядра; 0 — успех. */
+static int tokbench_measure(const char *text, tokenizer_kernel_t kernel, int iterations, int thread_count)
+{
+    tokbench_run_t runs[TOKBENCH_MAX_THREADS];
+    pthread_t threads[TOKBENCH_MAX_THREADS];
+    double mb = (double) strlen(text) / (1024.0 * 1024.0);
+    int i;
+
+    memset(runs, 0, sizeof(runs));
+    for (i = 0; i < thread_count; i++) {
+        runs[i].text = text;
+        runs[i].kernel = kernel;
+        runs[i].iterations = iterations;
+        if (i > 0 && pthread_create(&threads[i], NULL, tokbench_main, &runs[i]) != 0) {
+            fprintf(stderr, "tokbench: failed to start thread %d\n", i);
+            thread_count = i;
+            break;
+        }
+    }
+    tokbench_main(&runs[0]);
+    for (i = 1; i < thread_count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (i = 0; i < thread_count; i++) {
+        if (runs[i].word_count < 0) {
+            fprintf(stderr, "tokbench: tokenizer failed\n");
+            return 1;
+        }
+        if (runs[i].word_count != runs[0].word_count || runs[i].checksum != runs[0].checksum) {
+            fprintf(stderr, "tokbench: thread %d got a different result\n", i);
+            return 1;
+        }
+    }
+
+    printf("%-6s input %.2f MB, %d unique words, %d iterations x %d threads: "
+           "best %.2f ms (%.1f MB/s), avg %.2f ms\n",
+           tokenizer_kernel_name(kernel), mb, runs[0].word_count, iterations, thread_count,
+           runs[0].best_ms, mb / (runs[0].best_ms / 1000.0), runs[0].total_ms / iterations);
+    return 0;
+}
+
+static void tokbench_usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [-s size_kb] [-v vocabulary] [-n iterations] [-t threads]\n"
+                    "       [-k auto|scalar|sse2|avx2] [file]\n"
+                    "       %s -f cases\n", argv0, argv0);
+}
+
+int main(int argc, char **argv)
+{
+    size_t size_kb = TOKBENCH_DEFAULT_SIZE_KB;
+    int vocabulary = TOKBENCH_DEFAULT_VOCABULARY;
+    int iterations = TOKBENCH_DEFAULT_ITERATIONS;
+    int thread_count = 1;
+    int fuzz_cases = 0;
+    int kernel_given = 0;
+    tokenizer_kernel_t kernel = TOKENIZER_KERNEL_AUTO;
+    char *text;
+    int rc = 0;
+    int opt;
+    size_t k;
+
+    while ((opt = getopt(argc, argv, "s:v:n:t:k:f:h")) != -1) {
+        switch (opt) {
+        case 's':
+            size_kb = (size_t) strtoul(optarg, NULL, 10);
+            break;
+        case 'v':
+            vocabulary = atoi(optarg);
+            break;
+        case 'n':
+            iterations = atoi(optarg);
+            break;
+        case 't':
+            thread_count = atoi(optarg);
+            break;
+        case 'k':
+            if (tokbench_parse_kernel(optarg, &kernel) != 0) {
+                tokbench_usage(argv[0]);
+                return 2;
+            }
+            kernel_given = 1;
+            break;
+        case 'f':
+            fuzz_cases = atoi(optarg);
+            break;
+        default:
+            tokbench_usage(argv[0]);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (fuzz_cases > 0) {
+        return tokbench_fuzz(fuzz_cases) == 0 ? 0 : 1;
+    }
+    if (size_kb == 0 || vocabulary <= 0 || iterations <= 0 ||
+        thread_count <= 0 || thread_count > TOKBENCH_MAX_THREADS) {
+        tokbench_usage(argv[0]);
+        return 2;
+    }
+    if (!tokenizer_kernel_available(kernel)) {
+        fprintf(stderr, "tokbench: kernel %s is not available on this CPU\n", tokenizer_kernel_name(kernel));
+        return 1;
+    }
+
+    text = optind < argc ? tokbench_read_file(argv[optind]) : tokbench_generate(size_kb * 1024, vocabulary);
+    if (!text) {
+        fprintf(stderr, "tokbench: failed to prepare input\n");
+        return 1;
+    }
+
+    if (kernel_given) {
+        rc = tokbench_measure(text, kernel, iterations, thread_count);
+    } else {
+        for (k = 0; k < sizeof(tokbench_kernels) / sizeof(tokbench_kernels[0]) && rc == 0; k++) {
+            if (tokenizer_kernel_available(tokbench_kernels[k])) {
+                rc = tokbench_measure(text, tokbench_kernels[k], iterations, thread_count);
+            }
+        }
+    }
+
+    free(text);
+    return rc;
+}
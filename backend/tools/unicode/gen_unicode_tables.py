@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+# tools/unicode/gen_unicode_tables.py
+#
+# Генерирует src/utils/unicode_tables.h из unicodedata текущего Python:
+#   - диапазоны букв (категории L* и M*) вне ASCII;
+#   - простое посимвольное приведение регистра (casefold, иначе lower,
+#     только отображения 1:1), сжатое в серии {start, count, delta, stride}.
+#
+#   python3 tools/unicode/gen_unicode_tables.py > src/utils/unicode_tables.h
+import sys
+import unicodedata
+
+MAX_CP = 0x110000
+
+
+def letter_ranges():
+    ranges = []
+    for cp in range(0x80, MAX_CP):
+        if unicodedata.category(chr(cp))[0] not in "LM":
+            continue
+        if ranges and ranges[-1][1] == cp - 1:
+            ranges[-1][1] = cp
+        else:
+            ranges.append([cp, cp])
+    return ranges
+
+
+def fold_map():
+    mapping = {}
+    for cp in range(0x80, MAX_CP):
+        ch = chr(cp)
+        for folded in (ch.casefold(), ch.lower()):
+            if len(folded) == 1 and folded != ch:
+                mapping[cp] = ord(folded)
+                break
+    return mapping
+
+
+def fold_runs(mapping):
+    # Серия: start, start + stride, ... с одинаковым сдвигом
+    runs = []
+    pending = sorted(mapping)
+    used = set()
+    for cp in pending:
+        if cp in used:
+            continue
+        delta = mapping[cp] - cp
+        best = (1, 1)
+        for stride in (1, 2):
+            count = 1
+            while mapping.get(cp + count * stride) is not None and \
+                    cp + count * stride not in used and \
+                    mapping[cp + count * stride] - (cp + count * stride) == delta and \
+                    (stride == 1 or cp + count * stride - 1 not in mapping) and \
+                    count < 0xFFFF:
+                count += 1
+            if count > best[0]:
+                best = (count, stride)
+        count, stride = best
+        for i in range(count):
+            used.add(cp + i * stride)
+        runs.append((cp, count, delta, stride))
+    runs.sort()
+    return runs
+
+
+def lookup(runs, cp):
+    # Тот же поиск, что в unicode.c: последняя серия с start <= cp
+    lo, hi = 0, len(runs)
+    while lo < hi:
+        mid = (lo + hi) // 2
+        if runs[mid][0] <= cp:
+            lo = mid + 1
+        else:
+            hi = mid
+    if lo == 0:
+        return cp
+    start, count, delta, stride = runs[lo - 1]
+    offset = cp - start
+    if offset % stride == 0 and offset // stride < count:
+        return cp + delta
+    return cp
+
+
+def main():
+    out = sys.stdout
+    letters = letter_ranges()
+    mapping = fold_map()
+    runs = fold_runs(mapping)
+    for cp in range(0x80, MAX_CP):
+        if lookup(runs, cp) != mapping.get(cp, cp):
+            sys.exit("fold table self-check failed at U+%04X" % cp)
+
+    out.write("/* Сгенерировано tools/unicode/gen_unicode_tables.py, Unicode %s. Не править вручную. */\n"
+              % unicodedata.unidata_version)
+    out.write("#ifndef UTILS_UNICODE_TABLES_H\n#define UTILS_UNICODE_TABLES_H\n\n")
+    out.write("#include <stdint.h>\n\n")
+
+    out.write("/* Буквы и комбинируемые знаки вне ASCII: [first, last]. */\n")
+    out.write("static const uint32_t unicode_letter_ranges[][2] = {\n")
+    for first, last in letters:
+        out.write("    {0x%04X, 0x%04X},\n" % (first, last))
+    out.write("};\n\n")
+
+    out.write("/* Приведение регистра: start + i * stride -> + delta для i < count. */\n")
+    out.write("typedef struct {\n    uint32_t start;\n    uint16_t count;\n"
+              "    uint8_t stride;\n    int32_t delta;\n} unicode_fold_run_t;\n\n")
+    out.write("static const unicode_fold_run_t unicode_fold_runs[] = {\n")
+    for start, count, delta, stride in runs:
+        out.write("    {0x%04X, %d, %d, %d},\n" % (start, count, stride, delta))
+    out.write("};\n\n#endif\n")
+
+
+if __name__ == "__main__":
+    main()
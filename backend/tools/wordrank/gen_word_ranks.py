@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+# tools/wordrank/gen_word_ranks.py
+#
+# Собирает частотный список лемм (tools/wordrank/frequency.txt) в бинарный
+# словарь рангов для src/utils/word_rank.c. Файл не разбирается при старте:
+# сервер отображает его через mmap и ищет прямо в нём. Раскладка — та же
+# минимальная совершенная хеш-таблица, что у стоп-слов (build() берётся из
+# gen_stopword_table.py), все числа — little-endian:
+#
+#   char     magic[8]          "WRANK01\0"
+#   uint32   count             число слов и слотов
+#   uint32   strings_size      размер блока строк
+#   int32    displace[count]   сдвиг корзины, как stopword_displace
+#   uint32   offset[count]     начало слова слота в блоке строк
+#   uint32   rank[count]       ранг слова слота, 1 — самое частое
+#   char     strings[]         слова через '\0'
+#
+#   python3 tools/wordrank/gen_word_ranks.py frequency.txt data/word_ranks.bin
+import os
+import struct
+import sys
+
+sys.dont_write_bytecode = True
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "stopwords"))
+from gen_stopword_table import build, lookup  # noqa: E402
+
+MAGIC = b"WRANK01\0"
+MAX_WORD_BYTES = 64
+
+
+def load(path):
+    ranks = {}
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            for word in line.split():
+                # Частоты из списков вида "слово число" пропускаются.
+                if word.isdigit():
+                    continue
+                word = word.lower()
+                if len(word.encode("utf-8")) > MAX_WORD_BYTES or word in ranks:
+                    continue
+                ranks[word] = len(ranks) + 1
+    if not ranks:
+        sys.exit("%s: no words" % path)
+    return ranks
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: gen_word_ranks.py frequency.txt output.bin")
+    ranks = load(sys.argv[1])
+    keys = {w.encode("utf-8"): r for w, r in ranks.items()}
+    displace, slots = build(sorted(keys))
+    assert all(lookup(displace, slots, k) for k in keys)
+
+    offsets = []
+    strings = bytearray()
+    for key in slots:
+        offsets.append(len(strings))
+        strings += key + b"\0"
+
+    n = len(slots)
+    data = bytearray(MAGIC)
+    data += struct.pack("<II", n, len(strings))
+    data += struct.pack("<%di" % n, *displace)
+    data += struct.pack("<%dI" % n, *offsets)
+    data += struct.pack("<%dI" % n, *(keys[k] for k in slots))
+    data += strings
+
+    out_dir = os.path.dirname(sys.argv[2])
+    if out_dir:
+        os.makedirs(out_dir, exist_ok=True)
+    tmp = sys.argv[2] + ".tmp"
+    with open(tmp, "wb") as f:
+        f.write(data)
+    # rename, а не запись поверх: у работающего сервера старый файл отображён в память.
+    os.replace(tmp, sys.argv[2])
+    print("word ranks: %d words, %d bytes -> %s" % (n, len(data), sys.argv[2]))
+
+
+if __name__ == "__main__":
+    main()
@@ -1,10 +1,19 @@
 # docker/ollama/mock_server.py
 from flask import Flask, jsonify, request
 import re
+import argparse
+import random
+import time
 import json   # добавлено для сериализации карточки в строку
 
 app = Flask(__name__)
 
+# Искусственная задержка части ответов — для проверки дедлайнов и hedge
+SLOW_RATIO = 0.0
+SLOW_DELAY_MS = 0
+# Доля карточек, из которых выкидывается одно поле — для проверки дозапроса
+DROP_FIELD_RATIO = 0.0
+
 MODEL_INFO = {
     "name": "llama3:8b",
     "id": "365c0bd3c000",
@@ -37,16 +46,29 @@ def extract_word_from_prompt(prompt: str) -> str:
 
     return "unknown"
 
-@app.route("/v1/generate", methods=["POST"])
-@app.route("/api/generate", methods=["POST"])
-def generate():
-    data = request.json or {}
-    prompt = data.get("prompt", "")
+def extract_words_from_batch_prompt(prompt: str):
+    """
+    Извлекаем список слов из пакетного prompt.
+    Ожидаем формат:
+    English words: ["run", "eat"]
+    Возвращает None, если prompt не пакетный.
+    """
+    if not prompt:
+        return None
+
+    match = re.search(r'English words:\s*(\[[^\n]*\])', prompt)
+    if not match:
+        return None
+
+    try:
+        words = json.loads(match.group(1))
+    except ValueError:
+        return None
 
-    word = extract_word_from_prompt(prompt)
+    return [str(w) for w in words]
 
-    # Формируем карточку как словарь
-    card = {
+def build_card(word: str) -> dict:
+    return {
         "word": word,
         "translation": "_______________",
         "transcription": "ˈtest",
@@ -56,8 +78,49 @@ def generate():
         ]
     }
 
+def apply_schema(card: dict, schema) -> dict:
+    """
+    Структурированный вывод: оставляем только поля из "properties" схемы,
+    примеров — столько, сколько требует minItems.
+    """
+    if not isinstance(schema, dict):
+        return card
+    props = schema.get("properties") or {}
+    result = {k: v for k, v in card.items() if k in props}
+    if "example" in props:
+        count = props["example"].get("minItems", len(card["example"]))
+        result["example"] = card["example"][:count]
+    return result
+
+def maybe_drop_field(card: dict) -> dict:
+    if DROP_FIELD_RATIO and random.random() < DROP_FIELD_RATIO:
+        field = random.choice([k for k in card if k != "word"] or ["word"])
+        if field == "example" and card.get("example"):
+            card["example"] = card["example"][:-1]
+        else:
+            card.pop(field, None)
+    return card
+
+@app.route("/v1/generate", methods=["POST"])
+@app.route("/api/generate", methods=["POST"])
+def generate():
+    if SLOW_DELAY_MS and random.random() < SLOW_RATIO:
+        time.sleep(SLOW_DELAY_MS / 1000.0)
+    data = request.json or {}
+    prompt = data.get("prompt", "")
+    schema = data.get("format")
+
+    words = extract_words_from_batch_prompt(prompt)
+    if words is not None:
+        # Пакетный запрос: карточки в порядке слов, {"cards": [...]} при схеме
+        cards = [maybe_drop_field(build_card(w)) for w in words]
+        payload = {"cards": cards} if isinstance(schema, dict) else cards
+    else:
+        card = build_card(extract_word_from_prompt(prompt))
+        payload = maybe_drop_field(apply_schema(card, schema))
+
     # Преобразуем карточку в JSON-строку (как это делает реальная Ollama)
-    card_json = json.dumps(card, ensure_ascii=False)
+    card_json = json.dumps(payload, ensure_ascii=False)
 
     # Возвращаем в формате реального Ollama
     return jsonify({
@@ -70,4 +133,14 @@ def ping():
     return "pong"
 
 if __name__ == "__main__":
-    app.run(host="0.0.0.0", port=11434)
+    # Несколько экземпляров на разных портах — для проверки OLLAMA_BACKENDS
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--port", type=int, default=11434)
+    parser.add_argument("--slow-ratio", type=float, default=0.0)
+    parser.add_argument("--slow-ms", type=int, default=0)
+    parser.add_argument("--drop-field-ratio", type=float, default=0.0)
+    args = parser.parse_args()
+    DROP_FIELD_RATIO = args.drop_field_ratio
+    SLOW_RATIO = args.slow_ratio
+    SLOW_DELAY_MS = args.slow_ms
+    app.run(host="0.0.0.0", port=args.port, threaded=True)